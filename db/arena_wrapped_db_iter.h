@@ -59,6 +59,10 @@ class ArenaWrappedDBIter : public Iterator {
   virtual void Prev() override { db_iter_->Prev(); }
   virtual Slice key() const override { return db_iter_->key(); }
   virtual Slice value() const override { return db_iter_->value(); }
+  virtual size_t NextBatch(size_t max_entries, PinnableSlice* keys,
+                           PinnableSlice* values) override {
+    return db_iter_->NextBatch(max_entries, keys, values);
+  }
   virtual Status status() const override { return db_iter_->status(); }
   bool IsBlob() const { return db_iter_->IsBlob(); }
 
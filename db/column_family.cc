@@ -499,6 +499,8 @@ ColumnFamilyData::ColumnFamilyData(
       next_(nullptr),
       prev_(nullptr),
       log_number_(0),
+      manual_compaction_bytes_done_(0),
+      manual_compaction_start_micros_(0),
       flush_reason_(FlushReason::kOthers),
       column_family_set_(column_family_set),
       queued_for_flush_(false),
@@ -753,6 +755,28 @@ int GetL0ThresholdSpeedupCompaction(int level0_file_num_compaction_trigger,
 }
 }  // namespace
 
+double ColumnFamilyData::GetCompactionDebtRatio(
+    const MutableCFOptions& mutable_cf_options) const {
+  const VersionStorageInfo* vstorage = current_->storage_info();
+  double ratio = 0;
+  const int l0_threshold = GetL0ThresholdSpeedupCompaction(
+      mutable_cf_options.level0_file_num_compaction_trigger,
+      mutable_cf_options.level0_slowdown_writes_trigger);
+  if (l0_threshold > 0) {
+    ratio = static_cast<double>(vstorage->l0_delay_trigger_count()) /
+            l0_threshold;
+  }
+  const uint64_t bytes_threshold =
+      mutable_cf_options.soft_pending_compaction_bytes_limit / 4;
+  if (bytes_threshold > 0) {
+    ratio = std::max(
+        ratio,
+        static_cast<double>(vstorage->estimated_compaction_needed_bytes()) /
+            bytes_threshold);
+  }
+  return ratio;
+}
+
 std::pair<WriteStallCondition, ColumnFamilyData::WriteStallCause>
 ColumnFamilyData::GetWriteStallConditionAndCause(
     int num_unflushed_memtables, int num_l0_files,
@@ -17,6 +17,7 @@
 #include "db/memtable_list.h"
 #include "db/table_cache.h"
 #include "db/table_properties_collector.h"
+#include "db/version_edit.h"
 #include "db/write_batch_internal.h"
 #include "db/write_controller.h"
 #include "options/cf_options.h"
@@ -313,6 +314,32 @@ class ColumnFamilyData {
   void SetLogNumber(uint64_t log_number) { log_number_ = log_number; }
   uint64_t GetLogNumber() const { return log_number_; }
 
+  // Progress of the resumable manual compaction of this column family, as
+  // last persisted in the MANIFEST.
+  // REQUIRES: DB mutex held
+  const ManualCompactionProgress& manual_compaction_progress() const {
+    return manual_compaction_progress_;
+  }
+  void SetManualCompactionProgress(const ManualCompactionProgress& progress) {
+    manual_compaction_progress_ = progress;
+  }
+  // Bytes of input compacted by the resumable manual compaction since this
+  // DB was opened, and when it started, used to estimate its completion.
+  // REQUIRES: DB mutex held
+  void ResetManualCompactionStats(uint64_t now_micros) {
+    manual_compaction_bytes_done_ = 0;
+    manual_compaction_start_micros_ = now_micros;
+  }
+  void AddManualCompactionBytes(uint64_t bytes) {
+    manual_compaction_bytes_done_ += bytes;
+  }
+  uint64_t manual_compaction_bytes_done() const {
+    return manual_compaction_bytes_done_;
+  }
+  uint64_t manual_compaction_start_micros() const {
+    return manual_compaction_start_micros_;
+  }
+
   void SetFlushReason(FlushReason flush_reason) {
     flush_reason_ = flush_reason;
   }
@@ -481,6 +508,14 @@ class ColumnFamilyData {
   WriteStallCondition RecalculateWriteStallConditions(
       const MutableCFOptions& mutable_cf_options);
 
+  // Returns the compaction debt of the current version relative to the point
+  // at which RecalculateWriteStallConditions() asks for all compaction
+  // threads to be used: 0 means no debt, and 1 or more means that point has
+  // been reached.
+  // REQUIRES: DB mutex held
+  double GetCompactionDebtRatio(
+      const MutableCFOptions& mutable_cf_options) const;
+
   void set_initialized() { initialized_.store(true); }
 
   bool initialized() const { return initialized_.load(); }
@@ -557,6 +592,10 @@ class ColumnFamilyData {
   // recovered from
   uint64_t log_number_;
 
+  ManualCompactionProgress manual_compaction_progress_;
+  uint64_t manual_compaction_bytes_done_;
+  uint64_t manual_compaction_start_micros_;
+
   std::atomic<FlushReason> flush_reason_;
 
   // An object that keeps all the compaction stats
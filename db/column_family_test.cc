@@ -2758,6 +2758,79 @@ TEST_P(ColumnFamilyTest, CompactionSpeedupSingleColumnFamily) {
   ASSERT_EQ(1, dbfull()->TEST_BGCompactionsAllowed());
 }
 
+TEST_P(ColumnFamilyTest, CompactionAutoscaling) {
+  db_options_.max_background_compactions = 6;
+  // Only run on demand
+  db_options_.compaction_autoscale_period_sec = 1000;
+  // Speed up threshold = min(4 * 2, 4 + (36 - 4)/4) = 8
+  column_family_options_.level0_file_num_compaction_trigger = 4;
+  column_family_options_.level0_slowdown_writes_trigger = 36;
+  column_family_options_.level0_stop_writes_trigger = 50;
+  // Speedup threshold = 800 / 4 = 200
+  column_family_options_.soft_pending_compaction_bytes_limit = 800;
+  column_family_options_.hard_pending_compaction_bytes_limit = 2000;
+  Open({"default"});
+  ColumnFamilyData* cfd =
+      static_cast<ColumnFamilyHandleImpl*>(db_->DefaultColumnFamily())->cfd();
+  VersionStorageInfo* vstorage = cfd->current()->storage_info();
+  MutableCFOptions mutable_cf_options(column_family_options_);
+
+  ASSERT_EQ(1, dbfull()->TEST_AutoscaleCompactions());
+  ASSERT_EQ(1, dbfull()->TEST_BGCompactionsAllowed());
+
+  // Debt 0.6 jumps to ceil(6 * 0.6) = 4, then grows by one
+  vstorage->TEST_set_estimated_compaction_needed_bytes(120);
+  RecalculateWriteStallConditions(cfd, mutable_cf_options);
+  ASSERT_EQ(4, dbfull()->TEST_AutoscaleCompactions());
+  ASSERT_EQ(4, dbfull()->TEST_BGCompactionsAllowed());
+  ASSERT_EQ(5, dbfull()->TEST_AutoscaleCompactions());
+  ASSERT_EQ(5, dbfull()->TEST_BGCompactionsAllowed());
+
+  // Moderate debt keeps the limit
+  vstorage->TEST_set_estimated_compaction_needed_bytes(80);
+  RecalculateWriteStallConditions(cfd, mutable_cf_options);
+  ASSERT_EQ(5, dbfull()->TEST_AutoscaleCompactions());
+
+  // Low debt steps down one at a time
+  vstorage->TEST_set_estimated_compaction_needed_bytes(10);
+  RecalculateWriteStallConditions(cfd, mutable_cf_options);
+  ASSERT_EQ(4, dbfull()->TEST_AutoscaleCompactions());
+  ASSERT_EQ(3, dbfull()->TEST_AutoscaleCompactions());
+  ASSERT_EQ(3, dbfull()->TEST_BGCompactionsAllowed());
+
+  // Past the speedup threshold everything is allowed regardless
+  vstorage->TEST_set_estimated_compaction_needed_bytes(250);
+  RecalculateWriteStallConditions(cfd, mutable_cf_options);
+  ASSERT_EQ(6, dbfull()->TEST_BGCompactionsAllowed());
+
+  // L0 files count as debt too: 6 / 8 = 0.75
+  vstorage->TEST_set_estimated_compaction_needed_bytes(0);
+  vstorage->set_l0_delay_trigger_count(6);
+  RecalculateWriteStallConditions(cfd, mutable_cf_options);
+  ASSERT_EQ(5, dbfull()->TEST_AutoscaleCompactions());
+  ASSERT_EQ(5, dbfull()->TEST_BGCompactionsAllowed());
+  Close();
+
+  // Slow foreground writes lower the limit while debt is moderate
+  db_options_.compaction_autoscale_write_latency_micros = 100;
+  Open({"default"});
+  cfd = static_cast<ColumnFamilyHandleImpl*>(db_->DefaultColumnFamily())->cfd();
+  vstorage = cfd->current()->storage_info();
+  vstorage->TEST_set_estimated_compaction_needed_bytes(120);
+  RecalculateWriteStallConditions(cfd, mutable_cf_options);
+  ASSERT_EQ(4, dbfull()->TEST_AutoscaleCompactions());
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::WriteImpl:BeforeLeaderEnters",
+      [&](void* /*arg*/) { env_->SleepForMicroseconds(1000); });
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+  ASSERT_OK(Put(0, "foo", "bar"));
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+  rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_EQ(3, dbfull()->TEST_AutoscaleCompactions());
+  // Latency history is reset every period
+  ASSERT_EQ(4, dbfull()->TEST_AutoscaleCompactions());
+}
+
 TEST_P(ColumnFamilyTest, WriteStallTwoColumnFamilies) {
   const uint64_t kBaseRate = 810000u;
   db_options_.delayed_write_rate = kBaseRate;
@@ -291,6 +291,11 @@ class Compaction {
 
   uint32_t max_subcompactions() const { return max_subcompactions_; }
 
+  // Lowers max_subcompactions() to at most `limit`
+  void LimitMaxSubcompactions(uint32_t limit) {
+    max_subcompactions_ = std::min(max_subcompactions_, limit);
+  }
+
   uint64_t MinInputFileOldestAncesterTime() const;
 
  private:
@@ -45,6 +45,7 @@
 #include "port/port.h"
 #include "rocksdb/db.h"
 #include "rocksdb/env.h"
+#include "rocksdb/sst_partitioner.h"
 #include "rocksdb/statistics.h"
 #include "rocksdb/status.h"
 #include "rocksdb/table.h"
@@ -155,6 +156,11 @@ struct CompactionJob::SubcompactionState {
   uint64_t overlapped_bytes = 0;
   // A flag determine whether the key has been seen in ShouldStopBefore()
   bool seen_key = false;
+  // The sst_partitioner partition of the keys in the current output.
+  size_t output_partition = 0;
+  // The number of grandparent file boundaries between the keys of the
+  // current output, used in ShouldStopBefore().
+  size_t grandparent_boundaries_crossed = 0;
 
   SubcompactionState(Compaction* c, Slice* _start, Slice* _end,
                      uint64_t size = 0)
@@ -170,7 +176,9 @@ struct CompactionJob::SubcompactionState {
         approx_size(size),
         grandparent_index(0),
         overlapped_bytes(0),
-        seen_key(false) {
+        seen_key(false),
+        output_partition(0),
+        grandparent_boundaries_crossed(0) {
     assert(compaction != nullptr);
   }
 
@@ -193,6 +201,9 @@ struct CompactionJob::SubcompactionState {
     grandparent_index = std::move(o.grandparent_index);
     overlapped_bytes = std::move(o.overlapped_bytes);
     seen_key = std::move(o.seen_key);
+    output_partition = std::move(o.output_partition);
+    grandparent_boundaries_crossed =
+        std::move(o.grandparent_boundaries_crossed);
     return *this;
   }
 
@@ -201,6 +212,16 @@ struct CompactionJob::SubcompactionState {
 
   SubcompactionState& operator=(const SubcompactionState&) = delete;
 
+  // Returns true if output files are cut at grandparent file boundaries,
+  // with sizes between half and twice the target file size.
+  bool UseDynamicFileSize() const {
+    return compaction->immutable_cf_options()->compaction_style ==
+               kCompactionStyleLevel &&
+           compaction->mutable_cf_options()
+               ->level_compaction_dynamic_file_size &&
+           !compaction->grandparents().empty();
+  }
+
   // Returns true iff we should stop building the current output
   // before processing "internal_key".
   bool ShouldStopBefore(const Slice& internal_key, uint64_t curr_file_size) {
@@ -209,12 +230,14 @@ struct CompactionJob::SubcompactionState {
     const std::vector<FileMetaData*>& grandparents = compaction->grandparents();
 
     // Scan to find earliest grandparent file that contains key.
+    size_t boundaries_crossed = 0;
     while (grandparent_index < grandparents.size() &&
            icmp->Compare(internal_key,
                          grandparents[grandparent_index]->largest.Encode()) >
                0) {
       if (seen_key) {
         overlapped_bytes += grandparents[grandparent_index]->fd.GetFileSize();
+        boundaries_crossed++;
       }
       assert(grandparent_index + 1 >= grandparents.size() ||
              icmp->Compare(
@@ -224,13 +247,41 @@ struct CompactionJob::SubcompactionState {
     }
     seen_key = true;
 
+    const SstPartitioner* partitioner =
+        compaction->immutable_cf_options()->sst_partitioner.get();
+    if (partitioner != nullptr && builder != nullptr &&
+        partitioner->PartitionForKey(ExtractUserKey(internal_key)) !=
+            output_partition) {
+      // Output files must not straddle partition boundaries
+      overlapped_bytes = 0;
+      grandparent_boundaries_crossed = 0;
+      return true;
+    }
+
     if (overlapped_bytes + curr_file_size >
         compaction->max_compaction_bytes()) {
       // Too much overlap for current output; start new output
       overlapped_bytes = 0;
+      grandparent_boundaries_crossed = 0;
       return true;
     }
 
+    if (boundaries_crossed > 0 && UseDynamicFileSize()) {
+      // Stop at the grandparent boundary once the output is big enough. The
+      // more grandparent files the output already spans, the closer to the
+      // target size it has to get, which avoids many tiny outputs when the
+      // grandparent files are small.
+      const uint64_t min_file_size =
+          compaction->max_output_file_size() / 100 *
+          (50 + std::min<uint64_t>(5 * grandparent_boundaries_crossed, 40));
+      grandparent_boundaries_crossed += boundaries_crossed;
+      if (curr_file_size >= min_file_size) {
+        overlapped_bytes = 0;
+        grandparent_boundaries_crossed = 0;
+        return true;
+      }
+    }
+
     return false;
   }
 };
@@ -633,6 +684,13 @@ Status CompactionJob::Run() {
     ColumnFamilyData* cfd = compact_->compaction->column_family_data();
     auto prefix_extractor =
         compact_->compaction->mutable_cf_options()->prefix_extractor.get();
+    // The hot key ranges of the input files, warmed in the output files
+    // before they replace the input files
+    std::vector<std::pair<std::string, std::string>> hot_ranges;
+    if (compact_->compaction->mutable_cf_options()
+            ->warm_hot_blocks_after_compaction) {
+      GetInputCachedKeyRanges(&hot_ranges);
+    }
     std::atomic<size_t> next_file_meta_idx(0);
     auto verify_table = [&](Status& output_status) {
       while (true) {
@@ -646,10 +704,11 @@ Status CompactionJob::Run() {
         // No matter whether use_direct_io_for_flush_and_compaction is true,
         // we will regard this verification as user reads since the goal is
         // to cache it here for further user reads
+        TableReader* table_reader = nullptr;
         InternalIterator* iter = cfd->table_cache()->NewIterator(
             ReadOptions(), env_options_, cfd->internal_comparator(),
             *files_meta[file_idx], /*range_del_agg=*/nullptr, prefix_extractor,
-            /*table_reader_ptr=*/nullptr,
+            &table_reader,
             cfd->internal_stats()->GetFileReadHist(
                 compact_->compaction->output_level()),
             TableReaderCaller::kCompactionRefill, /*arena=*/nullptr,
@@ -663,6 +722,10 @@ Status CompactionJob::Run() {
           s = iter->status();
         }
 
+        if (s.ok() && table_reader != nullptr && !hot_ranges.empty()) {
+          WarmOutputFile(table_reader, *files_meta[file_idx], hot_ranges);
+        }
+
         delete iter;
 
         if (!s.ok()) {
@@ -709,6 +772,97 @@ Status CompactionJob::Run() {
   return status;
 }
 
+void CompactionJob::GetInputCachedKeyRanges(
+    std::vector<std::pair<std::string, std::string>>* ranges) {
+  Compaction* c = compact_->compaction;
+  ColumnFamilyData* cfd = c->column_family_data();
+  TableCache* table_cache = cfd->table_cache();
+  for (size_t i = 0; i < c->num_input_levels(); i++) {
+    for (const FileMetaData* f : *c->inputs(i)) {
+      TableReader* table_reader = f->fd.table_reader;
+      Cache::Handle* handle = nullptr;
+      if (table_reader == nullptr) {
+        // A table that is not open has not been read lately
+        Status s = table_cache->FindTable(
+            env_options_, cfd->internal_comparator(), f->fd, &handle,
+            c->mutable_cf_options()->prefix_extractor.get(), /*no_io=*/true);
+        if (!s.ok()) {
+          continue;
+        }
+        table_reader = table_cache->GetTableReaderFromHandle(handle);
+      }
+      // A failure only leaves ranges out
+      table_reader->GetCachedKeyRanges(ranges);
+      if (handle != nullptr) {
+        table_cache->ReleaseHandle(handle);
+      }
+    }
+  }
+
+  // An empty begin key stands for the start of a table, before any key
+  const Comparator* ucmp = cfd->user_comparator();
+  auto begin_less = [ucmp](const std::pair<std::string, std::string>& a,
+                           const std::pair<std::string, std::string>& b) {
+    if (a.first.empty() || b.first.empty()) {
+      return a.first.empty() && !b.first.empty();
+    }
+    return ucmp->Compare(a.first, b.first) < 0;
+  };
+  std::sort(ranges->begin(), ranges->end(), begin_less);
+  size_t merged = 0;
+  for (size_t i = 1; i < ranges->size(); i++) {
+    auto& last = (*ranges)[merged];
+    auto& range = (*ranges)[i];
+    if (range.first.empty() || ucmp->Compare(range.first, last.second) <= 0) {
+      if (ucmp->Compare(range.second, last.second) > 0) {
+        last.second.swap(range.second);
+      }
+    } else {
+      (*ranges)[++merged].swap(range);
+    }
+  }
+  if (!ranges->empty()) {
+    ranges->resize(merged + 1);
+  }
+}
+
+void CompactionJob::WarmOutputFile(
+    TableReader* table_reader, const FileMetaData& meta,
+    const std::vector<std::pair<std::string, std::string>>& ranges) {
+  const Comparator* ucmp =
+      compact_->compaction->column_family_data()->user_comparator();
+  const Slice smallest = meta.smallest.user_key();
+  const Slice largest = meta.largest.user_key();
+  for (const auto& range : ranges) {
+    if (ucmp->Compare(range.second, smallest) < 0) {
+      continue;
+    }
+    if (!range.first.empty() && ucmp->Compare(range.first, largest) >= 0) {
+      break;
+    }
+    // The ranges exclude their begin key, and include all the versions of
+    // their end key
+    InternalKey begin;
+    InternalKey end;
+    Slice begin_key;
+    Slice end_key;
+    const bool from_start =
+        range.first.empty() || ucmp->Compare(range.first, smallest) < 0;
+    const bool to_end = ucmp->Compare(range.second, largest) >= 0;
+    if (!from_start) {
+      begin.Set(range.first, 0, kValueTypeForSeekForPrev);
+      begin_key = begin.Encode();
+    }
+    if (!to_end) {
+      end.Set(range.second, 0, kValueTypeForSeekForPrev);
+      end_key = end.Encode();
+    }
+    // Warming is best effort
+    table_reader->Prefetch(from_start ? nullptr : &begin_key,
+                           to_end ? nullptr : &end_key);
+  }
+}
+
 Status CompactionJob::Install(const MutableCFOptions& mutable_cf_options) {
   AutoThreadOperationStageUpdater stage_updater(
       ThreadStatus::STAGE_COMPACTION_INSTALL);
@@ -717,6 +871,7 @@ Status CompactionJob::Install(const MutableCFOptions& mutable_cf_options) {
   ColumnFamilyData* cfd = compact_->compaction->column_family_data();
   cfd->internal_stats()->AddCompactionStats(
       compact_->compaction->output_level(), thread_pri_, compaction_stats_);
+  UpdatePartitionCompactionStats();
 
   if (status.ok()) {
     status = InstallCompactionResults(mutable_cf_options);
@@ -903,6 +1058,15 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
                                   sub_compact->current_output_file_size);
   }
   const auto& c_iter_stats = c_iter->iter_stats();
+  const SstPartitioner* partitioner =
+      sub_compact->compaction->output_level() != 0
+          ? cfd->ioptions()->sst_partitioner.get()
+          : nullptr;
+  // With dynamic file sizes, an output may grow past the target size to get
+  // to the next grandparent boundary.
+  const uint64_t max_output_file_size =
+      sub_compact->compaction->max_output_file_size() *
+      (sub_compact->UseDynamicFileSize() ? 2 : 1);
 
   while (status.ok() && !cfd->IsDropped() && c_iter->Valid()) {
     // Invariant: c_iter.status() is guaranteed to be OK if c_iter->Valid()
@@ -929,6 +1093,11 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
       if (!status.ok()) {
         break;
       }
+      if (partitioner != nullptr) {
+        sub_compact->output_partition =
+            partitioner->PartitionForKey(c_iter->user_key());
+      }
+      sub_compact->grandparent_boundaries_crossed = 0;
     }
     assert(sub_compact->builder != nullptr);
     assert(sub_compact->current_output() != nullptr);
@@ -950,8 +1119,7 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     bool output_file_ended = false;
     Status input_status;
     if (sub_compact->compaction->output_level() != 0 &&
-        sub_compact->current_output_file_size >=
-            sub_compact->compaction->max_output_file_size()) {
+        sub_compact->current_output_file_size >= max_output_file_size) {
       // (1) this key terminates the file. For historical reasons, the iterator
       // status before advancing will be given to FinishCompactionOutputFile().
       input_status = input->status();
@@ -1515,6 +1683,15 @@ Status CompactionJob::OpenCompactionOutputFile(
   sub_compact->outfile.reset(
       new WritableFileWriter(std::move(writable_file), fname, env_options_,
                              env_, db_options_.statistics.get(), listeners));
+  // Compactions of L0 files come first, since too many L0 files stall writes
+  if (sub_compact->compaction->start_level() == 0) {
+    sub_compact->outfile->SetIOClass(RateLimiter::IOClass::kL0Compaction);
+  } else if (bottommost_level_) {
+    sub_compact->outfile->SetIOClass(
+        RateLimiter::IOClass::kBottommostCompaction);
+  } else {
+    sub_compact->outfile->SetIOClass(RateLimiter::IOClass::kCompaction);
+  }
 
   // If the Column family flag is to only optimize filters for hits,
   // we can skip creating filters if this is the bottommost_level where
@@ -1570,6 +1747,38 @@ void CopyPrefix(const Slice& src, size_t prefix_length, std::string* dst) {
 
 #endif  // !ROCKSDB_LITE
 
+void CompactionJob::UpdatePartitionCompactionStats() {
+  const Compaction* c = compact_->compaction;
+  const SstPartitioner* partitioner =
+      c->immutable_cf_options()->sst_partitioner.get();
+  if (partitioner == nullptr) {
+    return;
+  }
+  std::vector<InternalStats::PartitionCompactionStats> stats(
+      partitioner->NumPartitions());
+  std::vector<bool> touched(stats.size(), false);
+  for (size_t i = 0; i < c->num_input_levels(); i++) {
+    for (const FileMetaData* f : *c->inputs(i)) {
+      size_t p = partitioner->PartitionForKey(f->smallest.user_key());
+      stats[p].bytes_read += f->fd.GetFileSize();
+      touched[p] = true;
+    }
+  }
+  for (const auto& sub_compact : compact_->sub_compact_states) {
+    for (const auto& out : sub_compact.outputs) {
+      size_t p = partitioner->PartitionForKey(out.meta.smallest.user_key());
+      stats[p].bytes_written += out.meta.fd.GetFileSize();
+      stats[p].num_output_files++;
+      touched[p] = true;
+    }
+  }
+  for (size_t p = 0; p < stats.size(); p++) {
+    stats[p].count = touched[p] ? 1 : 0;
+  }
+  c->column_family_data()->internal_stats()->AddPartitionCompactionStats(
+      stats);
+}
+
 void CompactionJob::UpdateCompactionStats() {
   Compaction* compaction = compact_->compaction;
   compaction_stats_.num_input_files_in_non_output_levels = 0;
@@ -115,6 +115,16 @@ class CompactionJob {
   // update the thread status for starting a compaction.
   void ReportStartedCompaction(Compaction* compaction);
   void AllocateCompactionOutputFileNumbers();
+  // Sets *ranges to the user key ranges of the data blocks of the input files
+  // found in the block cache, see TableReader::GetCachedKeyRanges(), sorted
+  // and merged.
+  void GetInputCachedKeyRanges(
+      std::vector<std::pair<std::string, std::string>>* ranges);
+  // Loads into the block cache the data blocks of an output file holding
+  // keys in the ranges given by GetInputCachedKeyRanges().
+  void WarmOutputFile(
+      TableReader* table_reader, const FileMetaData& meta,
+      const std::vector<std::pair<std::string, std::string>>& ranges);
   // Call compaction filter. Then iterate through input and compact the
   // kv-pairs
   void ProcessKeyValueCompaction(SubcompactionState* sub_compact);
@@ -134,6 +144,7 @@ class CompactionJob {
                          CompactionJobStats* compaction_job_stats = nullptr);
 
   void UpdateCompactionStats();
+  void UpdatePartitionCompactionStats();
   void UpdateCompactionInputStatsHelper(
       int* num_files, uint64_t* bytes_read, int input_level);
 
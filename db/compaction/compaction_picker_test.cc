@@ -13,6 +13,7 @@
 #include "db/compaction/compaction_picker_universal.h"
 
 #include "logging/logging.h"
+#include "rocksdb/sst_partitioner.h"
 #include "test_util/testharness.h"
 #include "test_util/testutil.h"
 #include "util/string_util.h"
@@ -122,7 +123,8 @@ class CompactionPickerTest : public testing::Test {
 
   void UpdateVersionStorageInfo() {
     vstorage_->CalculateBaseBytes(ioptions_, mutable_cf_options_);
-    vstorage_->UpdateFilesByCompactionPri(ioptions_.compaction_pri);
+    vstorage_->UpdateFilesByCompactionPri(ioptions_.compaction_pri,
+                                          ioptions_.sst_partitioner.get());
     vstorage_->UpdateNumNonEmptyLevels();
     vstorage_->GenerateFileIndexer();
     vstorage_->GenerateLevelFilesBrief();
@@ -724,6 +726,41 @@ TEST_F(CompactionPickerTest, CompactionPriMinOverlapping1) {
   ASSERT_GE(uint64_t{55000000}, compaction->OutputFilePreallocationSize());
 }
 
+TEST_F(CompactionPickerTest, CompactionPriSstPartitionScore) {
+  NewVersionStorage(3, kCompactionStyleLevel);
+  mutable_cf_options_.max_bytes_for_level_base = 1000;
+  mutable_cf_options_.RefreshDerivedOptions(ioptions_);
+
+  // Partition 0 has already settled into the bottommost level, partition 1
+  // only has data in L1.
+  Add(1, 1U, "100", "150", 2000U);
+  Add(1, 2U, "600", "650", 1000U);
+  Add(2, 10U, "100", "200", 100000U);
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(level_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  // Without a partitioner the largest file is picked.
+  ASSERT_EQ(1U, compaction->input(0, 0)->fd.GetNumber());
+  level_compaction_picker.ReleaseCompactionFiles(compaction.get(),
+                                                 Status::OK());
+  compaction.reset();
+
+  ioptions_.sst_partitioner = NewKeyRangeSstPartitioner({"500"});
+  NewVersionStorage(3, kCompactionStyleLevel);
+  Add(1, 1U, "100", "150", 2000U);
+  Add(1, 2U, "600", "650", 1000U);
+  Add(2, 10U, "100", "200", 100000U);
+  UpdateVersionStorageInfo();
+
+  compaction.reset(level_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  // Partition 1 is the most out of shape, so its file goes first.
+  ASSERT_EQ(2U, compaction->input(0, 0)->fd.GetNumber());
+}
+
 TEST_F(CompactionPickerTest, CompactionPriMinOverlapping2) {
   NewVersionStorage(6, kCompactionStyleLevel);
   ioptions_.compaction_pri = kMinOverlappingRatio;
@@ -810,6 +847,63 @@ TEST_F(CompactionPickerTest, CompactionPriMinOverlapping4) {
   ASSERT_EQ(6U, compaction->input(0, 0)->fd.GetNumber());
 }
 
+TEST_F(CompactionPickerTest, CompactionPriHotFirst) {
+  NewVersionStorage(6, kCompactionStyleLevel);
+  ioptions_.compaction_pri = kHotAndTombstoneDenseFirst;
+  mutable_cf_options_.target_file_size_base = 100000000000;
+  mutable_cf_options_.target_file_size_multiplier = 10;
+  mutable_cf_options_.max_bytes_for_level_base = 10 * 1024 * 1024;
+  mutable_cf_options_.RefreshDerivedOptions(ioptions_);
+
+  Add(2, 6U, "150", "179", 50000000U);
+  Add(2, 7U, "180", "220", 50000000U);
+  Add(2, 8U, "321", "400", 50000000U);  // File not overlapping
+  Add(2, 9U, "721", "800", 50000000U);
+
+  Add(3, 26U, "150", "170", 260000000U);
+  Add(3, 27U, "171", "179", 260000000U);
+  Add(3, 28U, "191", "220", 260000000U);
+  Add(3, 29U, "221", "300", 260000000U);
+  Add(3, 30U, "750", "900", 260000000U);
+  // File 7 is read-hot, which outweighs its overlap.
+  file_map_[7U].first->stats.num_reads_sampled = 100000;
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(level_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(1U, compaction->num_input_files(0));
+  ASSERT_EQ(7U, compaction->input(0, 0)->fd.GetNumber());
+}
+
+TEST_F(CompactionPickerTest, CompactionPriTombstoneDenseFirst) {
+  NewVersionStorage(6, kCompactionStyleLevel);
+  ioptions_.compaction_pri = kHotAndTombstoneDenseFirst;
+  mutable_cf_options_.target_file_size_base = 100000000000;
+  mutable_cf_options_.target_file_size_multiplier = 10;
+  mutable_cf_options_.max_bytes_for_level_base = 10 * 1024 * 1024;
+  mutable_cf_options_.RefreshDerivedOptions(ioptions_);
+
+  // None of the files overlap with the next level.
+  Add(2, 6U, "150", "179", 50000000U);
+  Add(2, 7U, "180", "220", 50000000U);
+  Add(2, 8U, "321", "400", 50000000U);
+
+  Add(3, 26U, "500", "600", 260000000U);
+  // Half of the entries of file 8 are tombstones.
+  file_map_[8U].first->num_entries = 1000;
+  file_map_[8U].first->num_deletions = 500;
+  file_map_[6U].first->num_entries = 1000;
+  file_map_[7U].first->num_entries = 1000;
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(level_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(1U, compaction->num_input_files(0));
+  ASSERT_EQ(8U, compaction->input(0, 0)->fd.GetNumber());
+}
+
 // This test exhibits the bug where we don't properly reset parent_index in
 // PickCompaction()
 TEST_F(CompactionPickerTest, ParentIndexResetBug) {
@@ -0,0 +1,56 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/sst_partitioner.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "rocksdb/comparator.h"
+
+namespace rocksdb {
+
+namespace {
+class KeyRangeSstPartitioner : public SstPartitioner {
+ public:
+  KeyRangeSstPartitioner(const std::vector<std::string>& boundaries,
+                         const Comparator* comparator)
+      : boundaries_(boundaries), comparator_(comparator) {
+#ifndef NDEBUG
+    for (size_t i = 1; i < boundaries_.size(); i++) {
+      assert(comparator_->Compare(boundaries_[i - 1], boundaries_[i]) < 0);
+    }
+#endif
+  }
+
+  const char* Name() const override { return "KeyRangeSstPartitioner"; }
+
+  size_t NumPartitions() const override { return boundaries_.size() + 1; }
+
+  size_t PartitionForKey(const Slice& user_key) const override {
+    // Number of boundaries that are <= user_key.
+    auto it = std::upper_bound(
+        boundaries_.begin(), boundaries_.end(), user_key,
+        [this](const Slice& key, const std::string& boundary) {
+          return comparator_->Compare(key, boundary) < 0;
+        });
+    return static_cast<size_t>(it - boundaries_.begin());
+  }
+
+ private:
+  const std::vector<std::string> boundaries_;
+  const Comparator* comparator_;
+};
+}  // namespace
+
+std::shared_ptr<SstPartitioner> NewKeyRangeSstPartitioner(
+    const std::vector<std::string>& boundaries, const Comparator* comparator) {
+  if (comparator == nullptr) {
+    comparator = BytewiseComparator();
+  }
+  return std::make_shared<KeyRangeSstPartitioner>(boundaries, comparator);
+}
+
+}  // namespace rocksdb
@@ -560,6 +560,69 @@ TEST_F(DBBlockCacheTest, ParanoidFileChecks) {
             TestGetTickerCount(options, BLOCK_CACHE_ADD));
 }
 
+TEST_F(DBBlockCacheTest, WarmHotBlocksAfterCompaction) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.statistics = rocksdb::CreateDBStatistics();
+  options.disable_auto_compactions = true;
+  BlockBasedTableOptions table_options;
+  // Each key gets its own data block
+  table_options.block_size = 1;
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 100;
+  auto key = [](int i) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "key%03d", i);
+    return std::string(buf);
+  };
+  for (int round = 0; round < 2; round++) {
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_OK(Put(key(i), "value" + ToString(round) + "_" + ToString(i)));
+    }
+    ASSERT_OK(Flush());
+  }
+  // Heat up the blocks of keys 20 to 29 in the newer file
+  for (int i = 20; i < 30; i++) {
+    ASSERT_EQ("value1_" + ToString(i), Get(key(i)));
+  }
+
+  ASSERT_OK(dbfull()->SetOptions(
+      {{"warm_hot_blocks_after_compaction", "true"}}));
+  uint64_t adds = TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD);
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("0,1", FilesPerLevel());
+  // The hot blocks of the output, and at most one past each end of the range
+  uint64_t warmed = TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD) - adds;
+  ASSERT_GE(warmed, 10);
+  ASSERT_LE(warmed, 12);
+
+  uint64_t misses = TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS);
+  uint64_t hits = TestGetTickerCount(options, BLOCK_CACHE_DATA_HIT);
+  for (int i = 20; i < 30; i++) {
+    ASSERT_EQ("value1_" + ToString(i), Get(key(i)));
+  }
+  ASSERT_EQ(misses, TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+  ASSERT_EQ(hits + 10, TestGetTickerCount(options, BLOCK_CACHE_DATA_HIT));
+  // Cold keys were not warmed
+  ASSERT_EQ("value1_50", Get(key(50)));
+  ASSERT_EQ(misses + 1, TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+
+  // Without the option, the hot blocks are not carried over
+  ASSERT_OK(dbfull()->SetOptions(
+      {{"warm_hot_blocks_after_compaction", "false"}}));
+  CompactRangeOptions cro;
+  cro.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  misses = TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS);
+  for (int i = 20; i < 30; i++) {
+    ASSERT_EQ("value1_" + ToString(i), Get(key(i)));
+  }
+  ASSERT_EQ(misses + 10, TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+}
+
 TEST_F(DBBlockCacheTest, CompressedCache) {
   if (!Snappy_Supported()) {
     return;
@@ -1891,6 +1891,71 @@ TEST_F(DBBloomFilterTest, DynamicBloomFilterOptions) {
   }
 }
 
+TEST_F(DBBloomFilterTest, RangeFilter) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.statistics = CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  table_options.range_filter = true;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  // L1 has a0..a9, c0..c9 and e0..e9, L0 has g0..g9
+  for (int i = 0; i < 10; i++) {
+    ASSERT_OK(Put("a" + ToString(i), "va"));
+    ASSERT_OK(Put("c" + ToString(i), "vc"));
+    ASSERT_OK(Put("e" + ToString(i), "ve"));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  for (int i = 0; i < 10; i++) {
+    ASSERT_OK(Put("g" + ToString(i), "vg"));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_EQ("1,1", FilesPerLevel());
+  ASSERT_OK(db_->VerifyChecksum());
+
+  auto count_from = [&](const std::string& start, const char* upper_bound) {
+    ReadOptions ro;
+    Slice upper_bound_slice(upper_bound != nullptr ? upper_bound : "");
+    if (upper_bound != nullptr) {
+      ro.iterate_upper_bound = &upper_bound_slice;
+    }
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ro));
+    int count = 0;
+    for (iter->Seek(start); iter->Valid(); iter->Next()) {
+      count++;
+    }
+    EXPECT_OK(iter->status());
+    return count;
+  };
+  auto data_block_accesses = [&]() {
+    return TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS) +
+           TestGetTickerCount(options, BLOCK_CACHE_DATA_HIT);
+  };
+
+  ASSERT_EQ(5, count_from("a5", "b"));
+  ASSERT_EQ(2, TestGetTickerCount(options, RANGE_FILTER_CHECKED));
+  ASSERT_EQ(1, TestGetTickerCount(options, RANGE_FILTER_USEFUL));
+
+  // No key in [b, bz) in either file
+  uint64_t data_blocks = data_block_accesses();
+  ASSERT_EQ(0, count_from("b", "bz"));
+  ASSERT_EQ(4, TestGetTickerCount(options, RANGE_FILTER_CHECKED));
+  ASSERT_EQ(3, TestGetTickerCount(options, RANGE_FILTER_USEFUL));
+  ASSERT_EQ(data_blocks, data_block_accesses());
+
+  ASSERT_EQ(10, count_from("b", "d"));
+  ASSERT_EQ(10, count_from("d", "f"));
+  ASSERT_EQ(20, count_from("d", "z"));
+  ASSERT_EQ(0, count_from("h", "z"));
+
+  // Not checked without an upper bound
+  uint64_t checked = TestGetTickerCount(options, RANGE_FILTER_CHECKED);
+  ASSERT_EQ(30, count_from("b", nullptr));
+  ASSERT_EQ(checked, TestGetTickerCount(options, RANGE_FILTER_CHECKED));
+}
+
 #endif  // ROCKSDB_LITE
 
 }  // namespace rocksdb
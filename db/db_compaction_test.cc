@@ -7,16 +7,20 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include <sstream>
+
 #include "db/db_test_util.h"
 #include "port/port.h"
 #include "port/stack_trace.h"
 #include "rocksdb/concurrent_task_limiter.h"
 #include "rocksdb/experimental.h"
 #include "rocksdb/sst_file_writer.h"
+#include "rocksdb/sst_partitioner.h"
 #include "rocksdb/utilities/convenience.h"
 #include "test_util/fault_injection_test_env.h"
 #include "test_util/sync_point.h"
 #include "util/concurrent_task_limiter_impl.h"
+#include "util/string_util.h"
 
 namespace rocksdb {
 
@@ -4932,6 +4936,263 @@ TEST_F(DBCompactionTest, ConsistencyFailTest) {
   rocksdb::SyncPoint::GetInstance()->DisableProcessing();
 }
 
+TEST_F(DBCompactionTest, SstPartitionerCutsOutputFiles) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  // Boundaries at Key(25), Key(50) and Key(75) create four partitions.
+  std::shared_ptr<SstPartitioner> partitioner =
+      NewKeyRangeSstPartitioner({Key(25), Key(50), Key(75)});
+  options.sst_partitioner = partitioner;
+  DestroyAndReopen(options);
+
+  std::string prop;
+  ASSERT_TRUE(dbfull()->GetProperty(DB::Properties::kSstPartitionStats, &prop));
+
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(Put(Key(i), "val"));
+  }
+  ASSERT_OK(Flush());
+  for (int i = 0; i < 100; i += 2) {
+    ASSERT_OK(Put(Key(i), "val2"));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_EQ(2, NumTableFilesAtLevel(0));
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  ASSERT_EQ(4, NumTableFilesAtLevel(1));
+
+  std::vector<LiveFileMetaData> metadata;
+  db_->GetLiveFilesMetaData(&metadata);
+  std::set<size_t> partitions;
+  for (const auto& f : metadata) {
+    size_t p = partitioner->PartitionForKey(f.smallestkey);
+    ASSERT_EQ(p, partitioner->PartitionForKey(f.largestkey));
+    partitions.insert(p);
+  }
+  ASSERT_EQ(4, partitions.size());
+
+  // One data row per partition, each with one file and read amplification
+  // of one, and compaction output recorded for every partition.
+  ASSERT_TRUE(dbfull()->GetProperty(DB::Properties::kSstPartitionStats, &prop));
+  std::vector<std::string> rows = StringSplit(prop, '\n');
+  ASSERT_EQ(2 + 4, rows.size());
+  for (size_t p = 0; p < 4; p++) {
+    std::istringstream row(rows[2 + p]);
+    size_t partition;
+    uint64_t files, read_amp, comp_count;
+    double size_mb, read_gb, write_gb;
+    row >> partition >> files >> size_mb >> read_amp >> read_gb >> write_gb >>
+        comp_count;
+    ASSERT_EQ(p, partition);
+    ASSERT_EQ(1, files);
+    ASSERT_EQ(1, read_amp);
+    ASSERT_EQ(1, comp_count);
+  }
+
+  Options no_partitioner = CurrentOptions();
+  Reopen(no_partitioner);
+  ASSERT_FALSE(
+      dbfull()->GetProperty(DB::Properties::kSstPartitionStats, &prop));
+}
+
+TEST_F(DBCompactionTest, DynamicFileSizeAlignsToGrandparents) {
+  for (bool dynamic_file_size : {false, true}) {
+    Options options = CurrentOptions();
+    options.disable_auto_compactions = true;
+    options.compression = kNoCompression;
+    options.target_file_size_base = 25 << 10;
+    options.level_compaction_dynamic_file_size = dynamic_file_size;
+    DestroyAndReopen(options);
+
+    // L2 files of ten keys each: [0, 9], [10, 19], ...
+    Random rnd(301);
+    const int kNumKeys = 200;
+    for (int i = 0; i < kNumKeys; i += 10) {
+      for (int j = i; j < i + 10; j++) {
+        ASSERT_OK(Put(Key(j), RandomString(&rnd, 1000)));
+      }
+      ASSERT_OK(Flush());
+      MoveFilesToLevel(2);
+    }
+    ASSERT_EQ(kNumKeys / 10, NumTableFilesAtLevel(2));
+
+    // Two overlapping L0 files, so that the compaction is not a trivial move
+    for (int parity = 0; parity < 2; parity++) {
+      for (int i = parity; i < kNumKeys; i += 2) {
+        ASSERT_OK(Put(Key(i), RandomString(&rnd, 1000)));
+      }
+      ASSERT_OK(Flush());
+    }
+    ASSERT_OK(dbfull()->TEST_CompactRange(0, nullptr, nullptr));
+    ASSERT_GT(NumTableFilesAtLevel(1), 1);
+
+    ColumnFamilyMetaData cf_meta;
+    db_->GetColumnFamilyMetaData(&cf_meta);
+    bool aligned = true;
+    for (const auto& file : cf_meta.levels[1].files) {
+      const int smallest = std::stoi(file.smallestkey.substr(3));
+      const int largest = std::stoi(file.largestkey.substr(3));
+      if (smallest % 10 != 0 || largest % 10 != 9) {
+        aligned = false;
+      }
+    }
+    ASSERT_EQ(dynamic_file_size, aligned);
+  }
+}
+
+class CompactionInputLevelCollector : public EventListener {
+ public:
+  void OnCompactionBegin(DB* /*db*/, const CompactionJobInfo& ci) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    input_levels_.push_back(ci.base_input_level);
+  }
+
+  std::vector<int> GetAndClearInputLevels() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<int> result;
+    result.swap(input_levels_);
+    return result;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<int> input_levels_;
+};
+
+TEST_F(DBCompactionTest, ResumableManualCompaction) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.target_file_size_base = 32 << 10;
+  // Compact one L1 file at a time
+  options.max_compaction_bytes = 1;
+  auto collector = std::make_shared<CompactionInputLevelCollector>();
+  options.listeners.push_back(collector);
+  DestroyAndReopen(options);
+
+  // Keep L1 from being the bottommost level
+  ASSERT_OK(Put("a", "va"));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(2);
+  Random rnd(301);
+  for (int i = 0; i < 200; i++) {
+    ASSERT_OK(Put(Key(i), RandomString(&rnd, 1000)));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  int num_l1_files = NumTableFilesAtLevel(1);
+  ASSERT_GE(num_l1_files, 4);
+
+  std::string prop;
+  ASSERT_TRUE(
+      dbfull()->GetProperty(DB::Properties::kManualCompactionProgress, &prop));
+  ASSERT_EQ("(none)\n", prop);
+
+  // Interrupt the manual compaction after two chunks
+  int num_compactions = 0;
+  bool interrupt = true;
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::BackgroundCompaction:Finish", [&](void* /*arg*/) {
+        if (++num_compactions == 2 && interrupt) {
+          dbfull()->DisableManualCompaction();
+        }
+      });
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+  CompactRangeOptions cro;
+  cro.resumable = true;
+  ASSERT_TRUE(db_->CompactRange(cro, nullptr, nullptr).IsIncomplete());
+  ASSERT_EQ(num_l1_files - 2, NumTableFilesAtLevel(1));
+  interrupt = false;
+
+  // The progress survives a restart
+  Reopen(options);
+  ASSERT_TRUE(
+      dbfull()->GetProperty(DB::Properties::kManualCompactionProgress, &prop));
+  ASSERT_NE(std::string::npos,
+            prop.find("level 1 from " + Slice("key").ToString(true)));
+  ASSERT_NE(std::string::npos, prop.find("ETA:"));
+
+  // Without new data in the range, only the remaining L1 files are
+  // compacted, and the output of the earlier run is left alone
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  std::vector<std::string> l2_files;
+  for (const auto& f : files) {
+    if (f.level == 2) {
+      l2_files.push_back(f.name);
+    }
+  }
+  ASSERT_GE(l2_files.size(), 3);
+  collector->GetAndClearInputLevels();
+  num_compactions = 0;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  ASSERT_EQ(num_l1_files - 2, num_compactions);
+  ASSERT_EQ(std::vector<int>(num_l1_files - 2, 1),
+            collector->GetAndClearInputLevels());
+  ASSERT_EQ(0, NumTableFilesAtLevel(1));
+  files.clear();
+  db_->GetLiveFilesMetaData(&files);
+  for (const auto& name : l2_files) {
+    ASSERT_TRUE(std::any_of(files.begin(), files.end(),
+                            [&](const LiveFileMetaData& f) {
+                              return f.level == 2 && f.name == name;
+                            }))
+        << name;
+  }
+  ASSERT_TRUE(
+      dbfull()->GetProperty(DB::Properties::kManualCompactionProgress, &prop));
+  ASSERT_EQ("(none)\n", prop);
+
+  // Interrupt another resumable compaction, this time with data below L1
+  for (int i = 0; i < 200; i++) {
+    ASSERT_OK(Put(Key(i), RandomString(&rnd, 1000)));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  num_l1_files = NumTableFilesAtLevel(1);
+  ASSERT_GE(num_l1_files, 4);
+  num_compactions = 0;
+  interrupt = true;
+  ASSERT_TRUE(db_->CompactRange(cro, nullptr, nullptr).IsIncomplete());
+  ASSERT_EQ(num_l1_files - 2, NumTableFilesAtLevel(1));
+  interrupt = false;
+  Reopen(options);
+
+  // New data in the range behind the progress is compacted down to L1 and
+  // then past the resume key, instead of restarting from scratch
+  ASSERT_OK(Put(Key(0), "new"));
+  ASSERT_OK(Flush());
+  collector->GetAndClearInputLevels();
+  num_compactions = 0;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  ASSERT_EQ(num_l1_files, num_compactions);
+  std::vector<int> input_levels = collector->GetAndClearInputLevels();
+  ASSERT_EQ(1, std::count(input_levels.begin(), input_levels.end(), 0));
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  ASSERT_EQ(0, NumTableFilesAtLevel(1));
+  ASSERT_EQ("new", Get(Key(0)));
+  ASSERT_TRUE(
+      dbfull()->GetProperty(DB::Properties::kManualCompactionProgress, &prop));
+  ASSERT_EQ("(none)\n", prop);
+
+  // Once finished, the next resumable compaction starts over
+  Reopen(options);
+  ASSERT_TRUE(
+      dbfull()->GetProperty(DB::Properties::kManualCompactionProgress, &prop));
+  ASSERT_EQ("(none)\n", prop);
+  ASSERT_OK(Put(Key(1), "new"));
+  ASSERT_OK(Flush());
+  num_compactions = 0;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  ASSERT_EQ(2, num_compactions);
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  ASSERT_EQ(0, NumTableFilesAtLevel(1));
+  ASSERT_EQ("new", Get(Key(0)));
+  ASSERT_EQ("new", Get(Key(1)));
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+}
+
 void IngestOneKeyValue(DBImpl* db, const std::string& key,
                        const std::string& value, const Options& options) {
   ExternalSstFileInfo info;
@@ -208,6 +208,10 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
       bg_compaction_paused_(0),
       refitting_level_(false),
       opened_successfully_(false),
+      compaction_autoscale_limit_(1),
+      compaction_autoscale_subcompactions_(
+          immutable_db_options_.max_subcompactions),
+      compaction_autoscale_rate_limiter_bytes_(0),
       two_write_queues_(options.two_write_queues),
       manual_wal_flush_(options.manual_wal_flush),
       // last_sequencee_ is always maintained by the main queue that also writes
@@ -408,6 +412,10 @@ void DBImpl::CancelAllBackgroundWork(bool wait) {
     thread_persist_stats_->cancel();
     thread_persist_stats_.reset();
   }
+  if (thread_compaction_autoscale_ != nullptr) {
+    thread_compaction_autoscale_->cancel();
+    thread_compaction_autoscale_.reset();
+  }
   InstrumentedMutexLock l(&mutex_);
   if (!shutting_down_.load(std::memory_order_acquire) &&
       has_unpersisted_data_.load(std::memory_order_relaxed) &&
@@ -665,6 +673,16 @@ void DBImpl::StartTimedTasks() {
             static_cast<uint64_t>(stats_persist_period_sec) * kMicrosInSecond));
       }
     }
+    const unsigned int autoscale_period_sec =
+        immutable_db_options_.compaction_autoscale_period_sec;
+    if (autoscale_period_sec > 0 && !thread_compaction_autoscale_) {
+      // The first run waits for a full period of write latencies
+      const uint64_t autoscale_period_us =
+          static_cast<uint64_t>(autoscale_period_sec) * kMicrosInSecond;
+      thread_compaction_autoscale_.reset(new rocksdb::RepeatableThread(
+          [this]() { DBImpl::AutoscaleCompactions(); }, "cmp_as", env_,
+          autoscale_period_us, autoscale_period_us));
+    }
   }
 }
 
@@ -1165,6 +1183,7 @@ Status DBImpl::SyncWAL() {
   autovector<log::Writer*, 1> logs_to_sync;
   bool need_log_dir_sync;
   uint64_t current_log_number;
+  uint64_t sync_id;
 
   {
     InstrumentedMutexLock l(&mutex_);
@@ -1172,11 +1191,20 @@ Status DBImpl::SyncWAL() {
 
     // This SyncWAL() call only cares about logs up to this number.
     current_log_number = logfile_number_;
+    // A sync starting from now on covers the records written before this
+    // call if it covers current_log_number too, so if one completes while we
+    // wait, we do not need to sync again.
+    const uint64_t min_covering_sync = wal_syncs_started_ + 1;
 
     while (logs_.front().number <= current_log_number &&
            logs_.front().getting_synced) {
+      TEST_SYNC_POINT("DBImpl::SyncWAL:Wait");
       log_sync_cv_.Wait();
     }
+    if (wal_syncs_done_ >= min_covering_sync &&
+        wal_syncs_done_log_number_ >= current_log_number) {
+      return Status::OK();
+    }
     // First check that logs are safe to sync in background.
     for (auto it = logs_.begin();
          it != logs_.end() && it->number <= current_log_number; ++it) {
@@ -1197,6 +1225,7 @@ Status DBImpl::SyncWAL() {
     }
 
     need_log_dir_sync = !log_dir_synced_;
+    sync_id = ++wal_syncs_started_;
   }
 
   TEST_SYNC_POINT("DBWALTest::SyncWALNotWaitWrite:1");
@@ -1217,6 +1246,10 @@ Status DBImpl::SyncWAL() {
   {
     InstrumentedMutexLock l(&mutex_);
     MarkLogsSynced(current_log_number, need_log_dir_sync, status);
+    if (status.ok() && sync_id > wal_syncs_done_) {
+      wal_syncs_done_ = sync_id;
+      wal_syncs_done_log_number_ = current_log_number;
+    }
   }
   TEST_SYNC_POINT("DBImpl::SyncWAL:BeforeMarkLogsSynced:2");
 
@@ -1411,7 +1444,8 @@ InternalIterator* DBImpl::NewInternalIterator(const ReadOptions& read_options,
   MergeIteratorBuilder merge_iter_builder(
       &cfd->internal_comparator(), arena,
       !read_options.total_order_seek &&
-          super_version->mutable_cf_options.prefix_extractor != nullptr);
+          super_version->mutable_cf_options.prefix_extractor != nullptr,
+      read_options.use_loser_tree_merge);
   // Collect iterator for mutable mem
   merge_iter_builder.AddIterator(
       super_version->mem->NewIterator(read_options, arena));
@@ -1490,7 +1524,11 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
   }
 
   // Acquire SuperVersion
-  SuperVersion* sv = GetAndRefSuperVersion(cfd);
+  SuperVersion* sv = get_impl_options.pinned_super_version;
+  const bool sv_pinned = sv != nullptr;
+  if (!sv_pinned) {
+    sv = GetAndRefSuperVersion(cfd);
+  }
 
   TEST_SYNC_POINT("DBImpl::GetImpl:1");
   TEST_SYNC_POINT("DBImpl::GetImpl:2");
@@ -1509,10 +1547,15 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
     // version because otherwise a flush happening in between may compact away
     // data for the snapshot, so the reader would see neither data that was be
     // visible to the snapshot before compaction nor the newer data inserted
-    // afterwards.
-    snapshot = last_seq_same_as_publish_seq_
-                   ? versions_->LastSequence()
-                   : versions_->LastPublishedSequence();
+    // afterwards. A pinned sequence number was assigned the same way when its
+    // SuperVersion was pinned.
+    if (sv_pinned) {
+      snapshot = get_impl_options.pinned_seq;
+    } else {
+      snapshot = last_seq_same_as_publish_seq_
+                     ? versions_->LastSequence()
+                     : versions_->LastPublishedSequence();
+    }
     if (get_impl_options.callback) {
       // The unprep_seqs are not published for write unprepared, so it could be
       // that max_visible_seq is larger. Seek to the std::max of the two.
@@ -1585,7 +1628,9 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
       }
     }
     if (!done && !s.ok() && !s.IsMergeInProgress()) {
-      ReturnAndCleanupSuperVersion(cfd, sv);
+      if (!sv_pinned) {
+        ReturnAndCleanupSuperVersion(cfd, sv);
+      }
       return s;
     }
   }
@@ -1605,7 +1650,9 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
   {
     PERF_TIMER_GUARD(get_post_process_time);
 
-    ReturnAndCleanupSuperVersion(cfd, sv);
+    if (!sv_pinned) {
+      ReturnAndCleanupSuperVersion(cfd, sv);
+    }
 
     RecordTick(stats_, NUMBER_KEYS_READ);
     size_t size = 0;
@@ -2382,6 +2429,10 @@ Status DBImpl::DropColumnFamilyImpl(ColumnFamilyHandle* column_family) {
     bg_cv_.SignalAll();
   }
 
+  if (s.ok() && scan_cache_ != nullptr) {
+    scan_cache_->InvalidateColumnFamily(cfd->GetID());
+  }
+
   if (s.ok()) {
     // Note that here we erase the associated cf_info of the to-be-dropped
     // cfd before its ref-count goes to zero to avoid having to erase cf_info
@@ -2477,8 +2528,11 @@ ArenaWrappedDBIter* DBImpl::NewIteratorImpl(const ReadOptions& read_options,
                                             SequenceNumber snapshot,
                                             ReadCallback* read_callback,
                                             bool allow_blob,
-                                            bool allow_refresh) {
-  SuperVersion* sv = cfd->GetReferencedSuperVersion(&mutex_);
+                                            bool allow_refresh,
+                                            SuperVersion* pinned_sv) {
+  SuperVersion* sv = pinned_sv != nullptr
+                         ? pinned_sv->Ref()
+                         : cfd->GetReferencedSuperVersion(&mutex_);
 
   // Try to generate a DB iterator tree in continuous memory area to be
   // cache friendly. Here is an example of result:
@@ -2526,7 +2580,9 @@ ArenaWrappedDBIter* DBImpl::NewIteratorImpl(const ReadOptions& read_options,
       env_, read_options, *cfd->ioptions(), sv->mutable_cf_options, snapshot,
       sv->mutable_cf_options.max_sequential_skip_in_iterations,
       sv->version_number, read_callback, this, cfd, allow_blob,
-      ((read_options.snapshot != nullptr) ? false : allow_refresh));
+      ((read_options.snapshot != nullptr || pinned_sv != nullptr)
+           ? false
+           : allow_refresh));
 
   InternalIterator* internal_iter =
       NewInternalIterator(read_options, cfd, sv, db_iter->GetArena(),
@@ -2584,6 +2640,52 @@ Status DBImpl::NewIterators(
   return Status::OK();
 }
 
+Status DBImpl::Scan(const ReadOptions& read_options,
+                    ColumnFamilyHandle* column_family, const Slice& start,
+                    size_t limit, std::vector<std::string>* keys,
+                    std::vector<std::string>* values) {
+  auto cfh = reinterpret_cast<ColumnFamilyHandleImpl*>(column_family);
+  auto cfd = cfh->cfd();
+  // Only scans of the latest state in total order are cached
+  bool use_scan_cache =
+      scan_cache_ != nullptr && limit > 0 &&
+      read_options.snapshot == nullptr &&
+      read_options.iterate_lower_bound == nullptr &&
+      read_options.iterate_upper_bound == nullptr &&
+      read_options.read_tier == kReadAllTier && !read_options.tailing &&
+      !read_options.prefix_same_as_start &&
+      !read_options.ignore_range_deletions &&
+      read_options.iter_start_seqnum == 0 &&
+      read_options.timestamp == nullptr && !read_options.table_filter;
+  if (use_scan_cache && !read_options.total_order_seek) {
+    SuperVersion* sv = GetAndRefSuperVersion(cfd);
+    use_scan_cache = sv->mutable_cf_options.prefix_extractor == nullptr;
+    ReturnAndCleanupSuperVersion(cfd, sv);
+  }
+  if (!use_scan_cache) {
+    return DB::Scan(read_options, column_family, start, limit, keys, values);
+  }
+
+  const uint32_t cf_id = cfd->GetID();
+  const Comparator* ucmp = cfd->user_comparator();
+  if (scan_cache_->Lookup(cf_id, ucmp, start, limit, keys, values)) {
+    RecordTick(stats_, SCAN_CACHE_HIT);
+    return Status::OK();
+  }
+  RecordTick(stats_, SCAN_CACHE_MISS);
+  if (!read_options.fill_cache) {
+    return DB::Scan(read_options, column_family, start, limit, keys, values);
+  }
+  // Registered before the iterator gets its sequence number, so that a write
+  // published in between invalidates the results
+  ScanCache::Fill* fill = scan_cache_->BeginFill(cf_id, ucmp, start);
+  TEST_SYNC_POINT("DBImpl::Scan:AfterBeginFill");
+  Status s = DB::Scan(read_options, column_family, start, limit, keys, values);
+  scan_cache_->EndFill(fill, s.ok(), *keys, *values,
+                       /*complete=*/keys->size() < limit);
+  return s;
+}
+
 const Snapshot* DBImpl::GetSnapshot() { return GetSnapshotImpl(false); }
 
 #ifndef ROCKSDB_LITE
@@ -2592,32 +2694,17 @@ const Snapshot* DBImpl::GetSnapshotForWriteConflictBoundary() {
 }
 #endif  // ROCKSDB_LITE
 
-SnapshotImpl* DBImpl::GetSnapshotImpl(bool is_write_conflict_boundary,
-                                      bool lock) {
-  int64_t unix_time = 0;
-  env_->GetCurrentTime(&unix_time);  // Ignore error
-  SnapshotImpl* s = new SnapshotImpl;
-
-  if (lock) {
-    mutex_.Lock();
-  }
+SnapshotImpl* DBImpl::GetSnapshotImpl(bool is_write_conflict_boundary) {
   // returns null if the underlying memtable does not support snapshot.
   if (!is_snapshot_supported_) {
-    if (lock) {
-      mutex_.Unlock();
-    }
-    delete s;
     return nullptr;
   }
-  auto snapshot_seq = last_seq_same_as_publish_seq_
-                          ? versions_->LastSequence()
-                          : versions_->LastPublishedSequence();
-  SnapshotImpl* snapshot =
-      snapshots_.New(s, snapshot_seq, unix_time, is_write_conflict_boundary);
-  if (lock) {
-    mutex_.Unlock();
-  }
-  return snapshot;
+  int64_t unix_time = 0;
+  env_->GetCurrentTime(&unix_time);  // Ignore error
+  SnapshotImpl* s = new SnapshotImpl;
+  return snapshots_.New(
+      s, [this]() { return GetLastPublishedSequence(); }, unix_time,
+      is_write_conflict_boundary);
 }
 
 namespace {
@@ -2634,19 +2721,13 @@ bool CfdListContains(const CfdList& list, ColumnFamilyData* cfd) {
 
 void DBImpl::ReleaseSnapshot(const Snapshot* s) {
   const SnapshotImpl* casted_s = reinterpret_cast<const SnapshotImpl*>(s);
-  {
+  snapshots_.Delete(casted_s);
+  // Avoid to take the DB mutex and go through every column family by checking
+  // a global threshold first.
+  if (snapshots_.GetOldestHint(GetLastPublishedSequence()) >
+      bottommost_files_mark_threshold_.load(std::memory_order_acquire)) {
     InstrumentedMutexLock l(&mutex_);
-    snapshots_.Delete(casted_s);
-    uint64_t oldest_snapshot;
-    if (snapshots_.empty()) {
-      oldest_snapshot = last_seq_same_as_publish_seq_
-                            ? versions_->LastSequence()
-                            : versions_->LastPublishedSequence();
-    } else {
-      oldest_snapshot = snapshots_.oldest()->number_;
-    }
-    // Avoid to go through every column family by checking a global threshold
-    // first.
+    uint64_t oldest_snapshot = snapshots_.GetOldest(GetLastPublishedSequence());
     if (oldest_snapshot > bottommost_files_mark_threshold_) {
       CfdList cf_scheduled;
       for (auto* cfd : *versions_->GetColumnFamilySet()) {
@@ -2673,7 +2754,8 @@ void DBImpl::ReleaseSnapshot(const Snapshot* s) {
             new_bottommost_files_mark_threshold,
             cfd->current()->storage_info()->bottommost_files_mark_threshold());
       }
-      bottommost_files_mark_threshold_ = new_bottommost_files_mark_threshold;
+      bottommost_files_mark_threshold_.store(
+          new_bottommost_files_mark_threshold, std::memory_order_release);
     }
   }
   delete casted_s;
@@ -2931,6 +3013,88 @@ void DBImpl::ReturnAndCleanupSuperVersion(uint32_t column_family_id,
   ReturnAndCleanupSuperVersion(cfd, sv);
 }
 
+SequenceNumber DBImpl::PinSuperVersions(
+    const std::vector<ColumnFamilyHandle*>& column_families,
+    std::vector<SuperVersion*>* super_versions) {
+  autovector<MultiGetColumnFamilyData> cf_list;
+  for (auto cf : column_families) {
+    cf_list.emplace_back(cf, nullptr);
+  }
+  std::function<MultiGetColumnFamilyData*(
+      autovector<MultiGetColumnFamilyData>::iterator&)>
+      iter_deref_lambda =
+          [](autovector<MultiGetColumnFamilyData>::iterator& cf_iter) {
+            return &(*cf_iter);
+          };
+
+  SequenceNumber seq;
+  bool unref_only = MultiCFSnapshot<autovector<MultiGetColumnFamilyData>>(
+      ReadOptions(), nullptr, iter_deref_lambda, &cf_list, &seq);
+  super_versions->clear();
+  super_versions->reserve(cf_list.size());
+  for (auto& cf_data : cf_list) {
+    if (unref_only) {
+      super_versions->push_back(cf_data.super_version);
+    } else {
+      // Thread local SuperVersions have to be given back before the thread
+      // reads the column family again, so keep a reference of our own.
+      super_versions->push_back(cf_data.super_version->Ref());
+      ReturnAndCleanupSuperVersion(cf_data.cfd, cf_data.super_version);
+    }
+  }
+  return seq;
+}
+
+void DBImpl::UnpinSuperVersions(std::vector<SuperVersion*>* super_versions) {
+  autovector<SuperVersion*> to_delete;
+  for (auto sv : *super_versions) {
+    if (sv->Unref()) {
+      to_delete.push_back(sv);
+    }
+    RecordTick(stats_, NUMBER_SUPERVERSION_RELEASES);
+  }
+  super_versions->clear();
+  if (to_delete.empty()) {
+    return;
+  }
+
+  const bool background_purge =
+      immutable_db_options_.avoid_unnecessary_blocking_io;
+  // Job id == 0 means that this is not our background process, but rather
+  // user thread
+  JobContext job_context(0);
+  mutex_.Lock();
+  for (auto sv : to_delete) {
+    sv->Cleanup();
+  }
+  FindObsoleteFiles(&job_context, false, true);
+  if (background_purge) {
+    ScheduleBgLogWriterClose(&job_context);
+  }
+  mutex_.Unlock();
+
+  for (auto sv : to_delete) {
+    delete sv;
+    RecordTick(stats_, NUMBER_SUPERVERSION_CLEANUPS);
+  }
+  if (job_context.HaveSomethingToDelete()) {
+    if (background_purge) {
+      PurgeObsoleteFiles(job_context, true /* schedule only */);
+      mutex_.Lock();
+      SchedulePurge();
+      mutex_.Unlock();
+    } else {
+      PurgeObsoleteFiles(job_context);
+    }
+  }
+  job_context.Clean();
+}
+
+void DBImpl::EnableWriteSeqTable(size_t num_buckets) {
+  write_seq_table_.reset(
+      new WriteSeqTable(num_buckets, versions_->LastSequence()));
+}
+
 // REQUIRED: this function should only be called on the write thread or if the
 // mutex is held.
 ColumnFamilyHandle* DBImpl::GetColumnFamilyHandle(uint32_t column_family_id) {
@@ -3013,6 +3177,113 @@ Status DBImpl::GetApproximateSizes(const SizeApproximationOptions& options,
   return Status::OK();
 }
 
+Status DBImpl::GetRangePartitions(ColumnFamilyHandle* column_family,
+                                  const Slice* begin, const Slice* end,
+                                  size_t num_partitions,
+                                  std::vector<std::string>* split_keys) {
+  split_keys->clear();
+  if (num_partitions == 0) {
+    return Status::InvalidArgument("num_partitions must be positive");
+  }
+  auto cfh = reinterpret_cast<ColumnFamilyHandleImpl*>(column_family);
+  auto cfd = cfh->cfd();
+  const Comparator* ucmp = cfd->user_comparator();
+  if (begin != nullptr && end != nullptr && ucmp->Compare(*begin, *end) >= 0) {
+    return Status::InvalidArgument("begin must be before end");
+  }
+  if (num_partitions == 1) {
+    return Status::OK();
+  }
+
+  InternalKey begin_key, end_key;
+  if (begin != nullptr) {
+    begin_key.SetMinPossibleForUserKey(*begin);
+  }
+  if (end != nullptr) {
+    end_key.SetMaxPossibleForUserKey(*end);
+  }
+  // Sample each file finely enough to split it alone into all partitions
+  const size_t max_anchors_per_file = std::max<size_t>(128, num_partitions);
+
+  SuperVersion* sv = GetAndRefSuperVersion(cfd);
+  const VersionStorageInfo* vstorage = sv->current->storage_info();
+  std::vector<TableReader::Anchor> anchors;
+  Status s;
+  for (int level = 0; s.ok() && level < vstorage->num_non_empty_levels();
+       level++) {
+    std::vector<FileMetaData*> files;
+    vstorage->GetOverlappingInputs(level, begin ? &begin_key : nullptr,
+                                   end ? &end_key : nullptr, &files,
+                                   -1 /* hint_index */, nullptr /* file_index */,
+                                   false /* expand_range */);
+    for (FileMetaData* f : files) {
+      std::vector<TableReader::Anchor> file_anchors;
+      s = cfd->table_cache()->ApproximateKeyAnchors(
+          ReadOptions(), f->fd, max_anchors_per_file,
+          cfd->internal_comparator(), &file_anchors,
+          sv->mutable_cf_options.prefix_extractor.get());
+      if (s.IsNotSupported()) {
+        file_anchors.clear();
+        file_anchors.emplace_back(f->largest.user_key(), f->fd.GetFileSize());
+        s = Status::OK();
+      }
+      if (!s.ok()) {
+        break;
+      }
+      // Keep the anchors of the data in range: those after *begin, up to
+      // the first one at or after *end.
+      for (auto& anchor : file_anchors) {
+        if (begin != nullptr && ucmp->Compare(anchor.user_key, *begin) <= 0) {
+          continue;
+        }
+        const bool past_end =
+            end != nullptr && ucmp->Compare(anchor.user_key, *end) >= 0;
+        anchors.push_back(std::move(anchor));
+        if (past_end) {
+          break;
+        }
+      }
+    }
+  }
+  ReturnAndCleanupSuperVersion(cfd, sv);
+  if (!s.ok()) {
+    return s;
+  }
+
+  std::sort(anchors.begin(), anchors.end(),
+            [ucmp](const TableReader::Anchor& a, const TableReader::Anchor& b) {
+              return ucmp->Compare(a.user_key, b.user_key) < 0;
+            });
+  uint64_t total_size = 0;
+  for (const auto& anchor : anchors) {
+    total_size += anchor.range_size;
+  }
+  // Split after the anchor reaching each multiple of the partition size
+  const double partition_size =
+      static_cast<double>(total_size) / num_partitions;
+  uint64_t cumulative_size = 0;
+  size_t next_partition = 1;
+  for (const auto& anchor : anchors) {
+    if (next_partition == num_partitions ||
+        (end != nullptr && ucmp->Compare(anchor.user_key, *end) >= 0)) {
+      break;
+    }
+    cumulative_size += anchor.range_size;
+    if (cumulative_size < partition_size * next_partition) {
+      continue;
+    }
+    if (split_keys->empty() ||
+        ucmp->Compare(anchor.user_key, split_keys->back()) > 0) {
+      split_keys->push_back(anchor.user_key);
+    }
+    while (next_partition < num_partitions &&
+           cumulative_size >= partition_size * next_partition) {
+      next_partition++;
+    }
+  }
+  return Status::OK();
+}
+
 std::list<uint64_t>::iterator
 DBImpl::CaptureCurrentFileNumberInPendingOutputs() {
   // We need to remember the iterator of our insert, because after the
@@ -3128,6 +3399,11 @@ Status DBImpl::DeleteFile(std::string name) {
       InstallSuperVersionAndScheduleWork(cfd,
                                          &job_context.superversion_contexts[0],
                                          *cfd->GetLatestMutableCFOptions());
+      if (scan_cache_ != nullptr) {
+        scan_cache_->InvalidateRange(cfd->GetID(),
+                                     metadata->smallest.user_key(),
+                                     metadata->largest.user_key());
+      }
     }
     FindObsoleteFiles(&job_context, false);
   }  // lock released here
@@ -3216,6 +3492,11 @@ Status DBImpl::DeleteFilesInRanges(ColumnFamilyHandle* column_family,
     }
     for (auto* deleted_file : deleted_files) {
       deleted_file->being_compacted = false;
+      if (status.ok() && scan_cache_ != nullptr) {
+        scan_cache_->InvalidateRange(cfd->GetID(),
+                                     deleted_file->smallest.user_key(),
+                                     deleted_file->largest.user_key());
+      }
     }
     input_version->Unref();
     FindObsoleteFiles(&job_context, false);
@@ -3370,6 +3651,137 @@ Status DB::DestroyColumnFamilyHandle(ColumnFamilyHandle* column_family) {
 
 DB::~DB() {}
 
+namespace {
+// Shared by the calling thread and the pool jobs of DB::ParallelScan()
+struct ParallelScanState {
+  ParallelScanState(const std::function<void(size_t)>& _scan_partition,
+                    size_t _num_scans)
+      : scan_partition(_scan_partition),
+        num_scans(_num_scans),
+        next_partition(0),
+        cv(&mu),
+        pending_jobs(0) {}
+
+  // Scans sub-ranges until none is left
+  void RunScans() {
+    size_t partition;
+    while ((partition = next_partition.fetch_add(1)) < num_scans) {
+      scan_partition(partition);
+    }
+  }
+
+  static void BGWork(void* arg) {
+    ParallelScanState* state = reinterpret_cast<ParallelScanState*>(arg);
+    state->RunScans();
+    MutexLock l(&state->mu);
+    if (--state->pending_jobs == 0) {
+      state->cv.SignalAll();
+    }
+  }
+
+  const std::function<void(size_t)>& scan_partition;
+  const size_t num_scans;
+  std::atomic<size_t> next_partition;
+  port::Mutex mu;
+  port::CondVar cv;
+  // Jobs scheduled and not yet finished or unscheduled, guarded by mu
+  size_t pending_jobs;
+};
+}  // namespace
+
+Status DB::ParallelScan(
+    const ReadOptions& options, ColumnFamilyHandle* column_family,
+    const Slice* begin, const Slice* end, size_t num_partitions,
+    const std::function<Status(size_t partition, Iterator* iter)>& scan_fn) {
+  std::vector<std::string> split_keys;
+  Status s = GetRangePartitions(column_family, begin, end, num_partitions,
+                                &split_keys);
+  if (!s.ok()) {
+    return s;
+  }
+
+  ReadOptions scan_options = options;
+  std::unique_ptr<ManagedSnapshot> snapshot;
+  if (scan_options.snapshot == nullptr) {
+    snapshot.reset(new ManagedSnapshot(this));
+    scan_options.snapshot = snapshot->snapshot();
+  }
+  const size_t num_scans = split_keys.size() + 1;
+  std::vector<Status> statuses(num_scans);
+  std::function<void(size_t)> scan_partition = [&](size_t partition) {
+    ReadOptions ro = scan_options;
+    Slice lower_bound, upper_bound;
+    ro.iterate_lower_bound = nullptr;
+    ro.iterate_upper_bound = nullptr;
+    if (partition > 0) {
+      lower_bound = split_keys[partition - 1];
+      ro.iterate_lower_bound = &lower_bound;
+    } else if (begin != nullptr) {
+      lower_bound = *begin;
+      ro.iterate_lower_bound = &lower_bound;
+    }
+    if (partition + 1 < num_scans) {
+      upper_bound = split_keys[partition];
+      ro.iterate_upper_bound = &upper_bound;
+    } else if (end != nullptr) {
+      upper_bound = *end;
+      ro.iterate_upper_bound = &upper_bound;
+    }
+    std::unique_ptr<Iterator> iter(NewIterator(ro, column_family));
+    statuses[partition] = scan_fn(partition, iter.get());
+    if (statuses[partition].ok()) {
+      statuses[partition] = iter->status();
+    }
+  };
+
+  // One job per extra sub-range is scheduled in the USER pool. The calling
+  // thread and the jobs take sub-ranges from a shared counter, so the scan
+  // completes even when the pool has no free thread. Jobs still queued once
+  // every sub-range is taken are unscheduled.
+  ParallelScanState state(scan_partition, num_scans);
+  Env* env = GetEnv();
+  state.pending_jobs = num_scans - 1;
+  for (size_t i = 1; i < num_scans; i++) {
+    env->Schedule(&ParallelScanState::BGWork, &state, Env::Priority::USER,
+                  &state);
+  }
+  state.RunScans();
+  int unscheduled = env->UnSchedule(&state, Env::Priority::USER);
+  {
+    MutexLock l(&state.mu);
+    state.pending_jobs -= static_cast<size_t>(unscheduled);
+    while (state.pending_jobs > 0) {
+      state.cv.Wait();
+    }
+  }
+  for (const auto& status : statuses) {
+    if (!status.ok()) {
+      return status;
+    }
+  }
+  return Status::OK();
+}
+
+Status DB::Scan(const ReadOptions& options, ColumnFamilyHandle* column_family,
+                const Slice& start, size_t limit,
+                std::vector<std::string>* keys,
+                std::vector<std::string>* values) {
+  keys->clear();
+  values->clear();
+  if (limit == 0) {
+    return Status::OK();
+  }
+  std::unique_ptr<Iterator> iter(NewIterator(options, column_family));
+  for (iter->Seek(start); iter->Valid(); iter->Next()) {
+    keys->push_back(iter->key().ToString());
+    values->push_back(iter->value().ToString());
+    if (keys->size() == limit) {
+      break;
+    }
+  }
+  return iter->status();
+}
+
 Status DBImpl::Close() {
   if (!closed_) {
     {
@@ -4084,6 +4496,13 @@ Status DBImpl::IngestExternalFiles(
         if (!cfd->IsDropped()) {
           InstallSuperVersionAndScheduleWork(cfd, &sv_ctxs[i],
                                              *cfd->GetLatestMutableCFOptions());
+          if (scan_cache_ != nullptr) {
+            for (const auto& file : ingestion_jobs[i].files_to_ingest()) {
+              scan_cache_->InvalidateRange(
+                  cfd->GetID(), file.smallest_internal_key.user_key(),
+                  file.largest_internal_key.user_key());
+            }
+          }
 #ifndef NDEBUG
           if (0 == i && num_cfs > 1) {
             TEST_SYNC_POINT(
@@ -35,14 +35,17 @@
 #include "db/pre_release_callback.h"
 #include "db/range_del_aggregator.h"
 #include "db/read_callback.h"
+#include "db/scan_cache.h"
 #include "db/snapshot_checker.h"
 #include "db/snapshot_impl.h"
 #include "db/trim_history_scheduler.h"
 #include "db/version_edit.h"
 #include "db/wal_manager.h"
 #include "db/write_controller.h"
+#include "db/write_seq_table.h"
 #include "db/write_thread.h"
 #include "logging/event_logger.h"
+#include "monitoring/histogram.h"
 #include "monitoring/instrumented_mutex.h"
 #include "options/db_options.h"
 #include "port/port.h"
@@ -240,6 +243,11 @@ class DBImpl : public DB {
       const ReadOptions& options,
       const std::vector<ColumnFamilyHandle*>& column_families,
       std::vector<Iterator*>* iterators) override;
+  using DB::Scan;
+  virtual Status Scan(const ReadOptions& options,
+                      ColumnFamilyHandle* column_family, const Slice& start,
+                      size_t limit, std::vector<std::string>* keys,
+                      std::vector<std::string>* values) override;
 
   virtual const Snapshot* GetSnapshot() override;
   virtual void ReleaseSnapshot(const Snapshot* snapshot) override;
@@ -261,6 +269,9 @@ class DBImpl : public DB {
                                      ColumnFamilyHandle* column_family,
                                      const Range* range, int n,
                                      uint64_t* sizes) override;
+  virtual Status GetRangePartitions(
+      ColumnFamilyHandle* column_family, const Slice* begin, const Slice* end,
+      size_t num_partitions, std::vector<std::string>* split_keys) override;
   using DB::GetApproximateMemTableStats;
   virtual void GetApproximateMemTableStats(ColumnFamilyHandle* column_family,
                                            const Range& range,
@@ -444,6 +455,11 @@ class DBImpl : public DB {
     PinnableSlice* merge_operands = nullptr;
     GetMergeOperandsOptions* get_merge_operands_options = nullptr;
     int* number_of_operands = nullptr;
+    // If not null, the key is read from this SuperVersion of the column
+    // family, which the caller keeps referenced, at pinned_seq instead of the
+    // last published sequence number. Requires options.snapshot to be null.
+    SuperVersion* pinned_super_version = nullptr;
+    SequenceNumber pinned_seq = kMaxSequenceNumber;
   };
 
   // Function that Get and KeyMayExist call with no_io true or false
@@ -461,7 +477,8 @@ class DBImpl : public DB {
                                       SequenceNumber snapshot,
                                       ReadCallback* read_callback,
                                       bool allow_blob = false,
-                                      bool allow_refresh = true);
+                                      bool allow_refresh = true,
+                                      SuperVersion* pinned_sv = nullptr);
 
   virtual SequenceNumber GetLastPublishedSequence() const {
     if (last_seq_same_as_publish_seq_) {
@@ -549,13 +566,17 @@ class DBImpl : public DB {
 
   // max_file_num_to_ignore allows bottom level compaction to filter out newly
   // compacted SST files. Setting max_file_num_to_ignore to kMaxUint64 will
-  // disable the filtering
-  Status RunManualCompaction(ColumnFamilyData* cfd, int input_level,
-                             int output_level,
-                             const CompactRangeOptions& compact_range_options,
-                             const Slice* begin, const Slice* end,
-                             bool exclusive, bool disallow_trivial_move,
-                             uint64_t max_file_num_to_ignore);
+  // disable the filtering.
+  // If progress is not nullptr, each compaction run records how far the
+  // manual compaction of [progress->begin, progress->end] has got in the
+  // MANIFEST, and automatic compactions are given a chance to run between
+  // compactions.
+  Status RunManualCompaction(
+      ColumnFamilyData* cfd, int input_level, int output_level,
+      const CompactRangeOptions& compact_range_options, const Slice* begin,
+      const Slice* end, bool exclusive, bool disallow_trivial_move,
+      uint64_t max_file_num_to_ignore,
+      const ManualCompactionProgress* progress = nullptr);
 
   // Return an internal iterator over the current state of the database.
   // The keys of this iterator are internal keys (see format.h).
@@ -623,7 +644,6 @@ class DBImpl : public DB {
   void LoadSnapshots(std::vector<SequenceNumber>* snap_vector,
                      SequenceNumber* oldest_write_conflict_snapshot,
                      const SequenceNumber& max_seq) const {
-    InstrumentedMutexLock l(mutex());
     snapshots().GetAll(snap_vector, oldest_write_conflict_snapshot, max_seq);
   }
 
@@ -651,6 +671,30 @@ class DBImpl : public DB {
   // Un-reference the super version and clean it up if it is the last reference.
   void CleanupSuperVersion(SuperVersion* sv);
 
+  // References the current SuperVersions of column_families into
+  // *super_versions, and returns a sequence number that all of them contain
+  // the data of. No snapshot is taken. As with MultiGet() across column
+  // families, the DB mutex is only acquired if memtables keep being switched
+  // during the attempts. Call UnpinSuperVersions() when they are no longer
+  // needed.
+  SequenceNumber PinSuperVersions(
+      const std::vector<ColumnFamilyHandle*>& column_families,
+      std::vector<SuperVersion*>* super_versions);
+
+  // Un-references the SuperVersions of PinSuperVersions() and clears
+  // *super_versions. As when an iterator is deleted, the files that only
+  // they kept alive are deleted, in the background if
+  // avoid_unnecessary_blocking_io is set.
+  void UnpinSuperVersions(std::vector<SuperVersion*>* super_versions);
+
+  // Starts recording the sequence number of the latest write to each of
+  // num_buckets hash buckets of keys in a WriteSeqTable.
+  // REQUIRED: no other thread uses the DB yet.
+  void EnableWriteSeqTable(size_t num_buckets);
+
+  // nullptr unless EnableWriteSeqTable() was called
+  WriteSeqTable* write_seq_table() const { return write_seq_table_.get(); }
+
   // Un-reference the super version and return it to thread local cache if
   // needed. If it is the last reference of the super version. Clean it up
   // after un-referencing it.
@@ -937,6 +981,8 @@ class DBImpl : public DB {
   void TEST_WaitForDumpStatsRun(std::function<void()> callback) const;
   void TEST_WaitForPersistStatsRun(std::function<void()> callback) const;
   bool TEST_IsPersistentStatsEnabled() const;
+  // Runs AutoscaleCompactions() once and returns the resulting limit
+  int TEST_AutoscaleCompactions();
   size_t TEST_EstimateInMemoryStatsHistorySize() const;
 #endif  // NDEBUG
 
@@ -982,6 +1028,14 @@ class DBImpl : public DB {
 
   std::unique_ptr<ColumnFamilyMemTablesImpl> column_family_memtables_;
 
+  // Caches the results of DB::Scan(), nullptr unless
+  // DBOptions::scan_cache_size is set
+  std::unique_ptr<ScanCache> scan_cache_;
+
+  // Latest write sequence numbers of hash buckets of keys, nullptr unless
+  // EnableWriteSeqTable() was called
+  std::unique_ptr<WriteSeqTable> write_seq_table_;
+
   // Increase the sequence number after writing each batch, whether memtable is
   // disabled for that or not. Otherwise the sequence number is increased after
   // writing each key into memtable. This implies that when disable_memtable is
@@ -1252,6 +1306,8 @@ class DBImpl : public DB {
     InternalKey* manual_end;     // how far we are compacting
     InternalKey tmp_storage;     // Used to keep track of compaction progress
     InternalKey tmp_storage1;    // Used to keep track of compaction progress
+    // nullptr unless the progress is to be persisted (resumable compaction)
+    const ManualCompactionProgress* progress;
   };
   struct PrepickedCompaction {
     // background compaction takes ownership of `compaction`.
@@ -1558,6 +1614,10 @@ class DBImpl : public DB {
   // dump rocksdb.stats to LOG
   void DumpStats();
 
+  // Adjust the number of compactions allowed to run at the same time to the
+  // current compaction debt and foreground write latency
+  void AutoscaleCompactions();
+
   // Return the minimum empty level that could hold the total data in the
   // input level. Return the input level, if such level could not be found.
   int FindMinimumEmptyLevelFitting(ColumnFamilyData* cfd,
@@ -1569,6 +1629,12 @@ class DBImpl : public DB {
   // hold the data set.
   Status ReFitLevel(ColumnFamilyData* cfd, int level, int target_level = -1);
 
+  // Returns true if the current version of cfd has files in level that
+  // overlap the user key range [begin, end].
+  // REQUIRES: mutex_ not held
+  bool LevelOverlapsRange(ColumnFamilyData* cfd, int level, const Slice* begin,
+                          const Slice* end);
+
   // helper functions for adding and removing from flush & compaction queues
   void AddToCompactionQueue(ColumnFamilyData* cfd);
   ColumnFamilyData* PopFirstFromCompactionQueue();
@@ -1581,8 +1647,7 @@ class DBImpl : public DB {
   // helper function to call after some of the logs_ were synced
   void MarkLogsSynced(uint64_t up_to, bool synced_dir, const Status& status);
 
-  SnapshotImpl* GetSnapshotImpl(bool is_write_conflict_boundary,
-                                bool lock = true);
+  SnapshotImpl* GetSnapshotImpl(bool is_write_conflict_boundary);
 
   uint64_t GetMaxTotalWalSize() const;
 
@@ -1603,6 +1668,13 @@ class DBImpl : public DB {
       ColumnFamilyData* cfd, SuperVersionContext* sv_context,
       const MutableCFOptions& mutable_cf_options);
 
+  // Drops the scan cache entries covering keys written by the group. Called
+  // once the group's last sequence is published.
+  void InvalidateScanCache(const WriteThread::WriteGroup& write_group);
+  // Drops the scan cache entries covering the key range of the compaction.
+  // Called once its result is installed.
+  void InvalidateScanCache(const Compaction& c);
+
   bool GetIntPropertyInternal(ColumnFamilyData* cfd,
                               const DBPropertyInfo& property_info,
                               bool is_locked, uint64_t* value);
@@ -1796,6 +1868,13 @@ class DBImpl : public DB {
   std::deque<LogWriterNumber> logs_;
   // Signaled when getting_synced becomes false for some of the logs_.
   InstrumentedCondVar log_sync_cv_;
+  // Number of syncs started by SyncWAL(), and id of the last one that
+  // succeeded with the highest log number it covered. SyncWAL() returns
+  // without syncing when a sync started after it was called succeeds while
+  // it waits and covers the logs it cares about. Protected by mutex_.
+  uint64_t wal_syncs_started_ = 0;
+  uint64_t wal_syncs_done_ = 0;
+  uint64_t wal_syncs_done_log_number_ = 0;
   // This is the app-level state that is written to the WAL but will be used
   // only during recovery. Using this feature enables not writing the state to
   // memtable on normal writes and hence improving the throughput. Each new
@@ -1811,7 +1890,7 @@ class DBImpl : public DB {
   // threads. Protected by db mutex.
   autovector<log::Writer*> logs_to_free_;
 
-  bool is_snapshot_supported_;
+  std::atomic<bool> is_snapshot_supported_;
 
   std::map<uint64_t, std::map<std::string, uint64_t>> stats_history_;
 
@@ -1989,8 +2068,10 @@ class DBImpl : public DB {
   bool opened_successfully_;
 
   // The min threshold to triggere bottommost compaction for removing
-  // garbages, among all column families.
-  SequenceNumber bottommost_files_mark_threshold_ = kMaxSequenceNumber;
+  // garbages, among all column families. Updated under mutex_, but read
+  // without it by ReleaseSnapshot().
+  std::atomic<SequenceNumber> bottommost_files_mark_threshold_{
+      kMaxSequenceNumber};
 
   LogsWithPrepTracker logs_with_prep_tracker_;
 
@@ -2010,6 +2091,21 @@ class DBImpl : public DB {
   // REQUIRES: mutex locked
   std::unique_ptr<rocksdb::RepeatableThread> thread_persist_stats_;
 
+  // handle for scheduling compaction autoscaling at fixed intervals
+  std::unique_ptr<rocksdb::RepeatableThread> thread_compaction_autoscale_;
+
+  // Number of compactions allowed to run at the same time, as last set by
+  // AutoscaleCompactions(), and max_subcompactions scaled accordingly.
+  // REQUIRES: mutex locked
+  int compaction_autoscale_limit_;
+  uint32_t compaction_autoscale_subcompactions_;
+  // Bytes through the rate limiter as of the last AutoscaleCompactions()
+  int64_t compaction_autoscale_rate_limiter_bytes_;
+
+  // Latency of DB::Write() since the last AutoscaleCompactions(), recorded
+  // if compaction_autoscale_write_latency_micros is set
+  HistogramImpl write_latency_hist_;
+
   // When set, we use a separate queue for writes that dont write to memtable.
   // In 2PC these are the writes at Prepare phase.
   const bool two_write_queues_;
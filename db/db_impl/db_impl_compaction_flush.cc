@@ -9,6 +9,7 @@
 #include "db/db_impl/db_impl.h"
 
 #include <cinttypes>
+#include <cmath>
 
 #include "db/builder.h"
 #include "db/error_handler.h"
@@ -641,6 +642,18 @@ void DBImpl::NotifyOnFlushCompleted(
 #endif  // ROCKSDB_LITE
 }
 
+namespace {
+// How long an exclusive resumable manual compaction steps aside between two
+// chunks for the automatic compactions that are due
+const uint64_t kMaxManualCompactionYieldMicros = 10 * 1000 * 1000;
+}  // namespace
+
+bool DBImpl::LevelOverlapsRange(ColumnFamilyData* cfd, int level,
+                                const Slice* begin, const Slice* end) {
+  InstrumentedMutexLock l(&mutex_);
+  return cfd->current()->storage_info()->OverlapInLevel(level, begin, end);
+}
+
 Status DBImpl::CompactRange(const CompactRangeOptions& options,
                             ColumnFamilyHandle* column_family,
                             const Slice* begin, const Slice* end) {
@@ -702,6 +715,37 @@ Status DBImpl::CompactRange(const CompactRangeOptions& options,
     next_file_number = versions_->current_next_file_number();
   }
 
+  // A resumable compaction continues from where the last resumable
+  // compaction of the same range stopped, if it did not finish. Data added to
+  // the range behind that position since is compacted down to it first.
+  ManualCompactionProgress progress;
+  const ManualCompactionProgress* resumable_progress = nullptr;
+  if (options.resumable &&
+      cfd->ioptions()->compaction_style == kCompactionStyleLevel) {
+    InstrumentedMutexLock l(&mutex_);
+    const ManualCompactionProgress& persisted =
+        cfd->manual_compaction_progress();
+    if (persisted.MatchesRange(begin, end)) {
+      progress = persisted;
+      ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                     "[%s] Resuming manual compaction of %s",
+                     cfd->GetName().c_str(),
+                     progress.DebugString(true).c_str());
+    } else {
+      progress.active = true;
+      progress.has_begin = begin != nullptr;
+      progress.has_end = end != nullptr;
+      if (begin != nullptr) {
+        progress.begin = begin->ToString();
+      }
+      if (end != nullptr) {
+        progress.end = end->ToString();
+      }
+    }
+    cfd->ResetManualCompactionStats(env_->NowMicros());
+    resumable_progress = &progress;
+  }
+
   int final_output_level = 0;
 
   if (cfd->ioptions()->compaction_style == kCompactionStyleUniversal &&
@@ -751,8 +795,40 @@ Status DBImpl::CompactRange(const CompactRangeOptions& options,
           output_level = ColumnFamilyData::kCompactToBaseLevel;
         }
       }
-      s = RunManualCompaction(cfd, level, output_level, options, begin, end,
-                              exclusive, false, max_file_num_to_ignore);
+      // The bottommost level is compacted into itself, so whatever an
+      // earlier run left in it is already compacted
+      const bool bottommost = level == max_level_with_files && level > 0;
+      if (resumable_progress != nullptr && level < progress.level) {
+        // An earlier run compacted this level, so the files in the range are
+        // data added since. They are pushed down without recording progress,
+        // and end up in progress.level.
+        if (!bottommost && LevelOverlapsRange(cfd, level, begin, end)) {
+          s = RunManualCompaction(cfd, level, output_level, options, begin,
+                                  end, exclusive, false,
+                                  max_file_num_to_ignore);
+        }
+      } else {
+        const Slice* level_begin = begin;
+        Slice resume_key;
+        if (resumable_progress != nullptr && level == progress.level &&
+            progress.has_resume_key) {
+          // Keys before the resume key were compacted by an earlier run, so
+          // the files holding them now are new data
+          resume_key = progress.resume_key;
+          level_begin = &resume_key;
+          if (!bottommost &&
+              LevelOverlapsRange(cfd, level, begin, &resume_key)) {
+            s = RunManualCompaction(cfd, level, output_level, options, begin,
+                                    &resume_key, exclusive, false,
+                                    max_file_num_to_ignore);
+          }
+        }
+        if (s.ok()) {
+          s = RunManualCompaction(cfd, level, output_level, options,
+                                  level_begin, end, exclusive, false,
+                                  max_file_num_to_ignore, resumable_progress);
+        }
+      }
       if (!s.ok()) {
         break;
       }
@@ -765,6 +841,20 @@ Status DBImpl::CompactRange(const CompactRangeOptions& options,
       TEST_SYNC_POINT("DBImpl::RunManualCompaction()::2");
     }
   }
+  if (s.ok() && resumable_progress != nullptr) {
+    // The whole range has been compacted, forget the progress
+    SuperVersionContext sv_context(/* create_superversion */ true);
+    InstrumentedMutexLock l(&mutex_);
+    VersionEdit edit;
+    edit.SetColumnFamily(cfd->GetID());
+    edit.SetManualCompactionProgress(ManualCompactionProgress());
+    const MutableCFOptions mutable_cf_options =
+        *cfd->GetLatestMutableCFOptions();
+    s = versions_->LogAndApply(cfd, mutable_cf_options, &edit, &mutex_,
+                               directories_.GetDbDir());
+    InstallSuperVersionAndScheduleWork(cfd, &sv_context, mutable_cf_options);
+    sv_context.Clean();
+  }
   if (!s.ok()) {
     LogFlush(immutable_db_options_.info_log);
     return s;
@@ -999,6 +1089,7 @@ Status DBImpl::CompactFilesImpl(
     InstallSuperVersionAndScheduleWork(c->column_family_data(),
                                        &job_context->superversion_contexts[0],
                                        *c->mutable_cf_options());
+    InvalidateScanCache(*c);
   }
   c->ReleaseCompactionFiles(s);
 #ifndef ROCKSDB_LITE
@@ -1366,9 +1457,10 @@ Status DBImpl::RunManualCompaction(
     ColumnFamilyData* cfd, int input_level, int output_level,
     const CompactRangeOptions& compact_range_options, const Slice* begin,
     const Slice* end, bool exclusive, bool disallow_trivial_move,
-    uint64_t max_file_num_to_ignore) {
+    uint64_t max_file_num_to_ignore, const ManualCompactionProgress* progress) {
   assert(input_level == ColumnFamilyData::kCompactAllLevels ||
          input_level >= 0);
+  assert(progress == nullptr || input_level >= 0);
 
   InternalKey begin_storage, end_storage;
   CompactionArg* ca;
@@ -1385,6 +1477,7 @@ Status DBImpl::RunManualCompaction(
   manual.incomplete = false;
   manual.exclusive = exclusive;
   manual.disallow_trivial_move = disallow_trivial_move;
+  manual.progress = progress;
   // For universal compaction, we enforce every manual compaction to compact
   // all files.
   if (begin == nullptr ||
@@ -1467,6 +1560,30 @@ Status DBImpl::RunManualCompaction(
         assert(!manual.in_progress);
         scheduled = false;
         manual.incomplete = false;
+        if (manual.progress != nullptr && exclusive &&
+            cfd->NeedsCompaction()) {
+          // Step aside until the automatic compactions that are due have
+          // run, or for at most kMaxManualCompactionYieldMicros, before the
+          // next chunk of the range is compacted. The progress so far has
+          // already been persisted.
+          TEST_SYNC_POINT("DBImpl::RunManualCompaction:YieldToAutomatic");
+          RemoveManualCompaction(&manual);
+          MaybeScheduleFlushOrCompaction();
+          const uint64_t yield_end_us =
+              env_->NowMicros() + kMaxManualCompactionYieldMicros;
+          while ((bg_bottom_compaction_scheduled_ > 0 ||
+                  bg_compaction_scheduled_ > 0) &&
+                 env_->NowMicros() < yield_end_us) {
+            bg_cv_.TimedWait(yield_end_us);
+          }
+          // No new automatic compaction is scheduled from now on, so this
+          // only waits for the ones that are running
+          AddManualCompaction(&manual);
+          while (bg_bottom_compaction_scheduled_ > 0 ||
+                 bg_compaction_scheduled_ > 0) {
+            bg_cv_.Wait();
+          }
+        }
       }
     } else if (!scheduled) {
       if (compaction == nullptr) {
@@ -1972,10 +2089,19 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
 
 DBImpl::BGJobLimits DBImpl::GetBGJobLimits() const {
   mutex_.AssertHeld();
-  return GetBGJobLimits(immutable_db_options_.max_background_flushes,
-                        mutable_db_options_.max_background_compactions,
-                        mutable_db_options_.max_background_jobs,
-                        write_controller_.NeedSpeedupCompaction());
+  const bool need_speedup = write_controller_.NeedSpeedupCompaction();
+  const bool autoscale =
+      immutable_db_options_.compaction_autoscale_period_sec > 0;
+  BGJobLimits res = GetBGJobLimits(
+      immutable_db_options_.max_background_flushes,
+      mutable_db_options_.max_background_compactions,
+      mutable_db_options_.max_background_jobs, need_speedup || autoscale);
+  if (autoscale && !need_speedup) {
+    // Writes are not about to stall, the autoscaler decides
+    res.max_compactions =
+        std::min(res.max_compactions, compaction_autoscale_limit_);
+  }
+  return res;
 }
 
 DBImpl::BGJobLimits DBImpl::GetBGJobLimits(int max_background_flushes,
@@ -2001,6 +2127,80 @@ DBImpl::BGJobLimits DBImpl::GetBGJobLimits(int max_background_flushes,
   return res;
 }
 
+void DBImpl::AutoscaleCompactions() {
+  TEST_SYNC_POINT("DBImpl::AutoscaleCompactions:Entry");
+  double write_latency_p99 = 0;
+  if (immutable_db_options_.compaction_autoscale_write_latency_micros > 0) {
+    write_latency_p99 = write_latency_hist_.Percentile(99);
+    write_latency_hist_.Clear();
+  }
+  InstrumentedMutexLock l(&mutex_);
+  if (shutting_down_.load(std::memory_order_acquire)) {
+    return;
+  }
+  // Adding compactions does not help if they are already throttled by the
+  // rate limiter
+  bool rate_limiter_saturated = false;
+  RateLimiter* rate_limiter = immutable_db_options_.rate_limiter.get();
+  if (rate_limiter != nullptr) {
+    const int64_t bytes = rate_limiter->GetTotalBytesThrough();
+    const double period_bytes =
+        static_cast<double>(rate_limiter->GetBytesPerSecond()) *
+        immutable_db_options_.compaction_autoscale_period_sec;
+    rate_limiter_saturated =
+        period_bytes > 0 &&
+        bytes - compaction_autoscale_rate_limiter_bytes_ >= 0.9 * period_bytes;
+    compaction_autoscale_rate_limiter_bytes_ = bytes;
+  }
+
+  // Compaction debt of the worst column family. At 1, all compaction
+  // threads are used whatever the autoscaler decides.
+  double debt = 0;
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->IsDropped() || !cfd->initialized()) {
+      continue;
+    }
+    debt = std::max(
+        debt, cfd->GetCompactionDebtRatio(*cfd->GetLatestMutableCFOptions()));
+  }
+
+  const int max_compactions =
+      GetBGJobLimits(immutable_db_options_.max_background_flushes,
+                     mutable_db_options_.max_background_compactions,
+                     mutable_db_options_.max_background_jobs,
+                     true /* parallelize_compactions */)
+          .max_compactions;
+  int limit = compaction_autoscale_limit_;
+  if (immutable_db_options_.compaction_autoscale_write_latency_micros > 0 &&
+      write_latency_p99 >
+          immutable_db_options_.compaction_autoscale_write_latency_micros) {
+    // Foreground writes come first as long as the debt allows
+    limit--;
+  } else if (debt >= 0.5) {
+    if (!rate_limiter_saturated) {
+      limit = std::max(limit + 1, static_cast<int>(std::ceil(
+                                      max_compactions * std::min(debt, 1.0))));
+    }
+  } else if (debt < 0.25) {
+    limit--;
+  }
+  limit = std::max(1, std::min(limit, max_compactions));
+  const uint32_t max_subcompactions = immutable_db_options_.max_subcompactions;
+  compaction_autoscale_subcompactions_ = std::max<uint32_t>(
+      1, (max_subcompactions * limit + max_compactions - 1) / max_compactions);
+
+  if (limit != compaction_autoscale_limit_) {
+    ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                   "Compaction autoscaling: limit %d -> %d (debt %.2f, write "
+                   "p99 %.1f us, rate limiter saturated %d)",
+                   compaction_autoscale_limit_, limit, debt, write_latency_p99,
+                   rate_limiter_saturated);
+    compaction_autoscale_limit_ = limit;
+    env_->IncBackgroundThreadsIfNeeded(limit, Env::Priority::LOW);
+    MaybeScheduleFlushOrCompaction();
+  }
+}
+
 void DBImpl::AddToCompactionQueue(ColumnFamilyData* cfd) {
   assert(!cfd->queued_for_compaction());
   cfd->Ref();
@@ -2385,6 +2585,13 @@ void DBImpl::BackgroundCallCompaction(PrepickedCompaction* prepicked_compaction,
       mutex_.Lock();
     }
 
+    if (prepicked_compaction != nullptr &&
+        prepicked_compaction->task_token != nullptr) {
+      // The limiter is owned by the column family options, so the token has
+      // to be released before the DB destructor may be signaled below.
+      prepicked_compaction->task_token.reset();
+    }
+
     assert(num_running_compactions_ > 0);
     num_running_compactions_--;
     if (bg_thread_pri == Env::Priority::LOW) {
@@ -2480,6 +2687,7 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
   }
 
   std::unique_ptr<TaskLimiterToken> task_token;
+  uint64_t manual_progress_bytes = 0;
 
   // InternalKey manual_end_storage;
   // InternalKey* manual_end = &manual_end_storage;
@@ -2519,6 +2727,21 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
             ((m->done || m->manual_end == nullptr)
                  ? "(end)"
                  : m->manual_end->DebugString().c_str()));
+        if (m->progress != nullptr) {
+          // Persisted atomically with the result of this compaction
+          ManualCompactionProgress next = *m->progress;
+          if (m->manual_end == nullptr) {
+            next.level = m->input_level + 1;
+            next.has_resume_key = false;
+            next.resume_key.clear();
+          } else {
+            next.level = m->input_level;
+            next.has_resume_key = true;
+            next.resume_key = m->manual_end->user_key().ToString();
+          }
+          c->edit()->SetManualCompactionProgress(next);
+          manual_progress_bytes = c->CalculateTotalInputSize();
+        }
       }
     }
   } else if (!is_prepicked && !compaction_queue_.empty()) {
@@ -2586,6 +2809,10 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
           // will sleep if !s.ok()
           status = Status::CompactionTooLarge();
         } else {
+          if (immutable_db_options_.compaction_autoscale_period_sec > 0 &&
+              !write_controller_.NeedSpeedupCompaction()) {
+            c->LimitMaxSubcompactions(compaction_autoscale_subcompactions_);
+          }
           // update statistics
           RecordInHistogram(stats_, NUM_FILES_IN_SINGLE_COMPACTION,
                             c->inputs(0)->size());
@@ -2639,6 +2866,7 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
     InstallSuperVersionAndScheduleWork(c->column_family_data(),
                                        &job_context->superversion_contexts[0],
                                        *c->mutable_cf_options());
+    InvalidateScanCache(*c);
     ROCKS_LOG_BUFFER(log_buffer, "[%s] Deleted %d files\n",
                      c->column_family_data()->GetName().c_str(),
                      c->num_input_files(0));
@@ -2781,6 +3009,7 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
       InstallSuperVersionAndScheduleWork(c->column_family_data(),
                                          &job_context->superversion_contexts[0],
                                          *c->mutable_cf_options());
+      InvalidateScanCache(*c);
     }
     *made_progress = true;
     TEST_SYNC_POINT_CALLBACK("DBImpl::BackgroundCompaction:AfterCompaction",
@@ -2838,6 +3067,8 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
     if (!status.ok()) {
       m->status = status;
       m->done = true;
+    } else if (m->progress != nullptr) {
+      m->cfd->AddManualCompactionBytes(manual_progress_bytes);
     }
     // For universal compaction:
     //   Because universal compaction always happens at level 0, so one
@@ -3025,6 +3256,14 @@ void DBImpl::BuildCompactionJobInfo(
 // new SuperVersion() inside of the mutex. We do similar thing
 // for superversion_to_free
 
+void DBImpl::InvalidateScanCache(const Compaction& c) {
+  // Compaction filters and FIFO compaction can drop visible entries
+  if (scan_cache_ != nullptr) {
+    scan_cache_->InvalidateRange(c.column_family_data()->GetID(),
+                                 c.GetSmallestUserKey(), c.GetLargestUserKey());
+  }
+}
+
 void DBImpl::InstallSuperVersionAndScheduleWork(
     ColumnFamilyData* cfd, SuperVersionContext* sv_context,
     const MutableCFOptions& mutable_cf_options) {
@@ -3048,12 +3287,14 @@ void DBImpl::InstallSuperVersionAndScheduleWork(
   // compaction may already be released here. But assuming there will always be
   // newer snapshot created and released frequently, the compaction will be
   // triggered soon anyway.
-  bottommost_files_mark_threshold_ = kMaxSequenceNumber;
+  SequenceNumber new_bottommost_files_mark_threshold = kMaxSequenceNumber;
   for (auto* my_cfd : *versions_->GetColumnFamilySet()) {
-    bottommost_files_mark_threshold_ = std::min(
-        bottommost_files_mark_threshold_,
+    new_bottommost_files_mark_threshold = std::min(
+        new_bottommost_files_mark_threshold,
         my_cfd->current()->storage_info()->bottommost_files_mark_threshold());
   }
+  bottommost_files_mark_threshold_.store(new_bottommost_files_mark_threshold,
+                                         std::memory_order_release);
 
   // Whenever we install new SuperVersion, we might need to issue new flushes or
   // compactions.
@@ -3113,7 +3354,7 @@ void DBImpl::GetSnapshotContext(
     // in snapshot_seqs and force compaction iterator to consider such
     // snapshots.
     const Snapshot* job_snapshot =
-        GetSnapshotImpl(false /*write_conflict_boundary*/, false /*lock*/);
+        GetSnapshotImpl(false /*write_conflict_boundary*/);
     job_context->job_snapshot.reset(new ManagedSnapshot(this, job_snapshot));
   }
   *snapshot_seqs = snapshots_.GetAll(earliest_write_conflict_snapshot);
@@ -282,6 +282,12 @@ bool DBImpl::TEST_IsPersistentStatsEnabled() const {
   return thread_persist_stats_ && thread_persist_stats_->IsRunning();
 }
 
+int DBImpl::TEST_AutoscaleCompactions() {
+  AutoscaleCompactions();
+  InstrumentedMutexLock l(&mutex_);
+  return compaction_autoscale_limit_;
+}
+
 size_t DBImpl::TEST_EstimateInMemoryStatsHistorySize() const {
   return EstimateInMemoryStatsHistorySize();
 }
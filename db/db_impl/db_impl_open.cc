@@ -228,6 +228,13 @@ Status DBImpl::ValidateOptions(const DBOptions& db_options) {
         "unordered_write is incompatible with enable_pipelined_write");
   }
 
+  if (db_options.scan_cache_size > 0 &&
+      (db_options.unordered_write || db_options.two_write_queues)) {
+    return Status::InvalidArgument(
+        "scan_cache_size is incompatible with unordered_write and "
+        "two_write_queues");
+  }
+
   if (db_options.atomic_flush && db_options.enable_pipelined_write) {
     return Status::InvalidArgument(
         "atomic_flush is incompatible with enable_pipelined_write");
@@ -1308,7 +1315,9 @@ Status DBImpl::CreateWAL(uint64_t log_file_num, uint64_t recycle_log_number,
     const auto& listeners = immutable_db_options_.listeners;
     std::unique_ptr<WritableFileWriter> file_writer(
         new WritableFileWriter(std::move(lfile), log_fname, opt_env_options,
-                               env_, nullptr /* stats */, listeners));
+                               env_, immutable_db_options_.statistics.get(),
+                               listeners));
+    file_writer->SetIOClass(RateLimiter::IOClass::kWAL);
     *new_log = new log::Writer(std::move(file_writer), log_file_num,
                                immutable_db_options_.recycle_log_file_num > 0,
                                immutable_db_options_.manual_wal_flush);
@@ -1340,6 +1349,10 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
   }
 
   DBImpl* impl = new DBImpl(db_options, dbname, seq_per_batch, batch_per_txn);
+  if (impl->immutable_db_options_.scan_cache_size > 0) {
+    impl->scan_cache_.reset(
+        new ScanCache(impl->immutable_db_options_.scan_cache_size));
+  }
   s = impl->env_->CreateDirIfMissing(impl->immutable_db_options_.wal_dir);
   if (s.ok()) {
     std::vector<std::string> paths;
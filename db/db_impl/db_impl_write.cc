@@ -49,7 +49,14 @@ void DBImpl::SetRecoverableStatePreReleaseCallback(
 }
 
 Status DBImpl::Write(const WriteOptions& write_options, WriteBatch* my_batch) {
-  return WriteImpl(write_options, my_batch, nullptr, nullptr);
+  if (immutable_db_options_.compaction_autoscale_write_latency_micros == 0) {
+    return WriteImpl(write_options, my_batch, nullptr, nullptr);
+  }
+  // Feeds the compaction autoscaler
+  const uint64_t start_micros = env_->NowMicros();
+  Status s = WriteImpl(write_options, my_batch, nullptr, nullptr);
+  write_latency_hist_.Add(env_->NowMicros() - start_micros);
+  return s;
 }
 
 #ifndef ROCKSDB_LITE
@@ -184,6 +191,7 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
       // TODO(myabandeh): propagate status to write_group
       auto last_sequence = w.write_group->last_sequence;
       versions_->SetLastSequence(last_sequence);
+      InvalidateScanCache(*w.write_group);
       MemTableInsertStatusCheck(w.status);
       write_thread_.ExitAsBatchGroupFollower(&w);
     }
@@ -416,9 +424,11 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
     mutex_.Lock();
     MarkLogsSynced(logfile_number_, need_log_dir_sync, status);
     mutex_.Unlock();
-    // Requesting sync with two_write_queues_ is expected to be very rare. We
-    // hence provide a simple implementation that is not necessarily efficient.
+    // With two_write_queues_ the WAL is synced by SyncWAL(), which lets the
+    // groups of both queues that wait for a sync share a single one, e.g. the
+    // prepare and commit markers of two-phase commit transactions.
     if (two_write_queues_) {
+      TEST_SYNC_POINT("DBImpl::WriteImpl:BeforeSyncWAL");
       if (manual_wal_flush_) {
         status = FlushWAL(true);
       } else {
@@ -438,6 +448,7 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
       // Note: if we are to resume after non-OK statuses we need to revisit how
       // we reacts to non-OK statuses here.
       versions_->SetLastSequence(last_sequence);
+      InvalidateScanCache(write_group);
     }
     MemTableInsertStatusCheck(w.status);
     write_thread_.ExitAsBatchGroupLeader(write_group, status);
@@ -554,6 +565,7 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
           write_options.ignore_missing_column_families, 0 /*log_number*/, this,
           false /*concurrent_memtable_writes*/, seq_per_batch_, batch_per_txn_);
       versions_->SetLastSequence(memtable_write_group.last_sequence);
+      InvalidateScanCache(memtable_write_group);
       write_thread_.ExitAsMemTableWriter(&w, memtable_write_group);
     }
   }
@@ -571,6 +583,7 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
     if (write_thread_.CompleteParallelMemTableWriter(&w)) {
       MemTableInsertStatusCheck(w.status);
       versions_->SetLastSequence(w.write_group->last_sequence);
+      InvalidateScanCache(*w.write_group);
       write_thread_.ExitAsMemTableWriter(&w, *w.write_group);
     }
   }
@@ -764,8 +777,8 @@ Status DBImpl::WriteImplWALOnly(
   }
   if (status.ok() && write_options.sync) {
     assert(!write_options.disableWAL);
-    // Requesting sync with two_write_queues_ is expected to be very rare. We
-    // hance provide a simple implementation that is not necessarily efficient.
+    // SyncWAL() shares the sync with the groups of both write queues that
+    // wait for one at the same time.
     if (manual_wal_flush_) {
       status = FlushWAL(true);
     } else {
@@ -835,6 +848,17 @@ void DBImpl::MemTableInsertStatusCheck(const Status& status) {
   }
 }
 
+void DBImpl::InvalidateScanCache(const WriteThread::WriteGroup& write_group) {
+  if (scan_cache_ == nullptr) {
+    return;
+  }
+  for (auto* writer : write_group) {
+    if (writer->ShouldWriteToMemtable()) {
+      scan_cache_->Invalidate(*writer->batch);
+    }
+  }
+}
+
 Status DBImpl::PreprocessWrite(const WriteOptions& write_options,
                                bool* need_log_sync,
                                WriteContext* write_context) {
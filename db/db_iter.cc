@@ -171,6 +171,84 @@ void DBIter::Next() {
   }
 }
 
+size_t DBIter::NextBatch(size_t max_entries, PinnableSlice* keys,
+                         PinnableSlice* values) {
+  size_t n = 0;
+  while (n < max_entries && valid_) {
+    IterateBatch::Set(&keys[n], key(),
+                      pin_thru_lifetime_ && saved_key_.IsKeyPinned());
+    IterateBatch::Set(&values[n], value(),
+                      pin_thru_lifetime_ && !current_entry_is_merged_ &&
+                          direction_ == kForward && iter_.IsValuePinned());
+    ++n;
+    if (n < max_entries && CanNextBatchInternal()) {
+      n += NextBatchInternal(max_entries - n, keys + n, values + n);
+    } else {
+      // Qualified so that it is not a virtual call
+      DBIter::Next();
+    }
+  }
+  return n;
+}
+
+bool DBIter::CanNextBatchInternal() const {
+  return direction_ == kForward && !current_entry_is_merged_ &&
+         read_callback_ == nullptr && start_seqnum_ == 0 &&
+         !prefix_same_as_start_ && range_del_agg_.IsEmpty();
+}
+
+size_t DBIter::NextBatchInternal(size_t max_entries, PinnableSlice* keys,
+                                 PinnableSlice* values) {
+  assert(valid_);
+  assert(status_.ok());
+  assert(CanNextBatchInternal());
+  assert(iter_.Valid());
+
+  PERF_CPU_TIMER_GUARD(iter_next_cpu_nanos, env_);
+  ReleaseTempPinnedData();
+  local_stats_.skip_count_ += num_internal_keys_skipped_;
+  local_stats_.skip_count_--;
+  num_internal_keys_skipped_ = 0;
+
+  IterateBatch batch;
+  batch.sequence = sequence_;
+  batch.user_comparator = user_comparator_.user_comparator();
+  batch.prev_user_key = saved_key_.GetUserKey();
+  batch.limit = iterate_upper_bound_;
+  batch.pin_data = pin_thru_lifetime_;
+  batch.keys = keys;
+  batch.values = values;
+  batch.max_entries = max_entries;
+  iter_.NextBatch(&batch);
+  // Each entry added stands for a Next() that found it right away
+  size_t n = batch.num_entries;
+  TEST_SYNC_POINT_CALLBACK("DBIter::NextBatchInternal:Added", &n);
+  PERF_COUNTER_ADD(internal_key_skipped_count, n + 1);
+  local_stats_.next_count_ += n + 1;
+  if (statistics_ != nullptr) {
+    local_stats_.next_found_count_ += n;
+    for (size_t i = 0; i < n; i++) {
+      local_stats_.bytes_read_ += keys[i].size() + values[i].size();
+    }
+  }
+  if (n > 0) {
+    saved_key_.SetUserKey(keys[n - 1], !keys[n - 1].IsPinned() /* copy */);
+    is_key_seqnum_zero_ = false;
+  }
+
+  if (iter_.Valid()) {
+    FindNextUserEntry(true /* skipping the current user key */, nullptr);
+  } else {
+    is_key_seqnum_zero_ = false;
+    valid_ = false;
+  }
+  if (statistics_ != nullptr && valid_) {
+    local_stats_.next_found_count_++;
+    local_stats_.bytes_read_ += (key().size() + value().size());
+  }
+  return n;
+}
+
 // PRE: saved_key_ has the current user key if skipping_saved_key
 // POST: saved_key_ should have the next user key if valid_,
 //       if the current entry is a result of merge
@@ -179,6 +179,8 @@ class DBIter final : public Iterator {
   Status GetProperty(std::string prop_name, std::string* prop) override;
 
   void Next() final override;
+  size_t NextBatch(size_t max_entries, PinnableSlice* keys,
+                   PinnableSlice* values) final override;
   void Prev() final override;
   void Seek(const Slice& target) final override;
   void SeekForPrev(const Slice& target) final override;
@@ -218,6 +220,14 @@ class DBIter final : public Iterator {
   bool FindNextUserEntryInternal(bool skipping_saved_key, const Slice* prefix);
   bool ParseKey(ParsedInternalKey* key);
   bool MergeValuesNewToOld();
+  // Whether the internal iterator can add the entries after the current one
+  // to a batch, since none needs more than the checks IterateBatch makes.
+  bool CanNextBatchInternal() const;
+  // Same as Next(), but first moves past the entries the internal iterator
+  // adds to keys[0, n) and values[0, n) in one batch. Returns n.
+  // REQUIRES: CanNextBatchInternal()
+  size_t NextBatchInternal(size_t max_entries, PinnableSlice* keys,
+                           PinnableSlice* values);
 
   // If prefix is not null, we need to set the iterator to invalid if no more
   // entry can be found within the prefix.
@@ -1572,6 +1572,145 @@ TEST_P(DBIteratorTest, PinnedDataIteratorMergeOperator) {
   delete iter;
 }
 
+TEST_P(DBIteratorTest, NextBatch) {
+  size_t num_added = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBIter::NextBatchInternal:Added",
+      [&](void* arg) { num_added += *static_cast<size_t*>(arg); });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  for (bool use_delta_encoding : {false, true}) {
+    Options options = CurrentOptions();
+    options.disable_auto_compactions = true;
+    options.target_file_size_base = 2 << 10;
+    BlockBasedTableOptions table_options;
+    table_options.use_delta_encoding = use_delta_encoding;
+    table_options.block_size = 256;
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    options.merge_operator = MergeOperators::CreateStringAppendOperator();
+    DestroyAndReopen(options);
+
+    // Runs of plain values in several L2 files, each of several blocks, with
+    // deletions and merges in L0 and overwrites in the memtable
+    Random rnd(301);
+    for (int start : {0, 1}) {
+      for (int i = start; i < 300; i += 2) {
+        ASSERT_OK(Put(Key(i), RandomString(&rnd, 10)));
+      }
+      ASSERT_OK(Flush());
+    }
+    MoveFilesToLevel(2);
+    ASSERT_GT(NumTableFilesAtLevel(2), 1);
+    for (int i = 0; i < 300; i += 13) {
+      ASSERT_OK(Delete(Key(i)));
+    }
+    for (int i = 0; i < 300; i += 17) {
+      ASSERT_OK(Merge(Key(i), "m"));
+    }
+    ASSERT_OK(Flush());
+    for (int i = 0; i < 300; i += 11) {
+      ASSERT_OK(Put(Key(i), "memtable"));
+    }
+    const Snapshot* snapshot = db_->GetSnapshot();
+    for (int i = 0; i < 300; i += 19) {
+      ASSERT_OK(Put(Key(i), "after snapshot"));
+    }
+
+    std::string upper_bound = Key(250);
+    Slice upper_bound_slice(upper_bound);
+    for (bool use_loser_tree_merge : {false, true}) {
+      for (bool pin_data : {false, true}) {
+        ReadOptions ro;
+        ro.pin_data = pin_data;
+        ro.use_loser_tree_merge = use_loser_tree_merge;
+        ro.iterate_upper_bound = &upper_bound_slice;
+        ro.snapshot = snapshot;
+
+        std::vector<std::pair<std::string, std::string>> expected;
+        std::unique_ptr<Iterator> iter(NewIterator(ro));
+        for (iter->Seek(Key(10)); iter->Valid(); iter->Next()) {
+          expected.emplace_back(iter->key().ToString(),
+                                iter->value().ToString());
+        }
+        ASSERT_OK(iter->status());
+        ASSERT_GT(expected.size(), 200);
+
+        const size_t kBatchSize = 16;
+        PinnableSlice keys[kBatchSize];
+        PinnableSlice values[kBatchSize];
+        std::vector<std::pair<std::string, std::string>> actual;
+        // Keys and values pinned through the lifetime of the iterator
+        std::vector<std::pair<Slice, std::string>> pinned;
+        num_added = 0;
+        iter.reset(NewIterator(ro));
+        iter->Seek(Key(10));
+        while (iter->Valid()) {
+          size_t n = iter->NextBatch(kBatchSize, keys, values);
+          ASSERT_GT(n, 0);
+          ASSERT_TRUE(n == kBatchSize || !iter->Valid());
+          for (size_t i = 0; i < n; i++) {
+            actual.emplace_back(keys[i].ToString(), values[i].ToString());
+            if (!pin_data) {
+              ASSERT_FALSE(keys[i].IsPinned());
+              ASSERT_FALSE(values[i].IsPinned());
+            } else if (!use_delta_encoding) {
+              ASSERT_TRUE(keys[i].IsPinned());
+            }
+            if (keys[i].IsPinned()) {
+              pinned.emplace_back(keys[i], keys[i].ToString());
+            }
+            if (values[i].IsPinned()) {
+              pinned.emplace_back(values[i], values[i].ToString());
+            }
+          }
+        }
+        ASSERT_OK(iter->status());
+        ASSERT_EQ(0, iter->NextBatch(kBatchSize, keys, values));
+        ASSERT_EQ(expected, actual);
+        for (auto& p : pinned) {
+          ASSERT_EQ(p.second, p.first.ToString());
+        }
+        // Most entries come from the memtable and SST file iterators in
+        // batches, unless a read callback decides which entries are visible
+        if (GetParam()) {
+          ASSERT_EQ(0, num_added);
+        } else {
+          ASSERT_GT(num_added, expected.size() / 2);
+        }
+      }
+    }
+    db_->ReleaseSnapshot(snapshot);
+  }
+
+  // A range tombstone leaves it to DBIter to check every entry
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(100), Key(200)));
+  std::vector<std::string> expected;
+  std::unique_ptr<Iterator> iter(NewIterator(ReadOptions()));
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    expected.push_back(iter->key().ToString());
+  }
+  ASSERT_OK(iter->status());
+  const size_t kBatchSize = 16;
+  PinnableSlice keys[kBatchSize];
+  PinnableSlice values[kBatchSize];
+  std::vector<std::string> actual;
+  num_added = 0;
+  iter.reset(NewIterator(ReadOptions()));
+  for (iter->SeekToFirst(); iter->Valid();) {
+    size_t n = iter->NextBatch(kBatchSize, keys, values);
+    for (size_t i = 0; i < n; i++) {
+      actual.push_back(keys[i].ToString());
+    }
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(expected, actual);
+  ASSERT_EQ(0, num_added);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_P(DBIteratorTest, PinnedDataIteratorReadAfterUpdate) {
   Options options = CurrentOptions();
   BlockBasedTableOptions table_options;
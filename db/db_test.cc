@@ -1690,8 +1690,298 @@ TEST_F(DBTest, ApproximateSizes_MixOfSmallAndLarge) {
     // ApproximateOffsetOf() is not yet implemented in plain table format.
   } while (ChangeOptions(kSkipPlainTable));
 }
+
+TEST_F(DBTest, GetRangePartitions) {
+  Options options = CurrentOptions();
+  options.compression = kNoCompression;
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+
+  // Two overlapping files, one with twice larger values
+  const int kNumKeys = 1000;
+  Random rnd(301);
+  for (int i = 0; i < kNumKeys; i += 2) {
+    ASSERT_OK(Put(Key(i), RandomString(&rnd, 1000)));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  for (int i = 1; i < kNumKeys; i += 2) {
+    ASSERT_OK(Put(Key(i), RandomString(&rnd, 2000)));
+  }
+  ASSERT_OK(Flush());
+
+  std::vector<std::string> split_keys;
+  ASSERT_OK(db_->GetRangePartitions(db_->DefaultColumnFamily(), nullptr,
+                                    nullptr, 1, &split_keys));
+  ASSERT_TRUE(split_keys.empty());
+  ASSERT_OK(db_->GetRangePartitions(db_->DefaultColumnFamily(), nullptr,
+                                    nullptr, 4, &split_keys));
+  ASSERT_EQ(3, split_keys.size());
+  std::string prev;
+  for (const auto& key : split_keys) {
+    ASSERT_GT(key, prev);
+    prev = key;
+  }
+  // Each quarter of the data holds about a quarter of the keys
+  ASSERT_GT(split_keys[0], Key(200));
+  ASSERT_LT(split_keys[0], Key(300));
+  ASSERT_GT(split_keys[1], Key(450));
+  ASSERT_LT(split_keys[1], Key(550));
+  ASSERT_GT(split_keys[2], Key(700));
+  ASSERT_LT(split_keys[2], Key(800));
+
+  // Split keys stay within the range
+  std::string begin = Key(100);
+  std::string end = Key(300);
+  Slice begin_slice(begin), end_slice(end);
+  ASSERT_OK(db_->GetRangePartitions(db_->DefaultColumnFamily(), &begin_slice,
+                                    &end_slice, 8, &split_keys));
+  ASSERT_GE(split_keys.size(), 4);
+  ASSERT_LE(split_keys.size(), 7);
+  ASSERT_GT(split_keys.front(), begin);
+  ASSERT_LT(split_keys.back(), end);
+
+  // A range without data is not split
+  std::string after = Key(kNumKeys + 100);
+  std::string after_end = Key(kNumKeys + 200);
+  Slice after_slice(after), after_end_slice(after_end);
+  ASSERT_OK(db_->GetRangePartitions(db_->DefaultColumnFamily(), &after_slice,
+                                    &after_end_slice, 4, &split_keys));
+  ASSERT_TRUE(split_keys.empty());
+
+  ASSERT_TRUE(db_->GetRangePartitions(db_->DefaultColumnFamily(), nullptr,
+                                      nullptr, 0, &split_keys)
+                  .IsInvalidArgument());
+  ASSERT_TRUE(db_->GetRangePartitions(db_->DefaultColumnFamily(), &end_slice,
+                                      &begin_slice, 4, &split_keys)
+                  .IsInvalidArgument());
+}
+
+TEST_F(DBTest, ParallelScan) {
+  Options options = CurrentOptions();
+  options.compression = kNoCompression;
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 1000;
+  Random rnd(301);
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), RandomString(&rnd, 1000)));
+  }
+  ASSERT_OK(Flush());
+  // Not counted for partitioning, but scanned
+  ASSERT_OK(Put(Key(kNumKeys), "memtable"));
+
+  const size_t kNumPartitions = 4;
+  // Without threads in the USER pool, then with some
+  for (int num_threads : {0, 2}) {
+    env_->SetBackgroundThreads(num_threads, Env::Priority::USER);
+    std::vector<std::vector<std::string>> scanned(kNumPartitions);
+    auto scan_fn = [&](size_t partition, Iterator* iter) {
+      EXPECT_LT(partition, kNumPartitions);
+      for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        scanned[partition].push_back(iter->key().ToString());
+      }
+      return Status::OK();
+    };
+    ASSERT_OK(db_->ParallelScan(ReadOptions(), db_->DefaultColumnFamily(),
+                                nullptr, nullptr, kNumPartitions, scan_fn));
+    std::vector<std::string> all_keys;
+    for (const auto& keys : scanned) {
+      ASSERT_FALSE(keys.empty());
+      all_keys.insert(all_keys.end(), keys.begin(), keys.end());
+    }
+    ASSERT_EQ(kNumKeys + 1, all_keys.size());
+    for (int i = 0; i <= kNumKeys; i++) {
+      ASSERT_EQ(Key(i), all_keys[i]);
+    }
+  }
+  env_->SetBackgroundThreads(0, Env::Priority::USER);
+
+  // Scans read from the given snapshot, within the range
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(Delete(Key(kNumKeys)));
+  ASSERT_OK(Put(Key(kNumKeys + 1), "new"));
+  ReadOptions ro;
+  ro.snapshot = snapshot;
+  std::string begin = Key(500);
+  Slice begin_slice(begin);
+  std::atomic<int> count(0);
+  ASSERT_OK(db_->ParallelScan(ro, db_->DefaultColumnFamily(), &begin_slice,
+                              nullptr, kNumPartitions,
+                              [&](size_t /*partition*/, Iterator* iter) {
+                                for (iter->SeekToFirst(); iter->Valid();
+                                     iter->Next()) {
+                                  count++;
+                                }
+                                return Status::OK();
+                              }));
+  ASSERT_EQ(kNumKeys + 1 - 500, count.load());
+  db_->ReleaseSnapshot(snapshot);
+
+  // Errors of any partition are returned
+  ASSERT_TRUE(db_->ParallelScan(ReadOptions(), db_->DefaultColumnFamily(),
+                                nullptr, nullptr, kNumPartitions,
+                                [](size_t partition, Iterator* /*iter*/) {
+                                  return partition == 2 ? Status::Aborted()
+                                                        : Status::OK();
+                                })
+                  .IsAborted());
+}
+#endif  // ROCKSDB_LITE
+
+namespace {
+// Returns the results of DB::Scan() as "key=value" strings
+std::vector<std::string> ScanToStrings(DB* db, const ReadOptions& ro,
+                                       const std::string& start,
+                                       size_t limit) {
+  std::vector<std::string> keys, values, result;
+  Status s = db->Scan(ro, start, limit, &keys, &values);
+  if (!s.ok()) {
+    result.push_back(s.ToString());
+    return result;
+  }
+  EXPECT_EQ(keys.size(), values.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    result.push_back(keys[i] + "=" + values[i]);
+  }
+  return result;
+}
+}  // namespace
+
+TEST_F(DBTest, ScanCache) {
+  Options options = CurrentOptions();
+  options.scan_cache_size = 1 << 20;
+  options.statistics = CreateDBStatistics();
+  DestroyAndReopen(options);
+
+  for (int i = 10; i < 20; i++) {
+    ASSERT_OK(Put("k" + ToString(i), "v" + ToString(i)));
+  }
+  typedef std::vector<std::string> Strings;
+  ReadOptions ro;
+  ASSERT_EQ(Strings({"k12=v12", "k13=v13", "k14=v14"}),
+            ScanToStrings(db_, ro, "k12", 3));
+  ASSERT_EQ(0, TestGetTickerCount(options, SCAN_CACHE_HIT));
+  ASSERT_EQ(1, TestGetTickerCount(options, SCAN_CACHE_MISS));
+  ASSERT_EQ(Strings({"k12=v12", "k13=v13", "k14=v14"}),
+            ScanToStrings(db_, ro, "k12", 3));
+  // Starting within the cached range, with enough entries after the start
+  ASSERT_EQ(Strings({"k13=v13", "k14=v14"}),
+            ScanToStrings(db_, ro, "k125", 2));
+  ASSERT_EQ(2, TestGetTickerCount(options, SCAN_CACHE_HIT));
+  // Not enough entries cached after the start
+  ASSERT_EQ(Strings({"k13=v13", "k14=v14", "k15=v15"}),
+            ScanToStrings(db_, ro, "k13", 3));
+  ASSERT_EQ(2, TestGetTickerCount(options, SCAN_CACHE_MISS));
+
+  // Writes outside of the cached range keep it
+  ASSERT_OK(Put("k11", "new"));
+  ASSERT_OK(Put("k16", "new"));
+  ASSERT_EQ(Strings({"k13=v13", "k14=v14", "k15=v15"}),
+            ScanToStrings(db_, ro, "k13", 3));
+  ASSERT_EQ(3, TestGetTickerCount(options, SCAN_CACHE_HIT));
+  // Writes within it invalidate it
+  ASSERT_OK(Put("k14", "new"));
+  ASSERT_EQ(Strings({"k13=v13", "k14=new", "k15=v15"}),
+            ScanToStrings(db_, ro, "k13", 3));
+  ASSERT_EQ(3, TestGetTickerCount(options, SCAN_CACHE_MISS));
+  ASSERT_OK(Delete("k15"));
+  ASSERT_EQ(Strings({"k13=v13", "k14=new", "k16=new"}),
+            ScanToStrings(db_, ro, "k13", 3));
+  ASSERT_EQ(4, TestGetTickerCount(options, SCAN_CACHE_MISS));
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             "k135", "k145"));
+  ASSERT_EQ(Strings({"k13=v13", "k16=new", "k17=v17"}),
+            ScanToStrings(db_, ro, "k13", 3));
+  ASSERT_EQ(5, TestGetTickerCount(options, SCAN_CACHE_MISS));
+
+  // A scan reaching the end covers all the keys after its start
+  ASSERT_EQ(Strings({"k18=v18", "k19=v19"}), ScanToStrings(db_, ro, "k18", 5));
+  ASSERT_EQ(Strings({"k19=v19"}), ScanToStrings(db_, ro, "k19", 5));
+  ASSERT_EQ(4, TestGetTickerCount(options, SCAN_CACHE_HIT));
+  ASSERT_OK(Put("k99", "v99"));
+  ASSERT_EQ(Strings({"k19=v19", "k99=v99"}), ScanToStrings(db_, ro, "k19", 5));
+  ASSERT_EQ(7, TestGetTickerCount(options, SCAN_CACHE_MISS));
+
+  // Flushes do not change the results, and scans that do not read the
+  // latest state bypass the cache
+  ASSERT_OK(Flush());
+  ASSERT_EQ(Strings({"k19=v19", "k99=v99"}), ScanToStrings(db_, ro, "k19", 5));
+  ASSERT_EQ(5, TestGetTickerCount(options, SCAN_CACHE_HIT));
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(Put("k99", "new"));
+  ReadOptions snapshot_ro;
+  snapshot_ro.snapshot = snapshot;
+  ASSERT_EQ(Strings({"k19=v19", "k99=v99"}),
+            ScanToStrings(db_, snapshot_ro, "k19", 5));
+  db_->ReleaseSnapshot(snapshot);
+  ASSERT_EQ(5, TestGetTickerCount(options, SCAN_CACHE_HIT));
+  ASSERT_EQ(7, TestGetTickerCount(options, SCAN_CACHE_MISS));
+  ASSERT_EQ(Strings({"k19=v19", "k99=new"}), ScanToStrings(db_, ro, "k19", 5));
+}
+
+TEST_F(DBTest, ScanCacheInvalidation) {
+  Options options = CurrentOptions();
+  options.scan_cache_size = 1 << 20;
+  options.statistics = CreateDBStatistics();
+  options.disable_auto_compactions = true;
+  // Drops the entries whose value is "drop"
+  class DropFilter : public CompactionFilter {
+   public:
+    bool Filter(int /*level*/, const Slice& /*key*/, const Slice& value,
+                std::string* /*new_value*/,
+                bool* /*value_changed*/) const override {
+      return value == "drop";
+    }
+    const char* Name() const override { return "DropFilter"; }
+  } drop_filter;
+  options.compaction_filter = &drop_filter;
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("a", "keep"));
+  ASSERT_OK(Put("b", "drop"));
+  ASSERT_OK(Put("c", "keep"));
+  ASSERT_OK(Flush());
+  typedef std::vector<std::string> Strings;
+  ReadOptions ro;
+  ASSERT_EQ(Strings({"a=keep", "b=drop"}), ScanToStrings(db_, ro, "a", 2));
+  ASSERT_EQ(Strings({"a=keep", "b=drop"}), ScanToStrings(db_, ro, "a", 2));
+  ASSERT_EQ(1, TestGetTickerCount(options, SCAN_CACHE_HIT));
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(Strings({"a=keep", "c=keep"}), ScanToStrings(db_, ro, "a", 2));
+  ASSERT_EQ(1, TestGetTickerCount(options, SCAN_CACHE_HIT));
+
+  // A write published while a scan runs keeps its results out of the cache
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::Scan:AfterBeginFill",
+      [&](void* /*arg*/) { ASSERT_OK(Put("d", "new")); });
+  SyncPoint::GetInstance()->EnableProcessing();
+  ASSERT_EQ(Strings({"c=keep", "d=new"}), ScanToStrings(db_, ro, "c", 5));
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_EQ(Strings({"c=keep", "d=new"}), ScanToStrings(db_, ro, "c", 5));
+  ASSERT_EQ(1, TestGetTickerCount(options, SCAN_CACHE_HIT));
+  ASSERT_EQ(Strings({"c=keep", "d=new"}), ScanToStrings(db_, ro, "c", 5));
+  ASSERT_EQ(2, TestGetTickerCount(options, SCAN_CACHE_HIT));
+
+#ifndef ROCKSDB_LITE
+  // Ingested files invalidate the range they cover
+  std::string sst_file = dbname_ + "/ingest.sst";
+  SstFileWriter sst_writer(EnvOptions(), options);
+  ASSERT_OK(sst_writer.Open(sst_file));
+  ASSERT_OK(sst_writer.Put("cc", "ingested"));
+  ASSERT_OK(sst_writer.Finish());
+  ASSERT_OK(db_->IngestExternalFile({sst_file}, IngestExternalFileOptions()));
+  ASSERT_EQ(Strings({"c=keep", "cc=ingested", "d=new"}),
+            ScanToStrings(db_, ro, "c", 5));
+  ASSERT_EQ(2, TestGetTickerCount(options, SCAN_CACHE_HIT));
 #endif  // ROCKSDB_LITE
 
+  // Not supported with two_write_queues
+  options.two_write_queues = true;
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+}
+
 #ifndef ROCKSDB_LITE
 TEST_F(DBTest, Snapshot) {
   anon::OptionsOverride options_override;
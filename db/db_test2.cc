@@ -1463,6 +1463,76 @@ TEST_F(DBTest2, DuplicateSnapshot) {
     db_->ReleaseSnapshot(s);
   }
 }
+
+TEST_F(DBTest2, ConcurrentSnapshots) {
+  DBImpl* dbi = reinterpret_cast<DBImpl*>(db_);
+
+  Put("k", "v");  // inc seq
+  const Snapshot* s1 = db_->GetSnapshot();
+  Put("k", "v");  // inc seq
+  const Snapshot* s2 = db_->GetSnapshot();
+  Put("k", "v");  // inc seq
+  const Snapshot* s3 = db_->GetSnapshot();
+  db_->ReleaseSnapshot(s2);
+  auto seqs = dbi->snapshots().GetAll();
+  ASSERT_EQ(seqs, std::vector<SequenceNumber>(
+                      {s1->GetSequenceNumber(), s3->GetSequenceNumber()}));
+  ASSERT_EQ(dbi->snapshots().GetOldest(kMaxSequenceNumber),
+            s1->GetSequenceNumber());
+  db_->ReleaseSnapshot(s1);
+  ASSERT_EQ(dbi->snapshots().GetOldest(kMaxSequenceNumber),
+            s3->GetSequenceNumber());
+  ASSERT_EQ(dbi->snapshots().GetOldestHint(kMaxSequenceNumber),
+            s3->GetSequenceNumber());
+  db_->ReleaseSnapshot(s3);
+  ASSERT_TRUE(dbi->snapshots().empty());
+
+  // Take and release snapshots out of order on several threads while the
+  // list is read.
+  const int kNumThreads = 4;
+  const int kNumSnapshots = 1000;
+  std::atomic<int> num_done(0);
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t]() {
+      Random rnd(301 + t);
+      std::vector<const Snapshot*> held;
+      for (int i = 0; i < kNumSnapshots; i++) {
+        held.push_back(db_->GetSnapshot());
+        ASSERT_OK(Put("k" + ToString(t), ToString(i)));
+        if (rnd.OneIn(2)) {
+          size_t idx = rnd.Uniform(static_cast<int>(held.size()));
+          db_->ReleaseSnapshot(held[idx]);
+          held.erase(held.begin() + idx);
+        }
+      }
+      for (auto s : held) {
+        db_->ReleaseSnapshot(s);
+      }
+      num_done++;
+    });
+  }
+  while (num_done.load() < kNumThreads) {
+    SequenceNumber last_seq = dbi->GetLastPublishedSequence();
+    SequenceNumber oldest = dbi->snapshots().GetOldest(last_seq);
+    seqs = dbi->snapshots().GetAll();
+    // Snapshots missed by GetOldest() are not older than last_seq
+    ASSERT_LE(oldest, last_seq);
+    if (!seqs.empty()) {
+      ASSERT_LE(oldest, seqs.front());
+    }
+    for (size_t i = 1; i < seqs.size(); i++) {
+      ASSERT_LT(seqs[i - 1], seqs[i]);
+    }
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  ASSERT_TRUE(dbi->snapshots().empty());
+  uint64_t num_snapshots = 0;
+  ASSERT_TRUE(db_->GetIntProperty("rocksdb.num-snapshots", &num_snapshots));
+  ASSERT_EQ(0, num_snapshots);
+}
 #endif  // ROCKSDB_LITE
 
 class PinL0IndexAndFilterBlocksTest
@@ -244,6 +244,89 @@ TEST_F(DBWALTest, SyncWALNotWaitWrite) {
   rocksdb::SyncPoint::GetInstance()->DisableProcessing();
 }
 
+TEST_F(DBWALTest, SyncWALSharesConcurrentSync) {
+  Options options = CurrentOptions();
+  options.statistics = rocksdb::CreateDBStatistics();
+  Reopen(options);
+  ASSERT_OK(Put("foo1", "bar1"));
+
+  // The first sync waits until two more SyncWAL() calls wait for it. Only
+  // one of them has to sync again once it is done.
+  std::atomic<bool> first_sync(true);
+  std::atomic<bool> first_sync_started(false);
+  std::atomic<bool> first_sync_released(false);
+  std::atomic<int> num_waiting(0);
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "DBWALTest::SyncWALNotWaitWrite:1", [&](void* /*arg*/) {
+        if (first_sync.exchange(false)) {
+          first_sync_started = true;
+          while (!first_sync_released) {
+            env_->SleepForMicroseconds(100);
+          }
+        }
+      });
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::SyncWAL:Wait", [&](void* /*arg*/) { num_waiting++; });
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+  uint64_t syncs = options.statistics->getTickerCount(WAL_FILE_SYNCED);
+  rocksdb::port::Thread first([&]() { ASSERT_OK(db_->SyncWAL()); });
+  while (!first_sync_started) {
+    env_->SleepForMicroseconds(100);
+  }
+  ASSERT_OK(Put("foo2", "bar2"));
+  std::vector<rocksdb::port::Thread> waiters;
+  for (int i = 0; i < 2; i++) {
+    waiters.emplace_back([&]() { ASSERT_OK(db_->SyncWAL()); });
+  }
+  while (num_waiting < 2) {
+    env_->SleepForMicroseconds(100);
+  }
+  first_sync_released = true;
+  first.join();
+  for (auto& t : waiters) {
+    t.join();
+  }
+  ASSERT_EQ(syncs + 2, options.statistics->getTickerCount(WAL_FILE_SYNCED));
+
+  // A sync that starts after a SyncWAL() call but only covers the logs before
+  // a memtable switch must not stand in for it. One call waits for the old
+  // log, the other writes to the new log, so both logs have to be synced.
+  first_sync = true;
+  first_sync_started = false;
+  first_sync_released = false;
+  num_waiting = 0;
+  ASSERT_OK(Put("foo3", "bar3"));
+  int file_syncs = env_->sync_counter_.load();
+  rocksdb::port::Thread second([&]() { ASSERT_OK(db_->SyncWAL()); });
+  while (!first_sync_started) {
+    env_->SleepForMicroseconds(100);
+  }
+  rocksdb::port::Thread old_log_waiter([&]() { ASSERT_OK(db_->SyncWAL()); });
+  while (num_waiting < 1) {
+    env_->SleepForMicroseconds(100);
+  }
+  ASSERT_OK(dbfull()->TEST_SwitchMemtable());
+  ASSERT_OK(Put("foo4", "bar4"));
+  rocksdb::port::Thread new_log_waiter([&]() { ASSERT_OK(db_->SyncWAL()); });
+  while (num_waiting < 2) {
+    env_->SleepForMicroseconds(100);
+  }
+  first_sync_released = true;
+  second.join();
+  old_log_waiter.join();
+  new_log_waiter.join();
+  ASSERT_EQ(file_syncs + 2, env_->sync_counter_.load());
+
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+  rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+  Reopen(options);
+  ASSERT_EQ("bar1", Get("foo1"));
+  ASSERT_EQ("bar2", Get("foo2"));
+  ASSERT_EQ("bar3", Get("foo3"));
+  ASSERT_EQ("bar4", Get("foo4"));
+}
+
 TEST_F(DBWALTest, Recover) {
   do {
     CreateAndReopenWithCF({"pikachu"}, CurrentOptions());
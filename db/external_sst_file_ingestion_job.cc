@@ -211,7 +211,10 @@ Status ExternalSstFileIngestionJob::Run() {
 
   if (ingestion_options_.snapshot_consistency && !db_snapshots_->empty()) {
     // We need to assign a global sequence number to all the files even
-    // if the dont overlap with any ranges since we have snapshots
+    // if the dont overlap with any ranges since we have snapshots.
+    // Snapshots are taken without the DB mutex, so one may still be taken
+    // during the ingestion. Like a snapshot taken while the MANIFEST is
+    // written, it only sees the ingested files once they are installed.
     force_global_seqno = true;
   }
   // It is safe to use this instead of LastAllocatedSequence since we are
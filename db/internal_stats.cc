@@ -19,6 +19,7 @@
 
 #include "db/column_family.h"
 #include "db/db_impl/db_impl.h"
+#include "rocksdb/sst_partitioner.h"
 #include "table/block_based/block_based_table_factory.h"
 #include "util/string_util.h"
 
@@ -206,6 +207,9 @@ static const std::string cfstats_no_file_histogram =
 static const std::string cf_file_histogram = "cf-file-histogram";
 static const std::string dbstats = "dbstats";
 static const std::string levelstats = "levelstats";
+static const std::string sst_partition_stats = "sst-partition-stats";
+static const std::string manual_compaction_progress =
+    "manual-compaction-progress";
 static const std::string num_immutable_mem_table = "num-immutable-mem-table";
 static const std::string num_immutable_mem_table_flushed =
     "num-immutable-mem-table-flushed";
@@ -271,6 +275,10 @@ const std::string DB::Properties::kCFFileHistogram =
     rocksdb_prefix + cf_file_histogram;
 const std::string DB::Properties::kDBStats = rocksdb_prefix + dbstats;
 const std::string DB::Properties::kLevelStats = rocksdb_prefix + levelstats;
+const std::string DB::Properties::kSstPartitionStats =
+    rocksdb_prefix + sst_partition_stats;
+const std::string DB::Properties::kManualCompactionProgress =
+    rocksdb_prefix + manual_compaction_progress;
 const std::string DB::Properties::kNumImmutableMemTable =
     rocksdb_prefix + num_immutable_mem_table;
 const std::string DB::Properties::kNumImmutableMemTableFlushed =
@@ -355,6 +363,12 @@ const std::unordered_map<std::string, DBPropertyInfo>
           nullptr, nullptr}},
         {DB::Properties::kLevelStats,
          {false, &InternalStats::HandleLevelStats, nullptr, nullptr, nullptr}},
+        {DB::Properties::kSstPartitionStats,
+         {false, &InternalStats::HandleSstPartitionStats, nullptr, nullptr,
+          nullptr}},
+        {DB::Properties::kManualCompactionProgress,
+         {false, &InternalStats::HandleManualCompactionProgress, nullptr,
+          nullptr, nullptr}},
         {DB::Properties::kStats,
          {false, &InternalStats::HandleStats, nullptr, nullptr, nullptr}},
         {DB::Properties::kCFStats,
@@ -570,6 +584,133 @@ bool InternalStats::HandleLevelStats(std::string* value, Slice /*suffix*/) {
   return true;
 }
 
+bool InternalStats::HandleManualCompactionProgress(std::string* value,
+                                                   Slice /*suffix*/) {
+  const ManualCompactionProgress& progress =
+      cfd_->manual_compaction_progress();
+  if (!progress.active) {
+    value->append("(none)\n");
+    return true;
+  }
+  const auto* vstorage = cfd_->current()->storage_info();
+
+  // Input files of the range that are yet to be compacted. The bottommost
+  // non-empty level is left out, as it is only rewritten in place when there
+  // is a compaction filter.
+  uint64_t remaining_bytes = 0;
+  InternalKey begin_key, end_key;
+  if (progress.has_end) {
+    end_key.SetMaxPossibleForUserKey(progress.end);
+  }
+  for (int level = progress.level;
+       level < vstorage->num_non_empty_levels() - 1; level++) {
+    const std::string* begin = nullptr;
+    if (level == progress.level && progress.has_resume_key) {
+      begin = &progress.resume_key;
+    } else if (progress.has_begin) {
+      begin = &progress.begin;
+    }
+    if (begin != nullptr) {
+      begin_key.SetMinPossibleForUserKey(*begin);
+    }
+    std::vector<FileMetaData*> inputs;
+    vstorage->GetOverlappingInputs(level, begin ? &begin_key : nullptr,
+                                   progress.has_end ? &end_key : nullptr,
+                                   &inputs);
+    for (const FileMetaData* f : inputs) {
+      remaining_bytes += f->fd.GetFileSize();
+    }
+  }
+
+  const uint64_t done_bytes = cfd_->manual_compaction_bytes_done();
+  const uint64_t now_micros = env_->NowMicros();
+  const uint64_t start_micros = cfd_->manual_compaction_start_micros();
+  const double elapsed_secs =
+      now_micros > start_micros ? (now_micros - start_micros) / kMicrosInSec
+                                : 0;
+
+  char buf[200];
+  value->append("Range: ");
+  value->append(progress.DebugString(true /* hex_key */));
+  snprintf(buf, sizeof(buf),
+           "\nCompacted: %.1f MB in %.1f secs\nRemaining: %.1f MB\n",
+           done_bytes / kMB, elapsed_secs, remaining_bytes / kMB);
+  value->append(buf);
+  if (done_bytes > 0 && elapsed_secs > 0) {
+    snprintf(buf, sizeof(buf), "ETA: %.1f secs\n",
+             remaining_bytes * elapsed_secs / done_bytes);
+  } else {
+    snprintf(buf, sizeof(buf), "ETA: unknown\n");
+  }
+  value->append(buf);
+  return true;
+}
+
+bool InternalStats::HandleSstPartitionStats(std::string* value,
+                                            Slice /*suffix*/) {
+  const SstPartitioner* partitioner = cfd_->ioptions()->sst_partitioner.get();
+  if (partitioner == nullptr) {
+    return false;
+  }
+  const size_t num_partitions = partitioner->NumPartitions();
+  const auto* vstorage = cfd_->current()->storage_info();
+
+  std::vector<uint64_t> num_files(num_partitions, 0);
+  std::vector<uint64_t> num_bytes(num_partitions, 0);
+  std::vector<uint64_t> read_amp(num_partitions, 0);
+  // Marks partitions overlapped by the files of the current level; sized one
+  // past the last partition so ranges can be closed without a bounds check.
+  std::vector<int> overlap(num_partitions + 1);
+  for (int level = 0; level < number_levels_; level++) {
+    std::fill(overlap.begin(), overlap.end(), 0);
+    for (const FileMetaData* f : vstorage->LevelFiles(level)) {
+      const size_t first =
+          partitioner->PartitionForKey(f->smallest.user_key());
+      const size_t last = partitioner->PartitionForKey(f->largest.user_key());
+      assert(first <= last && last < num_partitions);
+      num_files[first]++;
+      num_bytes[first] += f->fd.GetFileSize();
+      if (level == 0) {
+        // Every L0 file is a sorted run of its own.
+        for (size_t p = first; p <= last; p++) {
+          read_amp[p]++;
+        }
+      } else {
+        overlap[first]++;
+        overlap[last + 1]--;
+      }
+    }
+    if (level > 0) {
+      int running = 0;
+      for (size_t p = 0; p < num_partitions; p++) {
+        running += overlap[p];
+        if (running > 0) {
+          read_amp[p]++;
+        }
+      }
+    }
+  }
+
+  char buf[1000];
+  snprintf(buf, sizeof(buf),
+           "Partition Files Size(MB) ReadAmp Read(GB) Write(GB) Comp(cnt)\n"
+           "------------------------------------------------------------\n");
+  value->append(buf);
+  for (size_t p = 0; p < num_partitions; p++) {
+    PartitionCompactionStats comp;
+    if (p < partition_comp_stats_.size()) {
+      comp = partition_comp_stats_[p];
+    }
+    snprintf(buf, sizeof(buf),
+             "%9" ROCKSDB_PRIszt " %5" PRIu64 " %8.1f %7" PRIu64
+             " %8.2f %9.2f %9" PRIu64 "\n",
+             p, num_files[p], num_bytes[p] / kMB, read_amp[p],
+             comp.bytes_read / kGB, comp.bytes_written / kGB, comp.count);
+    value->append(buf);
+  }
+  return true;
+}
+
 bool InternalStats::HandleStats(std::string* value, Slice suffix) {
   if (!HandleCFStats(value, suffix)) {
     return false;
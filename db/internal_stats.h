@@ -321,6 +321,17 @@ class InternalStats {
     }
   };
 
+  // Compaction stats of one partition of the column family's
+  // sst_partitioner. Inputs and outputs are attributed to the partition of
+  // their smallest key.
+  struct PartitionCompactionStats {
+    uint64_t bytes_read = 0;
+    uint64_t bytes_written = 0;
+    uint64_t num_output_files = 0;
+    // Number of compactions that read or wrote files of the partition
+    uint64_t count = 0;
+  };
+
   void Clear() {
     for (int i = 0; i < kIntStatsNumMax; i++) {
       db_stats_[i].store(0);
@@ -335,6 +346,7 @@ class InternalStats {
     for (auto& h : file_read_latency_) {
       h.Clear();
     }
+    partition_comp_stats_.clear();
     cf_stats_snapshot_.Clear();
     db_stats_snapshot_.Clear();
     bg_error_count_ = 0;
@@ -351,6 +363,20 @@ class InternalStats {
     comp_stats_[level].bytes_moved += amount;
   }
 
+  // REQUIRES: DB mutex held
+  void AddPartitionCompactionStats(
+      const std::vector<PartitionCompactionStats>& stats) {
+    if (partition_comp_stats_.size() < stats.size()) {
+      partition_comp_stats_.resize(stats.size());
+    }
+    for (size_t i = 0; i < stats.size(); i++) {
+      partition_comp_stats_[i].bytes_read += stats[i].bytes_read;
+      partition_comp_stats_[i].bytes_written += stats[i].bytes_written;
+      partition_comp_stats_[i].num_output_files += stats[i].num_output_files;
+      partition_comp_stats_[i].count += stats[i].count;
+    }
+  }
+
   void AddCFStats(InternalCFStatsType type, uint64_t value) {
     cf_stats_value_[type] += value;
     ++cf_stats_count_[type];
@@ -424,6 +450,8 @@ class InternalStats {
   std::vector<CompactionStats> comp_stats_;
   std::vector<CompactionStats> comp_stats_by_pri_;
   std::vector<HistogramImpl> file_read_latency_;
+  // Per-partition compaction stats, indexed by sst_partitioner partition
+  std::vector<PartitionCompactionStats> partition_comp_stats_;
 
   // Used to compute per-interval statistics
   struct CFStatsSnapshot {
@@ -518,6 +546,8 @@ class InternalStats {
   bool HandleNumFilesAtLevel(std::string* value, Slice suffix);
   bool HandleCompressionRatioAtLevelPrefix(std::string* value, Slice suffix);
   bool HandleLevelStats(std::string* value, Slice suffix);
+  bool HandleSstPartitionStats(std::string* value, Slice suffix);
+  bool HandleManualCompactionProgress(std::string* value, Slice suffix);
   bool HandleStats(std::string* value, Slice suffix);
   bool HandleCFMapStats(std::map<std::string, std::string>* compaction_stats);
   bool HandleCFStats(std::string* value, Slice suffix);
@@ -658,6 +688,16 @@ class InternalStats {
 
   void IncBytesMoved(int /*level*/, uint64_t /*amount*/) {}
 
+  struct PartitionCompactionStats {
+    uint64_t bytes_read = 0;
+    uint64_t bytes_written = 0;
+    uint64_t num_output_files = 0;
+    uint64_t count = 0;
+  };
+
+  void AddPartitionCompactionStats(
+      const std::vector<PartitionCompactionStats>& /*stats*/) {}
+
   void AddCFStats(InternalCFStatsType /*type*/, uint64_t /*value*/) {}
 
   void AddDBStats(InternalDBStatsType /*type*/, uint64_t /*value*/,
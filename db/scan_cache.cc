@@ -0,0 +1,288 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/scan_cache.h"
+
+#include <algorithm>
+
+#include "rocksdb/write_batch.h"
+#include "util/mutexlock.h"
+
+namespace rocksdb {
+
+struct ScanCache::Entry {
+  uint32_t cf_id;
+  std::string start;
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  // Whether the entry covers the column family up to its end
+  bool complete;
+  size_t charge;
+  std::list<Entry*>::iterator lru_pos;
+};
+
+struct ScanCache::Fill {
+  uint32_t cf_id;
+  const Comparator* ucmp;
+  std::string start;
+  bool invalidated;
+  std::list<Fill*>::iterator pos;
+};
+
+class ScanCache::InvalidationHandler : public WriteBatch::Handler {
+ public:
+  explicit InvalidationHandler(ScanCache* cache) : cache_(cache) {}
+
+  Status PutCF(uint32_t column_family_id, const Slice& key,
+               const Slice& /*value*/) override {
+    cache_->InvalidateKeyLocked(column_family_id, key);
+    return Status::OK();
+  }
+
+  Status DeleteCF(uint32_t column_family_id, const Slice& key) override {
+    cache_->InvalidateKeyLocked(column_family_id, key);
+    return Status::OK();
+  }
+
+  Status SingleDeleteCF(uint32_t column_family_id, const Slice& key) override {
+    cache_->InvalidateKeyLocked(column_family_id, key);
+    return Status::OK();
+  }
+
+  Status DeleteRangeCF(uint32_t column_family_id, const Slice& begin_key,
+                       const Slice& end_key) override {
+    cache_->InvalidateRangeLocked(column_family_id, begin_key, end_key);
+    return Status::OK();
+  }
+
+  Status MergeCF(uint32_t column_family_id, const Slice& key,
+                 const Slice& /*value*/) override {
+    cache_->InvalidateKeyLocked(column_family_id, key);
+    return Status::OK();
+  }
+
+  Status PutBlobIndexCF(uint32_t column_family_id, const Slice& key,
+                        const Slice& /*value*/) override {
+    cache_->InvalidateKeyLocked(column_family_id, key);
+    return Status::OK();
+  }
+
+  Status MarkBeginPrepare(bool /*unprepared*/) override { return Status::OK(); }
+  Status MarkEndPrepare(const Slice& /*xid*/) override { return Status::OK(); }
+  Status MarkNoop(bool /*empty_batch*/) override { return Status::OK(); }
+  Status MarkRollback(const Slice& /*xid*/) override { return Status::OK(); }
+  Status MarkCommit(const Slice& /*xid*/) override { return Status::OK(); }
+
+ private:
+  ScanCache* cache_;
+};
+
+ScanCache::ScanCache(size_t capacity) : capacity_(capacity), usage_(0) {}
+
+ScanCache::~ScanCache() {
+  assert(fills_.empty());
+  for (Entry* entry : lru_) {
+    delete entry;
+  }
+}
+
+ScanCache::EntryMap::iterator ScanCache::FindCovering(
+    ColumnFamilyEntries* cf_entries, const Slice& user_key) {
+  EntryMap& entries = cf_entries->entries;
+  auto it = entries.upper_bound(user_key.ToString());
+  if (it == entries.begin()) {
+    return entries.end();
+  }
+  --it;
+  const Entry* entry = it->second;
+  if (entry->complete ||
+      cf_entries->ucmp->Compare(user_key, entry->keys.back()) <= 0) {
+    return it;
+  }
+  return entries.end();
+}
+
+bool ScanCache::Lookup(uint32_t cf_id, const Comparator* ucmp,
+                       const Slice& start, size_t limit,
+                       std::vector<std::string>* keys,
+                       std::vector<std::string>* values) {
+  MutexLock l(&mutex_);
+  auto cf_it = column_families_.find(cf_id);
+  if (cf_it == column_families_.end()) {
+    return false;
+  }
+  auto it = FindCovering(&cf_it->second, start);
+  if (it == cf_it->second.entries.end()) {
+    return false;
+  }
+  Entry* entry = it->second;
+  const size_t first =
+      std::lower_bound(entry->keys.begin(), entry->keys.end(), start,
+                       [ucmp](const std::string& key, const Slice& target) {
+                         return ucmp->Compare(key, target) < 0;
+                       }) -
+      entry->keys.begin();
+  const size_t available = entry->keys.size() - first;
+  if (available < limit && !entry->complete) {
+    return false;
+  }
+  const size_t count = std::min(available, limit);
+  keys->assign(entry->keys.begin() + first, entry->keys.begin() + first + count);
+  values->assign(entry->values.begin() + first,
+                 entry->values.begin() + first + count);
+  lru_.splice(lru_.end(), lru_, entry->lru_pos);
+  return true;
+}
+
+ScanCache::Fill* ScanCache::BeginFill(uint32_t cf_id, const Comparator* ucmp,
+                                      const Slice& start) {
+  Fill* fill = new Fill;
+  fill->cf_id = cf_id;
+  fill->ucmp = ucmp;
+  fill->start = start.ToString();
+  fill->invalidated = false;
+  MutexLock l(&mutex_);
+  fill->pos = fills_.insert(fills_.end(), fill);
+  return fill;
+}
+
+void ScanCache::EndFill(Fill* fill, bool ok,
+                        const std::vector<std::string>& keys,
+                        const std::vector<std::string>& values,
+                        bool complete) {
+  assert(keys.size() == values.size());
+  std::unique_ptr<Fill> fill_guard(fill);
+  size_t charge = sizeof(Entry) + fill->start.size();
+  for (size_t i = 0; i < keys.size(); i++) {
+    charge += 2 * sizeof(std::string) + keys[i].size() + values[i].size();
+  }
+  MutexLock l(&mutex_);
+  fills_.erase(fill->pos);
+  if (!ok || fill->invalidated || (keys.empty() && !complete) ||
+      charge > capacity_) {
+    return;
+  }
+
+  auto cf_it = column_families_.find(fill->cf_id);
+  if (cf_it == column_families_.end()) {
+    cf_it = column_families_
+                .emplace(fill->cf_id, ColumnFamilyEntries(fill->ucmp))
+                .first;
+  }
+  // Keeps the entries disjoint
+  const Slice last_key = complete ? Slice() : Slice(keys.back());
+  InvalidateOverlapping(&cf_it->second, fill->start,
+                        complete ? nullptr : &last_key);
+
+  Entry* entry = new Entry;
+  entry->cf_id = fill->cf_id;
+  entry->start = fill->start;
+  entry->keys = keys;
+  entry->values = values;
+  entry->complete = complete;
+  entry->charge = charge;
+  entry->lru_pos = lru_.insert(lru_.end(), entry);
+  cf_it->second.entries.emplace(entry->start, entry);
+  usage_ += charge;
+  EvictLocked();
+}
+
+void ScanCache::Invalidate(const WriteBatch& batch) {
+  InvalidationHandler handler(this);
+  MutexLock l(&mutex_);
+  batch.Iterate(&handler);
+}
+
+void ScanCache::InvalidateRange(uint32_t cf_id, const Slice& begin,
+                                const Slice& end) {
+  MutexLock l(&mutex_);
+  InvalidateRangeLocked(cf_id, begin, end);
+}
+
+void ScanCache::InvalidateColumnFamily(uint32_t cf_id) {
+  MutexLock l(&mutex_);
+  for (Fill* fill : fills_) {
+    if (fill->cf_id == cf_id) {
+      fill->invalidated = true;
+    }
+  }
+  auto cf_it = column_families_.find(cf_id);
+  if (cf_it == column_families_.end()) {
+    return;
+  }
+  EntryMap& entries = cf_it->second.entries;
+  while (!entries.empty()) {
+    Erase(&cf_it->second, entries.begin());
+  }
+  column_families_.erase(cf_it);
+}
+
+size_t ScanCache::GetUsage() const {
+  MutexLock l(&mutex_);
+  return usage_;
+}
+
+void ScanCache::InvalidateKeyLocked(uint32_t cf_id, const Slice& user_key) {
+  for (Fill* fill : fills_) {
+    if (fill->cf_id == cf_id && !fill->invalidated &&
+        fill->ucmp->Compare(user_key, fill->start) >= 0) {
+      fill->invalidated = true;
+    }
+  }
+  auto cf_it = column_families_.find(cf_id);
+  if (cf_it == column_families_.end()) {
+    return;
+  }
+  auto it = FindCovering(&cf_it->second, user_key);
+  if (it != cf_it->second.entries.end()) {
+    Erase(&cf_it->second, it);
+  }
+}
+
+void ScanCache::InvalidateRangeLocked(uint32_t cf_id, const Slice& begin,
+                                      const Slice& end) {
+  for (Fill* fill : fills_) {
+    if (fill->cf_id == cf_id && !fill->invalidated &&
+        fill->ucmp->Compare(end, fill->start) >= 0) {
+      fill->invalidated = true;
+    }
+  }
+  auto cf_it = column_families_.find(cf_id);
+  if (cf_it != column_families_.end()) {
+    InvalidateOverlapping(&cf_it->second, begin, &end);
+  }
+}
+
+void ScanCache::InvalidateOverlapping(ColumnFamilyEntries* cf_entries,
+                                      const Slice& begin, const Slice* end) {
+  EntryMap& entries = cf_entries->entries;
+  auto it = FindCovering(cf_entries, begin);
+  if (it != entries.end()) {
+    Erase(cf_entries, it);
+  }
+  it = entries.lower_bound(begin.ToString());
+  while (it != entries.end() &&
+         (end == nullptr || cf_entries->ucmp->Compare(it->first, *end) <= 0)) {
+    Erase(cf_entries, it++);
+  }
+}
+
+void ScanCache::Erase(ColumnFamilyEntries* cf_entries, EntryMap::iterator it) {
+  Entry* entry = it->second;
+  cf_entries->entries.erase(it);
+  lru_.erase(entry->lru_pos);
+  usage_ -= entry->charge;
+  delete entry;
+}
+
+void ScanCache::EvictLocked() {
+  while (usage_ > capacity_ && !lru_.empty()) {
+    const Entry* entry = lru_.front();
+    ColumnFamilyEntries* cf_entries = &column_families_.at(entry->cf_id);
+    Erase(cf_entries, cf_entries->entries.find(entry->start));
+  }
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,124 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/comparator.h"
+#include "rocksdb/slice.h"
+#include "util/kv_map.h"
+
+namespace rocksdb {
+
+class WriteBatch;
+
+// Caches the results of short scans of the latest state of column families,
+// see DB::Scan() and DBOptions::scan_cache_size.
+//
+// An entry holds the entries of a column family found by a scan from its
+// start key. It covers the user keys from its start key to its last key, or
+// to the end of the column family if the scan got to it, and answers any
+// later scan starting within that range, as long as enough of its entries
+// follow the start key. Entries of a column family never overlap: inserting
+// one drops the ones it overlaps.
+//
+// Entries are invalidated by the writes, range deletions, compactions and
+// file ingestions that touch the user keys they cover, once the change is
+// visible to new reads. To keep a scan from caching results that such a
+// change made stale while it was running, the scan registers itself with
+// BeginFill() before it gets its snapshot, and its results are dropped by
+// EndFill() if a change to keys at or after its start key was made visible
+// in the meantime.
+//
+// Entries are evicted in LRU order once their total charge exceeds the
+// capacity. Thread-safe.
+class ScanCache {
+ public:
+  struct Fill;
+
+  explicit ScanCache(size_t capacity);
+  ~ScanCache();
+
+  // No copying allowed
+  ScanCache(const ScanCache&) = delete;
+  void operator=(const ScanCache&) = delete;
+
+  // Sets *keys and *values to the first `limit` entries at or after `start`
+  // in the column family and returns true if an entry holds them. Returns
+  // false otherwise.
+  bool Lookup(uint32_t cf_id, const Comparator* ucmp, const Slice& start,
+              size_t limit, std::vector<std::string>* keys,
+              std::vector<std::string>* values);
+
+  // Registers a scan of the column family from `start`. Must be called
+  // before the scan gets its snapshot, and be followed by EndFill().
+  Fill* BeginFill(uint32_t cf_id, const Comparator* ucmp, const Slice& start);
+
+  // Inserts the results of the scan registered by `fill`, unless ok is
+  // false or they were invalidated since BeginFill(), and frees `fill`.
+  // complete tells whether the scan got to the end of the column family.
+  void EndFill(Fill* fill, bool ok, const std::vector<std::string>& keys,
+               const std::vector<std::string>& values, bool complete);
+
+  // Invalidates the entries covering keys written by the batch.
+  void Invalidate(const WriteBatch& batch);
+
+  // Invalidates the entries covering user keys in [begin, end].
+  void InvalidateRange(uint32_t cf_id, const Slice& begin, const Slice& end);
+
+  // Invalidates all the entries of the column family.
+  void InvalidateColumnFamily(uint32_t cf_id);
+
+  size_t GetCapacity() const { return capacity_; }
+
+  // Total charge of the entries.
+  size_t GetUsage() const;
+
+ private:
+  struct Entry;
+  class InvalidationHandler;
+  typedef std::map<std::string, Entry*, stl_wrappers::LessOfComparator>
+      EntryMap;
+
+  struct ColumnFamilyEntries {
+    explicit ColumnFamilyEntries(const Comparator* cmp)
+        : ucmp(cmp), entries(stl_wrappers::LessOfComparator(cmp)) {}
+
+    const Comparator* ucmp;
+    // By start key
+    EntryMap entries;
+  };
+
+  // Returns the entry covering user_key, or entries->end()
+  EntryMap::iterator FindCovering(ColumnFamilyEntries* cf_entries,
+                                  const Slice& user_key);
+  void InvalidateKeyLocked(uint32_t cf_id, const Slice& user_key);
+  void InvalidateRangeLocked(uint32_t cf_id, const Slice& begin,
+                             const Slice& end);
+  // Erases the entries covering user keys in [begin, *end], or from begin on
+  // if end is nullptr
+  void InvalidateOverlapping(ColumnFamilyEntries* cf_entries,
+                             const Slice& begin, const Slice* end);
+  void Erase(ColumnFamilyEntries* cf_entries, EntryMap::iterator it);
+  void EvictLocked();
+
+  const size_t capacity_;
+  mutable port::Mutex mutex_;
+  size_t usage_;
+  std::unordered_map<uint32_t, ColumnFamilyEntries> column_families_;
+  // Least recently used first
+  std::list<Entry*> lru_;
+  // Scans between BeginFill() and EndFill()
+  std::list<Fill*> fills_;
+};
+
+}  // namespace rocksdb
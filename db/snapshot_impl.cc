@@ -5,6 +5,7 @@
 
 #include "rocksdb/snapshot.h"
 
+#include "db/snapshot_impl.h"
 #include "rocksdb/db.h"
 
 namespace rocksdb {
@@ -23,4 +24,88 @@ ManagedSnapshot::~ManagedSnapshot() {
 
 const Snapshot* ManagedSnapshot::snapshot() { return snapshot_;}
 
+void SnapshotList::Delete(const SnapshotImpl* s) {
+  assert(s->list_ == this);
+  Shard* shard = shards_.AccessAtCore(s->shard_);
+  std::lock_guard<SpinMutex> lock(shard->mutex);
+  if (s->prev_ == nullptr) {
+    assert(shard->oldest == s);
+    shard->oldest = s->next_;
+    shard->oldest_seq.store(
+        s->next_ == nullptr ? kMaxSequenceNumber : s->next_->number_,
+        std::memory_order_relaxed);
+  } else {
+    s->prev_->next_ = s->next_;
+  }
+  if (s->next_ == nullptr) {
+    assert(shard->newest == s);
+    shard->newest = s->prev_;
+  } else {
+    s->next_->prev_ = s->prev_;
+  }
+  count_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void SnapshotList::GetAll(std::vector<SequenceNumber>* snap_vector,
+                          SequenceNumber* oldest_write_conflict_snapshot,
+                          const SequenceNumber& max_seq) const {
+  std::vector<SequenceNumber>& ret = *snap_vector;
+  // So far we have no use case that would pass a non-empty vector
+  assert(ret.size() == 0);
+
+  if (oldest_write_conflict_snapshot != nullptr) {
+    *oldest_write_conflict_snapshot = kMaxSequenceNumber;
+  }
+
+  for (size_t i = 0; i < shards_.Size(); ++i) {
+    Shard* shard = shards_.AccessAtCore(i);
+    size_t merged = ret.size();
+    {
+      std::lock_guard<SpinMutex> lock(shard->mutex);
+      for (const SnapshotImpl* s = shard->oldest;
+           s != nullptr && s->number_ <= max_seq; s = s->next_) {
+        // Avoid duplicates
+        if (ret.size() == merged || ret.back() != s->number_) {
+          ret.push_back(s->number_);
+        }
+        if (oldest_write_conflict_snapshot != nullptr &&
+            s->is_write_conflict_boundary_) {
+          *oldest_write_conflict_snapshot =
+              std::min(*oldest_write_conflict_snapshot, s->number_);
+        }
+      }
+    }
+    // The snapshots of each shard are sorted, merge them with the ones of
+    // the previous shards
+    std::inplace_merge(ret.begin(), ret.begin() + merged, ret.end());
+  }
+  ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+}
+
+SequenceNumber SnapshotList::GetOldest(SequenceNumber current_seq) const {
+  SequenceNumber oldest = current_seq;
+  for (size_t i = 0; i < shards_.Size(); ++i) {
+    Shard* shard = shards_.AccessAtCore(i);
+    std::lock_guard<SpinMutex> lock(shard->mutex);
+    if (shard->oldest != nullptr) {
+      oldest = std::min(oldest, shard->oldest->number_);
+    }
+  }
+  return oldest;
+}
+
+int64_t SnapshotList::GetOldestSnapshotTime() const {
+  SequenceNumber oldest_seq = kMaxSequenceNumber;
+  int64_t unix_time = 0;
+  for (size_t i = 0; i < shards_.Size(); ++i) {
+    Shard* shard = shards_.AccessAtCore(i);
+    std::lock_guard<SpinMutex> lock(shard->mutex);
+    if (shard->oldest != nullptr && shard->oldest->number_ < oldest_seq) {
+      oldest_seq = shard->oldest->number_;
+      unix_time = shard->oldest->unix_time_;
+    }
+  }
+  return unix_time;
+}
+
 }  // namespace rocksdb
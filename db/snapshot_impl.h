@@ -8,15 +8,21 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <vector>
 
+#include "db/dbformat.h"
 #include "rocksdb/db.h"
+#include "util/core_local.h"
+#include "util/mutexlock.h"
 
 namespace rocksdb {
 
 class SnapshotList;
 
-// Snapshots are kept in a doubly-linked list in the DB.
+// Snapshots are kept in per-core lists in the DB, see SnapshotList.
 // Each SnapshotImpl corresponds to a particular sequence number.
 class SnapshotImpl : public Snapshot {
  public:
@@ -31,11 +37,13 @@ class SnapshotImpl : public Snapshot {
  private:
   friend class SnapshotList;
 
-  // SnapshotImpl is kept in a doubly-linked circular list
+  // SnapshotImpl is kept in a doubly-linked list of its shard, from the
+  // oldest to the newest snapshot
   SnapshotImpl* prev_;
   SnapshotImpl* next_;
 
   SnapshotList* list_;                 // just for sanity checks
+  size_t shard_;
 
   int64_t unix_time_;
 
@@ -43,47 +51,54 @@ class SnapshotImpl : public Snapshot {
   bool is_write_conflict_boundary_;
 };
 
+// The snapshots of a DB, registered without the DB mutex.
+//
+// Snapshots are spread over shards picked by the core that takes them. Each
+// shard keeps its snapshots in a list ordered by sequence number under a
+// spin lock of its own, so taking and releasing snapshots on different cores
+// do not contend, and releasing a snapshot is O(1). The sequence number of a
+// new snapshot is read under the lock of its shard. Readers that lock the
+// shards one after the other, like GetAll() and GetOldest(), therefore only
+// miss snapshots that are at least as new as the last sequence number at the
+// time they started, as if the snapshots had been taken after they returned.
 class SnapshotList {
  public:
-  SnapshotList() {
-    list_.prev_ = &list_;
-    list_.next_ = &list_;
-    list_.number_ = 0xFFFFFFFFL;      // placeholder marker, for debugging
-    // Set all the variables to make UBSAN happy.
-    list_.list_ = nullptr;
-    list_.unix_time_ = 0;
-    list_.is_write_conflict_boundary_ = false;
-    count_ = 0;
-  }
+  SnapshotList() : count_(0) {}
 
   // No copy-construct.
   SnapshotList(const SnapshotList&) = delete;
 
-  bool empty() const { return list_.next_ == &list_; }
-  SnapshotImpl* oldest() const { assert(!empty()); return list_.next_; }
-  SnapshotImpl* newest() const { assert(!empty()); return list_.prev_; }
+  bool empty() const { return count() == 0; }
 
-  SnapshotImpl* New(SnapshotImpl* s, SequenceNumber seq, uint64_t unix_time,
-                    bool is_write_conflict_boundary) {
-    s->number_ = seq;
+  // Registers s with the sequence number returned by current_seq(), which
+  // must not decrease between calls.
+  template <typename SeqFunc>
+  SnapshotImpl* New(SnapshotImpl* s, const SeqFunc& current_seq,
+                    uint64_t unix_time, bool is_write_conflict_boundary) {
+    auto shard_and_idx = shards_.AccessElementAndIndex();
+    Shard* shard = shard_and_idx.first;
     s->unix_time_ = unix_time;
     s->is_write_conflict_boundary_ = is_write_conflict_boundary;
     s->list_ = this;
-    s->next_ = &list_;
-    s->prev_ = list_.prev_;
-    s->prev_->next_ = s;
-    s->next_->prev_ = s;
-    count_++;
+    s->shard_ = shard_and_idx.second;
+    s->next_ = nullptr;
+    std::lock_guard<SpinMutex> lock(shard->mutex);
+    s->number_ = current_seq();
+    s->prev_ = shard->newest;
+    if (shard->newest == nullptr) {
+      shard->oldest = s;
+      shard->oldest_seq.store(s->number_, std::memory_order_relaxed);
+    } else {
+      assert(shard->newest->number_ <= s->number_);
+      shard->newest->next_ = s;
+    }
+    shard->newest = s;
+    count_.fetch_add(1, std::memory_order_relaxed);
     return s;
   }
 
   // Do not responsible to free the object.
-  void Delete(const SnapshotImpl* s) {
-    assert(s->list_ == this);
-    s->prev_->next_ = s->next_;
-    s->next_->prev_ = s->prev_;
-    count_--;
-  }
+  void Delete(const SnapshotImpl* s);
 
   // retrieve all snapshot numbers up until max_seq. They are sorted in
   // ascending order (with no duplicates).
@@ -97,63 +112,42 @@ class SnapshotList {
 
   void GetAll(std::vector<SequenceNumber>* snap_vector,
               SequenceNumber* oldest_write_conflict_snapshot = nullptr,
-              const SequenceNumber& max_seq = kMaxSequenceNumber) const {
-    std::vector<SequenceNumber>& ret = *snap_vector;
-    // So far we have no use case that would pass a non-empty vector
-    assert(ret.size() == 0);
-
-    if (oldest_write_conflict_snapshot != nullptr) {
-      *oldest_write_conflict_snapshot = kMaxSequenceNumber;
-    }
-
-    if (empty()) {
-      return;
+              const SequenceNumber& max_seq = kMaxSequenceNumber) const;
+
+  // Returns the sequence number of the oldest snapshot, or current_seq if
+  // there is none. current_seq has to be read before the call, so that the
+  // result is never larger than the sequence number of a snapshot taken
+  // concurrently.
+  SequenceNumber GetOldest(SequenceNumber current_seq) const;
+
+  // Same as GetOldest(), but without locking the shards. The result may be
+  // larger than the sequence number of a snapshot taken concurrently.
+  SequenceNumber GetOldestHint(SequenceNumber current_seq) const {
+    SequenceNumber oldest = current_seq;
+    for (size_t i = 0; i < shards_.Size(); ++i) {
+      oldest = std::min(oldest, shards_.AccessAtCore(i)->oldest_seq.load(
+                                    std::memory_order_relaxed));
     }
-    const SnapshotImpl* s = &list_;
-    while (s->next_ != &list_) {
-      if (s->next_->number_ > max_seq) {
-        break;
-      }
-      // Avoid duplicates
-      if (ret.empty() || ret.back() != s->next_->number_) {
-        ret.push_back(s->next_->number_);
-      }
-
-      if (oldest_write_conflict_snapshot != nullptr &&
-          *oldest_write_conflict_snapshot == kMaxSequenceNumber &&
-          s->next_->is_write_conflict_boundary_) {
-        // If this is the first write-conflict boundary snapshot in the list,
-        // it is the oldest
-        *oldest_write_conflict_snapshot = s->next_->number_;
-      }
-
-      s = s->next_;
-    }
-    return;
-  }
-
-  // get the sequence number of the most recent snapshot
-  SequenceNumber GetNewest() {
-    if (empty()) {
-      return 0;
-    }
-    return newest()->number_;
+    return oldest;
   }
 
-  int64_t GetOldestSnapshotTime() const {
-    if (empty()) {
-      return 0;
-    } else {
-      return oldest()->unix_time_;
-    }
-  }
+  int64_t GetOldestSnapshotTime() const;
 
-  uint64_t count() const { return count_; }
+  uint64_t count() const { return count_.load(std::memory_order_relaxed); }
 
  private:
-  // Dummy head of doubly-linked list of snapshots
-  SnapshotImpl list_;
-  uint64_t count_;
+  struct Shard {
+    SpinMutex mutex;
+    SnapshotImpl* oldest = nullptr;
+    SnapshotImpl* newest = nullptr;
+    // Sequence number of oldest, kMaxSequenceNumber if the shard is empty
+    std::atomic<SequenceNumber> oldest_seq{kMaxSequenceNumber};
+    // Keeps shards on different cache lines
+    char padding[32];
+  };
+
+  CoreLocalArray<Shard> shards_;
+  std::atomic<uint64_t> count_;
 };
 
 }  // namespace rocksdb
@@ -658,4 +658,30 @@ uint64_t TableCache::ApproximateSize(
 
   return result;
 }
+
+Status TableCache::ApproximateKeyAnchors(
+    const ReadOptions& read_options, const FileDescriptor& fd,
+    size_t max_anchors, const InternalKeyComparator& internal_comparator,
+    std::vector<TableReader::Anchor>* anchors,
+    const SliceTransform* prefix_extractor) {
+  Status s;
+  TableReader* table_reader = fd.table_reader;
+  Cache::Handle* table_handle = nullptr;
+  if (table_reader == nullptr) {
+    s = FindTable(env_options_, internal_comparator, fd, &table_handle,
+                  prefix_extractor, read_options.read_tier == kBlockCacheTier);
+    if (s.ok()) {
+      table_reader = GetTableReaderFromHandle(table_handle);
+    }
+  }
+
+  if (s.ok()) {
+    s = table_reader->ApproximateKeyAnchors(read_options, max_anchors,
+                                            anchors);
+  }
+  if (table_handle != nullptr) {
+    ReleaseHandle(table_handle);
+  }
+  return s;
+}
 }  // namespace rocksdb
@@ -174,6 +174,14 @@ class TableCache {
                            const InternalKeyComparator& internal_comparator,
                            const SliceTransform* prefix_extractor = nullptr);
 
+  // Appends key anchors of a file represented by fd to *anchors, see
+  // TableReader::ApproximateKeyAnchors().
+  Status ApproximateKeyAnchors(const ReadOptions& read_options,
+                               const FileDescriptor& fd, size_t max_anchors,
+                               const InternalKeyComparator& internal_comparator,
+                               std::vector<TableReader::Anchor>* anchors,
+                               const SliceTransform* prefix_extractor = nullptr);
+
   // Release the handle from a cache
   void ReleaseHandle(Cache::Handle* handle);
 
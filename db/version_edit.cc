@@ -39,6 +39,7 @@ enum Tag : uint32_t {
   kMinLogNumberToKeep = 10,
   // Ignore-able field
   kDbId = kTagSafeIgnoreMask + 1,
+  kManualCompactionProgress = kTagSafeIgnoreMask + 2,
 
   // these are new formats divergent from open source leveldb
   kNewFile2 = 100,
@@ -117,6 +118,79 @@ void FileMetaData::UpdateBoundaries(const Slice& key, const Slice& value,
 #endif
 }
 
+namespace {
+// Flags of ManualCompactionProgress
+constexpr uint32_t kProgressActive = 1u << 0;
+constexpr uint32_t kProgressHasBegin = 1u << 1;
+constexpr uint32_t kProgressHasEnd = 1u << 2;
+constexpr uint32_t kProgressHasResumeKey = 1u << 3;
+}  // namespace
+
+void ManualCompactionProgress::EncodeTo(std::string* dst) const {
+  uint32_t flags = (active ? kProgressActive : 0u) |
+                   (has_begin ? kProgressHasBegin : 0u) |
+                   (has_end ? kProgressHasEnd : 0u) |
+                   (has_resume_key ? kProgressHasResumeKey : 0u);
+  PutVarint32Varint32(dst, flags, static_cast<uint32_t>(level));
+  if (has_begin) {
+    PutLengthPrefixedSlice(dst, begin);
+  }
+  if (has_end) {
+    PutLengthPrefixedSlice(dst, end);
+  }
+  if (has_resume_key) {
+    PutLengthPrefixedSlice(dst, resume_key);
+  }
+}
+
+bool ManualCompactionProgress::DecodeFrom(Slice* src) {
+  uint32_t flags = 0;
+  uint32_t encoded_level = 0;
+  if (!GetVarint32(src, &flags) || !GetVarint32(src, &encoded_level)) {
+    return false;
+  }
+  active = (flags & kProgressActive) != 0;
+  has_begin = (flags & kProgressHasBegin) != 0;
+  has_end = (flags & kProgressHasEnd) != 0;
+  has_resume_key = (flags & kProgressHasResumeKey) != 0;
+  level = static_cast<int>(encoded_level);
+  Slice str;
+  if (has_begin) {
+    if (!GetLengthPrefixedSlice(src, &str)) {
+      return false;
+    }
+    begin = str.ToString();
+  }
+  if (has_end) {
+    if (!GetLengthPrefixedSlice(src, &str)) {
+      return false;
+    }
+    end = str.ToString();
+  }
+  if (has_resume_key) {
+    if (!GetLengthPrefixedSlice(src, &str)) {
+      return false;
+    }
+    resume_key = str.ToString();
+  }
+  return true;
+}
+
+std::string ManualCompactionProgress::DebugString(bool hex_key) const {
+  if (!active) {
+    return "(none)";
+  }
+  std::string r = "range [";
+  r.append(has_begin ? Slice(begin).ToString(hex_key) : "(begin)");
+  r.append(", ");
+  r.append(has_end ? Slice(end).ToString(hex_key) : "(end)");
+  r.append("] level ");
+  AppendNumberTo(&r, level);
+  r.append(" from ");
+  r.append(has_resume_key ? Slice(resume_key).ToString(hex_key) : "(begin)");
+  return r;
+}
+
 void VersionEdit::Clear() {
   db_id_.clear();
   comparator_.clear();
@@ -135,6 +209,8 @@ void VersionEdit::Clear() {
   has_last_sequence_ = false;
   has_max_column_family_ = false;
   has_min_log_number_to_keep_ = false;
+  has_manual_compaction_progress_ = false;
+  manual_compaction_progress_ = ManualCompactionProgress();
   deleted_files_.clear();
   new_files_.clear();
   column_family_ = 0;
@@ -154,6 +230,13 @@ bool VersionEdit::EncodeTo(std::string* dst) const {
     PutVarint32(dst, kComparator);
     PutLengthPrefixedSlice(dst, comparator_);
   }
+  if (has_manual_compaction_progress_) {
+    // Length-prefixed so that older releases can skip it
+    std::string progress;
+    manual_compaction_progress_.EncodeTo(&progress);
+    PutVarint32(dst, kManualCompactionProgress);
+    PutLengthPrefixedSlice(dst, progress);
+  }
   if (has_log_number_) {
     PutVarint32Varint64(dst, kLogNumber, log_number_);
   }
@@ -406,6 +489,14 @@ Status VersionEdit::DecodeFrom(const Slice& src) {
           msg = "db id";
         }
         break;
+      case kManualCompactionProgress:
+        if (GetLengthPrefixedSlice(&input, &str) &&
+            manual_compaction_progress_.DecodeFrom(&str)) {
+          has_manual_compaction_progress_ = true;
+        } else {
+          msg = "manual compaction progress";
+        }
+        break;
       case kComparator:
         if (GetLengthPrefixedSlice(&input, &str)) {
           comparator_ = str.ToString();
@@ -628,6 +719,10 @@ std::string VersionEdit::DebugString(bool hex_key) const {
     r.append("\n  Comparator: ");
     r.append(comparator_);
   }
+  if (has_manual_compaction_progress_) {
+    r.append("\n  ManualCompactionProgress: ");
+    r.append(manual_compaction_progress_.DebugString(hex_key));
+  }
   if (has_log_number_) {
     r.append("\n  LogNumber: ");
     AppendNumberTo(&r, log_number_);
@@ -709,6 +804,10 @@ std::string VersionEdit::DebugJSON(int edit_num, bool hex_key) const {
   if (has_comparator_) {
     jw << "Comparator" << comparator_;
   }
+  if (has_manual_compaction_progress_) {
+    jw << "ManualCompactionProgress"
+       << manual_compaction_progress_.DebugString(hex_key);
+  }
   if (has_log_number_) {
     jw << "LogNumber" << log_number_;
   }
@@ -231,6 +231,40 @@ struct LevelFilesBrief {
   }
 };
 
+// Progress of a resumable manual compaction (CompactRangeOptions::resumable)
+// of a column family. It is persisted in the MANIFEST together with the
+// result of every compaction it runs, so that a CompactRange() interrupted by
+// a restart can continue where it left off.
+struct ManualCompactionProgress {
+  // False if no resumable manual compaction is in progress
+  bool active = false;
+  // The user key range passed to CompactRange(); a missing bound means the
+  // range is unbounded on that side.
+  bool has_begin = false;
+  bool has_end = false;
+  std::string begin;
+  std::string end;
+  // All input levels before `level` have been compacted. Within `level`,
+  // the keys before `resume_key` have been compacted if `has_resume_key`,
+  // otherwise none of them have.
+  int level = 0;
+  bool has_resume_key = false;
+  std::string resume_key;
+
+  // Returns true if this is the progress of a CompactRange() over
+  // [begin, end].
+  bool MatchesRange(const Slice* _begin, const Slice* _end) const {
+    return active && has_begin == (_begin != nullptr) &&
+           has_end == (_end != nullptr) &&
+           (!has_begin || begin == _begin->ToString()) &&
+           (!has_end || end == _end->ToString());
+  }
+
+  void EncodeTo(std::string* dst) const;
+  bool DecodeFrom(Slice* src);
+  std::string DebugString(bool hex_key) const;
+};
+
 // The state of a DB at any given time is referred to as a Version.
 // Any modification to the Version is considered a Version Edit. A Version is
 // constructed by joining a sequence of Version Edits. Version Edits are written
@@ -275,6 +309,18 @@ class VersionEdit {
     has_min_log_number_to_keep_ = true;
     min_log_number_to_keep_ = num;
   }
+  // Records the progress of a resumable manual compaction. An inactive
+  // `progress` records that the manual compaction has finished.
+  void SetManualCompactionProgress(const ManualCompactionProgress& progress) {
+    has_manual_compaction_progress_ = true;
+    manual_compaction_progress_ = progress;
+  }
+  bool has_manual_compaction_progress() const {
+    return has_manual_compaction_progress_;
+  }
+  const ManualCompactionProgress& manual_compaction_progress() const {
+    return manual_compaction_progress_;
+  }
 
   bool has_db_id() { return has_db_id_; }
 
@@ -392,6 +438,8 @@ class VersionEdit {
   bool has_last_sequence_;
   bool has_max_column_family_;
   bool has_min_log_number_to_keep_;
+  bool has_manual_compaction_progress_;
+  ManualCompactionProgress manual_compaction_progress_;
 
   DeletedFileSet deleted_files_;
   std::vector<std::pair<int, FileMetaData>> new_files_;
@@ -270,6 +270,36 @@ TEST_F(VersionEditTest, DbId) {
   TestEncodeDecode(edit);
 }
 
+TEST_F(VersionEditTest, ManualCompactionProgress) {
+  ManualCompactionProgress progress;
+  progress.active = true;
+  progress.has_end = true;
+  progress.end = "zoo";
+  progress.level = 2;
+  progress.has_resume_key = true;
+  progress.resume_key = "foo";
+  VersionEdit edit;
+  edit.SetManualCompactionProgress(progress);
+  TestEncodeDecode(edit);
+
+  std::string encoded;
+  edit.EncodeTo(&encoded);
+  VersionEdit parsed;
+  ASSERT_OK(parsed.DecodeFrom(encoded));
+  ASSERT_TRUE(parsed.has_manual_compaction_progress());
+  const ManualCompactionProgress& decoded = parsed.manual_compaction_progress();
+  Slice end("zoo");
+  ASSERT_TRUE(decoded.MatchesRange(nullptr, &end));
+  ASSERT_FALSE(decoded.MatchesRange(&end, &end));
+  ASSERT_EQ(2, decoded.level);
+  ASSERT_EQ("foo", decoded.resume_key);
+
+  // Finished compactions are recorded as inactive progress
+  edit.Clear();
+  edit.SetManualCompactionProgress(ManualCompactionProgress());
+  TestEncodeDecode(edit);
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -38,6 +38,7 @@
 #include "monitoring/persistent_stats_history.h"
 #include "rocksdb/env.h"
 #include "rocksdb/merge_operator.h"
+#include "rocksdb/sst_partitioner.h"
 #include "rocksdb/write_buffer_manager.h"
 #include "table/format.h"
 #include "table/get_context.h"
@@ -890,6 +891,7 @@ class LevelIterator final : public InternalIterator {
   void SeekToLast() override;
   void Next() final override;
   bool NextAndGetResult(IterateResult* result) override;
+  bool NextBatch(IterateBatch* batch, IterateResult* result) override;
   void Prev() override;
 
   bool Valid() const override { return file_iter_.Valid(); }
@@ -1117,6 +1119,20 @@ bool LevelIterator::NextAndGetResult(IterateResult* result) {
   return is_valid;
 }
 
+bool LevelIterator::NextBatch(IterateBatch* batch, IterateResult* result) {
+  assert(Valid());
+  // The batch does not go on in the next file, since opening it may add range
+  // tombstones that cover its entries.
+  file_iter_.NextBatch(batch);
+  SkipEmptyFileForward();
+  bool is_valid = Valid();
+  if (is_valid) {
+    result->key = key();
+    result->may_be_out_of_upper_bound = MayBeOutOfUpperBound();
+  }
+  return is_valid;
+}
+
 void LevelIterator::Prev() {
   assert(Valid());
   file_iter_.Prev();
@@ -2079,7 +2095,9 @@ void Version::PrepareApply(
   UpdateAccumulatedStats(update_stats);
   storage_info_.UpdateNumNonEmptyLevels();
   storage_info_.CalculateBaseBytes(*cfd_->ioptions(), mutable_cf_options);
-  storage_info_.UpdateFilesByCompactionPri(cfd_->ioptions()->compaction_pri);
+  storage_info_.UpdateFilesByCompactionPri(
+      cfd_->ioptions()->compaction_pri,
+      cfd_->ioptions()->sst_partitioner.get());
   storage_info_.GenerateFileIndexer();
   storage_info_.GenerateLevelFilesBrief();
   storage_info_.GenerateLevel0NonOverlapping();
@@ -2656,12 +2674,13 @@ void VersionStorageInfo::UpdateNumNonEmptyLevels() {
 }
 
 namespace {
-// Sort `temp` based on ratio of overlapping size over file size
-void SortFileByOverlappingRatio(
+// Calls `fn(file, overlapping_bytes)` for every file in `files`, where
+// overlapping_bytes is the total size of the files in `next_level_files`
+// overlapping the file's key range.
+template <typename Fn>
+void ForEachFileOverlappingBytes(
     const InternalKeyComparator& icmp, const std::vector<FileMetaData*>& files,
-    const std::vector<FileMetaData*>& next_level_files,
-    std::vector<Fsize>* temp) {
-  std::unordered_map<uint64_t, uint64_t> file_to_order;
+    const std::vector<FileMetaData*>& next_level_files, Fn fn) {
   auto next_level_it = next_level_files.begin();
 
   for (auto& file : files) {
@@ -2683,10 +2702,23 @@ void SortFileByOverlappingRatio(
       next_level_it++;
     }
 
-    assert(file->compensated_file_size != 0);
-    file_to_order[file->fd.GetNumber()] =
-        overlapping_bytes * 1024u / file->compensated_file_size;
+    fn(file, overlapping_bytes);
   }
+}
+
+// Sort `temp` based on ratio of overlapping size over file size
+void SortFileByOverlappingRatio(
+    const InternalKeyComparator& icmp, const std::vector<FileMetaData*>& files,
+    const std::vector<FileMetaData*>& next_level_files,
+    std::vector<Fsize>* temp) {
+  std::unordered_map<uint64_t, uint64_t> file_to_order;
+  ForEachFileOverlappingBytes(
+      icmp, files, next_level_files,
+      [&](FileMetaData* file, uint64_t overlapping_bytes) {
+        assert(file->compensated_file_size != 0);
+        file_to_order[file->fd.GetNumber()] =
+            overlapping_bytes * 1024u / file->compensated_file_size;
+      });
 
   std::sort(temp->begin(), temp->end(),
             [&](const Fsize& f1, const Fsize& f2) -> bool {
@@ -2694,10 +2726,94 @@ void SortFileByOverlappingRatio(
                      file_to_order[f2.file->fd.GetNumber()];
             });
 }
+
+// Sort `temp` so that files which are read-hot or dense with deletion
+// tombstones come first. Both boost the file's priority, while its ratio of
+// overlapping size in the next level over its own size lowers it as in
+// kMinOverlappingRatio.
+void SortFileByHeatAndTombstoneDensity(
+    const InternalKeyComparator& icmp, const std::vector<FileMetaData*>& files,
+    const std::vector<FileMetaData*>& next_level_files,
+    std::vector<Fsize>* temp) {
+  // A file consisting only of tombstones gets the same boost as one read
+  // kTombstoneWeight times per sampled MB.
+  const double kTombstoneWeight = 4.0;
+  const double kMB = 1048576.0;
+  std::unordered_map<uint64_t, double> file_to_priority;
+  ForEachFileOverlappingBytes(
+      icmp, files, next_level_files,
+      [&](FileMetaData* file, uint64_t overlapping_bytes) {
+        assert(file->compensated_file_size != 0);
+        double overlapping_ratio =
+            static_cast<double>(overlapping_bytes) /
+            static_cast<double>(file->compensated_file_size);
+        double tombstone_density =
+            file->num_entries > 0
+                ? static_cast<double>(file->num_deletions) /
+                      static_cast<double>(file->num_entries)
+                : 0.0;
+        double reads_per_mb =
+            static_cast<double>(
+                file->stats.num_reads_sampled.load(std::memory_order_relaxed)) /
+            (static_cast<double>(file->fd.GetFileSize()) / kMB + 1.0);
+        file_to_priority[file->fd.GetNumber()] =
+            (1.0 + reads_per_mb) *
+            (1.0 + kTombstoneWeight * tombstone_density) /
+            (1.0 + overlapping_ratio);
+      });
+
+  std::sort(temp->begin(), temp->end(),
+            [&](const Fsize& f1, const Fsize& f2) -> bool {
+              return file_to_priority[f1.file->fd.GetNumber()] >
+                     file_to_priority[f2.file->fd.GetNumber()];
+            });
+}
+
+// Stable-sort `temp` so that files of the partition whose data is the most
+// concentrated in this level relative to the next level come first. This
+// scores every partition of the sst_partitioner separately, so that hot
+// partitions are compacted before partitions whose data has already settled
+// into lower levels. Files are attributed to the partition of their smallest
+// key.
+void SortFileByPartitionScore(const SstPartitioner& partitioner,
+                              const std::vector<FileMetaData*>& files,
+                              const std::vector<FileMetaData*>& next_level_files,
+                              std::vector<Fsize>* temp) {
+  const size_t num_partitions = partitioner.NumPartitions();
+  if (num_partitions <= 1) {
+    return;
+  }
+  std::vector<uint64_t> level_bytes(num_partitions, 0);
+  std::vector<uint64_t> next_level_bytes(num_partitions, 0);
+  for (auto* f : files) {
+    level_bytes[partitioner.PartitionForKey(f->smallest.user_key())] +=
+        f->compensated_file_size;
+  }
+  for (auto* f : next_level_files) {
+    next_level_bytes[partitioner.PartitionForKey(f->smallest.user_key())] +=
+        f->compensated_file_size;
+  }
+  std::vector<double> score(num_partitions);
+  for (size_t p = 0; p < num_partitions; p++) {
+    score[p] = static_cast<double>(level_bytes[p]) /
+               static_cast<double>(next_level_bytes[p] + 1);
+  }
+
+  std::unordered_map<uint64_t, double> file_to_score;
+  for (auto* f : files) {
+    file_to_score[f->fd.GetNumber()] =
+        score[partitioner.PartitionForKey(f->smallest.user_key())];
+  }
+  std::stable_sort(temp->begin(), temp->end(),
+                   [&](const Fsize& f1, const Fsize& f2) -> bool {
+                     return file_to_score[f1.file->fd.GetNumber()] >
+                            file_to_score[f2.file->fd.GetNumber()];
+                   });
+}
 }  // namespace
 
 void VersionStorageInfo::UpdateFilesByCompactionPri(
-    CompactionPri compaction_pri) {
+    CompactionPri compaction_pri, const SstPartitioner* partitioner) {
   if (compaction_style_ == kCompactionStyleNone ||
       compaction_style_ == kCompactionStyleFIFO ||
       compaction_style_ == kCompactionStyleUniversal) {
@@ -2745,9 +2861,17 @@ void VersionStorageInfo::UpdateFilesByCompactionPri(
         SortFileByOverlappingRatio(*internal_comparator_, files_[level],
                                    files_[level + 1], &temp);
         break;
+      case kHotAndTombstoneDenseFirst:
+        SortFileByHeatAndTombstoneDensity(*internal_comparator_, files_[level],
+                                          files_[level + 1], &temp);
+        break;
       default:
         assert(false);
     }
+    if (partitioner != nullptr) {
+      SortFileByPartitionScore(*partitioner, files_[level], files_[level + 1],
+                               &temp);
+    }
     assert(temp.size() == files.size());
 
     // initialize files_by_compaction_pri_
@@ -3908,6 +4032,13 @@ Status VersionSet::ProcessManifestWrites(
           assert(version->cfd_->GetLogNumber() <= max_log_number_in_batch);
           version->cfd_->SetLogNumber(max_log_number_in_batch);
         }
+        for (const auto& e : batch_edits) {
+          if (e->has_manual_compaction_progress_ &&
+              e->column_family_ == cf_id) {
+            version->cfd_->SetManualCompactionProgress(
+                e->manual_compaction_progress_);
+          }
+        }
       }
 
       uint64_t last_min_log_number_to_keep = 0;
@@ -4222,6 +4353,9 @@ Status VersionSet::ExtractInfoFromVersionEdit(
         version_edit_params->SetLogNumber(from_edit.log_number_);
       }
     }
+    if (from_edit.has_manual_compaction_progress_) {
+      cfd->SetManualCompactionProgress(from_edit.manual_compaction_progress_);
+    }
     if (from_edit.has_comparator_ &&
         from_edit.comparator_ != cfd->user_comparator()->Name()) {
       return Status::InvalidArgument(
@@ -4981,6 +5115,9 @@ Status VersionSet::WriteCurrentStateToManifest(log::Writer* log) {
         }
       }
       edit.SetLogNumber(cfd->GetLogNumber());
+      if (cfd->manual_compaction_progress().active) {
+        edit.SetManualCompactionProgress(cfd->manual_compaction_progress());
+      }
       std::string record;
       if (!edit.EncodeTo(&record)) {
         return Status::Corruption(
@@ -64,6 +64,7 @@ class WriteBufferManager;
 class MergeContext;
 class ColumnFamilySet;
 class MergeIteratorBuilder;
+class SstPartitioner;
 
 // VersionEdit is always supposed to be valid and it is used to point at
 // entries in Manifest. Ideally it should not be used as a container to
@@ -177,8 +178,10 @@ class VersionStorageInfo {
   void GenerateLevelFilesBrief();
   // Sort all files for this version based on their file size and
   // record results in files_by_compaction_pri_. The largest files are listed
-  // first.
-  void UpdateFilesByCompactionPri(CompactionPri compaction_pri);
+  // first. If `partitioner` is given, files are additionally grouped by the
+  // compaction score of their partition.
+  void UpdateFilesByCompactionPri(CompactionPri compaction_pri,
+                                  const SstPartitioner* partitioner = nullptr);
 
   void GenerateLevel0NonOverlapping();
   bool level0_non_overlapping() const {
@@ -51,6 +51,7 @@
 #include "db/snapshot_impl.h"
 #include "db/trim_history_scheduler.h"
 #include "db/write_batch_internal.h"
+#include "db/write_seq_table.h"
 #include "monitoring/perf_context_imp.h"
 #include "monitoring/statistics.h"
 #include "rocksdb/merge_operator.h"
@@ -1196,6 +1197,8 @@ class MemTableInserter : public WriteBatch::Handler {
   // log number that all Memtables inserted into should reference
   uint64_t log_number_ref_;
   DBImpl* db_;
+  // Latest write sequence numbers of keys, nullptr unless the DB keeps them
+  WriteSeqTable* const write_seq_table_;
   const bool concurrent_memtable_writes_;
   bool       post_info_created_;
 
@@ -1282,6 +1285,7 @@ class MemTableInserter : public WriteBatch::Handler {
         recovering_log_number_(recovering_log_number),
         log_number_ref_(0),
         db_(static_cast_with_check<DBImpl, DB>(db)),
+        write_seq_table_(db_ != nullptr ? db_->write_seq_table() : nullptr),
         concurrent_memtable_writes_(concurrent_memtable_writes),
         post_info_created_(false),
         has_valid_writes_(has_valid_writes),
@@ -1395,6 +1399,18 @@ class MemTableInserter : public WriteBatch::Handler {
     return true;
   }
 
+  void RecordWriteSeq(uint32_t column_family_id, const Slice& key,
+                      ValueType value_type) {
+    if (write_seq_table_ == nullptr) {
+      return;
+    }
+    if (value_type == kTypeRangeDeletion) {
+      write_seq_table_->RecordRangeWrite(sequence_);
+    } else {
+      write_seq_table_->RecordWrite(column_family_id, key, sequence_);
+    }
+  }
+
   Status PutCFImpl(uint32_t column_family_id, const Slice& key,
                    const Slice& value, ValueType value_type) {
     // optimize for non-recovery mode
@@ -1418,6 +1434,7 @@ class MemTableInserter : public WriteBatch::Handler {
       return seek_status;
     }
     Status ret_status;
+    RecordWriteSeq(column_family_id, key, value_type);
 
     MemTable* mem = cf_mems_->GetMemTable();
     auto* moptions = mem->GetImmutableMemTableOptions();
@@ -1505,9 +1522,10 @@ class MemTableInserter : public WriteBatch::Handler {
     return PutCFImpl(column_family_id, key, value, kTypeValue);
   }
 
-  Status DeleteImpl(uint32_t /*column_family_id*/, const Slice& key,
+  Status DeleteImpl(uint32_t column_family_id, const Slice& key,
                     const Slice& value, ValueType delete_type) {
     Status ret_status;
+    RecordWriteSeq(column_family_id, key, delete_type);
     MemTable* mem = cf_mems_->GetMemTable();
     bool mem_res =
         mem->Add(sequence_, delete_type, key, value,
@@ -1670,6 +1688,7 @@ class MemTableInserter : public WriteBatch::Handler {
     }
 
     Status ret_status;
+    RecordWriteSeq(column_family_id, key, kTypeMerge);
     MemTable* mem = cf_mems_->GetMemTable();
     auto* moptions = mem->GetImmutableMemTableOptions();
     bool perform_merge = false;
@@ -0,0 +1,85 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/types.h"
+#include "util/hash.h"
+
+namespace rocksdb {
+
+// Fixed-size table of the sequence number of the latest write to the keys
+// hashed to each of its buckets, maintained by MemTableInserter. It tells
+// whether a key may have been written after a sequence number, independently
+// of how much memtable history is kept: keys sharing a bucket with a written
+// key, and every key of the DB after a range deletion, are reported as
+// written too. Used by OptimisticTransactionDB to check for conflicts, see
+// OptimisticTransactionDBOptions::occ_write_seq_buckets.
+//
+// Writes with sequence numbers up to the one the table is created with are
+// not recorded. Thread-safe.
+class WriteSeqTable {
+ public:
+  WriteSeqTable(size_t num_buckets, SequenceNumber created_seq)
+      : num_buckets_(num_buckets > 0 ? num_buckets : 1),
+        buckets_(new std::atomic<SequenceNumber>[num_buckets_]),
+        created_seq_(created_seq),
+        range_write_seq_(0) {
+    for (size_t i = 0; i < num_buckets_; i++) {
+      buckets_[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  // No copying allowed
+  WriteSeqTable(const WriteSeqTable&) = delete;
+  void operator=(const WriteSeqTable&) = delete;
+
+  void RecordWrite(uint32_t column_family_id, const Slice& key,
+                   SequenceNumber seq) {
+    RaiseTo(&buckets_[Bucket(column_family_id, key)], seq);
+  }
+
+  void RecordRangeWrite(SequenceNumber seq) { RaiseTo(&range_write_seq_, seq); }
+
+  // Returns true if the key may have been written with a sequence number
+  // larger than seq. *known is set to false if the table cannot tell because
+  // seq is older than the table.
+  bool MayHaveWrittenAfter(uint32_t column_family_id, const Slice& key,
+                           SequenceNumber seq, bool* known) const {
+    *known = seq >= created_seq_;
+    return seq < buckets_[Bucket(column_family_id, key)].load(
+                     std::memory_order_acquire) ||
+           seq < range_write_seq_.load(std::memory_order_acquire);
+  }
+
+ private:
+  size_t Bucket(uint32_t column_family_id, const Slice& key) const {
+    return fastrange64(NPHash64(key.data(), key.size(), column_family_id),
+                       num_buckets_);
+  }
+
+  // Writes of a write group can be inserted into the memtables out of
+  // sequence number order by concurrent memtable writers.
+  static void RaiseTo(std::atomic<SequenceNumber>* stamp, SequenceNumber seq) {
+    SequenceNumber cur = stamp->load(std::memory_order_relaxed);
+    while (cur < seq && !stamp->compare_exchange_weak(
+                            cur, seq, std::memory_order_acq_rel,
+                            std::memory_order_relaxed)) {
+    }
+  }
+
+  const size_t num_buckets_;
+  std::unique_ptr<std::atomic<SequenceNumber>[]> buckets_;
+  const SequenceNumber created_seq_;
+  // Sequence number of the latest range deletion, which could have deleted
+  // any key.
+  std::atomic<SequenceNumber> range_write_seq_;
+};
+
+}  // namespace rocksdb
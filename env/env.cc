@@ -420,6 +420,7 @@ void AssignEnvOptions(EnvOptions* env_options, const DBOptions& options) {
       options.writable_file_max_buffer_size;
   env_options->allow_fallocate = options.allow_fallocate;
   env_options->strict_bytes_per_sync = options.strict_bytes_per_sync;
+  env_options->max_async_writes_per_file = options.max_async_writes_per_file;
   options.env->SanitizeEnvOptions(env_options);
 }
 
@@ -431,11 +432,14 @@ EnvOptions Env::OptimizeForLogWrite(const EnvOptions& env_options,
   optimized_env_options.bytes_per_sync = db_options.wal_bytes_per_sync;
   optimized_env_options.writable_file_max_buffer_size =
       db_options.writable_file_max_buffer_size;
+  optimized_env_options.max_async_writes_per_file = 0;
   return optimized_env_options;
 }
 
 EnvOptions Env::OptimizeForManifestWrite(const EnvOptions& env_options) const {
-  return env_options;
+  EnvOptions optimized_env_options(env_options);
+  optimized_env_options.max_async_writes_per_file = 0;
+  return optimized_env_options;
 }
 
 EnvOptions Env::OptimizeForLogRead(const EnvOptions& env_options) const {
@@ -999,12 +999,12 @@ class PosixEnv : public Env {
 
   // Allow increasing the number of worker threads.
   void SetBackgroundThreads(int num, Priority pri) override {
-    assert(pri >= Priority::BOTTOM && pri <= Priority::HIGH);
+    assert(pri >= Priority::BOTTOM && pri <= Priority::USER);
     thread_pools_[pri].SetBackgroundThreads(num);
   }
 
   int GetBackgroundThreads(Priority pri) override {
-    assert(pri >= Priority::BOTTOM && pri <= Priority::HIGH);
+    assert(pri >= Priority::BOTTOM && pri <= Priority::USER);
     return thread_pools_[pri].GetBackgroundThreads();
   }
 
@@ -1015,12 +1015,12 @@ class PosixEnv : public Env {
 
   // Allow increasing the number of worker threads.
   void IncBackgroundThreadsIfNeeded(int num, Priority pri) override {
-    assert(pri >= Priority::BOTTOM && pri <= Priority::HIGH);
+    assert(pri >= Priority::BOTTOM && pri <= Priority::USER);
     thread_pools_[pri].IncBackgroundThreadsIfNeeded(num);
   }
 
   void LowerThreadPoolIOPriority(Priority pool = LOW) override {
-    assert(pool >= Priority::BOTTOM && pool <= Priority::HIGH);
+    assert(pool >= Priority::BOTTOM && pool <= Priority::USER);
 #ifdef OS_LINUX
     thread_pools_[pool].LowerIOPriority();
 #else
@@ -1029,7 +1029,7 @@ class PosixEnv : public Env {
   }
 
   void LowerThreadPoolCPUPriority(Priority pool = LOW) override {
-    assert(pool >= Priority::BOTTOM && pool <= Priority::HIGH);
+    assert(pool >= Priority::BOTTOM && pool <= Priority::USER);
 #ifdef OS_LINUX
     thread_pools_[pool].LowerCPUPriority();
 #else
@@ -1069,6 +1069,8 @@ class PosixEnv : public Env {
     optimized.fallocate_with_keep_size = true;
     optimized.writable_file_max_buffer_size =
         db_options.writable_file_max_buffer_size;
+    // A write is acknowledged once it is in the OS cache
+    optimized.max_async_writes_per_file = 0;
     return optimized;
   }
 
@@ -1078,6 +1080,8 @@ class PosixEnv : public Env {
     optimized.use_mmap_writes = false;
     optimized.use_direct_writes = false;
     optimized.fallocate_with_keep_size = true;
+    // Secondary instances read the live MANIFEST
+    optimized.max_async_writes_per_file = 0;
     return optimized;
   }
 
@@ -1160,7 +1164,7 @@ PosixEnv::PosixEnv()
 
 void PosixEnv::Schedule(void (*function)(void* arg1), void* arg, Priority pri,
                         void* tag, void (*unschedFunction)(void* arg)) {
-  assert(pri >= Priority::BOTTOM && pri <= Priority::HIGH);
+  assert(pri >= Priority::BOTTOM && pri <= Priority::USER);
   thread_pools_[pri].Schedule(function, arg, tag, unschedFunction);
 }
 
@@ -1169,7 +1173,7 @@ int PosixEnv::UnSchedule(void* arg, Priority pri) {
 }
 
 unsigned int PosixEnv::GetThreadPoolQueueLen(Priority pri) const {
-  assert(pri >= Priority::BOTTOM && pri <= Priority::HIGH);
+  assert(pri >= Priority::BOTTOM && pri <= Priority::USER);
   return thread_pools_[pri].GetQueueLen();
 }
 
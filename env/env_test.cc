@@ -883,6 +883,143 @@ TEST_F(EnvPosixTest, PositionedAppend) {
 }
 #endif  // !ROCKSDB_LITE
 
+TEST_F(EnvPosixTest, AsyncWrites) {
+  // Falls back to blocking writes without io_uring support
+  std::string fname = test::PerThreadDBPath(env_, "async_writes");
+  EnvOptions options;
+  options.use_mmap_writes = false;
+  options.max_async_writes_per_file = 4;
+  std::unique_ptr<WritableFile> writable_file;
+  ASSERT_OK(env_->NewWritableFile(fname, &writable_file, options));
+
+  Random rnd(301);
+  std::string expected_data;
+  std::string chunk;
+  for (int i = 0; i < 64; i++) {
+    // The file has to copy the chunk, which is overwritten right away
+    test::RandomString(&rnd, 1 + static_cast<int>(rnd.Uniform(8192)), &chunk);
+    ASSERT_OK(writable_file->Append(chunk));
+    expected_data += chunk;
+    ASSERT_OK(writable_file->Flush());
+    if (i % 8 == 7) {
+      ASSERT_OK(writable_file->RangeSync(0, expected_data.size()));
+    }
+    ASSERT_EQ(expected_data.size(), writable_file->GetFileSize());
+  }
+  ASSERT_OK(writable_file->Sync());
+  test::RandomString(&rnd, 100, &chunk);
+  ASSERT_OK(writable_file->Append(chunk));
+  expected_data += chunk;
+  ASSERT_OK(writable_file->Close());
+
+  std::string data;
+  ASSERT_OK(ReadFileToString(env_, fname, &data));
+  ASSERT_EQ(expected_data, data);
+  ASSERT_OK(env_->DeleteFile(fname));
+}
+
+TEST_F(EnvPosixTest, NoAsyncWritesForLogAndManifest) {
+  DBOptions db_options;
+  db_options.max_async_writes_per_file = 4;
+  EnvOptions options(db_options);
+  ASSERT_EQ(4U, options.max_async_writes_per_file);
+  ASSERT_EQ(0U, env_->OptimizeForLogWrite(options, db_options)
+                    .max_async_writes_per_file);
+  ASSERT_EQ(0U,
+            env_->OptimizeForManifestWrite(options).max_async_writes_per_file);
+}
+
+#if defined(ROCKSDB_IOURING_PRESENT) && !defined(NDEBUG)
+TEST_F(EnvPosixTest, AsyncWritesShortWrite) {
+  std::string fname = test::PerThreadDBPath(env_, "async_short_writes");
+  EnvOptions options;
+  options.use_mmap_writes = false;
+  options.max_async_writes_per_file = 4;
+  std::unique_ptr<WritableFile> writable_file;
+  ASSERT_OK(env_->NewWritableFile(fname, &writable_file, options));
+
+  // Report every write as half done, so the rest is written again with
+  // pwrite()
+  int num_results = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "PosixWritableFile::WaitForAsyncWrites:Result", [&](void* arg) {
+        int* res = static_cast<int*>(arg);
+        *res /= 2;
+        num_results++;
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Random rnd(301);
+  std::string expected_data;
+  std::string chunk;
+  for (int i = 0; i < 32; i++) {
+    test::RandomString(&rnd, 1 + static_cast<int>(rnd.Uniform(8192)), &chunk);
+    ASSERT_OK(writable_file->Append(chunk));
+    expected_data += chunk;
+  }
+  ASSERT_OK(writable_file->Close());
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  std::string data;
+  ASSERT_OK(ReadFileToString(env_, fname, &data));
+  ASSERT_EQ(expected_data, data);
+  ASSERT_OK(env_->DeleteFile(fname));
+  if (num_results == 0) {
+    fprintf(stderr, "io_uring is not supported, skipped\n");
+    return;
+  }
+  ASSERT_EQ(32, num_results);
+}
+
+TEST_F(EnvPosixTest, AsyncWritesError) {
+  std::string fname = test::PerThreadDBPath(env_, "async_write_error");
+  EnvOptions options;
+  options.use_mmap_writes = false;
+  options.max_async_writes_per_file = 2;
+  std::unique_ptr<WritableFile> writable_file;
+  ASSERT_OK(env_->NewWritableFile(fname, &writable_file, options));
+
+  // Fail the third write
+  int num_results = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "PosixWritableFile::WaitForAsyncWrites:Result", [&](void* arg) {
+        if (++num_results == 3) {
+          *static_cast<int*>(arg) = -EIO;
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  std::string chunk(4096, 'a');
+  Status s;
+  for (int i = 0; i < 8 && s.ok(); i++) {
+    s = writable_file->Append(chunk);
+  }
+  if (num_results == 0) {
+    SyncPoint::GetInstance()->DisableProcessing();
+    SyncPoint::GetInstance()->ClearAllCallBacks();
+    ASSERT_OK(writable_file->Close());
+    ASSERT_OK(env_->DeleteFile(fname));
+    fprintf(stderr, "io_uring is not supported, skipped\n");
+    return;
+  }
+  // The error is kept and returned by every later call
+  if (s.ok()) {
+    s = writable_file->Sync();
+  }
+  ASSERT_TRUE(s.IsIOError());
+  ASSERT_TRUE(writable_file->Append(chunk).IsIOError());
+  ASSERT_TRUE(writable_file->Flush().IsIOError());
+  ASSERT_TRUE(writable_file->Sync().IsIOError());
+  ASSERT_TRUE(writable_file->Close().IsIOError());
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  // Closed despite the error
+  writable_file.reset();
+  ASSERT_OK(env_->DeleteFile(fname));
+}
+#endif  // ROCKSDB_IOURING_PRESENT && !NDEBUG
+
 // `GetUniqueId()` temporarily returns zero on Windows. `BlockBasedTable` can
 // handle a return value of zero but this test case cannot.
 #ifndef OS_WIN
@@ -36,6 +36,7 @@
 #include "test_util/sync_point.h"
 #include "util/autovector.h"
 #include "util/coding.h"
+#include "util/mutexlock.h"
 #include "util/string_util.h"
 
 #if defined(OS_LINUX) && !defined(F_SET_RW_HINT)
@@ -946,6 +947,23 @@ PosixWritableFile::PosixWritableFile(const std::string& fname, int fd,
   sync_file_range_supported_ = IsSyncFileRangeSupported(fd_);
 #endif  // ROCKSDB_RANGESYNC_PRESENT
   assert(!options.use_mmap_writes);
+#if defined(ROCKSDB_IOURING_PRESENT)
+  async_ring_ = nullptr;
+  num_async_in_flight_ = 0;
+  if (options.max_async_writes_per_file > 0 && !use_direct_io_) {
+    async_ring_ = new struct io_uring;
+    int ret = io_uring_queue_init(
+        static_cast<unsigned int>(options.max_async_writes_per_file),
+        async_ring_, 0);
+    if (ret == 0) {
+      async_writes_.resize(options.max_async_writes_per_file);
+    } else {
+      // Platform doesn't support io_uring. Fall back to blocking writes.
+      delete async_ring_;
+      async_ring_ = nullptr;
+    }
+  }
+#endif  // defined(ROCKSDB_IOURING_PRESENT)
 }
 
 PosixWritableFile::~PosixWritableFile() {
@@ -959,6 +977,11 @@ Status PosixWritableFile::Append(const Slice& data) {
     assert(IsSectorAligned(data.size(), GetRequiredBufferAlignment()));
     assert(IsSectorAligned(data.data(), GetRequiredBufferAlignment()));
   }
+#if defined(ROCKSDB_IOURING_PRESENT)
+  if (async_ring_ != nullptr) {
+    return AppendAsync(data);
+  }
+#endif
   const char* src = data.data();
   size_t nbytes = data.size();
 
@@ -970,6 +993,131 @@ Status PosixWritableFile::Append(const Slice& data) {
   return Status::OK();
 }
 
+#if defined(ROCKSDB_IOURING_PRESENT)
+Status PosixWritableFile::AppendAsync(const Slice& data) {
+  MutexLock l(&async_mutex_);
+  if (!async_status_.ok() || data.empty()) {
+    return async_status_;
+  }
+  PosixAsyncWrite* write = GetFreeAsyncWrite();
+  if (write == nullptr) {
+    return async_status_;
+  }
+  // The caller may reuse its buffer as soon as Append() returns
+  if (write->capacity < data.size()) {
+    write->buf.reset(new char[data.size()]);
+    write->capacity = data.size();
+  }
+  memcpy(write->buf.get(), data.data(), data.size());
+  write->offset = filesize_;
+  write->len = data.size();
+  write->range_sync = false;
+  Status s = SubmitAsyncWrite(write);
+  if (s.ok()) {
+    filesize_ += data.size();
+  }
+  return s;
+}
+
+Status PosixWritableFile::RangeSyncAsync(uint64_t offset, uint64_t nbytes) {
+  MutexLock l(&async_mutex_);
+  if (!async_status_.ok()) {
+    return async_status_;
+  }
+  PosixAsyncWrite* write = GetFreeAsyncWrite();
+  if (write == nullptr) {
+    return async_status_;
+  }
+  write->offset = offset;
+  write->len = static_cast<size_t>(nbytes);
+  write->range_sync = true;
+  return SubmitAsyncWrite(write);
+}
+
+PosixAsyncWrite* PosixWritableFile::GetFreeAsyncWrite() {
+  if (num_async_in_flight_ == async_writes_.size()) {
+    WaitForAsyncWrites(async_writes_.size() - 1);
+  }
+  for (auto& write : async_writes_) {
+    if (!write.in_flight) {
+      return &write;
+    }
+  }
+  return nullptr;
+}
+
+Status PosixWritableFile::SubmitAsyncWrite(PosixAsyncWrite* write) {
+  // The ring has at least as many entries as requests can be in flight
+  struct io_uring_sqe* sqe = io_uring_get_sqe(async_ring_);
+  assert(sqe != nullptr);
+  if (write->range_sync) {
+    io_uring_prep_sync_file_range(sqe, fd_,
+                                  static_cast<unsigned int>(write->len),
+                                  write->offset, SYNC_FILE_RANGE_WRITE);
+  } else {
+    write->iov.iov_base = write->buf.get();
+    write->iov.iov_len = write->len;
+    io_uring_prep_writev(sqe, fd_, &write->iov, 1, write->offset);
+  }
+  io_uring_sqe_set_data(sqe, write);
+  int ret = io_uring_submit(async_ring_);
+  if (ret < 0) {
+    async_status_ = IOError("While submitting async write", filename_, -ret);
+    return async_status_;
+  }
+  write->in_flight = true;
+  num_async_in_flight_++;
+  return Status::OK();
+}
+
+void PosixWritableFile::WaitForAsyncWrites(size_t max_in_flight) {
+  while (num_async_in_flight_ > max_in_flight) {
+    struct io_uring_cqe* cqe;
+    int ret = io_uring_wait_cqe(async_ring_, &cqe);
+    if (ret == -EINTR) {
+      continue;
+    }
+    if (ret < 0) {
+      if (async_status_.ok()) {
+        async_status_ =
+            IOError("While waiting for async write", filename_, -ret);
+      }
+      return;
+    }
+    PosixAsyncWrite* write =
+        static_cast<PosixAsyncWrite*>(io_uring_cqe_get_data(cqe));
+    int res = cqe->res;
+    io_uring_cqe_seen(async_ring_, cqe);
+    TEST_SYNC_POINT_CALLBACK("PosixWritableFile::WaitForAsyncWrites:Result",
+                             &res);
+    write->in_flight = false;
+    num_async_in_flight_--;
+
+    Status s;
+    if (res < 0) {
+      s = IOError(write->range_sync ? "While sync_file_range"
+                                    : "While appending to file",
+                  filename_, -res);
+    } else if (!write->range_sync && static_cast<size_t>(res) < write->len) {
+      // Complete short writes synchronously
+      if (!PosixPositionedWrite(fd_, write->buf.get() + res, write->len - res,
+                                static_cast<off_t>(write->offset + res))) {
+        s = IOError("While appending to file", filename_, errno);
+      }
+    }
+    if (!s.ok() && async_status_.ok()) {
+      async_status_ = s;
+    }
+  }
+}
+
+Status PosixWritableFile::DrainAsyncWrites() {
+  MutexLock l(&async_mutex_);
+  WaitForAsyncWrites(0);
+  return async_status_;
+}
+#endif  // defined(ROCKSDB_IOURING_PRESENT)
+
 Status PosixWritableFile::PositionedAppend(const Slice& data, uint64_t offset) {
   if (use_direct_io()) {
     assert(IsSectorAligned(offset, GetRequiredBufferAlignment()));
@@ -977,6 +1125,14 @@ Status PosixWritableFile::PositionedAppend(const Slice& data, uint64_t offset) {
     assert(IsSectorAligned(data.data(), GetRequiredBufferAlignment()));
   }
   assert(offset <= static_cast<uint64_t>(std::numeric_limits<off_t>::max()));
+#if defined(ROCKSDB_IOURING_PRESENT)
+  if (async_ring_ != nullptr) {
+    Status s = DrainAsyncWrites();
+    if (!s.ok()) {
+      return s;
+    }
+  }
+#endif
   const char* src = data.data();
   size_t nbytes = data.size();
   if (!PosixPositionedWrite(fd_, src, nbytes, static_cast<off_t>(offset))) {
@@ -989,6 +1145,14 @@ Status PosixWritableFile::PositionedAppend(const Slice& data, uint64_t offset) {
 
 Status PosixWritableFile::Truncate(uint64_t size) {
   Status s;
+#if defined(ROCKSDB_IOURING_PRESENT)
+  if (async_ring_ != nullptr) {
+    s = DrainAsyncWrites();
+    if (!s.ok()) {
+      return s;
+    }
+  }
+#endif
   int r = ftruncate(fd_, size);
   if (r < 0) {
     s = IOError("While ftruncate file to size " + ToString(size), filename_,
@@ -1001,6 +1165,14 @@ Status PosixWritableFile::Truncate(uint64_t size) {
 
 Status PosixWritableFile::Close() {
   Status s;
+#if defined(ROCKSDB_IOURING_PRESENT)
+  if (async_ring_ != nullptr) {
+    s = DrainAsyncWrites();
+    io_uring_queue_exit(async_ring_);
+    delete async_ring_;
+    async_ring_ = nullptr;
+  }
+#endif
 
   size_t block_size;
   size_t last_allocated_block;
@@ -1054,9 +1226,28 @@ Status PosixWritableFile::Close() {
 }
 
 // write out the cached data to the OS cache
-Status PosixWritableFile::Flush() { return Status::OK(); }
+Status PosixWritableFile::Flush() {
+#if defined(ROCKSDB_IOURING_PRESENT)
+  // Async writes are not waited for, so that Flush() does not block. Files
+  // that have to be readable or survive a process crash after Flush(), like
+  // the WAL, are opened without async writes.
+  if (async_ring_ != nullptr) {
+    MutexLock l(&async_mutex_);
+    return async_status_;
+  }
+#endif
+  return Status::OK();
+}
 
 Status PosixWritableFile::Sync() {
+#if defined(ROCKSDB_IOURING_PRESENT)
+  if (async_ring_ != nullptr) {
+    Status s = DrainAsyncWrites();
+    if (!s.ok()) {
+      return s;
+    }
+  }
+#endif
   if (fdatasync(fd_) < 0) {
     return IOError("While fdatasync", filename_, errno);
   }
@@ -1064,6 +1255,14 @@ Status PosixWritableFile::Sync() {
 }
 
 Status PosixWritableFile::Fsync() {
+#if defined(ROCKSDB_IOURING_PRESENT)
+  if (async_ring_ != nullptr) {
+    Status s = DrainAsyncWrites();
+    if (!s.ok()) {
+      return s;
+    }
+  }
+#endif
   if (fsync(fd_) < 0) {
     return IOError("While fsync", filename_, errno);
   }
@@ -1137,6 +1336,12 @@ Status PosixWritableFile::RangeSync(uint64_t offset, uint64_t nbytes) {
   assert(offset <= static_cast<uint64_t>(std::numeric_limits<off_t>::max()));
   assert(nbytes <= static_cast<uint64_t>(std::numeric_limits<off_t>::max()));
   if (sync_file_range_supported_) {
+#if defined(ROCKSDB_IOURING_PRESENT)
+    // strict_bytes_per_sync has to wait for the previous writeback
+    if (async_ring_ != nullptr && !strict_bytes_per_sync_) {
+      return RangeSyncAsync(offset, nbytes);
+    }
+#endif
     int ret;
     if (strict_bytes_per_sync_) {
       // Specifying `SYNC_FILE_RANGE_WAIT_BEFORE` together with an offset/length
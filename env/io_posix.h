@@ -14,7 +14,10 @@
 #endif
 #include <unistd.h>
 #include <atomic>
+#include <memory>
 #include <string>
+#include <vector>
+#include "port/port.h"
 #include "rocksdb/env.h"
 #include "util/thread_local.h"
 
@@ -102,6 +105,19 @@ inline struct io_uring* CreateIOUring() {
   }
   return new_io_uring;
 }
+
+// A write of a copy of appended data, or a sync_file_range() request, that a
+// PosixWritableFile submits through its io_uring.
+struct PosixAsyncWrite {
+  std::unique_ptr<char[]> buf;
+  size_t capacity = 0;
+  // Range of the file that is written, or synced if range_sync is true.
+  uint64_t offset = 0;
+  size_t len = 0;
+  bool range_sync = false;
+  struct iovec iov;
+  bool in_flight = false;
+};
 #endif  // defined(ROCKSDB_IOURING_PRESENT)
 
 class PosixRandomAccessFile : public RandomAccessFile {
@@ -158,6 +174,33 @@ class PosixWritableFile : public WritableFile {
   // support it, so we need to do a dynamic check too.
   bool sync_file_range_supported_;
 #endif  // ROCKSDB_RANGESYNC_PRESENT
+#if defined(ROCKSDB_IOURING_PRESENT)
+  // Only set with EnvOptions::max_async_writes_per_file, see
+  // DBOptions::max_async_writes_per_file. The writes below are submitted
+  // through it, one per request that may be in flight.
+  struct io_uring* async_ring_;
+  std::vector<PosixAsyncWrite> async_writes_;
+  size_t num_async_in_flight_;
+  // First error of an async request, returned by all later calls.
+  Status async_status_;
+  // Protects the async members, since Sync() may be called concurrently
+  // with Append().
+  port::Mutex async_mutex_;
+
+  Status AppendAsync(const Slice& data);
+  Status RangeSyncAsync(uint64_t offset, uint64_t nbytes);
+  // Returns a request that is not in flight, waiting for one to complete if
+  // needed. Returns nullptr and sets async_status_ if waiting failed.
+  // REQUIRES: async_mutex_ held.
+  PosixAsyncWrite* GetFreeAsyncWrite();
+  // REQUIRES: async_mutex_ held.
+  Status SubmitAsyncWrite(PosixAsyncWrite* write);
+  // Reaps completions until at most max_in_flight requests are in flight.
+  // REQUIRES: async_mutex_ held.
+  void WaitForAsyncWrites(size_t max_in_flight);
+  // Waits for all requests and returns the first error of any request.
+  Status DrainAsyncWrites();
+#endif  // defined(ROCKSDB_IOURING_PRESENT)
 
  public:
   explicit PosixWritableFile(const std::string& fname, int fd,
@@ -30,6 +30,10 @@ Status RandomAccessFileReader::Read(uint64_t offset, size_t n, Slice* result,
                  true /*delay_enabled*/);
     auto prev_perf_level = GetPerfLevel();
     IOSTATS_TIMER_GUARD(read_nanos);
+    const bool rate_limit_user_read =
+        !for_compaction && rate_limiter_ != nullptr &&
+        rate_limiter_->IsRateLimited(RateLimiter::OpType::kRead,
+                                     RateLimiter::IOClass::kUserRead);
     if (use_direct_io()) {
 #ifndef ROCKSDB_LITE
       size_t alignment = file_->GetRequiredBufferAlignment();
@@ -47,6 +51,13 @@ Status RandomAccessFileReader::Read(uint64_t offset, size_t n, Slice* result,
           allowed = rate_limiter_->RequestToken(
               buf.Capacity() - buf.CurrentSize(), buf.Alignment(),
               Env::IOPriority::IO_LOW, stats_, RateLimiter::OpType::kRead);
+        } else if (rate_limit_user_read) {
+          sw.DelayStart();
+          allowed = rate_limiter_->RequestToken(
+              buf.Capacity() - buf.CurrentSize(), buf.Alignment(),
+              Env::IOPriority::IO_TOTAL, stats_, RateLimiter::OpType::kRead,
+              RateLimiter::IOClass::kUserRead);
+          sw.DelayStop();
         } else {
           assert(buf.CurrentSize() == 0);
           allowed = read_size;
@@ -97,6 +108,12 @@ Status RandomAccessFileReader::Read(uint64_t offset, size_t n, Slice* result,
           if (rate_limiter_->IsRateLimited(RateLimiter::OpType::kRead)) {
             sw.DelayStop();
           }
+        } else if (rate_limit_user_read) {
+          sw.DelayStart();
+          allowed = rate_limiter_->RequestToken(
+              n - pos, 0 /* alignment */, Env::IOPriority::IO_TOTAL, stats_,
+              RateLimiter::OpType::kRead, RateLimiter::IOClass::kUserRead);
+          sw.DelayStop();
         } else {
           allowed = n;
         }
@@ -157,6 +174,22 @@ Status RandomAccessFileReader::MultiRead(ReadRequest* read_reqs,
     auto prev_perf_level = GetPerfLevel();
     IOSTATS_TIMER_GUARD(read_nanos);
 
+    if (rate_limiter_ != nullptr &&
+        rate_limiter_->IsRateLimited(RateLimiter::OpType::kRead,
+                                     RateLimiter::IOClass::kUserRead)) {
+      // The reads are submitted at once, so they are granted beforehand
+      sw.DelayStart();
+      for (size_t i = 0; i < num_reqs; ++i) {
+        size_t left = read_reqs[i].len;
+        while (left > 0) {
+          left -= rate_limiter_->RequestToken(
+              left, 0 /* alignment */, Env::IOPriority::IO_TOTAL, stats_,
+              RateLimiter::OpType::kRead, RateLimiter::IOClass::kUserRead);
+        }
+      }
+      sw.DelayStop();
+    }
+
 #ifndef ROCKSDB_LITE
     FileOperationInfo::TimePoint start_ts;
     if (ShouldNotifyListeners()) {
@@ -263,6 +263,17 @@ Status WritableFileWriter::RangeSync(uint64_t offset, uint64_t nbytes) {
   return writable_file_->RangeSync(offset, nbytes);
 }
 
+size_t WritableFileWriter::RequestToken(size_t bytes, size_t alignment) {
+  if (has_io_class_) {
+    return rate_limiter_->RequestToken(
+        bytes, alignment, writable_file_->GetIOPriority(), stats_,
+        RateLimiter::OpType::kWrite, io_class_);
+  }
+  return rate_limiter_->RequestToken(bytes, alignment,
+                                     writable_file_->GetIOPriority(), stats_,
+                                     RateLimiter::OpType::kWrite);
+}
+
 // This method writes to disk the specified data and makes use of the rate
 // limiter if available
 Status WritableFileWriter::WriteBuffered(const char* data, size_t size) {
@@ -274,9 +285,7 @@ Status WritableFileWriter::WriteBuffered(const char* data, size_t size) {
   while (left > 0) {
     size_t allowed;
     if (rate_limiter_ != nullptr) {
-      allowed = rate_limiter_->RequestToken(
-          left, 0 /* alignment */, writable_file_->GetIOPriority(), stats_,
-          RateLimiter::OpType::kWrite);
+      allowed = RequestToken(left, 0 /* alignment */);
     } else {
       allowed = left;
     }
@@ -355,9 +364,7 @@ Status WritableFileWriter::WriteDirect() {
     // Check how much is allowed
     size_t size;
     if (rate_limiter_ != nullptr) {
-      size = rate_limiter_->RequestToken(left, buf_.Alignment(),
-                                         writable_file_->GetIOPriority(),
-                                         stats_, RateLimiter::OpType::kWrite);
+      size = RequestToken(left, buf_.Alignment());
     } else {
       size = left;
     }
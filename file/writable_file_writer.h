@@ -66,6 +66,8 @@ class WritableFileWriter {
   uint64_t last_sync_size_;
   uint64_t bytes_per_sync_;
   RateLimiter* rate_limiter_;
+  bool has_io_class_;
+  RateLimiter::IOClass io_class_;
   Statistics* stats_;
   std::vector<std::shared_ptr<EventListener>> listeners_;
 
@@ -88,6 +90,8 @@ class WritableFileWriter {
         last_sync_size_(0),
         bytes_per_sync_(options.bytes_per_sync),
         rate_limiter_(options.rate_limiter),
+        has_io_class_(false),
+        io_class_(RateLimiter::IOClass::kNumIOClasses),
         stats_(stats),
         listeners_() {
     TEST_SYNC_POINT_CALLBACK("WritableFileWriter::WritableFileWriter:0",
@@ -139,6 +143,14 @@ class WritableFileWriter {
 
   bool use_direct_io() { return writable_file_->use_direct_io(); }
 
+  // Tells the rate limiter the class of the writes to the file. Without it,
+  // the writes are only rate limited according to the IO priority of the
+  // file.
+  void SetIOClass(RateLimiter::IOClass io_class) {
+    has_io_class_ = true;
+    io_class_ = io_class;
+  }
+
   bool TEST_BufferIsEmpty() { return buf_.CurrentSize() == 0; }
 
  private:
@@ -151,5 +163,7 @@ class WritableFileWriter {
   Status WriteBuffered(const char* data, size_t size);
   Status RangeSync(uint64_t offset, uint64_t nbytes);
   Status SyncInternal(bool use_fsync);
+  // Returns how many of the bytes the rate limiter allows to write now.
+  size_t RequestToken(size_t bytes, size_t alignment);
 };
 }  // namespace rocksdb
@@ -54,6 +54,14 @@ enum CompactionPri : char {
   // and its size is the smallest. It in many cases can optimize write
   // amplification.
   kMinOverlappingRatio = 0x3,
+  // First compact files that are read-hot or dense with deletion tombstones,
+  // relative to their overlapping ratio with the next level. Read heat comes
+  // from the sampled number of reads of each file and tombstone density from
+  // the num_deletions/num_entries table properties. Try this for queue-like
+  // workloads where scans over tombstones become expensive long before the
+  // level size triggers a compaction. Read heat is sampled continuously but
+  // only taken into account whenever the LSM tree changes.
+  kHotAndTombstoneDenseFirst = 0x4,
 };
 
 struct CompactionOptionsFIFO {
@@ -417,6 +425,32 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through SetOptions() API
   int target_file_size_multiplier = 1;
 
+  // If true, level based compaction cuts an output file (other than in L0)
+  // as soon as its next key falls into a different file of the level below
+  // the output level, provided the output file has reached a minimum size.
+  // The minimum starts at half of the target file size and grows with the
+  // number of such files the output already overlaps, up to 90% of it.
+  // To reach a boundary, an output file may grow to twice the target file
+  // size. Aligning the output files with the files of the next level reduces
+  // the amount of data the next compaction has to rewrite.
+  //
+  // Default: false
+  //
+  // Dynamically changeable through SetOptions() API
+  bool level_compaction_dynamic_file_size = false;
+
+  // If true, a compaction loads into the block cache the data blocks of its
+  // output files that hold the keys of the data blocks of its input files
+  // found in the block cache, before the output files replace the input
+  // files. This keeps the reads of hot keys from missing the block cache
+  // right after the compaction, at the cost of reading those blocks in the
+  // compaction thread. Only supported by the block-based table format.
+  //
+  // Default: false
+  //
+  // Dynamically changeable through SetOptions() API
+  bool warm_hot_blocks_after_compaction = false;
+
   // If true, RocksDB will pick target size of each level dynamically.
   // We will pick a base level b >= 1. L0 will be directly merged into level b,
   // instead of always into level 1. Level 1 to b-1 need to be empty.
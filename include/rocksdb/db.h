@@ -10,6 +10,7 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -638,6 +639,22 @@ class DB {
     //      of files per level and total size of each level (MB).
     static const std::string kLevelStats;
 
+    //  "rocksdb.sst-partition-stats" - returns multi-line string containing,
+    //      for each partition of the column family's sst_partitioner, the
+    //      number of files and bytes it holds, the number of sorted runs a
+    //      read in it may have to consult (read amplification), and the bytes
+    //      read and written by compactions of it. Not supported if no
+    //      sst_partitioner is configured.
+    static const std::string kSstPartitionStats;
+
+    //  "rocksdb.manual-compaction-progress" - returns multi-line string
+    //      describing the CompactRange() with
+    //      CompactRangeOptions::resumable set that has not finished yet, if
+    //      any: the key range, the level and key it has got to, the bytes
+    //      compacted by the latest such call, the estimated bytes remaining
+    //      and an estimate of the time left.
+    static const std::string kManualCompactionProgress;
+
     //  "rocksdb.num-immutable-mem-table" - returns number of immutable
     //      memtables that have not yet been flushed.
     static const std::string kNumImmutableMemTable;
@@ -937,6 +954,65 @@ class DB {
     GetApproximateSizes(column_family, range, n, sizes, include_flags);
   }
 
+  // Splits the key range [*begin, *end) into sub-ranges holding about the
+  // same amount of data, for scanning them in parallel. begin == nullptr is
+  // treated as a key before all keys, and end == nullptr as a key after all
+  // keys. On success, *split_keys holds increasing user keys k[0..m-1]
+  // inside the range, which give the sub-ranges [*begin, k[0]),
+  // [k[0], k[1]), ..., [k[m-1], *end). There are at most num_partitions
+  // sub-ranges, and fewer if the range holds too little data to split.
+  //
+  // The split keys are sampled from the index blocks of the SST files of
+  // the current version, like the boundaries of subcompactions, and
+  // weighted by the size of the data blocks between them. Data in memtables
+  // is not taken into account.
+  virtual Status GetRangePartitions(ColumnFamilyHandle* /*column_family*/,
+                                    const Slice* /*begin*/,
+                                    const Slice* /*end*/,
+                                    size_t /*num_partitions*/,
+                                    std::vector<std::string>* /*split_keys*/) {
+    return Status::NotSupported("GetRangePartitions() is not implemented.");
+  }
+
+  // Scans the key range [*begin, *end) as partitioned by
+  // GetRangePartitions(), calling scan_fn once per sub-range. The sub-ranges
+  // are scanned by the calling thread and by jobs scheduled in the
+  // Env::Priority::USER thread pool, whose size is set with
+  // Env::SetBackgroundThreads(); with no thread in that pool, the calling
+  // thread scans them one after another. scan_fn is given the index of the
+  // sub-range and an iterator whose bounds are set to the sub-range; it must
+  // position the iterator, e.g. with SeekToFirst(), and must not keep it
+  // after returning. All the iterators read from the same snapshot,
+  // options.snapshot or one taken for the scan. The iterate_lower_bound and
+  // iterate_upper_bound of options are ignored.
+  //
+  // Returns the first error returned by scan_fn or an iterator, after all
+  // the sub-ranges are done.
+  virtual Status ParallelScan(
+      const ReadOptions& options, ColumnFamilyHandle* column_family,
+      const Slice* begin, const Slice* end, size_t num_partitions,
+      const std::function<Status(size_t partition, Iterator* iter)>& scan_fn);
+
+  // Sets *keys and *values to the first `limit` entries of the column family
+  // at or after `start`, as found by seeking an iterator created with
+  // options to `start` and moving it forward.
+  //
+  // With DBOptions::scan_cache_size set, the results of scans reading the
+  // latest state of the column family in total order, i.e. without a
+  // snapshot, iterator bounds, tailing or prefix seek, are served from the
+  // scan cache when possible, and added to it otherwise unless
+  // options.fill_cache is false. The tickers SCAN_CACHE_HIT and
+  // SCAN_CACHE_MISS count the lookups.
+  virtual Status Scan(const ReadOptions& options,
+                      ColumnFamilyHandle* column_family, const Slice& start,
+                      size_t limit, std::vector<std::string>* keys,
+                      std::vector<std::string>* values);
+  virtual Status Scan(const ReadOptions& options, const Slice& start,
+                      size_t limit, std::vector<std::string>* keys,
+                      std::vector<std::string>* values) {
+    return Scan(options, DefaultColumnFamily(), start, limit, keys, values);
+  }
+
   // Compact the underlying storage for the key range [*begin,*end].
   // The actual compaction interval might be superset of [*begin, *end].
   // In particular, deleted and overwritten versions are discarded,
@@ -126,6 +126,9 @@ struct EnvOptions {
   // See DBOptions doc
   size_t writable_file_max_buffer_size = 1024 * 1024;
 
+  // See DBOptions doc
+  size_t max_async_writes_per_file = 0;
+
   // If not nullptr, write rate limiting is enabled for flush and compaction
   RateLimiter* rate_limiter = nullptr;
 };
@@ -363,7 +366,9 @@ class Env {
     return Status::NotSupported("LoadLibrary is not implemented in this Env");
   }
 
-  // Priority for scheduling job in thread pool
+  // Priority for scheduling job in thread pool. The USER pool runs work on
+  // behalf of user calls, like the sub-range scans of DB::ParallelScan(),
+  // and has no thread unless set with SetBackgroundThreads().
   enum Priority { BOTTOM, LOW, HIGH, USER, TOTAL };
 
   static std::string PriorityToString(Priority priority);
@@ -82,6 +82,23 @@ class Iterator : public Cleanable {
   // REQUIRES: Valid()
   virtual Slice value() const = 0;
 
+  // Returns the current entry and the ones after it in keys[0, n) and
+  // values[0, n), and moves the iterator past them as if Next() was called
+  // n times. n is at most max_entries, and smaller only if the iterator
+  // became invalid, in which case status() should be checked. Returns 0 if
+  // the iterator is not valid.
+  //
+  // A key or value that stays valid as long as the iterator is alive, e.g.
+  // with ReadOptions::pin_data, is pinned without copying
+  // (PinnableSlice::IsPinned()). Others are copied into the PinnableSlice's
+  // own buffer, which is reused when the PinnableSlice is passed again.
+  //
+  // DB iterators let the iterator of one memtable or SST file at a time add
+  // a run of plain values, without a virtual call per entry.
+  // REQUIRES: keys and values have room for max_entries elements
+  virtual size_t NextBatch(size_t max_entries, PinnableSlice* keys,
+                           PinnableSlice* values);
+
   // If an error has occurred, return it.  Else return an ok status.
   // If non-blocking IO is requested and this operation cannot be
   // satisfied without doing some IO, then this returns Status::Incomplete().
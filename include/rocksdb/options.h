@@ -38,6 +38,7 @@ class ConcurrentTaskLimiter;
 class Env;
 enum InfoLogLevel : unsigned char;
 class SstFileManager;
+class SstPartitioner;
 class FilterPolicy;
 class Logger;
 class MergeOperator;
@@ -306,6 +307,15 @@ struct ColumnFamilyOptions : public AdvancedColumnFamilyOptions {
   // Default: nullptr
   std::shared_ptr<ConcurrentTaskLimiter> compaction_thread_limiter = nullptr;
 
+  // If non-nullptr, splits the key space into partitions that leveled
+  // compaction keeps apart: output files of compactions into L1 and below
+  // never contain keys from more than one partition, files are picked for
+  // compaction per partition, and per-partition stats are exposed through
+  // the "rocksdb.sst-partition-stats" property. See sst_partitioner.h.
+  //
+  // Default: nullptr
+  std::shared_ptr<SstPartitioner> sst_partitioner = nullptr;
+
   // Create ColumnFamilyOptions with default values for all fields
   ColumnFamilyOptions();
   // Create ColumnFamilyOptions from Options
@@ -578,6 +588,32 @@ struct DBOptions {
   // Default: -1
   int max_background_flushes = -1;
 
+  // If non-zero, the number of compactions that may run at the same time is
+  // adjusted every compaction_autoscale_period_sec seconds, between one and
+  // the limit derived from max_background_jobs (or
+  // max_background_compactions). Otherwise only one compaction runs at a time
+  // until writes are about to be slowed down, at which point the full limit
+  // is used at once.
+  //
+  // The limit is raised in proportion to the compaction debt of the worst
+  // column family, measured against the number of L0 files and estimated
+  // pending compaction bytes at which the full limit would be used anyway,
+  // and lowered as the debt is paid off. It is not raised while the
+  // rate_limiter, if any, is saturated. The LOW priority thread pool is grown
+  // as needed, and max_subcompactions is scaled down in proportion to the
+  // limit. Per column family compaction_thread_limiter limits still apply.
+  //
+  // Default: 0 (disabled)
+  unsigned int compaction_autoscale_period_sec = 0;
+
+  // If non-zero and compaction_autoscale_period_sec is set, the compaction
+  // limit is lowered whenever the 99th percentile latency of DB::Write()
+  // over the last period exceeds this many microseconds, unless the debt
+  // already requires the full limit.
+  //
+  // Default: 0 (foreground latency is not considered)
+  uint64_t compaction_autoscale_write_latency_micros = 0;
+
   // Specify the maximal size of the info log file. If the log file
   // is larger than `max_log_file_size`, a new info log file will
   // be created.
@@ -796,6 +832,22 @@ struct DBOptions {
   // Dynamically changeable through SetDBOptions() API.
   size_t writable_file_max_buffer_size = 1024 * 1024;
 
+  // If non-zero, SST files written with buffered IO submit their appends and
+  // bytes_per_sync range syncs through a per-file io_uring instead of
+  // blocking in write(), with up to this many requests in flight per file.
+  // Append() only blocks once that many requests are in flight; Sync(),
+  // Fsync() and Close() wait for all of them. Each write in flight holds a
+  // copy of its data. An error of a request is returned by the next
+  // Append(), Flush(), Sync() or Close() of the file.
+  // The WAL, MANIFEST and blob files keep blocking writes: they are read
+  // while they are written, and a WAL write has to survive a process crash
+  // once it is acknowledged.
+  // Ignored with direct IO, or if RocksDB was built without liburing or the
+  // kernel does not support io_uring.
+  //
+  // Default: 0 (disabled)
+  size_t max_async_writes_per_file = 0;
+
   // Use adaptive mutex, which spins in the user space before resorting
   // to kernel. This could reduce context switch when the mutex is not
   // heavily contended. However, if the mutex is hot, we could end up
@@ -990,6 +1042,15 @@ struct DBOptions {
   // Not supported in ROCKSDB_LITE mode!
   std::shared_ptr<Cache> row_cache = nullptr;
 
+  // If non-zero, DB::Scan() caches the results of scans reading the latest
+  // state of a column family, up to this many bytes, and serves later scans
+  // starting within the same key range from the cache. Cached results are
+  // dropped when writes, range deletions, compactions or file ingestions
+  // touch their key range. See DB::Scan().
+  // Not supported with unordered_write or two_write_queues.
+  // Default: 0 (disabled)
+  size_t scan_cache_size = 0;
+
 #ifndef ROCKSDB_LITE
   // A filter object supplied to be invoked while processing write-ahead-logs
   // (WALs) during recovery. The filter provides a way to inspect log
@@ -1271,6 +1332,14 @@ struct ReadOptions {
   // Default: false
   bool ignore_range_deletions;
 
+  // If true, iterators merge their memtable and SST file children with a
+  // loser tree instead of a binary heap when moving forward. A loser tree
+  // needs fewer key comparisons per Next() when there are many children
+  // (e.g. many L0 files) and keys interleave between them, but is slower
+  // when long runs of keys come from the same child.
+  // Default: false
+  bool use_loser_tree_merge;
+
   // A callback to determine whether relevant keys for this scan exist in a
   // given table based on the table's properties. The callback is passed the
   // properties of each table during iteration. If the callback returns false,
@@ -1453,6 +1522,14 @@ struct CompactRangeOptions {
   bool allow_write_stall = false;
   // If > 0, it will replace the option in the DBOptions for this compaction.
   uint32_t max_subcompactions = 0;
+  // If true, level based compaction records its progress in the MANIFEST
+  // after every compaction it runs, steps aside for automatic compactions
+  // between chunks of at most max_compaction_bytes, and a later CompactRange()
+  // over the same range with resumable set continues from the last recorded
+  // position, even across DB restarts. Data written to the range behind that
+  // position in the meantime is compacted down to it first. The progress is
+  // reported by the "rocksdb.manual-compaction-progress" property.
+  bool resumable = false;
 };
 
 // IngestExternalFileOptions is used by IngestExternalFile()
@@ -27,6 +27,21 @@ class RateLimiter {
     kWritesOnly,
     kAllIo,
   };
+  // Classes of I/O that a rate limiter may schedule differently, see
+  // NewWeightedRateLimiter().
+  enum class IOClass {
+    kUserRead = 0,
+    kWAL,
+    kFlush,
+    // Compactions whose inputs include L0 files
+    kL0Compaction,
+    // Other compactions that do not output to the bottommost level
+    kCompaction,
+    kBottommostCompaction,
+    // Copies of BackupEngine
+    kBackup,
+    kNumIOClasses,
+  };
 
   // For API compatibility, default to rate-limiting writes only.
   explicit RateLimiter(Mode mode = Mode::kWritesOnly) : mode_(mode) {}
@@ -70,6 +85,17 @@ class RateLimiter {
     }
   }
 
+  // Requests token to read or write bytes of io_class and potentially
+  // updates statistics. By default, the class is ignored.
+  //
+  // If this request can not be satisfied, the call is blocked. Caller is
+  // responsible to make sure bytes <= GetSingleBurstBytes().
+  virtual void Request(const int64_t bytes, const Env::IOPriority pri,
+                       Statistics* stats, OpType op_type,
+                       IOClass /* io_class */) {
+    Request(bytes, pri, stats, op_type);
+  }
+
   // Requests token to read or write bytes and potentially updates statistics.
   // Takes into account GetSingleBurstBytes() and alignment (e.g., in case of
   // direct I/O) to allocate an appropriate number of bytes, which may be less
@@ -78,6 +104,13 @@ class RateLimiter {
                               Env::IOPriority io_priority, Statistics* stats,
                               RateLimiter::OpType op_type);
 
+  // Same as above for I/O of io_class, which is only limited if
+  // IsRateLimited(op_type, io_class) is true, whatever io_priority is.
+  virtual size_t RequestToken(size_t bytes, size_t alignment,
+                              Env::IOPriority io_priority, Statistics* stats,
+                              RateLimiter::OpType op_type,
+                              RateLimiter::IOClass io_class);
+
   // Max bytes can be granted in a single burst
   virtual int64_t GetSingleBurstBytes() const = 0;
 
@@ -101,6 +134,15 @@ class RateLimiter {
     return true;
   }
 
+  // User reads and WAL writes are only limited by rate limiters that
+  // schedule I/O by class.
+  virtual bool IsRateLimited(OpType op_type, IOClass io_class) {
+    if (io_class == IOClass::kUserRead || io_class == IOClass::kWAL) {
+      return false;
+    }
+    return IsRateLimited(op_type);
+  }
+
  protected:
   Mode GetMode() { return mode_; }
 
@@ -136,4 +178,52 @@ extern RateLimiter* NewGenericRateLimiter(
     RateLimiter::Mode mode = RateLimiter::Mode::kWritesOnly,
     bool auto_tuned = false);
 
+// Options of NewWeightedRateLimiter().
+struct WeightedRateLimiterOptions {
+  struct IOClassOptions {
+    // Share of the rate granted to the class while other classes wait too,
+    // relative to the weights of the other waiting classes. 0 means the I/O
+    // of the class is not rate limited.
+    uint32_t weight = 0;
+    // Bytes per second granted to the class while it waits, before the rate
+    // is shared by weight. The guarantees of all classes should add up to
+    // less than the rate.
+    int64_t min_bytes_per_sec = 0;
+    // If positive, a class whose oldest request has waited for longer than
+    // this is granted before the rate is shared by weight.
+    int64_t max_queueing_delay_us = 0;
+  };
+
+  WeightedRateLimiterOptions();
+
+  // Total rate of the I/O of all classes.
+  int64_t rate_bytes_per_sec = 0;
+  // See NewGenericRateLimiter().
+  int64_t refill_period_us = 100 * 1000;
+  // Which types of operations count against the limit. Contrary to
+  // NewGenericRateLimiter(), reads count by default: user reads, and also
+  // compaction input reads, which are charged to kCompaction when
+  // DBOptions::new_table_reader_for_compaction_inputs is set. With
+  // kWritesOnly, neither is rate limited.
+  RateLimiter::Mode mode = RateLimiter::Mode::kAllIo;
+  // Indexed by RateLimiter::IOClass. By default, flushes, compactions and
+  // backups are weighted by urgency, and neither user reads nor WAL writes
+  // are rate limited.
+  IOClassOptions
+      io_classes[static_cast<int>(RateLimiter::IOClass::kNumIOClasses)];
+};
+
+// Create a RateLimiter object that shares a rate between the classes of I/O
+// of the DB: user reads, WAL writes, flushes, compactions and backups.
+// Contrary to the generic rate limiter, it also limits user reads of SST
+// files and WAL writes if their classes have a weight, and by default it
+// charges compaction input reads too, see WeightedRateLimiterOptions::mode.
+// The time requests of each class wait is recorded in the
+// RATE_LIMITER_DELAY_* histograms of the Statistics given with the
+// requests. Requests that do not tell their class, e.g. from
+// RateLimiter::Request(bytes, pri), count as kFlush with Env::IO_HIGH and
+// as kCompaction otherwise.
+extern RateLimiter* NewWeightedRateLimiter(
+    const WeightedRateLimiterOptions& options);
+
 }  // namespace rocksdb
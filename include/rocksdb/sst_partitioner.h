@@ -0,0 +1,55 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+
+namespace rocksdb {
+
+class Comparator;
+
+// SstPartitioner splits the user key space of a column family into a fixed
+// number of contiguous, non-overlapping key ranges ("partitions").
+//
+// When a partitioner is configured, compactions whose output level is not L0
+// never produce an SST file containing keys from more than one partition, the
+// leveled compaction picker prefers files of the partition whose shape is the
+// most out of balance at each level, and per-partition statistics are
+// reported through the "rocksdb.sst-partition-stats" property.
+//
+// The partition layout must not change for the lifetime of a column family
+// (other than by adding boundaries). Files written before the partitioner
+// was configured may still straddle boundaries; they are attributed to the
+// partition of their smallest key until they are rewritten.
+class SstPartitioner {
+ public:
+  virtual ~SstPartitioner() {}
+
+  // Returns a name that identifies this partitioner.
+  virtual const char* Name() const = 0;
+
+  // Total number of partitions. Must be at least one.
+  virtual size_t NumPartitions() const = 0;
+
+  // Returns the partition in [0, NumPartitions()) that owns `user_key`.
+  // REQUIRES: for any two keys a <= b in the column family's comparator
+  // order, PartitionForKey(a) <= PartitionForKey(b).
+  virtual size_t PartitionForKey(const Slice& user_key) const = 0;
+};
+
+// Returns a partitioner splitting the key space at `boundaries`, which must
+// be sorted in increasing order by `comparator`. boundaries[i] is the
+// smallest user key of partition i + 1, so N boundaries create N + 1
+// partitions. A nullptr comparator means BytewiseComparator().
+extern std::shared_ptr<SstPartitioner> NewKeyRangeSstPartitioner(
+    const std::vector<std::string>& boundaries,
+    const Comparator* comparator = nullptr);
+
+}  // namespace rocksdb
@@ -340,6 +340,16 @@ enum Tickers : uint32_t {
   BLOCK_CACHE_COMPRESSION_DICT_ADD,
   BLOCK_CACHE_COMPRESSION_DICT_BYTES_INSERT,
   BLOCK_CACHE_COMPRESSION_DICT_BYTES_EVICT,
+
+  // # of times the range filter was checked on an iterator seek with an
+  // upper bound.
+  RANGE_FILTER_CHECKED,
+  // # of times the range filter showed that a table had no key in range.
+  RANGE_FILTER_USEFUL,
+
+  // # of DB::Scan() calls served from / not found in the scan cache.
+  SCAN_CACHE_HIT,
+  SCAN_CACHE_MISS,
   TICKER_ENUM_MAX
 };
 
@@ -430,6 +440,16 @@ enum Histograms : uint32_t {
   FLUSH_TIME,
   SST_BATCH_SIZE,
 
+  // Time requests wait for the weighted rate limiter, per
+  // RateLimiter::IOClass, in the same order.
+  RATE_LIMITER_DELAY_USER_READ_MICROS,
+  RATE_LIMITER_DELAY_WAL_MICROS,
+  RATE_LIMITER_DELAY_FLUSH_MICROS,
+  RATE_LIMITER_DELAY_L0_COMPACTION_MICROS,
+  RATE_LIMITER_DELAY_COMPACTION_MICROS,
+  RATE_LIMITER_DELAY_BOTTOMMOST_COMPACTION_MICROS,
+  RATE_LIMITER_DELAY_BACKUP_MICROS,
+
   HISTOGRAM_ENUM_MAX,
 };
 
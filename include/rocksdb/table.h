@@ -119,6 +119,16 @@ struct BlockBasedTableOptions {
     // slice, and you need to call Valid()/status() afterwards.
     // TODO(kolmike): Fix it.
     kBinarySearchWithFirstKey = 0x03,
+
+    // Like kBinarySearch, but the table also stores a small piecewise linear
+    // model of the index keys, which predicts the position of a key in the
+    // index within a few restart points. Index seeks then only binary search
+    // these restart points, which saves most of the key comparisons, and
+    // cache misses, of seeks in large index blocks. The model is only built
+    // for BytewiseComparator, and not if too many consecutive restart points
+    // of the index share their first 8 bytes; the index is then searched
+    // like kBinarySearch.
+    kLearnedIndexSearch = 0x04,
   };
 
   IndexType index_type = kBinarySearch;
@@ -132,9 +142,22 @@ struct BlockBasedTableOptions {
   DataBlockIndexType data_block_index_type = kDataBlockBinarySearch;
 
   // #entries/#buckets. It is valid only when data_block_hash_index_type is
-  // kDataBlockBinaryAndHash.
+  // kDataBlockBinaryAndHash, or hash_index_partitions is true.
   double data_block_hash_table_util_ratio = 0.75;
 
+  // If true and index_type is kTwoLevelIndexSearch, each index partition gets
+  // a hash table mapping the user keys of the data blocks it indexes to the
+  // restart point of their index entry. Seeks in the partition, and so
+  // point lookups, then find the index entry of a key in the table with a
+  // hash probe and two key comparisons instead of a binary search; other
+  // keys, and keys whose hash collides, fall back to the binary search. The
+  // hash table takes 2 bytes per bucket, and counts towards
+  // metadata_block_size, so partitions index fewer data blocks and the top
+  // level index, which has no hash table, gets larger.
+  // This option only affects newly written tables, which older versions of
+  // RocksDB cannot read.
+  bool hash_index_partitions = false;
+
   // This option is now deprecated. No matter what value it is set to,
   // it will behave as if hash_index_allow_collision=true.
   bool hash_index_allow_collision = true;
@@ -246,7 +269,7 @@ struct BlockBasedTableOptions {
   // Default: 0 (disabled)
   uint32_t read_amp_bytes_per_bit = 0;
 
-  // We currently have five versions:
+  // We currently have seven versions:
   // 0 -- This version is currently written out by all RocksDB's versions by
   // default.  Can be read by really old RocksDB's. Doesn't support changing
   // checksum (default is CRC32).
@@ -272,6 +295,11 @@ struct BlockBasedTableOptions {
   // 5 -- Can be read by RocksDB's versions since 6.6.0. Full and partitioned
   // filters use a generally faster and more accurate Bloom filter
   // implementation, with a different schema.
+  // 6 -- Can be read by RocksDB's versions since 6.7.0. With
+  // BytewiseComparator, data and index blocks store the first 8 bytes of
+  // the key at each restart point in a fixed-width array, so that seeks
+  // narrow down the restart interval without decoding keys. This adds 8
+  // bytes per restart point.
   uint32_t format_version = 2;
 
   // Store index blocks on disk in compressed format. Changing this option to
@@ -316,6 +344,15 @@ struct BlockBasedTableOptions {
 
   IndexShorteningMode index_shortening =
       IndexShorteningMode::kShortenSeparators;
+
+  // If true, tables get a range filter meta block, which lets iterator seeks
+  // with ReadOptions::iterate_upper_bound skip a table that has no key in
+  // [seek key, upper bound) without reading its index or data blocks. It
+  // stores the shortest prefixes that tell the table's user keys apart, with
+  // prefix compression, and is held in memory while the table is open.
+  // Only used with BytewiseComparator.
+  // This option only affects newly written tables.
+  bool range_filter = false;
 };
 
 // Table Properties that are specific to block-based table properties.
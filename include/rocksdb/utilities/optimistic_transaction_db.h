@@ -31,6 +31,38 @@ struct OptimisticTransactionOptions {
   const Comparator* cmp = BytewiseComparator();
 };
 
+enum class OccValidationPolicy {
+  // Validate the transaction on the write thread, after it entered the write
+  // group. Transactions are validated one at a time and their writes are not
+  // batched with other writes.
+  kValidateSerial = 0,
+  // Validate the transaction before it enters the write group, holding the
+  // lock buckets of its keys. Transactions on disjoint lock buckets are
+  // validated concurrently and their writes are batched in the write group.
+  // Only conflicts with other transactions of the same DB are guaranteed to
+  // be detected: a write made directly to the DB between the validation and
+  // the commit of a transaction on the same key goes unnoticed.
+  kValidateParallel = 1
+};
+
+struct OptimisticTransactionDBOptions {
+  OccValidationPolicy validate_policy = OccValidationPolicy::kValidateSerial;
+
+  // Number of lock buckets keys are hashed to with kValidateParallel. More
+  // buckets make it less likely that transactions on different keys wait for
+  // each other, at the cost of a mutex per bucket.
+  uint32_t occ_lock_buckets = (1 << 20);
+
+  // If non-zero, the sequence number of the latest write to the keys hashed
+  // to each of this many buckets is kept in a table of 8 bytes per bucket,
+  // and conflicts are checked against it instead of against the memtables.
+  // Memtable history is then not needed (see
+  // max_write_buffer_size_to_maintain), and is not enabled by Open(). Keys
+  // sharing a bucket with a key written since they were tracked, and all
+  // keys after a DeleteRange(), are reported as conflicting.
+  size_t occ_write_seq_buckets = 0;
+};
+
 class OptimisticTransactionDB : public StackableDB {
  public:
   // Open an OptimisticTransactionDB similar to DB::Open().
@@ -42,6 +74,13 @@ class OptimisticTransactionDB : public StackableDB {
                      std::vector<ColumnFamilyHandle*>* handles,
                      OptimisticTransactionDB** dbptr);
 
+  static Status Open(const DBOptions& db_options,
+                     const OptimisticTransactionDBOptions& occ_options,
+                     const std::string& dbname,
+                     const std::vector<ColumnFamilyDescriptor>& column_families,
+                     std::vector<ColumnFamilyHandle*>* handles,
+                     OptimisticTransactionDB** dbptr);
+
   virtual ~OptimisticTransactionDB() {}
 
   // Starts a new Transaction.
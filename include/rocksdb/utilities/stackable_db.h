@@ -193,6 +193,14 @@ class StackableDB : public DB {
     return db_->NewIterators(options, column_families, iterators);
   }
 
+  using DB::Scan;
+  virtual Status Scan(
+      const ReadOptions& options, ColumnFamilyHandle* column_family,
+      const Slice& start, size_t limit, std::vector<std::string>* keys,
+      std::vector<std::string>* values) override {
+    return db_->Scan(options, column_family, start, limit, keys, values);
+  }
+
   virtual const Snapshot* GetSnapshot() override { return db_->GetSnapshot(); }
 
   virtual void ReleaseSnapshot(const Snapshot* snapshot) override {
@@ -231,6 +239,15 @@ class StackableDB : public DB {
     return db_->GetApproximateSizes(options, column_family, r, n, sizes);
   }
 
+  virtual Status GetRangePartitions(ColumnFamilyHandle* column_family,
+                                    const Slice* begin, const Slice* end,
+                                    size_t num_partitions,
+                                    std::vector<std::string>* split_keys)
+      override {
+    return db_->GetRangePartitions(column_family, begin, end, num_partitions,
+                                   split_keys);
+  }
+
   using DB::GetApproximateMemTableStats;
   virtual void GetApproximateMemTableStats(ColumnFamilyHandle* column_family,
                                            const Range& range,
@@ -464,6 +464,26 @@ class Transaction {
                                 const Slice& key) = 0;
   virtual void UndoGetForUpdate(const Slice& key) = 0;
 
+  // Exclusively locks every key k of the column family with start <= k <= end
+  // according to the comparator of the column family, including keys that do
+  // not exist yet. Other transactions can neither lock nor write such keys,
+  // nor lock an overlapping range, until this transaction commits or rolls
+  // back. RollbackToSavePoint() does not release range locks.
+  //
+  // Unlike GetForUpdate(), no snapshot validation is done for the keys in the
+  // range, and the keys are not tracked individually.
+  //
+  // Status::OK() on success,
+  // Status::Busy() if a deadlock was detected,
+  // Status::TimedOut() if the lock could not be acquired in time,
+  // Status::InvalidArgument() if start is greater than end,
+  // Status::NotSupported() if range locks are not supported by this
+  // transaction, e.g. if it was created by an OptimisticTransactionDB.
+  virtual Status GetRangeLock(ColumnFamilyHandle* /*column_family*/,
+                              const Slice& /*start*/, const Slice& /*end*/) {
+    return Status::NotSupported("Range locks are not supported");
+  }
+
   virtual Status RebuildFromWriteBatch(WriteBatch* src_batch) = 0;
 
   virtual WriteBatch* GetCommitTimeWriteBatch() = 0;
@@ -31,6 +31,13 @@ enum TxnDBWritePolicy {
   WRITE_UNPREPARED  // write data before the prepare phase of 2pc
 };
 
+enum TxnDBLockManager {
+  // Hash maps split into stripes that each have a mutex and a condvar
+  STRIPED_LOCK_MANAGER = 0,
+  // Open-addressed hash tables with a wait queue per key
+  SCALABLE_LOCK_MANAGER,
+};
+
 const uint32_t kInitialMaxDeadlocks = 5;
 
 struct TransactionDBOptions {
@@ -86,6 +93,15 @@ struct TransactionDBOptions {
   // tell apart committed from uncommitted data.
   TxnDBWritePolicy write_policy = TxnDBWritePolicy::WRITE_COMMITTED;
 
+  // The implementation of the key locks of pessimistic transactions.
+  // STRIPED_LOCK_MANAGER protects each of the num_stripes parts of the lock
+  // table of a column family with one mutex and wakes up every waiter of a
+  // stripe whenever one of its keys is unlocked. SCALABLE_LOCK_MANAGER keeps
+  // a wait queue per key, only wakes up the waiters that can make progress,
+  // and takes uncontended exclusive locks without a mutex; it ignores
+  // num_stripes and custom_mutex_factory.
+  TxnDBLockManager lock_manager = TxnDBLockManager::STRIPED_LOCK_MANAGER;
+
   // TODO(myabandeh): remove this option
   // Note: this is a temporary option as a hot fix in rollback of writeprepared
   // txns in myrocks. MyRocks uses merge operands for autoinc column id without
@@ -180,6 +196,16 @@ struct TransactionOptions {
   int64_t write_batch_flush_threshold = -1;
 };
 
+struct ReadOnlyTransactionOptions {
+  // Duration in milliseconds of the lease on the view of the DB that a
+  // ReadOnlyTransaction reads from. Once it has passed, reads fail with
+  // Status::Expired(), and a background thread of the TransactionDB releases
+  // the memtables and SST files that the view pinned within about 100ms,
+  // whether or not the transaction is read from again. If negative, they stay
+  // pinned until the transaction is deleted.
+  int64_t lease = -1;
+};
+
 // The per-write optimizations that do not involve transactions. TransactionDB
 // implementation might or might not make use of the specified optimizations.
 struct TransactionDBWriteOptimizations {
@@ -223,6 +249,65 @@ struct DeadlockPath {
   bool empty() { return path.empty() && !limit_exceeded; }
 };
 
+// A transaction that only reads, from a consistent view of the column
+// families it was started with. Unlike a Transaction with a snapshot, it does
+// not register a snapshot with the DB: the view is kept by referencing the
+// memtables and SST files that were current when the transaction started,
+// together with the sequence number they contain the data of. Compactions are
+// therefore free to drop the key versions it reads from new files, but the
+// files it reads from are kept until the lease of the transaction expires or
+// the transaction is deleted.
+//
+// With WRITE_PREPARED and WRITE_UNPREPARED, reads fail with
+// Status::TryAgain() once the commit cache has evicted entries newer than the
+// view, and iterators are not supported.
+//
+// Not thread-safe. Iterators hold their own references to the files they
+// read, and can be used after the lease has expired.
+class ReadOnlyTransaction {
+ public:
+  virtual ~ReadOnlyTransaction() {}
+
+  // Reads key at the sequence number of the transaction.
+  // options.snapshot must be null, and column_family must be one of the
+  // column families the transaction was started with.
+  virtual Status Get(const ReadOptions& options,
+                     ColumnFamilyHandle* column_family, const Slice& key,
+                     PinnableSlice* value) = 0;
+
+  virtual Status Get(const ReadOptions& options,
+                     ColumnFamilyHandle* column_family, const Slice& key,
+                     std::string* value) {
+    assert(value != nullptr);
+    PinnableSlice pinnable_val(value);
+    assert(!pinnable_val.IsPinned());
+    auto s = Get(options, column_family, key, &pinnable_val);
+    if (s.ok() && pinnable_val.IsPinned()) {
+      value->assign(pinnable_val.data(), pinnable_val.size());
+    }  // else value is already assigned
+    return s;
+  }
+
+  virtual std::vector<Status> MultiGet(
+      const ReadOptions& options,
+      const std::vector<ColumnFamilyHandle*>& column_family,
+      const std::vector<Slice>& keys, std::vector<std::string>* values) = 0;
+
+  // Returns an iterator over column_family at the sequence number of the
+  // transaction. The caller is responsible for deleting it.
+  virtual Iterator* GetIterator(const ReadOptions& options,
+                                ColumnFamilyHandle* column_family) = 0;
+
+  // Sequence number of the view the transaction reads from.
+  virtual SequenceNumber GetSequenceNumber() const = 0;
+
+ protected:
+  ReadOnlyTransaction() {}
+  // No copying allowed
+  ReadOnlyTransaction(const ReadOnlyTransaction&) = delete;
+  void operator=(const ReadOnlyTransaction&) = delete;
+};
+
 class TransactionDB : public StackableDB {
  public:
   // Optimized version of ::Write that receives more optimization request such
@@ -286,6 +371,19 @@ class TransactionDB : public StackableDB {
       const TransactionOptions& txn_options = TransactionOptions(),
       Transaction* old_txn = nullptr) = 0;
 
+  // Starts a new ReadOnlyTransaction over column_families, or over the
+  // default column family if column_families is empty. Returns nullptr if the
+  // TransactionDB does not support read-only transactions.
+  //
+  // Caller is responsible for deleting the returned transaction when no
+  // longer needed.
+  virtual ReadOnlyTransaction* BeginReadOnlyTransaction(
+      const ReadOnlyTransactionOptions& /*txn_options*/ =
+          ReadOnlyTransactionOptions(),
+      const std::vector<ColumnFamilyHandle*>& /*column_families*/ = {}) {
+    return nullptr;
+  }
+
   virtual Transaction* GetTransactionByName(const TransactionName& name) = 0;
   virtual void GetAllPreparedTransactions(std::vector<Transaction*>* trans) = 0;
 
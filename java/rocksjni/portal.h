@@ -4226,6 +4226,8 @@ class CompactionPriorityJni {
         return 0x2;
       case rocksdb::CompactionPri::kMinOverlappingRatio:
         return 0x3;
+      case rocksdb::CompactionPri::kHotAndTombstoneDenseFirst:
+        return 0x4;
       default:
         return 0x0;  // undefined
     }
@@ -4244,6 +4246,8 @@ class CompactionPriorityJni {
         return rocksdb::CompactionPri::kOldestSmallestSeqFirst;
       case 0x3:
         return rocksdb::CompactionPri::kMinOverlappingRatio;
+      case 0x4:
+        return rocksdb::CompactionPri::kHotAndTombstoneDenseFirst;
       default:
         // undefined/default
         return rocksdb::CompactionPri::kByCompensatedSize;
@@ -4622,6 +4626,14 @@ class TickerTypeJni {
         return -0x0C;
       case rocksdb::Tickers::TXN_GET_TRY_AGAIN:
         return -0x0D;
+      case rocksdb::Tickers::RANGE_FILTER_CHECKED:
+        return -0x0E;
+      case rocksdb::Tickers::RANGE_FILTER_USEFUL:
+        return -0x0F;
+      case rocksdb::Tickers::SCAN_CACHE_HIT:
+        return -0x10;
+      case rocksdb::Tickers::SCAN_CACHE_MISS:
+        return -0x11;
       case rocksdb::Tickers::TICKER_ENUM_MAX:
         // 0x5F for backwards compatibility on current minor version.
         return 0x5F;
@@ -4916,6 +4928,14 @@ class TickerTypeJni {
         return rocksdb::Tickers::TXN_SNAPSHOT_MUTEX_OVERHEAD;
       case -0x0D:
         return rocksdb::Tickers::TXN_GET_TRY_AGAIN;
+      case -0x0E:
+        return rocksdb::Tickers::RANGE_FILTER_CHECKED;
+      case -0x0F:
+        return rocksdb::Tickers::RANGE_FILTER_USEFUL;
+      case -0x10:
+        return rocksdb::Tickers::SCAN_CACHE_HIT;
+      case -0x11:
+        return rocksdb::Tickers::SCAN_CACHE_MISS;
       case 0x5F:
         // 0x5F for backwards compatibility on current minor version.
         return rocksdb::Tickers::TICKER_ENUM_MAX;
@@ -5028,6 +5048,21 @@ class HistogramTypeJni {
         return 0x2D;
       case rocksdb::Histograms::BLOB_DB_DECOMPRESSION_MICROS:
         return 0x2E;
+      case rocksdb::Histograms::RATE_LIMITER_DELAY_USER_READ_MICROS:
+        return 0x2F;
+      case rocksdb::Histograms::RATE_LIMITER_DELAY_WAL_MICROS:
+        return 0x30;
+      case rocksdb::Histograms::RATE_LIMITER_DELAY_FLUSH_MICROS:
+        return 0x31;
+      case rocksdb::Histograms::RATE_LIMITER_DELAY_L0_COMPACTION_MICROS:
+        return 0x32;
+      case rocksdb::Histograms::RATE_LIMITER_DELAY_COMPACTION_MICROS:
+        return 0x33;
+      case rocksdb::Histograms::
+          RATE_LIMITER_DELAY_BOTTOMMOST_COMPACTION_MICROS:
+        return 0x34;
+      case rocksdb::Histograms::RATE_LIMITER_DELAY_BACKUP_MICROS:
+        return 0x35;
       case rocksdb::Histograms::HISTOGRAM_ENUM_MAX:
         // 0x1F for backwards compatibility on current minor version.
         return 0x1F;
@@ -5135,6 +5170,21 @@ class HistogramTypeJni {
         return rocksdb::Histograms::BLOB_DB_COMPRESSION_MICROS;
       case 0x2E:
         return rocksdb::Histograms::BLOB_DB_DECOMPRESSION_MICROS;
+      case 0x2F:
+        return rocksdb::Histograms::RATE_LIMITER_DELAY_USER_READ_MICROS;
+      case 0x30:
+        return rocksdb::Histograms::RATE_LIMITER_DELAY_WAL_MICROS;
+      case 0x31:
+        return rocksdb::Histograms::RATE_LIMITER_DELAY_FLUSH_MICROS;
+      case 0x32:
+        return rocksdb::Histograms::RATE_LIMITER_DELAY_L0_COMPACTION_MICROS;
+      case 0x33:
+        return rocksdb::Histograms::RATE_LIMITER_DELAY_COMPACTION_MICROS;
+      case 0x34:
+        return rocksdb::Histograms::
+            RATE_LIMITER_DELAY_BOTTOMMOST_COMPACTION_MICROS;
+      case 0x35:
+        return rocksdb::Histograms::RATE_LIMITER_DELAY_BACKUP_MICROS;
       case 0x1F:
         // 0x1F for backwards compatibility on current minor version.
         return rocksdb::Histograms::HISTOGRAM_ENUM_MAX;
@@ -5910,6 +5960,8 @@ class IndexTypeJni {
        return 0x2;
      case rocksdb::BlockBasedTableOptions::IndexType::kBinarySearchWithFirstKey:
        return 0x3;
+     case rocksdb::BlockBasedTableOptions::IndexType::kLearnedIndexSearch:
+       return 0x4;
      default:
        return 0x7F;  // undefined
    }
@@ -5929,6 +5981,8 @@ class IndexTypeJni {
      case 0x3:
        return rocksdb::BlockBasedTableOptions::IndexType::
            kBinarySearchWithFirstKey;
+     case 0x4:
+       return rocksdb::BlockBasedTableOptions::IndexType::kLearnedIndexSearch;
      default:
        // undefined/default
        return rocksdb::BlockBasedTableOptions::IndexType::kBinarySearch;
@@ -33,7 +33,13 @@ public enum CompactionPriority {
    * and its size is the smallest. It in many cases can optimize write
    * amplification.
    */
-  MinOverlappingRatio((byte)0x3);
+  MinOverlappingRatio((byte)0x3),
+
+  /**
+   * First compact files that are read-hot or dense with deletion tombstones,
+   * relative to their overlapping ratio with the next level.
+   */
+  HotAndTombstoneDenseFirst((byte)0x4);
 
 
   private final byte value;
@@ -159,6 +159,41 @@ public enum HistogramType {
    */
   BLOB_DB_DECOMPRESSION_MICROS((byte) 0x2E),
 
+  /**
+   * Time user reads wait for the weighted rate limiter.
+   */
+  RATE_LIMITER_DELAY_USER_READ_MICROS((byte) 0x2F),
+
+  /**
+   * Time WAL writes wait for the weighted rate limiter.
+   */
+  RATE_LIMITER_DELAY_WAL_MICROS((byte) 0x30),
+
+  /**
+   * Time flushes wait for the weighted rate limiter.
+   */
+  RATE_LIMITER_DELAY_FLUSH_MICROS((byte) 0x31),
+
+  /**
+   * Time L0 compactions wait for the weighted rate limiter.
+   */
+  RATE_LIMITER_DELAY_L0_COMPACTION_MICROS((byte) 0x32),
+
+  /**
+   * Time non-bottommost compactions wait for the weighted rate limiter.
+   */
+  RATE_LIMITER_DELAY_COMPACTION_MICROS((byte) 0x33),
+
+  /**
+   * Time bottommost compactions wait for the weighted rate limiter.
+   */
+  RATE_LIMITER_DELAY_BOTTOMMOST_COMPACTION_MICROS((byte) 0x34),
+
+  /**
+   * Time backups wait for the weighted rate limiter.
+   */
+  RATE_LIMITER_DELAY_BACKUP_MICROS((byte) 0x35),
+
   // 0x1F for backwards compatibility on current minor version.
   HISTOGRAM_ENUM_MAX((byte) 0x1F);
 
@@ -22,7 +22,13 @@ public enum IndexType {
   /**
    * A two-level index implementation. Both levels are binary search indexes.
    */
-  kTwoLevelIndexSearch((byte) 2);
+  kTwoLevelIndexSearch((byte) 2),
+  /**
+   * Like {@link #kBinarySearch}, but the table also stores a small piecewise
+   * linear model of the index keys, which narrows index seeks down to a few
+   * restart points.
+   */
+  kLearnedIndexSearch((byte) 4);
 
   /**
    * Returns the byte value of the enumerations value
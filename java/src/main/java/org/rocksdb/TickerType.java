@@ -722,6 +722,27 @@ public enum TickerType {
      */
     TXN_GET_TRY_AGAIN((byte) -0x0D),
 
+    /**
+     * # of times the range filter was checked on an iterator seek with an
+     * upper bound.
+     */
+    RANGE_FILTER_CHECKED((byte) -0x0E),
+
+    /**
+     * # of times the range filter showed that a table had no key in range.
+     */
+    RANGE_FILTER_USEFUL((byte) -0x0F),
+
+    /**
+     * # of DB::Scan() calls served from the scan cache.
+     */
+    SCAN_CACHE_HIT((byte) -0x10),
+
+    /**
+     * # of DB::Scan() calls not found in the scan cache.
+     */
+    SCAN_CACHE_MISS((byte) -0x11),
+
     TICKER_ENUM_MAX((byte) 0x5F);
 
     private final byte value;
@@ -176,6 +176,10 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
      "rocksdb.block.cache.compression.dict.bytes.insert"},
     {BLOCK_CACHE_COMPRESSION_DICT_BYTES_EVICT,
      "rocksdb.block.cache.compression.dict.bytes.evict"},
+    {RANGE_FILTER_CHECKED, "rocksdb.range.filter.checked"},
+    {RANGE_FILTER_USEFUL, "rocksdb.range.filter.useful"},
+    {SCAN_CACHE_HIT, "rocksdb.scan.cache.hit"},
+    {SCAN_CACHE_MISS, "rocksdb.scan.cache.miss"},
 };
 
 const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
@@ -227,6 +231,19 @@ const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
     {BLOB_DB_DECOMPRESSION_MICROS, "rocksdb.blobdb.decompression.micros"},
     {FLUSH_TIME, "rocksdb.db.flush.micros"},
     {SST_BATCH_SIZE, "rocksdb.sst.batch.size"},
+    {RATE_LIMITER_DELAY_USER_READ_MICROS,
+     "rocksdb.rate.limiter.delay.user.read.micros"},
+    {RATE_LIMITER_DELAY_WAL_MICROS, "rocksdb.rate.limiter.delay.wal.micros"},
+    {RATE_LIMITER_DELAY_FLUSH_MICROS,
+     "rocksdb.rate.limiter.delay.flush.micros"},
+    {RATE_LIMITER_DELAY_L0_COMPACTION_MICROS,
+     "rocksdb.rate.limiter.delay.l0.compaction.micros"},
+    {RATE_LIMITER_DELAY_COMPACTION_MICROS,
+     "rocksdb.rate.limiter.delay.compaction.micros"},
+    {RATE_LIMITER_DELAY_BOTTOMMOST_COMPACTION_MICROS,
+     "rocksdb.rate.limiter.delay.bottommost.compaction.micros"},
+    {RATE_LIMITER_DELAY_BACKUP_MICROS,
+     "rocksdb.rate.limiter.delay.backup.micros"},
 };
 
 std::shared_ptr<Statistics> CreateDBStatistics() {
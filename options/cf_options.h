@@ -123,6 +123,8 @@ struct ImmutableCFOptions {
   std::vector<DbPath> cf_paths;
 
   std::shared_ptr<ConcurrentTaskLimiter> compaction_thread_limiter;
+
+  std::shared_ptr<SstPartitioner> sst_partitioner;
 };
 
 struct MutableCFOptions {
@@ -149,6 +151,10 @@ struct MutableCFOptions {
         max_compaction_bytes(options.max_compaction_bytes),
         target_file_size_base(options.target_file_size_base),
         target_file_size_multiplier(options.target_file_size_multiplier),
+        level_compaction_dynamic_file_size(
+            options.level_compaction_dynamic_file_size),
+        warm_hot_blocks_after_compaction(
+            options.warm_hot_blocks_after_compaction),
         max_bytes_for_level_base(options.max_bytes_for_level_base),
         max_bytes_for_level_multiplier(options.max_bytes_for_level_multiplier),
         ttl(options.ttl),
@@ -185,6 +191,8 @@ struct MutableCFOptions {
         max_compaction_bytes(0),
         target_file_size_base(0),
         target_file_size_multiplier(0),
+        level_compaction_dynamic_file_size(false),
+        warm_hot_blocks_after_compaction(false),
         max_bytes_for_level_base(0),
         max_bytes_for_level_multiplier(0),
         ttl(0),
@@ -236,6 +244,8 @@ struct MutableCFOptions {
   uint64_t max_compaction_bytes;
   uint64_t target_file_size_base;
   int target_file_size_multiplier;
+  bool level_compaction_dynamic_file_size;
+  bool warm_hot_blocks_after_compaction;
   uint64_t max_bytes_for_level_base;
   double max_bytes_for_level_multiplier;
   uint64_t ttl;
@@ -36,6 +36,9 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       wal_dir(options.wal_dir),
       max_subcompactions(options.max_subcompactions),
       max_background_flushes(options.max_background_flushes),
+      compaction_autoscale_period_sec(options.compaction_autoscale_period_sec),
+      compaction_autoscale_write_latency_micros(
+          options.compaction_autoscale_write_latency_micros),
       max_log_file_size(options.max_log_file_size),
       log_file_time_to_roll(options.log_file_time_to_roll),
       keep_log_file_num(options.keep_log_file_num),
@@ -75,6 +78,8 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       wal_recovery_mode(options.wal_recovery_mode),
       allow_2pc(options.allow_2pc),
       row_cache(options.row_cache),
+      scan_cache_size(options.scan_cache_size),
+      max_async_writes_per_file(options.max_async_writes_per_file),
 #ifndef ROCKSDB_LITE
       wal_filter(options.wal_filter),
 #endif  // ROCKSDB_LITE
@@ -149,6 +154,11 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    max_subcompactions);
   ROCKS_LOG_HEADER(log, "                 Options.max_background_flushes: %d",
                    max_background_flushes);
+  ROCKS_LOG_HEADER(log, "        Options.compaction_autoscale_period_sec: %u",
+                   compaction_autoscale_period_sec);
+  ROCKS_LOG_HEADER(
+      log, "Options.compaction_autoscale_write_latency_micros: %" PRIu64,
+      compaction_autoscale_write_latency_micros);
   ROCKS_LOG_HEADER(log,
                    "                        Options.WAL_ttl_seconds: %" PRIu64,
                    wal_ttl_seconds);
@@ -212,6 +222,12 @@ void ImmutableDBOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(log,
                      "                              Options.row_cache: None");
   }
+  ROCKS_LOG_HEADER(
+      log, "                        Options.scan_cache_size: %" ROCKSDB_PRIszt,
+      scan_cache_size);
+  ROCKS_LOG_HEADER(
+      log, "              Options.max_async_writes_per_file: %" ROCKSDB_PRIszt,
+      max_async_writes_per_file);
 #ifndef ROCKSDB_LITE
   ROCKS_LOG_HEADER(log, "                             Options.wal_filter: %s",
                    wal_filter ? wal_filter->Name() : "None");
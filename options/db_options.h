@@ -35,6 +35,8 @@ struct ImmutableDBOptions {
   std::string wal_dir;
   uint32_t max_subcompactions;
   int max_background_flushes;
+  unsigned int compaction_autoscale_period_sec;
+  uint64_t compaction_autoscale_write_latency_micros;
   size_t max_log_file_size;
   size_t log_file_time_to_roll;
   size_t keep_log_file_num;
@@ -70,6 +72,8 @@ struct ImmutableDBOptions {
   WALRecoveryMode wal_recovery_mode;
   bool allow_2pc;
   std::shared_ptr<Cache> row_cache;
+  size_t scan_cache_size;
+  size_t max_async_writes_per_file;
 #ifndef ROCKSDB_LITE
   WalFilter* wal_filter;
 #endif  // ROCKSDB_LITE
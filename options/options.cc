@@ -24,6 +24,7 @@
 #include "rocksdb/slice.h"
 #include "rocksdb/slice_transform.h"
 #include "rocksdb/sst_file_manager.h"
+#include "rocksdb/sst_partitioner.h"
 #include "rocksdb/table.h"
 #include "rocksdb/table_properties.h"
 #include "rocksdb/wal_filter.h"
@@ -61,6 +62,10 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       level0_stop_writes_trigger(options.level0_stop_writes_trigger),
       target_file_size_base(options.target_file_size_base),
       target_file_size_multiplier(options.target_file_size_multiplier),
+      level_compaction_dynamic_file_size(
+          options.level_compaction_dynamic_file_size),
+      warm_hot_blocks_after_compaction(
+          options.warm_hot_blocks_after_compaction),
       level_compaction_dynamic_level_bytes(
           options.level_compaction_dynamic_level_bytes),
       max_bytes_for_level_multiplier(options.max_bytes_for_level_multiplier),
@@ -122,6 +127,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
   ROCKS_LOG_HEADER(
       log, "       Options.compaction_filter_factory: %s",
       compaction_filter_factory ? compaction_filter_factory->Name() : "None");
+  ROCKS_LOG_HEADER(log, "         Options.sst_partitioner: %s",
+                   sst_partitioner ? sst_partitioner->Name() : "None");
   ROCKS_LOG_HEADER(log, "        Options.memtable_factory: %s",
                    memtable_factory->Name());
   ROCKS_LOG_HEADER(log, "           Options.table_factory: %s",
@@ -213,6 +220,12 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
         target_file_size_base);
     ROCKS_LOG_HEADER(log, "            Options.target_file_size_multiplier: %d",
                      target_file_size_multiplier);
+    ROCKS_LOG_HEADER(log,
+                     "     Options.level_compaction_dynamic_file_size: %d",
+                     level_compaction_dynamic_file_size);
+    ROCKS_LOG_HEADER(log,
+                     "       Options.warm_hot_blocks_after_compaction: %d",
+                     warm_hot_blocks_after_compaction);
     ROCKS_LOG_HEADER(
         log, "               Options.max_bytes_for_level_base: %" PRIu64,
         max_bytes_for_level_base);
@@ -596,6 +609,7 @@ ReadOptions::ReadOptions()
       pin_data(false),
       background_purge_on_iterator_cleanup(false),
       ignore_range_deletions(false),
+      use_loser_tree_merge(false),
       iter_start_seqnum(0),
       timestamp(nullptr) {}
 
@@ -615,6 +629,7 @@ ReadOptions::ReadOptions(bool cksum, bool cache)
       pin_data(false),
       background_purge_on_iterator_cleanup(false),
       ignore_range_deletions(false),
+      use_loser_tree_merge(false),
       iter_start_seqnum(0),
       timestamp(nullptr) {}
 
@@ -63,6 +63,10 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.strict_bytes_per_sync = mutable_db_options.strict_bytes_per_sync;
   options.max_subcompactions = immutable_db_options.max_subcompactions;
   options.max_background_flushes = immutable_db_options.max_background_flushes;
+  options.compaction_autoscale_period_sec =
+      immutable_db_options.compaction_autoscale_period_sec;
+  options.compaction_autoscale_write_latency_micros =
+      immutable_db_options.compaction_autoscale_write_latency_micros;
   options.max_log_file_size = immutable_db_options.max_log_file_size;
   options.log_file_time_to_roll = immutable_db_options.log_file_time_to_roll;
   options.keep_log_file_num = immutable_db_options.keep_log_file_num;
@@ -121,6 +125,9 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.wal_recovery_mode = immutable_db_options.wal_recovery_mode;
   options.allow_2pc = immutable_db_options.allow_2pc;
   options.row_cache = immutable_db_options.row_cache;
+  options.scan_cache_size = immutable_db_options.scan_cache_size;
+  options.max_async_writes_per_file =
+      immutable_db_options.max_async_writes_per_file;
 #ifndef ROCKSDB_LITE
   options.wal_filter = immutable_db_options.wal_filter;
 #endif  // ROCKSDB_LITE
@@ -180,6 +187,10 @@ ColumnFamilyOptions BuildColumnFamilyOptions(
   cf_opts.target_file_size_base = mutable_cf_options.target_file_size_base;
   cf_opts.target_file_size_multiplier =
       mutable_cf_options.target_file_size_multiplier;
+  cf_opts.level_compaction_dynamic_file_size =
+      mutable_cf_options.level_compaction_dynamic_file_size;
+  cf_opts.warm_hot_blocks_after_compaction =
+      mutable_cf_options.warm_hot_blocks_after_compaction;
   cf_opts.max_bytes_for_level_base =
       mutable_cf_options.max_bytes_for_level_base;
   cf_opts.max_bytes_for_level_multiplier =
@@ -224,7 +235,8 @@ std::map<CompactionPri, std::string> OptionsHelper::compaction_pri_to_string = {
     {kByCompensatedSize, "kByCompensatedSize"},
     {kOldestLargestSeqFirst, "kOldestLargestSeqFirst"},
     {kOldestSmallestSeqFirst, "kOldestSmallestSeqFirst"},
-    {kMinOverlappingRatio, "kMinOverlappingRatio"}};
+    {kMinOverlappingRatio, "kMinOverlappingRatio"},
+    {kHotAndTombstoneDenseFirst, "kHotAndTombstoneDenseFirst"}};
 
 std::map<CompactionStopStyle, std::string>
     OptionsHelper::compaction_stop_style_to_string = {
@@ -1540,6 +1552,19 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"max_subcompactions",
          {offsetof(struct DBOptions, max_subcompactions), OptionType::kUInt32T,
           OptionVerificationType::kNormal, false, 0}},
+        {"compaction_autoscale_period_sec",
+         {offsetof(struct DBOptions, compaction_autoscale_period_sec),
+          OptionType::kUInt, OptionVerificationType::kNormal, false, 0}},
+        {"compaction_autoscale_write_latency_micros",
+         {offsetof(struct DBOptions,
+                   compaction_autoscale_write_latency_micros),
+          OptionType::kUInt64T, OptionVerificationType::kNormal, false, 0}},
+        {"scan_cache_size",
+         {offsetof(struct DBOptions, scan_cache_size), OptionType::kSizeT,
+          OptionVerificationType::kNormal, false, 0}},
+        {"max_async_writes_per_file",
+         {offsetof(struct DBOptions, max_async_writes_per_file),
+          OptionType::kSizeT, OptionVerificationType::kNormal, false, 0}},
         {"WAL_size_limit_MB",
          {offsetof(struct DBOptions, WAL_size_limit_MB), OptionType::kUInt64T,
           OptionVerificationType::kNormal, false, 0}},
@@ -1683,7 +1708,9 @@ std::unordered_map<std::string, BlockBasedTableOptions::IndexType>
         {"kTwoLevelIndexSearch",
          BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch},
         {"kBinarySearchWithFirstKey",
-         BlockBasedTableOptions::IndexType::kBinarySearchWithFirstKey}};
+         BlockBasedTableOptions::IndexType::kBinarySearchWithFirstKey},
+        {"kLearnedIndexSearch",
+         BlockBasedTableOptions::IndexType::kLearnedIndexSearch}};
 
 std::unordered_map<std::string, BlockBasedTableOptions::DataBlockIndexType>
     OptionsHelper::block_base_table_data_block_index_type_string_map = {
@@ -1718,7 +1745,8 @@ std::unordered_map<std::string, CompactionPri>
         {"kByCompensatedSize", kByCompensatedSize},
         {"kOldestLargestSeqFirst", kOldestLargestSeqFirst},
         {"kOldestSmallestSeqFirst", kOldestSmallestSeqFirst},
-        {"kMinOverlappingRatio", kMinOverlappingRatio}};
+        {"kMinOverlappingRatio", kMinOverlappingRatio},
+        {"kHotAndTombstoneDenseFirst", kHotAndTombstoneDenseFirst}};
 
 std::unordered_map<std::string, WALRecoveryMode>
     OptionsHelper::wal_recovery_mode_string_map = {
@@ -1818,6 +1846,16 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"level_compaction_dynamic_level_bytes",
          {offset_of(&ColumnFamilyOptions::level_compaction_dynamic_level_bytes),
           OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
+        {"level_compaction_dynamic_file_size",
+         {offset_of(&ColumnFamilyOptions::level_compaction_dynamic_file_size),
+          OptionType::kBoolean, OptionVerificationType::kNormal, true,
+          offsetof(struct MutableCFOptions,
+                   level_compaction_dynamic_file_size)}},
+        {"warm_hot_blocks_after_compaction",
+         {offset_of(&ColumnFamilyOptions::warm_hot_blocks_after_compaction),
+          OptionType::kBoolean, OptionVerificationType::kNormal, true,
+          offsetof(struct MutableCFOptions,
+                   warm_hot_blocks_after_compaction)}},
         {"optimize_filters_for_hits",
          {offset_of(&ColumnFamilyOptions::optimize_filters_for_hits),
           OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
@@ -152,7 +152,9 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
       "hash_index_allow_collision=false;"
       "verify_compression=true;read_amp_bytes_per_bit=0;"
       "enable_index_compression=false;"
-      "block_align=true",
+      "block_align=true;"
+      "range_filter=true;"
+      "hash_index_partitions=true",
       new_bbto));
 
   ASSERT_EQ(unset_bytes_base,
@@ -233,6 +235,10 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "wal_dir=path/to/wal_dir;"
                              "db_write_buffer_size=2587;"
                              "max_subcompactions=64330;"
+                             "compaction_autoscale_period_sec=60;"
+                             "compaction_autoscale_write_latency_micros=500;"
+                             "scan_cache_size=1048576;"
+                             "max_async_writes_per_file=16;"
                              "table_cache_numshardbits=28;"
                              "max_open_files=72;"
                              "max_file_opening_threads=35;"
@@ -359,6 +365,8 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       {offset_of(&ColumnFamilyOptions::cf_paths), sizeof(std::vector<DbPath>)},
       {offset_of(&ColumnFamilyOptions::compaction_thread_limiter),
        sizeof(std::shared_ptr<ConcurrentTaskLimiter>)},
+      {offset_of(&ColumnFamilyOptions::sst_partitioner),
+       sizeof(std::shared_ptr<SstPartitioner>)},
   };
 
   char* options_ptr = new char[sizeof(ColumnFamilyOptions)];
@@ -423,6 +431,8 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "max_sequential_skip_in_iterations=4294971408;"
       "arena_block_size=1893;"
       "target_file_size_multiplier=35;"
+      "level_compaction_dynamic_file_size=true;"
+      "warm_hot_blocks_after_compaction=true;"
       "min_write_buffer_number_to_merge=9;"
       "max_write_buffer_number=84;"
       "write_buffer_size=1653;"
@@ -137,6 +137,14 @@ void DataBlockIter::NextOrReport() {
   ParseNextDataKey<CheckAndDecodeEntry>();
 }
 
+void DataBlockIter::AddToBatch(IterateBatch* batch, bool pin) {
+  pin = pin && block_contents_pinned_;
+  while (Valid() && !batch->full() && batch->Accepts(key_.GetKey())) {
+    batch->Add(key_.GetUserKey(), pin && key_pinned_, value(), pin);
+    ParseNextDataKey<DecodeEntry>();
+  }
+}
+
 void IndexBlockIter::Next() {
   assert(Valid());
   ParseNextIndexKey();
@@ -247,7 +255,7 @@ void DataBlockIter::Seek(const Slice& target) {
   }
   uint32_t index = 0;
   bool ok = BinarySeek<DecodeKey>(seek_key, 0, num_restarts_ - 1, &index,
-                                  comparator_);
+                                  comparator_, true /* target_includes_seq */);
 
   if (!ok) {
     return;
@@ -288,6 +296,9 @@ void DataBlockIter::Seek(const Slice& target) {
 bool DataBlockIter::SeekForGetImpl(const Slice& target) {
   Slice target_user_key = ExtractUserKey(target);
   uint32_t map_offset = restarts_ + num_restarts_ * sizeof(uint32_t);
+  if (restart_key_prefixes_ != nullptr) {
+    map_offset += num_restarts_ * sizeof(uint64_t);
+  }
   uint8_t entry =
       data_block_hash_index_->Lookup(data_, map_offset, target_user_key);
 
@@ -394,12 +405,25 @@ void IndexBlockIter::Seek(const Slice& target) {
   bool ok = false;
   if (prefix_index_) {
     ok = PrefixSeek(target, &index);
-  } else if (value_delta_encoded_) {
-    ok = BinarySeek<DecodeKeyV4>(seek_key, 0, num_restarts_ - 1, &index,
-                                 comparator_);
+  } else if (index_hash_ != nullptr && HashSeek(target, seek_key, &index)) {
+    ok = true;
+  } else if (index_hash_ != nullptr && !status_.ok()) {
+    // Corrupted restart point
+    return;
   } else {
-    ok = BinarySeek<DecodeKey>(seek_key, 0, num_restarts_ - 1, &index,
-                               comparator_);
+    uint32_t left = 0;
+    uint32_t right = num_restarts_ - 1;
+    if (learned_model_ != nullptr) {
+      learned_model_->Predict(GetRestartKeyPrefix(ExtractUserKey(target)),
+                              &left, &right);
+    }
+    if (value_delta_encoded_) {
+      ok = BinarySeek<DecodeKeyV4>(seek_key, left, right, &index, comparator_,
+                                   key_includes_seq_);
+    } else {
+      ok = BinarySeek<DecodeKey>(seek_key, left, right, &index, comparator_,
+                                 key_includes_seq_);
+    }
   }
 
   if (!ok) {
@@ -423,7 +447,7 @@ void DataBlockIter::SeekForPrev(const Slice& target) {
   }
   uint32_t index = 0;
   bool ok = BinarySeek<DecodeKey>(seek_key, 0, num_restarts_ - 1, &index,
-                                  comparator_);
+                                  comparator_, true /* target_includes_seq */);
 
   if (!ok) {
     return;
@@ -655,6 +679,29 @@ void IndexBlockIter::DecodeCurrentValue(uint32_t shared) {
   }
 }
 
+namespace {
+// Returns the number of entries of the sorted restart key prefix array that
+// are less than `target`, or not greater than it if kOrEqual. The loop has no
+// data dependent branch so that it compiles to conditional moves.
+template <bool kOrEqual>
+inline uint32_t CountRestartKeyPrefixesBelow(const char* prefixes,
+                                             uint32_t num_prefixes,
+                                             uint64_t target) {
+  assert(num_prefixes > 0);
+  uint32_t base = 0;
+  uint32_t n = num_prefixes;
+  while (n > 1) {
+    const uint32_t half = n / 2;
+    const uint64_t probe =
+        DecodeFixed64(prefixes + (base + half) * sizeof(uint64_t));
+    base += (kOrEqual ? probe <= target : probe < target) ? half : 0;
+    n -= half;
+  }
+  const uint64_t last = DecodeFixed64(prefixes + base * sizeof(uint64_t));
+  return base + ((kOrEqual ? last <= target : last < target) ? 1 : 0);
+}
+}  // namespace
+
 // Binary search in restart array to find the first restart point that
 // is either the last restart point with a key less than target,
 // which means the key of next restart point is larger than target, or
@@ -663,9 +710,33 @@ template <class TValue>
 template <typename DecodeKeyFunc>
 bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t left,
                                    uint32_t right, uint32_t* index,
-                                   const Comparator* comp) {
+                                   const Comparator* comp,
+                                   bool target_includes_seq) {
   assert(left <= right);
 
+  if (restart_key_prefixes_ != nullptr) {
+    // Restart points with a smaller key prefix have a smaller key, and those
+    // with a larger key prefix have a larger key, so only the ones sharing
+    // the target key prefix, and the one before them, need to be compared.
+    // Counting within [left, right] is enough, since the search does not
+    // leave it anyway.
+    const uint64_t target_prefix = GetRestartKeyPrefix(
+        target_includes_seq ? ExtractUserKey(target) : target);
+    const char* const prefixes =
+        restart_key_prefixes_ + left * sizeof(uint64_t);
+    const uint32_t num_less =
+        left + CountRestartKeyPrefixesBelow<false>(prefixes, right - left + 1,
+                                                   target_prefix);
+    const uint32_t num_not_greater =
+        left + CountRestartKeyPrefixesBelow<true>(prefixes, right - left + 1,
+                                                  target_prefix);
+    if (num_less > 0) {
+      left = std::max(left, num_less - 1);
+    }
+    right = num_not_greater > 0 ? std::min(right, num_not_greater - 1) : left;
+    right = std::max(left, right);
+  }
+
   while (left < right) {
     uint32_t mid = (left + right + 1) / 2;
     uint32_t region_offset = GetRestartPoint(mid);
@@ -695,6 +766,38 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t left,
   return true;
 }
 
+bool IndexBlockIter::HashSeek(const Slice& target, const Slice& seek_key,
+                              uint32_t* index) {
+  const uint16_t entry = index_hash_->Lookup(ExtractUserKey(target));
+  if (entry >= num_restarts_) {
+    // kIndexHashNoEntry or kIndexHashCollision, or a corrupted entry
+    return false;
+  }
+  // The restart interval holds the first index entry at or after the first
+  // version of the user key. The binary search stops at the last restart
+  // point whose key is smaller than seek_key, or at one equal to it, which is
+  // this one or the one before it if seek_key is in the table. Stopping at
+  // a restart point followed by one equal to seek_key is fine as well, since
+  // the linear search ends up at the same entry.
+  uint32_t candidate = entry;
+  if (CompareBlockKey(candidate, seek_key) > 0) {
+    if (candidate > 0) {
+      candidate--;
+      if (CompareBlockKey(candidate, seek_key) > 0) {
+        return false;
+      }
+    }
+  } else if (candidate + 1 < num_restarts_ &&
+             CompareBlockKey(candidate + 1, seek_key) < 0) {
+    return false;
+  }
+  if (!status_.ok()) {
+    return false;
+  }
+  *index = candidate;
+  return true;
+}
+
 // Compare target key and the block key of the block of `block_index`.
 // Return -1 if error.
 int IndexBlockIter::CompareBlockKey(uint32_t block_index, const Slice& target) {
@@ -787,6 +890,10 @@ uint32_t Block::NumRestarts() const {
   assert(size_ >= 2 * sizeof(uint32_t));
   uint32_t block_footer = DecodeFixed32(data_ + size_ - sizeof(uint32_t));
   uint32_t num_restarts = block_footer;
+  if (HasRestartKeyPrefixes() || HasIndexHash()) {
+    UnPackIndexTypeAndNumRestarts(block_footer, nullptr, &num_restarts);
+    return num_restarts;
+  }
   if (size_ > kMaxBlockSizeSupportedByHashIndex) {
     // In BlockBuilder, we have ensured a block with HashIndex is less than
     // kMaxBlockSizeSupportedByHashIndex (64KiB).
@@ -818,6 +925,24 @@ BlockBasedTableOptions::DataBlockIndexType Block::IndexType() const {
   return index_type;
 }
 
+bool Block::HasRestartKeyPrefixes() const {
+  assert(size_ >= 2 * sizeof(uint32_t));
+  uint32_t block_footer = DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+  bool has_restart_key_prefixes;
+  UnPackIndexTypeAndNumRestarts(block_footer, nullptr, nullptr,
+                                &has_restart_key_prefixes);
+  return has_restart_key_prefixes;
+}
+
+bool Block::HasIndexHash() const {
+  assert(size_ >= 2 * sizeof(uint32_t));
+  uint32_t block_footer = DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+  bool has_index_hash;
+  UnPackIndexTypeAndNumRestarts(block_footer, nullptr, nullptr, nullptr,
+                                &has_index_hash);
+  return has_index_hash;
+}
+
 Block::~Block() {
   // This sync point can be re-enabled if RocksDB can control the
   // initialization order of any/all static options created by the user.
@@ -831,6 +956,7 @@ Block::Block(BlockContents&& contents, SequenceNumber _global_seqno,
       size_(contents_.data.size()),
       restart_offset_(0),
       num_restarts_(0),
+      restart_key_prefixes_(nullptr),
       global_seqno_(_global_seqno) {
   TEST_SYNC_POINT("Block::Block:0");
   if (size_ < sizeof(uint32_t)) {
@@ -840,6 +966,20 @@ Block::Block(BlockContents&& contents, SequenceNumber _global_seqno,
     num_restarts_ = NumRestarts();
     switch (IndexType()) {
       case BlockBasedTableOptions::kDataBlockBinarySearch:
+        if (HasIndexHash()) {
+          uint32_t map_offset;
+          if (!index_hash_.Initialize(
+                  data_, static_cast<uint32_t>(size_ - sizeof(uint32_t)),
+                  &map_offset)) {
+            size_ = 0;
+            break;
+          }
+          restart_offset_ = map_offset - num_restarts_ * sizeof(uint32_t);
+          if (restart_offset_ > map_offset) {
+            size_ = 0;
+          }
+          break;
+        }
         restart_offset_ = static_cast<uint32_t>(size_) -
                           (1 + num_restarts_) * sizeof(uint32_t);
         if (restart_offset_ > size_ - sizeof(uint32_t)) {
@@ -876,6 +1016,20 @@ Block::Block(BlockContents&& contents, SequenceNumber _global_seqno,
         size_ = 0;  // Error marker
     }
   }
+  if (size_ != 0 && HasRestartKeyPrefixes()) {
+    // The prefix array sits between the restart array and whatever followed
+    // the restart array in the older formats.
+    const uint64_t prefixes_size =
+        static_cast<uint64_t>(num_restarts_) * sizeof(uint64_t);
+    if (prefixes_size > restart_offset_) {
+      size_ = 0;
+    } else {
+      restart_key_prefixes_ =
+          data_ + restart_offset_ + num_restarts_ * sizeof(uint32_t) -
+          prefixes_size;
+      restart_offset_ -= static_cast<uint32_t>(prefixes_size);
+    }
+  }
   if (read_amp_bytes_per_bit != 0 && statistics && size_ != 0) {
     read_amp_bitmap_.reset(new BlockReadAmpBitmap(
         restart_offset_, read_amp_bytes_per_bit, statistics));
@@ -902,8 +1056,9 @@ DataBlockIter* Block::NewDataIterator(const Comparator* cmp,
     return ret_iter;
   } else {
     ret_iter->Initialize(
-        cmp, ucmp, data_, restart_offset_, num_restarts_, global_seqno_,
-        read_amp_bitmap_.get(), block_contents_pinned,
+        cmp, ucmp, data_, restart_offset_, num_restarts_,
+        restart_key_prefixes_,
+        global_seqno_, read_amp_bitmap_.get(), block_contents_pinned,
         data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr);
     if (read_amp_bitmap_) {
       if (read_amp_bitmap_->GetStatistics() != stats) {
@@ -920,7 +1075,7 @@ IndexBlockIter* Block::NewIndexIterator(
     const Comparator* cmp, const Comparator* ucmp, IndexBlockIter* iter,
     Statistics* /*stats*/, bool total_order_seek, bool have_first_key,
     bool key_includes_seq, bool value_is_full, bool block_contents_pinned,
-    BlockPrefixIndex* prefix_index) {
+    BlockPrefixIndex* prefix_index, const LearnedIndexModel* learned_model) {
   IndexBlockIter* ret_iter;
   if (iter != nullptr) {
     ret_iter = iter;
@@ -939,8 +1094,10 @@ IndexBlockIter* Block::NewIndexIterator(
     BlockPrefixIndex* prefix_index_ptr =
         total_order_seek ? nullptr : prefix_index;
     ret_iter->Initialize(cmp, ucmp, data_, restart_offset_, num_restarts_,
-                         global_seqno_, prefix_index_ptr, have_first_key,
-                         key_includes_seq, value_is_full,
+                         restart_key_prefixes_, global_seqno_,
+                         prefix_index_ptr, learned_model,
+                         index_hash_.Valid() ? &index_hash_ : nullptr,
+                         have_first_key, key_includes_seq, value_is_full,
                          block_contents_pinned);
   }
 
@@ -22,6 +22,8 @@
 #include "rocksdb/table.h"
 #include "table/block_based/block_prefix_index.h"
 #include "table/block_based/data_block_hash_index.h"
+#include "table/block_based/index_block_hash_index.h"
+#include "table/block_based/learned_index_model.h"
 #include "table/format.h"
 #include "table/internal_iterator.h"
 #include "test_util/sync_point.h"
@@ -168,6 +170,14 @@ class Block {
 
   BlockBasedTableOptions::DataBlockIndexType IndexType() const;
 
+  // Whether the block has a restart key prefix array. Only blocks whose keys
+  // are ordered by BytewiseComparator have one.
+  bool HasRestartKeyPrefixes() const;
+
+  // Whether the block is an index block with a hash index, see
+  // index_block_hash_index.h.
+  bool HasIndexHash() const;
+
   // If comparator is InternalKeyComparator, user_comparator is its user
   // comparator; they are equal otherwise.
   //
@@ -202,6 +212,12 @@ class Block {
   // If `prefix_index` is not nullptr this block will do hash lookup for the key
   // prefix. If total_order_seek is true, prefix_index_ is ignored.
   //
+  // If `learned_model` is not nullptr and was built for this block, Seek()
+  // limits its binary search to the restart points the model predicts.
+  //
+  // If the block has a hash index, Seek() first tries the restart interval
+  // the hash index gives for the target's user key.
+  //
   // `have_first_key` controls whether IndexValue will contain
   // first_internal_key. It affects data serialization format, so the same value
   // have_first_key must be used when writing and reading index.
@@ -212,7 +228,9 @@ class Block {
                                    bool total_order_seek, bool have_first_key,
                                    bool key_includes_seq, bool value_is_full,
                                    bool block_contents_pinned = false,
-                                   BlockPrefixIndex* prefix_index = nullptr);
+                                   BlockPrefixIndex* prefix_index = nullptr,
+                                   const LearnedIndexModel* learned_model =
+                                       nullptr);
 
   // Report an approximation of how much memory has been used.
   size_t ApproximateMemoryUsage() const;
@@ -225,12 +243,15 @@ class Block {
   size_t size_;              // contents_.data.size()
   uint32_t restart_offset_;  // Offset in data_ of restart array
   uint32_t num_restarts_;
+  // Restart key prefix array, or nullptr if the block has none
+  const char* restart_key_prefixes_;
   std::unique_ptr<BlockReadAmpBitmap> read_amp_bitmap_;
   // All keys in the block will have seqno = global_seqno_, regardless of
   // the encoded value (kDisableGlobalSequenceNumber means disabled)
   const SequenceNumber global_seqno_;
 
   DataBlockHashIndex data_block_hash_index_;
+  IndexBlockHashIndex index_hash_;
 };
 
 template <class TValue>
@@ -238,6 +259,7 @@ class BlockIter : public InternalIteratorBase<TValue> {
  public:
   void InitializeBase(const Comparator* comparator, const char* data,
                       uint32_t restarts, uint32_t num_restarts,
+                      const char* restart_key_prefixes,
                       SequenceNumber global_seqno, bool block_contents_pinned) {
     assert(data_ == nullptr);  // Ensure it is called only once
     assert(num_restarts > 0);  // Ensure the param is valid
@@ -246,6 +268,7 @@ class BlockIter : public InternalIteratorBase<TValue> {
     data_ = data;
     restarts_ = restarts;
     num_restarts_ = num_restarts;
+    restart_key_prefixes_ = restart_key_prefixes;
     current_ = restarts_;
     restart_index_ = num_restarts_;
     global_seqno_ = global_seqno;
@@ -314,6 +337,8 @@ class BlockIter : public InternalIteratorBase<TValue> {
   // Index of restart block in which current_ or current_-1 falls
   uint32_t restart_index_;
   uint32_t restarts_;  // Offset of restart array (list of fixed32)
+  // Restart key prefix array (list of fixed64), or nullptr if absent
+  const char* restart_key_prefixes_;
   // current_ is offset in data_ of current entry.  >= restarts_ if !Valid
   uint32_t current_;
   IterKey key_;
@@ -360,7 +385,8 @@ class BlockIter : public InternalIteratorBase<TValue> {
 
   template <typename DecodeKeyFunc>
   inline bool BinarySeek(const Slice& target, uint32_t left, uint32_t right,
-                         uint32_t* index, const Comparator* comp);
+                         uint32_t* index, const Comparator* comp,
+                         bool target_includes_seq);
 };
 
 class DataBlockIter final : public BlockIter<Slice> {
@@ -369,23 +395,24 @@ class DataBlockIter final : public BlockIter<Slice> {
       : BlockIter(), read_amp_bitmap_(nullptr), last_bitmap_offset_(0) {}
   DataBlockIter(const Comparator* comparator, const Comparator* user_comparator,
                 const char* data, uint32_t restarts, uint32_t num_restarts,
-                SequenceNumber global_seqno,
+                const char* restart_key_prefixes, SequenceNumber global_seqno,
                 BlockReadAmpBitmap* read_amp_bitmap, bool block_contents_pinned,
                 DataBlockHashIndex* data_block_hash_index)
       : DataBlockIter() {
     Initialize(comparator, user_comparator, data, restarts, num_restarts,
-               global_seqno, read_amp_bitmap, block_contents_pinned,
-               data_block_hash_index);
+               restart_key_prefixes, global_seqno, read_amp_bitmap,
+               block_contents_pinned, data_block_hash_index);
   }
   void Initialize(const Comparator* comparator,
                   const Comparator* user_comparator, const char* data,
                   uint32_t restarts, uint32_t num_restarts,
+                  const char* restart_key_prefixes,
                   SequenceNumber global_seqno,
                   BlockReadAmpBitmap* read_amp_bitmap,
                   bool block_contents_pinned,
                   DataBlockHashIndex* data_block_hash_index) {
-    InitializeBase(comparator, data, restarts, num_restarts, global_seqno,
-                   block_contents_pinned);
+    InitializeBase(comparator, data, restarts, num_restarts,
+                   restart_key_prefixes, global_seqno, block_contents_pinned);
     user_comparator_ = user_comparator;
     key_.SetIsUserKey(false);
     read_amp_bitmap_ = read_amp_bitmap;
@@ -426,6 +453,12 @@ class DataBlockIter final : public BlockIter<Slice> {
   // incur higher CPU overhead because we need to perform check on every entry.
   void NextOrReport();
 
+  // Adds the current entry and the ones after it to batch while it accepts
+  // them, and moves past them. Stops at the first entry not added, or at the
+  // end of the block. Keys and values are pinned if pin is set and the block
+  // contents are pinned, and copied otherwise.
+  void AddToBatch(IterateBatch* batch, bool pin);
+
   virtual void SeekToFirst() override;
 
   // Try to seek to the first entry in the block. If there is data corruption
@@ -487,7 +520,11 @@ class DataBlockIter final : public BlockIter<Slice> {
 
 class IndexBlockIter final : public BlockIter<IndexValue> {
  public:
-  IndexBlockIter() : BlockIter(), prefix_index_(nullptr) {}
+  IndexBlockIter()
+      : BlockIter(),
+        prefix_index_(nullptr),
+        learned_model_(nullptr),
+        index_hash_(nullptr) {}
 
   virtual Slice key() const override {
     assert(Valid());
@@ -500,15 +537,23 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
   void Initialize(const Comparator* comparator,
                   const Comparator* user_comparator, const char* data,
                   uint32_t restarts, uint32_t num_restarts,
+                  const char* restart_key_prefixes,
                   SequenceNumber global_seqno, BlockPrefixIndex* prefix_index,
-                  bool have_first_key, bool key_includes_seq,
-                  bool value_is_full, bool block_contents_pinned) {
+                  const LearnedIndexModel* learned_model,
+                  const IndexBlockHashIndex* index_hash, bool have_first_key,
+                  bool key_includes_seq, bool value_is_full,
+                  bool block_contents_pinned) {
     InitializeBase(key_includes_seq ? comparator : user_comparator, data,
-                   restarts, num_restarts, kDisableGlobalSequenceNumber,
-                   block_contents_pinned);
+                   restarts, num_restarts, restart_key_prefixes,
+                   kDisableGlobalSequenceNumber, block_contents_pinned);
     key_includes_seq_ = key_includes_seq;
     key_.SetIsUserKey(!key_includes_seq_);
     prefix_index_ = prefix_index;
+    learned_model_ = learned_model != nullptr &&
+                             learned_model->num_restarts() == num_restarts
+                         ? learned_model
+                         : nullptr;
+    index_hash_ = index_hash;
     value_delta_encoded_ = !value_is_full;
     have_first_key_ = have_first_key;
     if (have_first_key_ && global_seqno != kDisableGlobalSequenceNumber) {
@@ -572,6 +617,8 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
   bool value_delta_encoded_;
   bool have_first_key_;  // value includes first_internal_key
   BlockPrefixIndex* prefix_index_;
+  const LearnedIndexModel* learned_model_;
+  const IndexBlockHashIndex* index_hash_;
   // Whether the value is delta encoded. In that case the value is assumed to be
   // BlockHandle. The first value in each restart interval is the full encoded
   // BlockHandle; the restart of encoded size part of the BlockHandle. The
@@ -596,6 +643,10 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
   std::unique_ptr<GlobalSeqnoState> global_seqno_state_;
 
   bool PrefixSeek(const Slice& target, uint32_t* index);
+  // Sets *index to the restart point the binary search for seek_key would
+  // stop at and returns true, if the restart interval index_hash_ gives for
+  // the user key of target shows it. Returns false otherwise.
+  bool HashSeek(const Slice& target, const Slice& seek_key, uint32_t* index);
   bool BinaryBlockIndexSeek(const Slice& target, uint32_t* block_ids,
                             uint32_t left, uint32_t right, uint32_t* index);
   inline int CompareBlockKey(uint32_t block_index, const Slice& target);
@@ -38,6 +38,7 @@
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/full_filter_block.h"
 #include "table/block_based/partitioned_filter_block.h"
+#include "table/block_based/range_filter_block.h"
 #include "table/format.h"
 #include "table/table_builder.h"
 
@@ -294,6 +295,8 @@ struct BlockBasedTableBuilder::Rep {
   std::vector<std::pair<std::string, std::vector<std::string>>>
       data_block_and_keys_buffers;
   BlockBuilder range_del_block;
+  // Set if table_options.range_filter and the table uses BytewiseComparator
+  std::unique_ptr<RangeFilterBlockBuilder> range_filter_builder;
 
   InternalKeySliceTransform internal_prefix_transform;
   std::unique_ptr<IndexBuilder> index_builder;
@@ -383,7 +386,10 @@ struct BlockBasedTableBuilder::Rep {
                            ->CanKeysWithDifferentByteContentsBeEqual()
                        ? BlockBasedTableOptions::kDataBlockBinarySearch
                        : table_options.data_block_index_type,
-                   table_options.data_block_hash_table_util_ratio),
+                   table_options.data_block_hash_table_util_ratio,
+                   BlockBuilder::UseRestartKeyPrefixes(
+                       table_options.format_version,
+                       icomparator.user_comparator())),
         range_del_block(1 /* block_restart_interval */),
         internal_prefix_transform(_moptions.prefix_extractor.get()),
         compression_type(_compression_type),
@@ -431,6 +437,11 @@ struct BlockBasedTableBuilder::Rep {
           p_index_builder_));
     }
 
+    if (table_options.range_filter &&
+        internal_comparator.user_comparator() == BytewiseComparator()) {
+      range_filter_builder.reset(new RangeFilterBlockBuilder());
+    }
+
     for (auto& collector_factories : *int_tbl_prop_collector_factories) {
       table_properties_collectors.emplace_back(
           collector_factories->CreateIntTblPropCollector(column_family_id));
@@ -542,6 +553,10 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
       r->filter_builder->Add(ExtractUserKeyAndStripTimestamp(key, ts_sz));
     }
 
+    if (r->range_filter_builder != nullptr) {
+      r->range_filter_builder->AddKey(ExtractUserKey(key));
+    }
+
     r->last_key.assign(key.data(), key.size());
     r->data_block.Add(key, value);
     if (r->state == Rep::State::kBuffered) {
@@ -1031,6 +1046,21 @@ void BlockBasedTableBuilder::WriteRangeDelBlock(
   }
 }
 
+void BlockBasedTableBuilder::WriteRangeFilterBlock(
+    MetaIndexBuilder* meta_index_builder) {
+  // Only point keys are added. Range tombstones are read when the table is
+  // opened, whether or not a seek is answered by the range filter.
+  if (ok() && rep_->range_filter_builder != nullptr &&
+      !rep_->range_filter_builder->empty()) {
+    BlockHandle range_filter_block_handle;
+    WriteRawBlock(rep_->range_filter_builder->Finish(), kNoCompression,
+                  &range_filter_block_handle);
+    if (ok()) {
+      meta_index_builder->Add(kRangeFilterBlock, range_filter_block_handle);
+    }
+  }
+}
+
 void BlockBasedTableBuilder::WriteFooter(BlockHandle& metaindex_block_handle,
                                          BlockHandle& index_block_handle) {
   Rep* r = rep_;
@@ -1145,15 +1175,17 @@ Status BlockBasedTableBuilder::Finish() {
   //    2. [meta block: index]
   //    3. [meta block: compression dictionary]
   //    4. [meta block: range deletion tombstone]
-  //    5. [meta block: properties]
-  //    6. [metaindex block]
-  //    7. Footer
+  //    5. [meta block: range filter]
+  //    6. [meta block: properties]
+  //    7. [metaindex block]
+  //    8. Footer
   BlockHandle metaindex_block_handle, index_block_handle;
   MetaIndexBuilder meta_index_builder;
   WriteFilterBlock(&meta_index_builder);
   WriteIndexBlock(&meta_index_builder, &index_block_handle);
   WriteCompressionDictBlock(&meta_index_builder);
   WriteRangeDelBlock(&meta_index_builder);
+  WriteRangeFilterBlock(&meta_index_builder);
   WritePropertiesBlock(&meta_index_builder);
   if (ok()) {
     // flush the meta index block
@@ -405,6 +405,12 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  block_align: %d\n",
            table_options_.block_align);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  range_filter: %d\n",
+           table_options_.range_filter);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  hash_index_partitions: %d\n",
+           table_options_.hash_index_partitions);
+  ret.append(buffer);
   return ret;
 }
 
@@ -636,6 +642,7 @@ const std::string BlockBasedTablePropertyNames::kPrefixFiltering =
 const std::string kHashIndexPrefixesBlock = "rocksdb.hashindex.prefixes";
 const std::string kHashIndexPrefixesMetadataBlock =
     "rocksdb.hashindex.metadata";
+const std::string kLearnedIndexModelBlock = "rocksdb.learned_index.model";
 const std::string kPropTrue = "1";
 const std::string kPropFalse = "0";
 
@@ -84,6 +84,7 @@ class BlockBasedTableFactory : public TableFactory {
 
 extern const std::string kHashIndexPrefixesBlock;
 extern const std::string kHashIndexPrefixesMetadataBlock;
+extern const std::string kLearnedIndexModelBlock;
 extern const std::string kPropTrue;
 extern const std::string kPropFalse;
 
@@ -190,6 +191,12 @@ static std::unordered_map<std::string, OptionTypeInfo>
         {"pin_top_level_index_and_filter",
          {offsetof(struct BlockBasedTableOptions,
                    pin_top_level_index_and_filter),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
+        {"range_filter",
+         {offsetof(struct BlockBasedTableOptions, range_filter),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
+        {"hash_index_partitions",
+         {offsetof(struct BlockBasedTableOptions, hash_index_partitions),
           OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}}};
 #endif  // !ROCKSDB_LITE
 }  // namespace rocksdb
@@ -37,6 +37,7 @@
 #include "table/block_based/block_prefix_index.h"
 #include "table/block_based/filter_block.h"
 #include "table/block_based/full_filter_block.h"
+#include "table/block_based/learned_index_model.h"
 #include "table/block_based/partitioned_filter_block.h"
 #include "table/block_fetcher.h"
 #include "table/format.h"
@@ -61,6 +62,7 @@ namespace rocksdb {
 extern const uint64_t kBlockBasedTableMagicNumber;
 extern const std::string kHashIndexPrefixesBlock;
 extern const std::string kHashIndexPrefixesMetadataBlock;
+extern const std::string kLearnedIndexModelBlock;
 
 typedef BlockBasedTable::IndexReader IndexReader;
 
@@ -786,6 +788,129 @@ class HashIndexReader : public BlockBasedTable::IndexReaderCommon {
   std::unique_ptr<BlockPrefixIndex> prefix_index_;
 };
 
+// Binary search index whose seeks only search the few restart points that a
+// learned model predicts for the target. See LearnedIndexModel.
+class LearnedIndexReader : public BlockBasedTable::IndexReaderCommon {
+ public:
+  static Status Create(const BlockBasedTable* table,
+                       FilePrefetchBuffer* prefetch_buffer,
+                       InternalIterator* meta_index_iter, bool use_cache,
+                       bool prefetch, bool pin,
+                       BlockCacheLookupContext* lookup_context,
+                       std::unique_ptr<IndexReader>* index_reader) {
+    assert(table != nullptr);
+    assert(index_reader != nullptr);
+    assert(!pin || prefetch);
+
+    const BlockBasedTable::Rep* rep = table->get_rep();
+    assert(rep != nullptr);
+
+    CachableEntry<Block> index_block;
+    if (prefetch || !use_cache) {
+      const Status s =
+          ReadIndexBlock(table, prefetch_buffer, ReadOptions(), use_cache,
+                         /*get_context=*/nullptr, lookup_context, &index_block);
+      if (!s.ok()) {
+        return s;
+      }
+
+      if (use_cache && !pin) {
+        index_block.Reset();
+      }
+    }
+
+    // Like for the hash index, the index is still usable for binary search
+    // without the model, so Create succeeds regardless from this point on.
+    index_reader->reset(new LearnedIndexReader(table, std::move(index_block)));
+
+    // The model is missing when it could not meet its error bound
+    BlockHandle model_handle;
+    Status s =
+        FindMetaBlock(meta_index_iter, kLearnedIndexModelBlock, &model_handle);
+    if (!s.ok()) {
+      return Status::OK();
+    }
+
+    BlockContents model_contents;
+    BlockFetcher model_block_fetcher(
+        rep->file.get(), prefetch_buffer, rep->footer, ReadOptions(),
+        model_handle, &model_contents, rep->ioptions, true /*decompress*/,
+        true /*maybe_compressed*/, BlockType::kLearnedIndexModel,
+        UncompressionDict::GetEmptyDict(), rep->persistent_cache_options,
+        GetMemoryAllocator(rep->table_options));
+    s = model_block_fetcher.ReadBlockContents();
+    if (!s.ok()) {
+      return s;
+    }
+
+    std::unique_ptr<LearnedIndexModel> model;
+    s = LearnedIndexModel::Create(model_contents.data, &model);
+    if (s.ok()) {
+      LearnedIndexReader* const learned_index_reader =
+          static_cast<LearnedIndexReader*>(index_reader->get());
+      learned_index_reader->model_ = std::move(model);
+    } else {
+      ROCKS_LOG_WARN(rep->ioptions.info_log,
+                     "Unable to decode the learned index model: %s",
+                     s.ToString().c_str());
+    }
+
+    return Status::OK();
+  }
+
+  InternalIteratorBase<IndexValue>* NewIterator(
+      const ReadOptions& read_options, bool /* disable_prefix_seek */,
+      IndexBlockIter* iter, GetContext* get_context,
+      BlockCacheLookupContext* lookup_context) override {
+    const bool no_io = (read_options.read_tier == kBlockCacheTier);
+    CachableEntry<Block> index_block;
+    const Status s =
+        GetOrReadIndexBlock(no_io, get_context, lookup_context, &index_block);
+    if (!s.ok()) {
+      if (iter != nullptr) {
+        iter->Invalidate(s);
+        return iter;
+      }
+
+      return NewErrorInternalIterator<IndexValue>(s);
+    }
+
+    Statistics* kNullStats = nullptr;
+    // We don't return pinned data from index blocks, so no need
+    // to set `block_contents_pinned`.
+    auto it = index_block.GetValue()->NewIndexIterator(
+        internal_comparator(), internal_comparator()->user_comparator(), iter,
+        kNullStats, true, index_has_first_key(), index_key_includes_seq(),
+        index_value_is_full(), false /* block_contents_pinned */,
+        nullptr /* prefix_index */, model_.get());
+
+    assert(it != nullptr);
+    index_block.TransferTo(it);
+
+    return it;
+  }
+
+  size_t ApproximateMemoryUsage() const override {
+    size_t usage = ApproximateIndexBlockMemoryUsage();
+    if (model_) {
+      usage += model_->ApproximateMemoryUsage();
+    }
+#ifdef ROCKSDB_MALLOC_USABLE_SIZE
+    usage += malloc_usable_size(const_cast<LearnedIndexReader*>(this));
+#else
+    usage += sizeof(*this);
+#endif  // ROCKSDB_MALLOC_USABLE_SIZE
+    return usage;
+  }
+
+ private:
+  LearnedIndexReader(const BlockBasedTable* t,
+                     CachableEntry<Block>&& index_block)
+      : IndexReaderCommon(t, std::move(index_block)) {}
+
+  std::unique_ptr<LearnedIndexModel> model_;
+};
+
 void BlockBasedTable::UpdateCacheHitMetrics(BlockType block_type,
                                             GetContext* get_context,
                                             size_t usage) const {
@@ -1221,6 +1346,11 @@ Status BlockBasedTable::Open(
   if (!s.ok()) {
     return s;
   }
+  s = new_table->ReadRangeFilterBlock(prefetch_buffer.get(),
+                                      metaindex_iter.get());
+  if (!s.ok()) {
+    return s;
+  }
   s = new_table->PrefetchIndexAndFilterBlocks(
       prefetch_buffer.get(), metaindex_iter.get(), new_table.get(),
       prefetch_all, table_options, level, &lookup_context);
@@ -1477,6 +1607,41 @@ Status BlockBasedTable::ReadRangeDelBlock(
   return s;
 }
 
+Status BlockBasedTable::ReadRangeFilterBlock(
+    FilePrefetchBuffer* prefetch_buffer, InternalIterator* meta_iter) {
+  // The filter compares keys bytewise
+  if (rep_->internal_comparator.user_comparator() != BytewiseComparator()) {
+    return Status::OK();
+  }
+  bool found_range_filter_block = false;
+  BlockHandle range_filter_handle;
+  Status s = SeekToRangeFilterBlock(meta_iter, &found_range_filter_block,
+                                    &range_filter_handle);
+  if (!s.ok() || !found_range_filter_block || range_filter_handle.IsNull()) {
+    // The range filter is optional
+    return Status::OK();
+  }
+  std::unique_ptr<Block> range_filter_block;
+  s = ReadBlockFromFile(
+      rep_->file.get(), prefetch_buffer, rep_->footer, ReadOptions(),
+      range_filter_handle, &range_filter_block, rep_->ioptions,
+      true /* decompress */, true /*maybe_compressed*/,
+      BlockType::kRangeFilter, UncompressionDict::GetEmptyDict(),
+      rep_->persistent_cache_options, kDisableGlobalSequenceNumber,
+      0 /* read_amp_bytes_per_bit */, GetMemoryAllocator(rep_->table_options),
+      false /* for_compaction */, rep_->blocks_definitely_zstd_compressed,
+      nullptr /* filter_policy */);
+  if (!s.ok()) {
+    ROCKS_LOG_WARN(rep_->ioptions.info_log,
+                   "Encountered error while reading range filter block %s",
+                   s.ToString().c_str());
+    return Status::OK();
+  }
+  rep_->range_filter.reset(
+      new RangeFilterBlockReader(std::move(range_filter_block)));
+  return s;
+}
+
 Status BlockBasedTable::PrefetchIndexAndFilterBlocks(
     FilePrefetchBuffer* prefetch_buffer, InternalIterator* meta_iter,
     BlockBasedTable* new_table, bool prefetch_all,
@@ -1632,6 +1797,9 @@ size_t BlockBasedTable::ApproximateMemoryUsage() const {
   if (rep_->uncompression_dict_reader) {
     usage += rep_->uncompression_dict_reader->ApproximateMemoryUsage();
   }
+  if (rep_->range_filter) {
+    usage += rep_->range_filter->ApproximateMemoryUsage();
+  }
   return usage;
 }
 
@@ -2682,6 +2850,27 @@ bool BlockBasedTable::PrefixMayMatch(
   return may_match;
 }
 
+bool BlockBasedTable::RangeMayMatch(const Slice& internal_key,
+                                    const Slice& upper_bound,
+                                    bool* has_key_after) const {
+  if (rep_->range_filter == nullptr) {
+    return true;
+  }
+  const Slice user_key = ExtractUserKey(internal_key);
+  if (user_key.compare(upper_bound) >= 0) {
+    // Empty range, which the iterator handles by itself
+    return true;
+  }
+  bool may_match =
+      rep_->range_filter->RangeMayMatch(user_key, upper_bound, has_key_after);
+  Statistics* statistics = rep_->ioptions.statistics;
+  RecordTick(statistics, RANGE_FILTER_CHECKED);
+  if (!may_match) {
+    RecordTick(statistics, RANGE_FILTER_USEFUL);
+  }
+  return may_match;
+}
+
 template <class TBlockIter, typename TValue>
 void BlockBasedTableIterator<TBlockIter, TValue>::Seek(const Slice& target) {
   SeekImpl(&target);
@@ -2701,6 +2890,9 @@ void BlockBasedTableIterator<TBlockIter, TValue>::SeekImpl(
     ResetDataIter();
     return;
   }
+  if (target && !CheckRangeMayMatch(*target)) {
+    return;
+  }
 
   bool need_seek_index = true;
   if (block_iter_points_to_real_block_ && block_iter_.Valid()) {
@@ -2874,6 +3066,30 @@ bool BlockBasedTableIterator<TBlockIter, TValue>::NextAndGetResult(
   return is_valid;
 }
 
+template <class TBlockIter, typename TValue>
+bool BlockBasedTableIterator<TBlockIter, TValue>::NextBatch(
+    IterateBatch* batch, IterateResult* result) {
+  const bool pin = batch->pin_data && pinned_iters_mgr_ != nullptr &&
+                   pinned_iters_mgr_->PinningEnabled();
+  Next();
+  // Add the entries of as many blocks as the batch takes in full. A block
+  // known only from the index is left for the caller to read.
+  while (Valid() && !is_at_first_key_from_index_) {
+    block_iter_.AddToBatch(batch, pin);
+    if (block_iter_.Valid()) {
+      break;
+    }
+    FindKeyForward();
+    CheckOutOfBound();
+  }
+  bool is_valid = Valid();
+  if (is_valid) {
+    result->key = key();
+    result->may_be_out_of_upper_bound = MayBeOutOfUpperBound();
+  }
+  return is_valid;
+}
+
 template <class TBlockIter, typename TValue>
 void BlockBasedTableIterator<TBlockIter, TValue>::Prev() {
   if (is_at_first_key_from_index_) {
@@ -3846,6 +4062,14 @@ BlockType BlockBasedTable::GetBlockTypeForMetaBlockByName(
     return BlockType::kHashIndexMetadata;
   }
 
+  if (meta_block_name == kRangeFilterBlock) {
+    return BlockType::kRangeFilter;
+  }
+
+  if (meta_block_name == kLearnedIndexModelBlock) {
+    return BlockType::kLearnedIndexModel;
+  }
+
   assert(false);
   return BlockType::kInvalid;
 }
@@ -3884,7 +4108,7 @@ Status BlockBasedTable::VerifyChecksumInMetaBlocks(
   return s;
 }
 
-bool BlockBasedTable::TEST_BlockInCache(const BlockHandle& handle) const {
+bool BlockBasedTable::BlockInCache(const BlockHandle& handle) const {
   assert(rep_ != nullptr);
 
   Cache* const cache = rep_->table_options.block_cache.get();
@@ -3907,6 +4131,10 @@ bool BlockBasedTable::TEST_BlockInCache(const BlockHandle& handle) const {
   return true;
 }
 
+bool BlockBasedTable::TEST_BlockInCache(const BlockHandle& handle) const {
+  return BlockInCache(handle);
+}
+
 bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
                                       const Slice& key) {
   std::unique_ptr<InternalIteratorBase<IndexValue>> iiter(NewIndexIterator(
@@ -3971,6 +4199,28 @@ Status BlockBasedTable::CreateIndexReader(
                                      use_cache, prefetch, pin, lookup_context,
                                      index_reader);
     }
+    case BlockBasedTableOptions::kLearnedIndexSearch: {
+      std::unique_ptr<Block> metaindex_guard;
+      std::unique_ptr<InternalIterator> metaindex_iter_guard;
+      auto meta_index_iter = preloaded_meta_index_iter;
+      if (meta_index_iter == nullptr) {
+        auto s = ReadMetaIndexBlock(prefetch_buffer, &metaindex_guard,
+                                    &metaindex_iter_guard);
+        if (!s.ok()) {
+          ROCKS_LOG_WARN(rep_->ioptions.info_log,
+                         "Unable to read the metaindex block."
+                         " Fall back to binary search index.");
+          return BinarySearchIndexReader::Create(this, prefetch_buffer,
+                                                 use_cache, prefetch, pin,
+                                                 lookup_context, index_reader);
+        }
+        meta_index_iter = metaindex_iter_guard.get();
+      }
+
+      return LearnedIndexReader::Create(this, prefetch_buffer,
+                                        meta_index_iter, use_cache, prefetch,
+                                        pin, lookup_context, index_reader);
+    }
     default: {
       std::string error_message =
           "Unrecognized index type: " + ToString(rep_->index_type);
@@ -4042,6 +4292,87 @@ uint64_t BlockBasedTable::ApproximateSize(const Slice& start, const Slice& end,
   return end_offset - start_offset;
 }
 
+Status BlockBasedTable::ApproximateKeyAnchors(const ReadOptions& read_options,
+                                              size_t max_anchors,
+                                              std::vector<Anchor>* anchors) {
+  BlockCacheLookupContext context(TableReaderCaller::kUserApproximateSize);
+  IndexBlockIter iiter_on_stack;
+  auto index_iter =
+      NewIndexIterator(read_options, /*disable_prefix_seek=*/false,
+                       /*input_iter=*/&iiter_on_stack, /*get_context=*/nullptr,
+                       /*lookup_context=*/&context);
+  std::unique_ptr<InternalIteratorBase<IndexValue>> iiter_unique_ptr;
+  if (index_iter != &iiter_on_stack) {
+    iiter_unique_ptr.reset(index_iter);
+  }
+
+  const uint64_t num_blocks = rep_->table_properties
+                                  ? rep_->table_properties->num_data_blocks
+                                  : 0;
+  const uint64_t blocks_per_anchor =
+      std::max<uint64_t>(1, num_blocks / std::max<size_t>(1, max_anchors));
+  uint64_t count = 0;
+  uint64_t range_start = 0;
+  uint64_t range_end = 0;
+  std::string last_key;
+  for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
+    const BlockHandle& handle = index_iter->value().handle;
+    range_end = handle.offset() + handle.size();
+    if (++count % blocks_per_anchor == 0) {
+      anchors->emplace_back(index_iter->user_key(), range_end - range_start);
+      range_start = range_end;
+    } else {
+      last_key.assign(index_iter->user_key().data(),
+                      index_iter->user_key().size());
+    }
+  }
+  if (!index_iter->status().ok()) {
+    return index_iter->status();
+  }
+  if (range_end > range_start) {
+    anchors->emplace_back(last_key, range_end - range_start);
+  }
+  return Status::OK();
+}
+
+Status BlockBasedTable::GetCachedKeyRanges(
+    std::vector<std::pair<std::string, std::string>>* ranges) {
+  if (rep_->table_options.block_cache == nullptr) {
+    return Status::OK();
+  }
+  // Only the blocks already in the cache matter, so the walk does not fill
+  // the cache with the index partitions it reads
+  ReadOptions read_options;
+  read_options.fill_cache = false;
+  BlockCacheLookupContext context(TableReaderCaller::kPrefetch);
+  IndexBlockIter iiter_on_stack;
+  auto index_iter =
+      NewIndexIterator(read_options, /*disable_prefix_seek=*/false,
+                       /*input_iter=*/&iiter_on_stack, /*get_context=*/nullptr,
+                       /*lookup_context=*/&context);
+  std::unique_ptr<InternalIteratorBase<IndexValue>> iiter_unique_ptr;
+  if (index_iter != &iiter_on_stack) {
+    iiter_unique_ptr.reset(index_iter);
+  }
+
+  bool in_run = false;
+  std::string prev_key;
+  for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
+    const Slice user_key = index_iter->user_key();
+    if (BlockInCache(index_iter->value().handle)) {
+      if (!in_run) {
+        ranges->emplace_back(prev_key, std::string());
+        in_run = true;
+      }
+      ranges->back().second.assign(user_key.data(), user_key.size());
+    } else {
+      in_run = false;
+    }
+    prev_key.assign(user_key.data(), user_key.size());
+  }
+  return index_iter->status();
+}
+
 bool BlockBasedTable::TEST_FilterBlockInCache() const {
   assert(rep_ != nullptr);
   return TEST_BlockInCache(rep_->filter_handle);
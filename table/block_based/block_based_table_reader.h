@@ -30,6 +30,7 @@
 #include "table/block_based/block_type.h"
 #include "table/block_based/cachable_entry.h"
 #include "table/block_based/filter_block.h"
+#include "table/block_based/range_filter_block.h"
 #include "table/block_based/uncompression_dict_reader.h"
 #include "table/format.h"
 #include "table/get_context.h"
@@ -126,6 +127,13 @@ class BlockBasedTable : public TableReader {
                       const bool need_upper_bound_check,
                       BlockCacheLookupContext* lookup_context) const;
 
+  // Returns false if the range filter shows that the table has no user key
+  // in [ExtractUserKey(internal_key), upper_bound). In that case
+  // *has_key_after tells whether it has a user key >= upper_bound.
+  // Always returns true if the table has no range filter.
+  bool RangeMayMatch(const Slice& internal_key, const Slice& upper_bound,
+                     bool* has_key_after) const;
+
   // Returns a new iterator over the table contents.
   // The result of NewIterator() is initially invalid (caller must
   // call one of the Seek methods on the iterator before using it).
@@ -172,6 +180,16 @@ class BlockBasedTable : public TableReader {
   uint64_t ApproximateSize(const Slice& start, const Slice& end,
                            TableReaderCaller caller) override;
 
+  // Samples the separators of the index, one every num_data_blocks /
+  // max_anchors data blocks.
+  Status ApproximateKeyAnchors(const ReadOptions& read_options,
+                               size_t max_anchors,
+                               std::vector<Anchor>* anchors) override;
+
+  // Walks the index and probes the block cache for each data block.
+  Status GetCachedKeyRanges(
+      std::vector<std::pair<std::string, std::string>>* ranges) override;
+
   bool TEST_BlockInCache(const BlockHandle& handle) const;
 
   // Returns true if the block for the specified key is in cache.
@@ -283,6 +301,9 @@ class BlockBasedTable : public TableReader {
   Cache::Handle* GetEntryFromCache(Cache* block_cache, const Slice& key,
                                    BlockType block_type,
                                    GetContext* get_context) const;
+  // Whether the block is in the uncompressed block cache. Does not record
+  // any statistics.
+  bool BlockInCache(const BlockHandle& handle) const;
 
   // Either Block::NewDataIterator() or Block::NewIndexIterator().
   template <typename TBlockIter>
@@ -426,6 +447,8 @@ class BlockBasedTable : public TableReader {
                            InternalIterator* meta_iter,
                            const InternalKeyComparator& internal_comparator,
                            BlockCacheLookupContext* lookup_context);
+  Status ReadRangeFilterBlock(FilePrefetchBuffer* prefetch_buffer,
+                              InternalIterator* meta_iter);
   Status PrefetchIndexAndFilterBlocks(
       FilePrefetchBuffer* prefetch_buffer, InternalIterator* meta_iter,
       BlockBasedTable* new_table, bool prefetch_all,
@@ -553,6 +576,9 @@ struct BlockBasedTable::Rep {
 
   std::shared_ptr<const FragmentedRangeTombstoneList> fragmented_range_dels;
 
+  // Held in memory while the table is open. Null if the table has none.
+  std::unique_ptr<RangeFilterBlockReader> range_filter;
+
   // If global_seqno is used, all Keys in this file will have the same
   // seqno with value `global_seqno`.
   //
@@ -642,6 +668,7 @@ class BlockBasedTableIterator : public InternalIteratorBase<TValue> {
   void SeekToLast() override;
   void Next() final override;
   bool NextAndGetResult(IterateResult* result) override;
+  bool NextBatch(IterateBatch* batch, IterateResult* result) override;
   void Prev() override;
   bool Valid() const override {
     return !is_out_of_bound_ &&
@@ -716,6 +743,23 @@ class BlockBasedTableIterator : public InternalIteratorBase<TValue> {
            block_iter_points_to_real_block_;
   }
 
+  // Returns false, and invalidates the iterator, if the range filter shows
+  // that the table has no key in [ikey, iterate_upper_bound).
+  bool CheckRangeMayMatch(const Slice& ikey) {
+    bool has_key_after = false;
+    if (block_type_ == BlockType::kData &&
+        read_options_.iterate_upper_bound != nullptr &&
+        !table_->RangeMayMatch(ikey, *read_options_.iterate_upper_bound,
+                               &has_key_after)) {
+      ResetDataIter();
+      // If the table has a key after the range, no key from ikey on is
+      // within the bound, so a LevelIterator need not try the next files.
+      is_out_of_bound_ = has_key_after;
+      return false;
+    }
+    return true;
+  }
+
   bool CheckPrefixMayMatch(const Slice& ikey) {
     if (check_filter_ &&
         !table_->PrefixMayMatch(ikey, read_options_, prefix_extractor_,
@@ -800,4 +844,11 @@ class BlockBasedTableIterator : public InternalIteratorBase<TValue> {
   void CheckDataBlockWithinUpperBound();
 };
 
+// Index blocks are not read in batches.
+template <>
+inline bool BlockBasedTableIterator<IndexBlockIter, IndexValue>::NextBatch(
+    IterateBatch* /*batch*/, IterateResult* result) {
+  return NextAndGetResult(result);
+}
+
 }  // namespace rocksdb
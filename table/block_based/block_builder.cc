@@ -46,10 +46,13 @@ BlockBuilder::BlockBuilder(
     int block_restart_interval, bool use_delta_encoding,
     bool use_value_delta_encoding,
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    double data_block_hash_table_util_ratio)
+    double data_block_hash_table_util_ratio, bool use_restart_key_prefixes,
+    bool key_includes_seq, bool use_index_hash)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
       use_value_delta_encoding_(use_value_delta_encoding),
+      use_restart_key_prefixes_(use_restart_key_prefixes),
+      key_includes_seq_(key_includes_seq),
       restarts_(),
       counter_(0),
       finished_(false) {
@@ -63,22 +66,36 @@ BlockBuilder::BlockBuilder(
     default:
       assert(0);
   }
+  if (use_index_hash) {
+    assert(index_type == BlockBasedTableOptions::kDataBlockBinarySearch);
+    index_hash_builder_.Initialize(data_block_hash_table_util_ratio);
+  }
   assert(block_restart_interval_ >= 1);
   restarts_.push_back(0);  // First restart point is at offset 0
   estimate_ = sizeof(uint32_t) + sizeof(uint32_t);
+  if (use_restart_key_prefixes_) {
+    estimate_ += sizeof(uint64_t);
+  }
 }
 
 void BlockBuilder::Reset() {
   buffer_.clear();
   restarts_.clear();
   restarts_.push_back(0);  // First restart point is at offset 0
+  restart_key_prefixes_.clear();
   estimate_ = sizeof(uint32_t) + sizeof(uint32_t);
+  if (use_restart_key_prefixes_) {
+    estimate_ += sizeof(uint64_t);
+  }
   counter_ = 0;
   finished_ = false;
   last_key_.clear();
   if (data_block_hash_index_builder_.Valid()) {
     data_block_hash_index_builder_.Reset();
   }
+  if (index_hash_builder_.Valid()) {
+    index_hash_builder_.Reset();
+  }
 }
 
 size_t BlockBuilder::EstimateSizeAfterKV(const Slice& key,
@@ -96,6 +113,9 @@ size_t BlockBuilder::EstimateSizeAfterKV(const Slice& key,
 
   if (counter_ >= block_restart_interval_) {
     estimate += sizeof(uint32_t);  // a new restart entry.
+    if (use_restart_key_prefixes_) {
+      estimate += sizeof(uint64_t);
+    }
   }
 
   estimate += sizeof(int32_t);  // varint for shared prefix length.
@@ -114,6 +134,16 @@ Slice BlockBuilder::Finish() {
   for (size_t i = 0; i < restarts_.size(); i++) {
     PutFixed32(&buffer_, restarts_[i]);
   }
+  // Append restart key prefix array. The first key may be missing if the
+  // block is empty.
+  const bool has_restart_key_prefixes =
+      use_restart_key_prefixes_ &&
+      restart_key_prefixes_.size() == restarts_.size();
+  if (has_restart_key_prefixes) {
+    for (uint64_t prefix : restart_key_prefixes_) {
+      PutFixed64(&buffer_, prefix);
+    }
+  }
 
   uint32_t num_restarts = static_cast<uint32_t>(restarts_.size());
   BlockBasedTableOptions::DataBlockIndexType index_type =
@@ -123,15 +153,31 @@ Slice BlockBuilder::Finish() {
     data_block_hash_index_builder_.Finish(buffer_);
     index_type = BlockBasedTableOptions::kDataBlockBinaryAndHash;
   }
+  const bool has_index_hash = index_hash_builder_.Valid();
+  if (has_index_hash) {
+    index_hash_builder_.Finish(buffer_);
+  }
 
   // footer is a packed format of data_block_index_type and num_restarts
-  uint32_t block_footer = PackIndexTypeAndNumRestarts(index_type, num_restarts);
+  uint32_t block_footer = PackIndexTypeAndNumRestarts(
+      index_type, num_restarts, has_restart_key_prefixes, has_index_hash);
 
   PutFixed32(&buffer_, block_footer);
   finished_ = true;
   return Slice(buffer_);
 }
 
+void BlockBuilder::AddIndexHashes(const std::vector<uint32_t>& key_hashes) {
+  assert(!finished_);
+  assert(!buffer_.empty());
+  if (!index_hash_builder_.Valid()) {
+    return;
+  }
+  for (uint32_t key_hash : key_hashes) {
+    index_hash_builder_.Add(key_hash, restarts_.size() - 1);
+  }
+}
+
 void BlockBuilder::Add(const Slice& key, const Slice& value,
                        const Slice* const delta_value) {
   assert(!finished_);
@@ -142,6 +188,9 @@ void BlockBuilder::Add(const Slice& key, const Slice& value,
     // Restart compression
     restarts_.push_back(static_cast<uint32_t>(buffer_.size()));
     estimate_ += sizeof(uint32_t);
+    if (use_restart_key_prefixes_) {
+      estimate_ += sizeof(uint64_t);
+    }
     counter_ = 0;
 
     if (use_delta_encoding_) {
@@ -159,6 +208,11 @@ void BlockBuilder::Add(const Slice& key, const Slice& value,
     last_key_.assign(key.data(), key.size());
   }
 
+  if (use_restart_key_prefixes_ && counter_ == 0) {
+    restart_key_prefixes_.push_back(GetRestartKeyPrefix(
+        key_includes_seq_ ? ExtractUserKey(key) : key));
+  }
+
   const size_t non_shared = key.size() - shared;
   const size_t curr_size = buffer_.size();
 
@@ -11,9 +11,11 @@
 #include <vector>
 
 #include <stdint.h>
+#include "rocksdb/comparator.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/table.h"
 #include "table/block_based/data_block_hash_index.h"
+#include "table/block_based/index_block_hash_index.h"
 
 namespace rocksdb {
 
@@ -27,7 +29,18 @@ class BlockBuilder {
                         bool use_value_delta_encoding = false,
                         BlockBasedTableOptions::DataBlockIndexType index_type =
                             BlockBasedTableOptions::kDataBlockBinarySearch,
-                        double data_block_hash_table_util_ratio = 0.75);
+                        double data_block_hash_table_util_ratio = 0.75,
+                        bool use_restart_key_prefixes = false,
+                        bool key_includes_seq = true,
+                        bool use_index_hash = false);
+
+  // Whether blocks of a table written with `format_version` whose keys are
+  // ordered by `user_comparator` should have a restart key prefix array.
+  // See GetRestartKeyPrefix() for the format.
+  static bool UseRestartKeyPrefixes(uint32_t format_version,
+                                    const Comparator* user_comparator) {
+    return format_version >= 6 && user_comparator == BytewiseComparator();
+  }
 
   // Reset the contents as if the BlockBuilder was just constructed.
   void Reset();
@@ -37,6 +50,11 @@ class BlockBuilder {
   void Add(const Slice& key, const Slice& value,
            const Slice* const delta_value = nullptr);
 
+  // Maps the key hashes to the restart interval of the last entry added, in
+  // the hash index of an index block, see index_block_hash_index.h.
+  // REQUIRES: use_index_hash, and an entry was added since the last Reset()
+  void AddIndexHashes(const std::vector<uint32_t>& key_hashes);
+
   // Finish building the block and return a slice that refers to the
   // block contents.  The returned slice will remain valid for the
   // lifetime of this builder or until Reset() is called.
@@ -45,9 +63,12 @@ class BlockBuilder {
   // Returns an estimate of the current (uncompressed) size of the block
   // we are building.
   inline size_t CurrentSizeEstimate() const {
-    return estimate_ + (data_block_hash_index_builder_.Valid()
-                            ? data_block_hash_index_builder_.EstimateSize()
-                            : 0);
+    return estimate_ +
+           (data_block_hash_index_builder_.Valid()
+                ? data_block_hash_index_builder_.EstimateSize()
+                : 0) +
+           (index_hash_builder_.Valid() ? index_hash_builder_.EstimateSize()
+                                        : 0);
   }
 
   // Returns an estimated block size after appending key and value.
@@ -62,14 +83,19 @@ class BlockBuilder {
   const bool use_delta_encoding_;
   // Refer to BlockIter::DecodeCurrentValue for format of delta encoded values
   const bool use_value_delta_encoding_;
+  const bool use_restart_key_prefixes_;
+  // Whether keys are internal keys, used to find the restart key prefixes
+  const bool key_includes_seq_;
 
   std::string buffer_;              // Destination buffer
   std::vector<uint32_t> restarts_;  // Restart points
+  std::vector<uint64_t> restart_key_prefixes_;
   size_t estimate_;
   int counter_;    // Number of entries emitted since restart
   bool finished_;  // Has Finish() been called?
   std::string last_key_;
   DataBlockHashIndexBuilder data_block_hash_index_builder_;
+  IndexBlockHashIndexBuilder index_hash_builder_;
 };
 
 }  // namespace rocksdb
@@ -22,6 +22,8 @@
 #include "rocksdb/table.h"
 #include "table/block_based/block.h"
 #include "table/block_based/block_builder.h"
+#include "table/block_based/index_block_hash_index.h"
+#include "table/block_based/learned_index_model.h"
 #include "table/format.h"
 #include "test_util/testharness.h"
 #include "test_util/testutil.h"
@@ -493,6 +495,330 @@ TEST_F(BlockTest, ReadAmpBitmapPow2) {
   ASSERT_EQ(BlockReadAmpBitmap(100, 35, stats.get()).GetBytesPerBit(), 32u);
 }
 
+// Sorted user keys that often share their first 8 bytes, or differ from each
+// other only by zero bytes within them.
+std::vector<std::string> GenerateRestartKeyPrefixTestKeys(int num_keys) {
+  Random rnd(303);
+  const char kAlphabet[] = {'\0', '\1', 'a', '\xff'};
+  std::set<std::string> keys;
+  while (static_cast<int>(keys.size()) < num_keys) {
+    std::string key =
+        rnd.OneIn(2) ? std::string("restart\0", 8) : std::string();
+    const int len = static_cast<int>(rnd.Uniform(12));
+    for (int i = 0; i < len; i++) {
+      key.push_back(kAlphabet[rnd.Uniform(sizeof(kAlphabet))]);
+    }
+    keys.insert(key);
+  }
+  return std::vector<std::string>(keys.begin(), keys.end());
+}
+
+TEST_F(BlockTest, RestartKeyPrefixes) {
+  Random rnd(301);
+  InternalKeyComparator icmp(BytewiseComparator());
+  std::vector<std::string> user_keys = GenerateRestartKeyPrefixTestKeys(500);
+
+  for (int restart_interval : {1, 4, 16}) {
+    for (auto index_type : {BlockBasedTableOptions::kDataBlockBinarySearch,
+                            BlockBasedTableOptions::kDataBlockBinaryAndHash}) {
+      BlockBuilder builder(restart_interval, true /* use_delta_encoding */,
+                           false /* use_value_delta_encoding */, index_type,
+                           0.75, true /* use_restart_key_prefixes */);
+      BlockBuilder plain_builder(restart_interval);
+      for (size_t i = 0; i < user_keys.size(); i++) {
+        // Two versions of each key
+        for (SequenceNumber seq : {2, 1}) {
+          std::string ikey = InternalKey(user_keys[i], seq, kTypeValue).Encode()
+                                 .ToString();
+          builder.Add(ikey, ToString(i));
+          plain_builder.Add(ikey, ToString(i));
+        }
+      }
+      BlockContents contents;
+      contents.data = builder.Finish();
+      Block reader(std::move(contents), kDisableGlobalSequenceNumber);
+      BlockContents plain_contents;
+      plain_contents.data = plain_builder.Finish();
+      Block plain_reader(std::move(plain_contents),
+                         kDisableGlobalSequenceNumber);
+      ASSERT_TRUE(reader.HasRestartKeyPrefixes());
+      ASSERT_FALSE(plain_reader.HasRestartKeyPrefixes());
+      ASSERT_EQ(plain_reader.NumRestarts(), reader.NumRestarts());
+      if (reader.NumRestarts() <= kMaxRestartSupportedByHashIndex) {
+        ASSERT_EQ(index_type, reader.IndexType());
+      }
+      if (index_type == BlockBasedTableOptions::kDataBlockBinarySearch) {
+        ASSERT_EQ(plain_reader.size() + reader.NumRestarts() * sizeof(uint64_t),
+                  reader.size());
+      }
+
+      std::unique_ptr<DataBlockIter> iter(
+          reader.NewDataIterator(&icmp, icmp.user_comparator()));
+      std::unique_ptr<DataBlockIter> plain_iter(
+          plain_reader.NewDataIterator(&icmp, icmp.user_comparator()));
+      int count = 0;
+      for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        count++;
+      }
+      ASSERT_OK(iter->status());
+      ASSERT_EQ(user_keys.size() * 2, count);
+
+      // Seek to existing keys, to keys between them and past the ends, and
+      // compare with a block without restart key prefixes
+      std::vector<std::string> targets = user_keys;
+      targets.emplace_back("");
+      targets.emplace_back("\xff\xff\xff\xff\xff\xff\xff\xff\xff");
+      for (const auto& user_key : user_keys) {
+        targets.emplace_back(user_key + '\0');
+        if (!user_key.empty()) {
+          targets.emplace_back(user_key.substr(0, user_key.size() - 1));
+        }
+      }
+      for (const auto& target : targets) {
+        for (SequenceNumber seq : {kMaxSequenceNumber, SequenceNumber{1}}) {
+          std::string seek_key =
+              InternalKey(target, seq, kValueTypeForSeek).Encode().ToString();
+          iter->Seek(seek_key);
+          plain_iter->Seek(seek_key);
+          ASSERT_EQ(plain_iter->Valid(), iter->Valid());
+          if (iter->Valid()) {
+            ASSERT_EQ(plain_iter->key().ToString(), iter->key().ToString());
+          }
+          iter->SeekForPrev(seek_key);
+          plain_iter->SeekForPrev(seek_key);
+          ASSERT_EQ(plain_iter->Valid(), iter->Valid());
+          if (iter->Valid()) {
+            ASSERT_EQ(plain_iter->key().ToString(), iter->key().ToString());
+          }
+        }
+      }
+      ASSERT_OK(iter->status());
+    }
+  }
+}
+
+TEST_F(BlockTest, RestartKeyPrefixesInIndexBlock) {
+  InternalKeyComparator icmp(BytewiseComparator());
+  std::vector<std::string> user_keys = GenerateRestartKeyPrefixTestKeys(500);
+
+  BlockBuilder builder(1, true /* use_delta_encoding */,
+                       true /* use_value_delta_encoding */,
+                       BlockBasedTableOptions::kDataBlockBinarySearch, 0.75,
+                       true /* use_restart_key_prefixes */,
+                       false /* key_includes_seq */);
+  BlockHandle last_handle = BlockHandle::NullBlockHandle();
+  uint64_t offset = 0;
+  for (const auto& user_key : user_keys) {
+    IndexValue entry(BlockHandle(offset, 100), Slice());
+    offset += 100 + kBlockTrailerSize;
+    std::string encoded_entry;
+    std::string delta_encoded_entry;
+    entry.EncodeTo(&encoded_entry, false, nullptr);
+    if (!last_handle.IsNull()) {
+      entry.EncodeTo(&delta_encoded_entry, false, &last_handle);
+    }
+    last_handle = entry.handle;
+    const Slice delta_encoded_entry_slice(delta_encoded_entry);
+    builder.Add(user_key, encoded_entry, &delta_encoded_entry_slice);
+  }
+  BlockContents contents;
+  contents.data = builder.Finish();
+  Block reader(std::move(contents), kDisableGlobalSequenceNumber);
+  ASSERT_TRUE(reader.HasRestartKeyPrefixes());
+
+  std::unique_ptr<IndexBlockIter> iter(reader.NewIndexIterator(
+      &icmp, icmp.user_comparator(), nullptr, nullptr,
+      true /* total_order_seek */, false /* have_first_key */,
+      false /* key_includes_seq */, false /* value_is_full */));
+  for (size_t i = 0; i < user_keys.size(); i++) {
+    // The first separator not less than the key, also when seeking to the
+    // largest key less than it
+    iter->Seek(
+        InternalKey(user_keys[i], kMaxSequenceNumber, kValueTypeForSeek)
+            .Encode());
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(user_keys[i], iter->key().ToString());
+    ASSERT_EQ(i * (100 + kBlockTrailerSize), iter->value().handle.offset());
+    std::string smaller = user_keys[i].substr(0, user_keys[i].size() - 1);
+    if (i > 0 && smaller > user_keys[i - 1]) {
+      iter->Seek(InternalKey(smaller, kMaxSequenceNumber, kValueTypeForSeek)
+                     .Encode());
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(user_keys[i], iter->key().ToString());
+    }
+  }
+  iter->Seek(InternalKey(user_keys.back() + '\0', kMaxSequenceNumber,
+                         kValueTypeForSeek)
+                 .Encode());
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_OK(iter->status());
+}
+
+// A key whose restart key prefix is `prefix`
+std::string EncodeRestartKeyPrefix(uint64_t prefix) {
+  std::string key(8, '\0');
+  for (int i = 7; i >= 0; i--, prefix >>= 8) {
+    key[i] = static_cast<char>(prefix & 0xff);
+  }
+  return key + "suffix";
+}
+
+TEST_F(BlockTest, LearnedIndexModel) {
+  const uint32_t kMaxError = 8;
+  Random64 rnd(301);
+  for (int iter = 0; iter < 20; iter++) {
+    // Gaps of varying scale, and a few runs of equal prefixes
+    std::vector<uint64_t> prefixes;
+    const uint32_t num_restarts = 1 + static_cast<uint32_t>(rnd.Uniform(5000));
+    uint64_t prefix = rnd.Uniform(1000);
+    while (prefixes.size() < num_restarts) {
+      const size_t run = rnd.OneIn(50) ? 1 + rnd.Uniform(kMaxError + 1) : 1;
+      for (size_t i = 0; i < run && prefixes.size() < num_restarts; i++) {
+        prefixes.push_back(prefix);
+      }
+      prefix += rnd.OneIn(20) ? rnd.Uniform(uint64_t{1} << 40)
+                              : 1 + rnd.Uniform(1000);
+    }
+    LearnedIndexModelBuilder builder(kMaxError);
+    for (uint64_t p : prefixes) {
+      builder.AddRestartKey(EncodeRestartKeyPrefix(p));
+    }
+    std::string contents = builder.Finish().ToString();
+    std::unique_ptr<LearnedIndexModel> model;
+    ASSERT_OK(LearnedIndexModel::Create(contents, &model));
+    ASSERT_EQ(num_restarts, model->num_restarts());
+
+    // The binary search for a target ends at or after the last restart point
+    // with a smaller prefix, and at or before the last one with a prefix not
+    // greater.
+    for (int i = 0; i < 5000; i++) {
+      uint64_t target;
+      switch (rnd.Uniform(3)) {
+        case 0:
+          target = prefixes[rnd.Uniform(prefixes.size())];
+          break;
+        case 1:
+          target = prefixes[rnd.Uniform(prefixes.size())] + 1;
+          break;
+        default:
+          target = rnd.Next();
+          break;
+      }
+      const uint32_t num_less = static_cast<uint32_t>(
+          std::lower_bound(prefixes.begin(), prefixes.end(), target) -
+          prefixes.begin());
+      const uint32_t num_not_greater = static_cast<uint32_t>(
+          std::upper_bound(prefixes.begin(), prefixes.end(), target) -
+          prefixes.begin());
+      uint32_t left, right;
+      model->Predict(target, &left, &right);
+      ASSERT_LE(left, right);
+      ASSERT_LT(right, num_restarts);
+      ASSERT_LE(left, num_less > 0 ? num_less - 1 : 0);
+      ASSERT_GE(right, num_not_greater > 0 ? num_not_greater - 1 : 0);
+      // Much smaller than the block
+      ASSERT_LE(right - left, 2 * kMaxError + 4);
+    }
+
+    // Truncated contents
+    ASSERT_TRUE(
+        LearnedIndexModel::Create(Slice(contents.data(), contents.size() - 1),
+                                  &model)
+            .IsCorruption());
+  }
+
+  // Too many restart points sharing a prefix
+  LearnedIndexModelBuilder builder(kMaxError);
+  for (uint32_t i = 0; i < kMaxError + 2; i++) {
+    builder.AddRestartKey(EncodeRestartKeyPrefix(1));
+  }
+  ASSERT_TRUE(builder.Finish().empty());
+}
+
+TEST_F(BlockTest, IndexBlockHashIndex) {
+  InternalKeyComparator icmp(BytewiseComparator());
+  Random rnd(301);
+  std::vector<std::string> user_keys = GenerateRestartKeyPrefixTestKeys(2000);
+
+  for (int restart_interval : {1, 4}) {
+    // Data blocks of 1 to 8 keys, indexed by their last key
+    std::vector<size_t> last_key_index;
+    for (size_t i = 0; i < user_keys.size(); i += 1 + rnd.Uniform(8)) {
+      last_key_index.push_back(i);
+    }
+    last_key_index.back() = user_keys.size() - 1;
+
+    BlockBuilder builder(restart_interval, true /* use_delta_encoding */,
+                         false /* use_value_delta_encoding */,
+                         BlockBasedTableOptions::kDataBlockBinarySearch, 0.75,
+                         false /* use_restart_key_prefixes */,
+                         false /* key_includes_seq */,
+                         true /* use_index_hash */);
+    BlockBuilder plain_builder(restart_interval, true /* use_delta_encoding */,
+                               false /* use_value_delta_encoding */,
+                               BlockBasedTableOptions::kDataBlockBinarySearch,
+                               0.75, false /* use_restart_key_prefixes */,
+                               false /* key_includes_seq */);
+    size_t next_key = 0;
+    for (size_t i = 0; i < last_key_index.size(); i++) {
+      std::string encoded_entry;
+      IndexValue(BlockHandle(i * 100, 100), Slice())
+          .EncodeTo(&encoded_entry, false, nullptr);
+      builder.Add(user_keys[last_key_index[i]], encoded_entry);
+      plain_builder.Add(user_keys[last_key_index[i]], encoded_entry);
+      std::vector<uint32_t> key_hashes;
+      for (; next_key <= last_key_index[i]; next_key++) {
+        key_hashes.push_back(IndexBlockHashIndex::HashKey(user_keys[next_key]));
+      }
+      if (i % 10 == 5) {
+        // A key mapped to the wrong entry only costs a fallback
+        key_hashes.push_back(IndexBlockHashIndex::HashKey(user_keys[0]));
+      }
+      builder.AddIndexHashes(key_hashes);
+    }
+    BlockContents contents;
+    contents.data = builder.Finish();
+    Block reader(std::move(contents), kDisableGlobalSequenceNumber);
+    ASSERT_TRUE(reader.HasIndexHash());
+    BlockContents plain_contents;
+    plain_contents.data = plain_builder.Finish();
+    Block plain_reader(std::move(plain_contents), kDisableGlobalSequenceNumber);
+    ASSERT_FALSE(plain_reader.HasIndexHash());
+    ASSERT_EQ(reader.NumRestarts(), plain_reader.NumRestarts());
+
+    std::unique_ptr<IndexBlockIter> iter(reader.NewIndexIterator(
+        &icmp, icmp.user_comparator(), nullptr, nullptr,
+        true /* total_order_seek */, false /* have_first_key */,
+        false /* key_includes_seq */, true /* value_is_full */));
+    std::unique_ptr<IndexBlockIter> plain_iter(plain_reader.NewIndexIterator(
+        &icmp, icmp.user_comparator(), nullptr, nullptr,
+        true /* total_order_seek */, false /* have_first_key */,
+        false /* key_includes_seq */, true /* value_is_full */));
+    std::vector<std::string> targets = user_keys;
+    for (int i = 0; i < 1000; i++) {
+      // Mostly absent keys
+      targets.push_back(user_keys[rnd.Uniform(static_cast<int>(
+                            user_keys.size()))] +
+                        RandomString(&rnd, 1));
+    }
+    targets.push_back(user_keys.back() + '\0');
+    for (const auto& target : targets) {
+      const std::string seek_key =
+          InternalKey(target, kMaxSequenceNumber, kValueTypeForSeek).Encode()
+              .ToString();
+      iter->Seek(seek_key);
+      plain_iter->Seek(seek_key);
+      ASSERT_OK(iter->status());
+      ASSERT_EQ(plain_iter->Valid(), iter->Valid());
+      if (iter->Valid()) {
+        ASSERT_EQ(plain_iter->key().ToString(), iter->key().ToString());
+        ASSERT_EQ(plain_iter->value().handle.offset(),
+                  iter->value().handle.offset());
+      }
+    }
+  }
+}
+
 class IndexBlockTest
     : public testing::Test,
       public testing::WithParamInterface<std::tuple<bool, bool>> {
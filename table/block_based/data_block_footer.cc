@@ -15,15 +15,24 @@ namespace rocksdb {
 
 const int kDataBlockIndexTypeBitShift = 31;
 
-// 0x7FFFFFFF
-const uint32_t kMaxNumRestarts = (1u << kDataBlockIndexTypeBitShift) - 1u;
+// A block cannot hold 2^30 restart points (4 bytes each) as block sizes fit
+// in 32 bits, so the bit is free in blocks written by older versions.
+const int kRestartKeyPrefixesBitShift = 30;
 
-// 0x7FFFFFFF
-const uint32_t kNumRestartsMask = (1u << kDataBlockIndexTypeBitShift) - 1u;
+// Neither can it hold 2^29 restart points in practice, as the restart array
+// alone would take 2GB.
+const int kIndexHashBitShift = 29;
+
+// 0x1FFFFFFF
+const uint32_t kMaxNumRestarts = (1u << kIndexHashBitShift) - 1u;
+
+// 0x1FFFFFFF
+const uint32_t kNumRestartsMask = (1u << kIndexHashBitShift) - 1u;
 
 uint32_t PackIndexTypeAndNumRestarts(
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    uint32_t num_restarts) {
+    uint32_t num_restarts, bool has_restart_key_prefixes,
+    bool has_index_hash) {
   if (num_restarts > kMaxNumRestarts) {
     assert(0);  // mute travis "unused" warning
   }
@@ -34,6 +43,12 @@ uint32_t PackIndexTypeAndNumRestarts(
   } else if (index_type != BlockBasedTableOptions::kDataBlockBinarySearch) {
     assert(0);
   }
+  if (has_restart_key_prefixes) {
+    block_footer |= 1u << kRestartKeyPrefixesBitShift;
+  }
+  if (has_index_hash) {
+    block_footer |= 1u << kIndexHashBitShift;
+  }
 
   return block_footer;
 }
@@ -41,7 +56,8 @@ uint32_t PackIndexTypeAndNumRestarts(
 void UnPackIndexTypeAndNumRestarts(
     uint32_t block_footer,
     BlockBasedTableOptions::DataBlockIndexType* index_type,
-    uint32_t* num_restarts) {
+    uint32_t* num_restarts, bool* has_restart_key_prefixes,
+    bool* has_index_hash) {
   if (index_type) {
     if (block_footer & 1u << kDataBlockIndexTypeBitShift) {
       *index_type = BlockBasedTableOptions::kDataBlockBinaryAndHash;
@@ -50,6 +66,15 @@ void UnPackIndexTypeAndNumRestarts(
     }
   }
 
+  if (has_restart_key_prefixes) {
+    *has_restart_key_prefixes =
+        (block_footer & 1u << kRestartKeyPrefixesBitShift) != 0;
+  }
+
+  if (has_index_hash) {
+    *has_index_hash = (block_footer & 1u << kIndexHashBitShift) != 0;
+  }
+
   if (num_restarts) {
     *num_restarts = block_footer & kNumRestartsMask;
     assert(*num_restarts <= kMaxNumRestarts);
@@ -9,17 +9,39 @@
 
 #pragma once
 
+#include "rocksdb/slice.h"
 #include "rocksdb/table.h"
 
 namespace rocksdb {
 
+// The block footer packs num_restarts with the data block index type,
+// whether the block has a restart key prefix array and whether it is an index
+// block with a hash index (see index_block_hash_index.h).
 uint32_t PackIndexTypeAndNumRestarts(
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    uint32_t num_restarts);
+    uint32_t num_restarts, bool has_restart_key_prefixes = false,
+    bool has_index_hash = false);
 
 void UnPackIndexTypeAndNumRestarts(
     uint32_t block_footer,
     BlockBasedTableOptions::DataBlockIndexType* index_type,
-    uint32_t* num_restarts);
+    uint32_t* num_restarts, bool* has_restart_key_prefixes = nullptr,
+    bool* has_index_hash = nullptr);
+
+// Blocks written with format_version >= 6 and BytewiseComparator store, right
+// after the restart array, one fixed64 per restart point holding the first 8
+// bytes of the user key of that restart point, zero padded and read as a
+// big-endian integer. If two prefixes differ, the keys compare the same way,
+// so a seek can narrow the restart interval down without decoding any key.
+inline uint64_t GetRestartKeyPrefix(const Slice& user_key) {
+  uint64_t prefix = 0;
+  const size_t n = user_key.size() < sizeof(prefix) ? user_key.size()
+                                                    : sizeof(prefix);
+  for (size_t i = 0; i < n; i++) {
+    prefix |= static_cast<uint64_t>(static_cast<unsigned char>(user_key[i]))
+              << (8 * (sizeof(prefix) - 1 - i));
+  }
+  return prefix;
+}
 
 }  // namespace rocksdb
@@ -0,0 +1,91 @@
+// Copyright (c) 2011-present, Facebook, Inc. All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/index_block_hash_index.h"
+
+#include <assert.h>
+
+#include "table/block_based/data_block_hash_index.h"
+#include "util/coding.h"
+#include "util/hash.h"
+
+namespace rocksdb {
+
+void IndexBlockHashIndexBuilder::Initialize(double util_ratio) {
+  if (util_ratio <= 0) {
+    util_ratio = kDefaultUtilRatio;  // sanity check
+  }
+  bucket_per_key_ = 1 / util_ratio;
+  valid_ = true;
+}
+
+void IndexBlockHashIndexBuilder::Add(uint32_t key_hash,
+                                     size_t restart_index) {
+  assert(Valid());
+  if (restart_index > kMaxRestartSupportedByIndexHash) {
+    valid_ = false;
+    return;
+  }
+  hash_and_restart_pairs_.emplace_back(key_hash,
+                                       static_cast<uint16_t>(restart_index));
+  estimated_num_buckets_ += bucket_per_key_;
+}
+
+void IndexBlockHashIndexBuilder::Finish(std::string& buffer) {
+  assert(Valid());
+  // An odd number of buckets spreads the hashes better, as for data blocks
+  const uint32_t num_buckets =
+      static_cast<uint32_t>(estimated_num_buckets_) | 1;
+
+  std::vector<uint16_t> buckets(num_buckets, kIndexHashNoEntry);
+  for (const auto& entry : hash_and_restart_pairs_) {
+    uint16_t& bucket = buckets[entry.first % num_buckets];
+    if (bucket == kIndexHashNoEntry) {
+      bucket = entry.second;
+    } else if (bucket != entry.second) {
+      bucket = kIndexHashCollision;
+    }
+  }
+
+  for (uint16_t restart_index : buckets) {
+    PutFixed16(&buffer, restart_index);
+  }
+  PutFixed32(&buffer, num_buckets);
+}
+
+void IndexBlockHashIndexBuilder::Reset() {
+  estimated_num_buckets_ = 0;
+  valid_ = true;
+  hash_and_restart_pairs_.clear();
+}
+
+uint32_t IndexBlockHashIndex::HashKey(const Slice& user_key) {
+  return GetSliceHash(user_key);
+}
+
+bool IndexBlockHashIndex::Initialize(const char* data, uint32_t size,
+                                     uint32_t* map_offset) {
+  if (size < sizeof(uint32_t)) {
+    return false;
+  }
+  const uint32_t num_buckets = DecodeFixed32(data + size - sizeof(uint32_t));
+  const uint64_t map_size =
+      static_cast<uint64_t>(num_buckets) * sizeof(uint16_t);
+  if (num_buckets == 0 || map_size > size - sizeof(uint32_t)) {
+    return false;
+  }
+  *map_offset = static_cast<uint32_t>(size - sizeof(uint32_t) - map_size);
+  buckets_ = data + *map_offset;
+  num_buckets_ = num_buckets;
+  return true;
+}
+
+uint16_t IndexBlockHashIndex::Lookup(const Slice& user_key) const {
+  assert(Valid());
+  const uint32_t idx = HashKey(user_key) % num_buckets_;
+  return DecodeFixed16(buckets_ + idx * sizeof(uint16_t));
+}
+
+}  // namespace rocksdb
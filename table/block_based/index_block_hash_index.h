@@ -0,0 +1,102 @@
+// Copyright (c) 2011-present, Facebook, Inc. All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rocksdb/slice.h"
+
+namespace rocksdb {
+
+// A hash index for the index partitions of kTwoLevelIndexSearch, see
+// BlockBasedTableOptions::hash_index_partitions. Like the data block hash
+// index (see data_block_hash_index.h), it maps user keys to restart points,
+// but the keys are those of the data blocks the partition points to: the
+// hash of each user key maps to the restart interval holding the index entry
+// of the first data block containing the key.
+//
+// The hash index is appended to the index block, after the restart array
+// and the restart key prefix array, if any:
+//
+// INDEX_BLOCK: [ENTRIES RESTARTS [PREFIXES] HASH_IDX FOOTER]
+// HASH_IDX:    [B B B ... B NUM_BUCK]
+//
+// B:         bucket, the restart index of the keys hashed to it, as a
+//            fixed16.
+// NUM_BUCK:  number of buckets, as a fixed32.
+// FOOTER:    the block footer, with the flag telling the hash index is there
+//            (see data_block_footer.h).
+//
+// Like for data blocks, a bucket holding keys of two restart intervals is
+// marked as a collision. Because the keys looked up need not be in the
+// table, a seek only uses the restart interval found in the hash index after
+// checking with the keys of the restart points around it that a binary
+// search would have picked it, and falls back to the binary search
+// otherwise. A wrong or missing entry thus only costs a few key comparisons.
+//
+// Index blocks with more than kMaxRestartSupportedByIndexHash restart points
+// get no hash index.
+const uint16_t kIndexHashNoEntry = 0xFFFF;
+const uint16_t kIndexHashCollision = 0xFFFE;
+const uint16_t kMaxRestartSupportedByIndexHash = 0xFFFD;
+
+class IndexBlockHashIndexBuilder {
+ public:
+  IndexBlockHashIndexBuilder()
+      : bucket_per_key_(-1 /*uninitialized marker*/),
+        estimated_num_buckets_(0),
+        valid_(false) {}
+
+  void Initialize(double util_ratio);
+
+  inline bool Valid() const { return valid_ && bucket_per_key_ > 0; }
+
+  // Maps the key hash, as given by IndexBlockHashIndex::HashKey(), to the
+  // restart interval.
+  void Add(uint32_t key_hash, size_t restart_index);
+  void Finish(std::string& buffer);
+  void Reset();
+
+  inline size_t EstimateSize() const {
+    return sizeof(uint32_t) +
+           (static_cast<size_t>(estimated_num_buckets_) | 1) *
+               sizeof(uint16_t);
+  }
+
+ private:
+  double bucket_per_key_;  // is the multiplicative inverse of util_ratio_
+  double estimated_num_buckets_;
+  // Marked false when the restart index gets too large for the buckets. The
+  // hash index is then not appended to the block.
+  bool valid_;
+  std::vector<std::pair<uint32_t, uint16_t>> hash_and_restart_pairs_;
+};
+
+class IndexBlockHashIndex {
+ public:
+  IndexBlockHashIndex() : buckets_(nullptr), num_buckets_(0) {}
+
+  static uint32_t HashKey(const Slice& user_key);
+
+  // Reads the hash index that ends at data + size. Sets *map_offset to the
+  // offset of its first bucket and returns true, or returns false if the
+  // hash index does not fit.
+  bool Initialize(const char* data, uint32_t size, uint32_t* map_offset);
+
+  // Returns the restart index stored for the user key, or kIndexHashNoEntry
+  // or kIndexHashCollision.
+  uint16_t Lookup(const Slice& user_key) const;
+
+  inline bool Valid() const { return num_buckets_ != 0; }
+
+ private:
+  const char* buckets_;
+  uint32_t num_buckets_;
+};
+
+}  // namespace rocksdb
@@ -17,6 +17,7 @@
 
 #include "rocksdb/comparator.h"
 #include "rocksdb/flush_block_policy.h"
+#include "table/block_based/index_block_hash_index.h"
 #include "table/block_based/partitioned_filter_block.h"
 #include "table/format.h"
 
@@ -54,6 +55,12 @@ IndexBuilder* IndexBuilder::CreateIndexBuilder(
           table_opt.format_version, use_value_delta_encoding,
           table_opt.index_shortening, /* include_first_key */ true);
     } break;
+    case BlockBasedTableOptions::kLearnedIndexSearch: {
+      result = new LearnedIndexBuilder(
+          comparator, table_opt.index_block_restart_interval,
+          table_opt.format_version, use_value_delta_encoding,
+          table_opt.index_shortening);
+    } break;
     default: {
       assert(!"Do not recognize the index type ");
     } break;
@@ -74,12 +81,22 @@ PartitionedIndexBuilder::PartitionedIndexBuilder(
     const BlockBasedTableOptions& table_opt,
     const bool use_value_delta_encoding)
     : IndexBuilder(comparator),
-      index_block_builder_(table_opt.index_block_restart_interval,
-                           true /*use_delta_encoding*/,
-                           use_value_delta_encoding),
-      index_block_builder_without_seq_(table_opt.index_block_restart_interval,
-                                       true /*use_delta_encoding*/,
-                                       use_value_delta_encoding),
+      index_block_builder_(
+          table_opt.index_block_restart_interval, true /*use_delta_encoding*/,
+          use_value_delta_encoding,
+          BlockBasedTableOptions::kDataBlockBinarySearch,
+          0.75 /* data_block_hash_table_util_ratio */,
+          BlockBuilder::UseRestartKeyPrefixes(table_opt.format_version,
+                                              comparator->user_comparator()),
+          true /* key_includes_seq */),
+      index_block_builder_without_seq_(
+          table_opt.index_block_restart_interval, true /*use_delta_encoding*/,
+          use_value_delta_encoding,
+          BlockBasedTableOptions::kDataBlockBinarySearch,
+          0.75 /* data_block_hash_table_util_ratio */,
+          BlockBuilder::UseRestartKeyPrefixes(table_opt.format_version,
+                                              comparator->user_comparator()),
+          false /* key_includes_seq */),
       sub_index_builder_(nullptr),
       table_opt_(table_opt),
       // We start by false. After each partition we revise the value based on
@@ -100,7 +117,9 @@ void PartitionedIndexBuilder::MakeNewSubIndexBuilder() {
   sub_index_builder_ = new ShortenedIndexBuilder(
       comparator_, table_opt_.index_block_restart_interval,
       table_opt_.format_version, use_value_delta_encoding_,
-      table_opt_.index_shortening, /* include_first_key */ false);
+      table_opt_.index_shortening, /* include_first_key */ false,
+      table_opt_.hash_index_partitions,
+      table_opt_.data_block_hash_table_util_ratio);
   flush_policy_.reset(FlushBlockBySizePolicyFactory::NewFlushBlockPolicy(
       table_opt_.metadata_block_size, table_opt_.block_size_deviation,
       // Note: this is sub-optimal since sub_index_builder_ could later reset
@@ -124,8 +143,8 @@ void PartitionedIndexBuilder::AddIndexEntry(
     if (sub_index_builder_ == nullptr) {
       MakeNewSubIndexBuilder();
     }
-    sub_index_builder_->AddIndexEntry(last_key_in_current_block,
-                                      first_key_in_next_block, block_handle);
+    AddSubIndexEntry(last_key_in_current_block, first_key_in_next_block,
+                     block_handle);
     if (sub_index_builder_->seperator_is_key_plus_seq_) {
       // then we need to apply it to all sub-index builders
       seperator_is_key_plus_seq_ = true;
@@ -155,8 +174,8 @@ void PartitionedIndexBuilder::AddIndexEntry(
     if (sub_index_builder_ == nullptr) {
       MakeNewSubIndexBuilder();
     }
-    sub_index_builder_->AddIndexEntry(last_key_in_current_block,
-                                      first_key_in_next_block, block_handle);
+    AddSubIndexEntry(last_key_in_current_block, first_key_in_next_block,
+                     block_handle);
     sub_index_last_key_ = std::string(*last_key_in_current_block);
     if (sub_index_builder_->seperator_is_key_plus_seq_) {
       // then we need to apply it to all sub-index builders
@@ -165,6 +184,35 @@ void PartitionedIndexBuilder::AddIndexEntry(
   }
 }
 
+void PartitionedIndexBuilder::OnKeyAdded(const Slice& key) {
+  if (!table_opt_.hash_index_partitions) {
+    return;
+  }
+  // Only the first version of a user key is looked up
+  const uint32_t key_hash = IndexBlockHashIndex::HashKey(ExtractUserKey(key));
+  if (!has_last_key_hash_ || key_hash != last_key_hash_) {
+    pending_key_hashes_.push_back(key_hash);
+    last_key_hash_ = key_hash;
+    has_last_key_hash_ = true;
+  }
+}
+
+void PartitionedIndexBuilder::AddSubIndexEntry(
+    std::string* last_key_in_current_block,
+    const Slice* first_key_in_next_block, const BlockHandle& block_handle) {
+  sub_index_builder_->AddIndexEntry(last_key_in_current_block,
+                                    first_key_in_next_block, block_handle);
+  if (!pending_key_hashes_.empty()) {
+    sub_index_builder_->index_block_builder_.AddIndexHashes(
+        pending_key_hashes_);
+    if (!sub_index_builder_->seperator_is_key_plus_seq_) {
+      sub_index_builder_->index_block_builder_without_seq_.AddIndexHashes(
+          pending_key_hashes_);
+    }
+    pending_key_hashes_.clear();
+  }
+}
+
 Status PartitionedIndexBuilder::Finish(
     IndexBlocks* index_blocks, const BlockHandle& last_partition_block_handle) {
   if (partition_cnt_ == 0) {
@@ -15,10 +15,12 @@
 #include <list>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "rocksdb/comparator.h"
 #include "table/block_based/block_based_table_factory.h"
 #include "table/block_based/block_builder.h"
+#include "table/block_based/learned_index_model.h"
 #include "table/format.h"
 
 namespace rocksdb {
@@ -125,14 +127,25 @@ class ShortenedIndexBuilder : public IndexBuilder {
       const int index_block_restart_interval, const uint32_t format_version,
       const bool use_value_delta_encoding,
       BlockBasedTableOptions::IndexShorteningMode shortening_mode,
-      bool include_first_key)
+      bool include_first_key, bool use_index_hash = false,
+      double index_hash_util_ratio = 0.75)
       : IndexBuilder(comparator),
-        index_block_builder_(index_block_restart_interval,
-                             true /*use_delta_encoding*/,
-                             use_value_delta_encoding),
-        index_block_builder_without_seq_(index_block_restart_interval,
-                                         true /*use_delta_encoding*/,
-                                         use_value_delta_encoding),
+        index_block_builder_(
+            index_block_restart_interval, true /*use_delta_encoding*/,
+            use_value_delta_encoding,
+            BlockBasedTableOptions::kDataBlockBinarySearch,
+            index_hash_util_ratio,
+            BlockBuilder::UseRestartKeyPrefixes(
+                format_version, comparator->user_comparator()),
+            true /* key_includes_seq */, use_index_hash),
+        index_block_builder_without_seq_(
+            index_block_restart_interval, true /*use_delta_encoding*/,
+            use_value_delta_encoding,
+            BlockBasedTableOptions::kDataBlockBinarySearch,
+            index_hash_util_ratio,
+            BlockBuilder::UseRestartKeyPrefixes(
+                format_version, comparator->user_comparator()),
+            false /* key_includes_seq */, use_index_hash),
         use_value_delta_encoding_(use_value_delta_encoding),
         include_first_key_(include_first_key),
         shortening_mode_(shortening_mode) {
@@ -352,6 +365,75 @@ class HashIndexBuilder : public IndexBuilder {
   uint64_t current_restart_index_ = 0;
 };
 
+// LearnedIndexBuilder builds the same index block as ShortenedIndexBuilder,
+// and a model of the keys of its restart points, stored in the
+// "rocksdb.learned_index.model" meta block. See LearnedIndexModel.
+class LearnedIndexBuilder : public IndexBuilder {
+ public:
+  explicit LearnedIndexBuilder(
+      const InternalKeyComparator* comparator,
+      int index_block_restart_interval, int format_version,
+      bool use_value_delta_encoding,
+      BlockBasedTableOptions::IndexShorteningMode shortening_mode)
+      : IndexBuilder(comparator),
+        primary_index_builder_(comparator, index_block_restart_interval,
+                               format_version, use_value_delta_encoding,
+                               shortening_mode, /* include_first_key */ false),
+        index_block_restart_interval_(index_block_restart_interval),
+        // Restart key prefixes are compared bytewise
+        use_model_(comparator->user_comparator() == BytewiseComparator()),
+        model_builder_(kMaxError) {}
+
+  virtual void AddIndexEntry(std::string* last_key_in_current_block,
+                             const Slice* first_key_in_next_block,
+                             const BlockHandle& block_handle) override {
+    primary_index_builder_.AddIndexEntry(last_key_in_current_block,
+                                         first_key_in_next_block, block_handle);
+    // The primary index builder replaced the key with the separator it added
+    if (use_model_ && num_entries_++ % index_block_restart_interval_ == 0) {
+      model_builder_.AddRestartKey(ExtractUserKey(*last_key_in_current_block));
+    }
+  }
+
+  virtual void OnKeyAdded(const Slice& key) override {
+    primary_index_builder_.OnKeyAdded(key);
+  }
+
+  virtual Status Finish(
+      IndexBlocks* index_blocks,
+      const BlockHandle& last_partition_block_handle) override {
+    Status s = primary_index_builder_.Finish(index_blocks,
+                                             last_partition_block_handle);
+    if (s.ok() && use_model_) {
+      model_ = model_builder_.Finish();
+      if (!model_.empty()) {
+        index_blocks->meta_blocks.insert(
+            {kLearnedIndexModelBlock.c_str(), model_});
+      }
+    }
+    return s;
+  }
+
+  virtual size_t IndexSize() const override {
+    return primary_index_builder_.IndexSize() + model_.size();
+  }
+
+  virtual bool seperator_is_key_plus_seq() override {
+    return primary_index_builder_.seperator_is_key_plus_seq();
+  }
+
+ private:
+  // Maximum distance between the predicted and the actual restart point
+  static const uint32_t kMaxError = 8;
+
+  ShortenedIndexBuilder primary_index_builder_;
+  const uint32_t index_block_restart_interval_;
+  const bool use_model_;
+  LearnedIndexModelBuilder model_builder_;
+  Slice model_;
+  uint64_t num_entries_ = 0;
+};
+
 /**
  * IndexBuilder for two-level indexing. Internally it creates a new index for
  * each partition and Finish then in order when Finish is called on it
@@ -379,6 +461,8 @@ class PartitionedIndexBuilder : public IndexBuilder {
                              const Slice* first_key_in_next_block,
                              const BlockHandle& block_handle) override;
 
+  virtual void OnKeyAdded(const Slice& key) override;
+
   virtual Status Finish(
       IndexBlocks* index_blocks,
       const BlockHandle& last_partition_block_handle) override;
@@ -415,6 +499,11 @@ class PartitionedIndexBuilder : public IndexBuilder {
   size_t partition_cnt_ = 0;
 
   void MakeNewSubIndexBuilder();
+  // Adds the index entry to the active partition, along with the hashes of
+  // the user keys of the data block
+  void AddSubIndexEntry(std::string* last_key_in_current_block,
+                        const Slice* first_key_in_next_block,
+                        const BlockHandle& block_handle);
 
   struct Entry {
     std::string key;
@@ -438,6 +527,11 @@ class PartitionedIndexBuilder : public IndexBuilder {
   bool partition_cut_requested_ = true;
   // true if it should cut the next filter partition block
   bool cut_filter_block = false;
+  // Hashes of the user keys of the next data block, for the hash index of
+  // its partition. See BlockBasedTableOptions::hash_index_partitions.
+  std::vector<uint32_t> pending_key_hashes_;
+  uint32_t last_key_hash_ = 0;
+  bool has_last_key_hash_ = false;
   BlockHandle last_encoded_handle_;
 };
 }  // namespace rocksdb
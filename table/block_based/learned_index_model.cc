@@ -0,0 +1,170 @@
+// Copyright (c) 2011-present, Facebook, Inc. All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/learned_index_model.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "table/block_based/data_block_footer.h"
+#include "util/coding.h"
+
+namespace rocksdb {
+
+namespace {
+const size_t kHeaderSize = 2 * sizeof(uint32_t);
+const size_t kSegmentSize = sizeof(uint64_t) + sizeof(uint32_t) +
+                            sizeof(uint64_t);
+
+uint64_t DoubleToBits(double d) {
+  uint64_t bits;
+  memcpy(&bits, &d, sizeof(bits));
+  return bits;
+}
+
+double BitsToDouble(uint64_t bits) {
+  double d;
+  memcpy(&d, &bits, sizeof(d));
+  return d;
+}
+}  // namespace
+
+LearnedIndexModelBuilder::LearnedIndexModelBuilder(uint32_t max_error)
+    : max_error_(max_error),
+      num_restarts_(0),
+      failed_(false),
+      last_prefix_start_(0),
+      last_prefix_(0),
+      start_prefix_(0),
+      start_index_(0),
+      min_slope_(0),
+      max_slope_(std::numeric_limits<double>::infinity()) {
+  // The header is filled in by Finish()
+  model_.resize(kHeaderSize);
+}
+
+void LearnedIndexModelBuilder::AddRestartKey(const Slice& user_key) {
+  const uint64_t prefix = GetRestartKeyPrefix(user_key);
+  const uint32_t index = num_restarts_++;
+  if (failed_) {
+    return;
+  }
+  if (index == 0) {
+    last_prefix_ = start_prefix_ = prefix;
+    return;
+  }
+  assert(prefix >= last_prefix_);
+  if (prefix != last_prefix_) {
+    last_prefix_ = prefix;
+    last_prefix_start_ = index;
+  } else if (index - last_prefix_start_ > max_error_) {
+    // All the restart points sharing a prefix get the same prediction
+    failed_ = true;
+    return;
+  }
+  if (prefix == start_prefix_) {
+    // Predicted as start_index_
+    return;
+  }
+
+  const double dx = static_cast<double>(prefix - start_prefix_);
+  const double dy = static_cast<double>(index) - start_index_;
+  const double lo = (dy - max_error_) / dx;
+  const double hi = (dy + max_error_) / dx;
+  if (lo > max_slope_ || hi < min_slope_) {
+    FinishSegment();
+    start_prefix_ = prefix;
+    start_index_ = index;
+    min_slope_ = 0;
+    max_slope_ = std::numeric_limits<double>::infinity();
+  } else {
+    min_slope_ = std::max(min_slope_, lo);
+    max_slope_ = std::min(max_slope_, hi);
+  }
+}
+
+void LearnedIndexModelBuilder::FinishSegment() {
+  const double slope = std::isinf(max_slope_)
+                           ? min_slope_
+                           : min_slope_ + (max_slope_ - min_slope_) / 2;
+  PutFixed64(&model_, start_prefix_);
+  PutFixed32(&model_, start_index_);
+  PutFixed64(&model_, DoubleToBits(slope));
+}
+
+Slice LearnedIndexModelBuilder::Finish() {
+  if (failed_ || num_restarts_ == 0) {
+    return Slice();
+  }
+  FinishSegment();
+  EncodeFixed32(&model_[0], max_error_);
+  EncodeFixed32(&model_[sizeof(uint32_t)], num_restarts_);
+  return Slice(model_);
+}
+
+Status LearnedIndexModel::Create(const Slice& contents,
+                                 std::unique_ptr<LearnedIndexModel>* model) {
+  if (contents.size() < kHeaderSize + kSegmentSize ||
+      (contents.size() - kHeaderSize) % kSegmentSize != 0) {
+    return Status::Corruption("Bad learned index model size");
+  }
+  const char* p = contents.data();
+  const uint32_t max_error = DecodeFixed32(p);
+  const uint32_t num_restarts = DecodeFixed32(p + sizeof(uint32_t));
+  p += kHeaderSize;
+  std::unique_ptr<LearnedIndexModel> result(
+      new LearnedIndexModel(max_error, num_restarts));
+  const size_t num_segments = (contents.size() - kHeaderSize) / kSegmentSize;
+  result->segments_.reserve(num_segments);
+  for (size_t i = 0; i < num_segments; i++) {
+    Segment segment;
+    segment.start_prefix = DecodeFixed64(p);
+    segment.start_index = DecodeFixed32(p + sizeof(uint64_t));
+    segment.slope =
+        BitsToDouble(DecodeFixed64(p + sizeof(uint64_t) + sizeof(uint32_t)));
+    p += kSegmentSize;
+    const bool ordered =
+        i == 0 ? segment.start_index == 0
+               : segment.start_prefix > result->segments_.back().start_prefix &&
+                     segment.start_index > result->segments_.back().start_index;
+    if (!ordered || segment.start_index >= num_restarts ||
+        !(segment.slope >= 0) || std::isinf(segment.slope)) {
+      return Status::Corruption("Bad learned index model segment");
+    }
+    result->segments_.push_back(segment);
+  }
+  *model = std::move(result);
+  return Status::OK();
+}
+
+void LearnedIndexModel::Predict(uint64_t key_prefix, uint32_t* left,
+                                uint32_t* right) const {
+  assert(!segments_.empty());
+  // The segment of the largest start prefix not greater than key_prefix
+  auto next = std::upper_bound(
+      segments_.begin(), segments_.end(), key_prefix,
+      [](uint64_t prefix, const Segment& s) { return prefix < s.start_prefix; });
+  double pos = 0;
+  if (next != segments_.begin()) {
+    const Segment& segment = *(next - 1);
+    pos = segment.start_index +
+          segment.slope *
+              static_cast<double>(key_prefix - segment.start_prefix);
+    const uint32_t limit =
+        next == segments_.end() ? num_restarts_ - 1 : next->start_index;
+    pos = std::min(pos, static_cast<double>(limit));
+  }
+  // The binary search may stop at the restart point before the predicted
+  // one, and one more on each side absorbs rounding errors.
+  const double lo = std::floor(pos) - max_error_ - 2;
+  const double hi = std::ceil(pos) + max_error_ + 1;
+  *left = lo <= 0 ? 0 : static_cast<uint32_t>(lo);
+  *right = hi >= num_restarts_ - 1 ? num_restarts_ - 1
+                                   : static_cast<uint32_t>(hi);
+}
+
+}  // namespace rocksdb
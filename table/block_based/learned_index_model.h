@@ -0,0 +1,104 @@
+// Copyright (c) 2011-present, Facebook, Inc. All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace rocksdb {
+
+// A piecewise linear model of the restart points of an index block, used by
+// BlockBasedTableOptions::kLearnedIndexSearch. It maps the key prefix of a
+// seek target, as given by GetRestartKeyPrefix(), to an interval of restart
+// points that the binary search of the index block can be limited to.
+//
+// The model is a sequence of segments, each starting at the key prefix of a
+// restart point. Within a segment, the restart index is predicted with a
+// line of non-negative slope, and at most the first restart index of the
+// next segment, so that the prediction never decreases with the key prefix.
+// The segments are fitted greedily, narrowing the range of allowed slopes as
+// restart points are added, so that every restart point is predicted within
+// max_error of its index (see Xie et al., "FITing-Tree: A Data-aware Index
+// Structure", SIGMOD 2019). Because the prediction is monotonic, the restart
+// point found by a binary search for any target is then within max_error + 1
+// of the prediction for the target.
+//
+// Format of the "rocksdb.learned_index.model" meta block:
+//   max_error: fixed32
+//   num_restarts: fixed32
+//   for each segment:
+//     start key prefix: fixed64
+//     start restart index: fixed32
+//     slope: fixed64, the bits of a double
+class LearnedIndexModelBuilder {
+ public:
+  explicit LearnedIndexModelBuilder(uint32_t max_error);
+
+  // Adds the user key of the next restart point.
+  // REQUIRES: restart keys are added in increasing order
+  void AddRestartKey(const Slice& user_key);
+
+  // Returns the encoded model, valid until the builder is destroyed, or an
+  // empty slice if the model could not meet max_error, which happens when
+  // more than max_error consecutive restart keys share their key prefix.
+  Slice Finish();
+
+ private:
+  void FinishSegment();
+
+  const uint32_t max_error_;
+  uint32_t num_restarts_;
+  bool failed_;
+  // Restart index of the first of the restart keys sharing the last prefix
+  uint32_t last_prefix_start_;
+  uint64_t last_prefix_;
+  // Current segment
+  uint64_t start_prefix_;
+  uint32_t start_index_;
+  double min_slope_;
+  double max_slope_;
+  std::string model_;
+};
+
+class LearnedIndexModel {
+ public:
+  // Decodes a model from the contents of its meta block. Returns Corruption
+  // if the contents are malformed.
+  static Status Create(const Slice& contents,
+                       std::unique_ptr<LearnedIndexModel>* model);
+
+  // Sets [*left, *right] to the restart points the binary search for a
+  // target with the given key prefix is limited to.
+  void Predict(uint64_t key_prefix, uint32_t* left, uint32_t* right) const;
+
+  // The number of restart points of the index block the model was built for.
+  // A model must not be used for a block with another number of restarts.
+  uint32_t num_restarts() const { return num_restarts_; }
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(LearnedIndexModel) + segments_.capacity() * sizeof(Segment);
+  }
+
+ private:
+  struct Segment {
+    uint64_t start_prefix;
+    uint32_t start_index;
+    double slope;
+  };
+
+  LearnedIndexModel(uint32_t max_error, uint32_t num_restarts)
+      : max_error_(max_error), num_restarts_(num_restarts) {}
+
+  const uint32_t max_error_;
+  const uint32_t num_restarts_;
+  std::vector<Segment> segments_;
+};
+
+}  // namespace rocksdb
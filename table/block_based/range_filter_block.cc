@@ -0,0 +1,84 @@
+// Copyright (c) 2011-present, Facebook, Inc. All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/range_filter_block.h"
+
+#include <algorithm>
+
+#include "rocksdb/comparator.h"
+
+namespace rocksdb {
+
+namespace {
+const int kRangeFilterRestartInterval = 16;
+}  // namespace
+
+RangeFilterBlockBuilder::RangeFilterBlockBuilder()
+    : block_(kRangeFilterRestartInterval),
+      last_key_prev_shared_(0),
+      has_last_key_(false) {}
+
+void RangeFilterBlockBuilder::AddKey(const Slice& user_key) {
+  if (has_last_key_) {
+    const Slice last_key(last_key_);
+    if (last_key == user_key) {
+      return;
+    }
+    assert(last_key.compare(user_key) < 0);
+    const size_t shared = last_key.difference_offset(user_key);
+    AddPrefix(shared);
+    last_key_prev_shared_ = shared;
+  }
+  last_key_.assign(user_key.data(), user_key.size());
+  has_last_key_ = true;
+}
+
+void RangeFilterBlockBuilder::AddPrefix(size_t next_shared) {
+  const size_t len = std::min(
+      last_key_.size(), std::max(last_key_prev_shared_, next_shared) + 1);
+  block_.Add(Slice(last_key_.data(), len), Slice());
+}
+
+Slice RangeFilterBlockBuilder::Finish() {
+  if (has_last_key_) {
+    AddPrefix(0);
+    has_last_key_ = false;
+  }
+  return block_.Finish();
+}
+
+bool RangeFilterBlockReader::RangeMayMatch(const Slice& lower,
+                                           const Slice& upper,
+                                           bool* has_key_after) const {
+  assert(lower.compare(upper) < 0);
+  *has_key_after = false;
+  DataBlockIter iter;
+  block_->NewDataIterator(BytewiseComparator(), BytewiseComparator(), &iter);
+  iter.Seek(lower);
+  bool prefix_after = false;
+  if (iter.Valid()) {
+    if (iter.key().compare(upper) < 0) {
+      return true;
+    }
+    prefix_after = true;
+    iter.Prev();
+  } else {
+    iter.SeekToLast();
+  }
+  if (iter.Valid() && lower.starts_with(iter.key())) {
+    return true;
+  }
+  if (!iter.status().ok()) {
+    return true;
+  }
+  *has_key_after = prefix_after;
+  return false;
+}
+
+size_t RangeFilterBlockReader::ApproximateMemoryUsage() const {
+  return block_->ApproximateMemoryUsage();
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,80 @@
+// Copyright (c) 2011-present, Facebook, Inc. All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "rocksdb/slice.h"
+#include "table/block_based/block.h"
+#include "table/block_based/block_builder.h"
+
+namespace rocksdb {
+// A range filter answers whether a table may contain a user key in a range
+// [lower, upper), so that range scans with an upper bound can skip tables
+// that have no key in range, even when the range spans several prefixes.
+//
+// It stores the leaves of a trie of the table's user keys truncated at the
+// shortest prefixes that tell consecutive keys apart, like the base trie of
+// SuRF (Zhang et al., "SuRF: Practical Range Query Filtering with Fast
+// Succinct Tries", SIGMOD 2018). For each user key k[i], in order, the
+// filter keeps the shortest prefix of k[i] that is longer than its common
+// prefix with both k[i-1] and k[i+1], or k[i] itself if shorter. These
+// prefixes sort like the keys, and are stored with prefix compression in a
+// block with empty values, the "rocksdb.range_filter" meta block. This is
+// not SuRF's succinct (LOUDS) encoding of the trie: the leaves are searched
+// through the block's restart points like a data block, and take more space
+// than the succinct trie would.
+//
+// A key of the table is in [lower, upper) only if either the last prefix
+// before lower is a prefix of lower, or the first prefix at or after lower
+// is before upper. Otherwise no key is in range, and if a prefix at or after
+// upper exists, the table has a key at or after upper. Keys and bounds are
+// compared bytewise, so the filter is only built for tables using
+// BytewiseComparator.
+class RangeFilterBlockBuilder {
+ public:
+  RangeFilterBlockBuilder();
+
+  // REQUIRES: user keys are added in increasing order. Consecutive
+  // duplicates, i.e. other versions of the same user key, are ignored.
+  void AddKey(const Slice& user_key);
+
+  bool empty() const { return !has_last_key_ && block_.empty(); }
+
+  // Returns the block contents, valid until the builder is destroyed.
+  Slice Finish();
+
+ private:
+  // Adds the prefix of last_key_, given its common prefix length with the
+  // next key.
+  void AddPrefix(size_t next_shared);
+
+  BlockBuilder block_;
+  std::string last_key_;
+  // Common prefix length of last_key_ and the key before it
+  size_t last_key_prev_shared_;
+  bool has_last_key_;
+};
+
+class RangeFilterBlockReader {
+ public:
+  explicit RangeFilterBlockReader(std::unique_ptr<Block>&& block)
+      : block_(std::move(block)) {}
+
+  // Returns false if the table has no user key in [lower, upper). In that
+  // case *has_key_after sets whether it has a user key >= upper.
+  // REQUIRES: lower < upper
+  bool RangeMayMatch(const Slice& lower, const Slice& upper,
+                     bool* has_key_after) const;
+
+  size_t ApproximateMemoryUsage() const;
+
+ private:
+  std::unique_ptr<Block> block_;
+};
+
+}  // namespace rocksdb
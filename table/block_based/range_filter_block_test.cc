@@ -0,0 +1,126 @@
+// Copyright (c) 2011-present, Facebook, Inc. All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include <set>
+#include <string>
+
+#include "table/block_based/range_filter_block.h"
+#include "table/format.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+#include "util/random.h"
+
+namespace rocksdb {
+
+class RangeFilterBlockTest : public testing::Test {
+ protected:
+  void Build(const std::set<std::string>& keys) {
+    RangeFilterBlockBuilder builder;
+    ASSERT_TRUE(builder.empty());
+    for (const auto& key : keys) {
+      builder.AddKey(key);
+      // Other versions of the same user key
+      builder.AddKey(key);
+    }
+    contents_ = builder.Finish().ToString();
+    BlockContents block_contents;
+    block_contents.data = Slice(contents_);
+    std::unique_ptr<Block> block(
+        new Block(std::move(block_contents), kDisableGlobalSequenceNumber));
+    reader_.reset(new RangeFilterBlockReader(std::move(block)));
+    keys_ = keys;
+  }
+
+  // Checks the filter against the keys for [lower, upper)
+  void Check(const std::string& lower, const std::string& upper) {
+    auto it = keys_.lower_bound(lower);
+    bool expected = it != keys_.end() && *it < upper;
+    bool expected_key_after = keys_.lower_bound(upper) != keys_.end();
+    bool has_key_after = false;
+    bool may_match = reader_->RangeMayMatch(lower, upper, &has_key_after);
+    if (expected) {
+      ASSERT_TRUE(may_match) << "[" << lower << ", " << upper << ")";
+    } else if (!may_match) {
+      ASSERT_EQ(expected_key_after, has_key_after)
+          << "[" << lower << ", " << upper << ")";
+    }
+  }
+
+  std::string contents_;
+  std::unique_ptr<RangeFilterBlockReader> reader_;
+  std::set<std::string> keys_;
+};
+
+TEST_F(RangeFilterBlockTest, Basic) {
+  Build({"apple", "apricot", "banana", "cherry", "cherrypie", "grape"});
+
+  // Ranges containing a key
+  Check("a", "b");
+  Check("apple", "apple0");
+  Check("banana", "c");
+  Check("cherry", "cherry0");
+  Check("cherryp", "d");
+  Check("f", "z");
+  // Ranges between keys
+  bool has_key_after = false;
+  ASSERT_FALSE(reader_->RangeMayMatch("c", "ch", &has_key_after));
+  ASSERT_TRUE(has_key_after);
+  ASSERT_FALSE(reader_->RangeMayMatch("d", "g", &has_key_after));
+  ASSERT_TRUE(has_key_after);
+  ASSERT_FALSE(reader_->RangeMayMatch("0", "a", &has_key_after));
+  ASSERT_TRUE(has_key_after);
+  // After the last key
+  ASSERT_FALSE(reader_->RangeMayMatch("h", "z", &has_key_after));
+  ASSERT_FALSE(has_key_after);
+  ASSERT_FALSE(reader_->RangeMayMatch("cherryq", "d", &has_key_after));
+  ASSERT_TRUE(has_key_after);
+  // Within the prefix stored for "grape", a false positive
+  ASSERT_TRUE(reader_->RangeMayMatch("gz", "h", &has_key_after));
+}
+
+TEST_F(RangeFilterBlockTest, Randomized) {
+  Random rnd(301);
+  for (int iter = 0; iter < 20; iter++) {
+    std::set<std::string> keys;
+    int num_keys = 1 + rnd.Uniform(2000);
+    int key_len = 1 + rnd.Uniform(8);
+    for (int i = 0; i < num_keys; i++) {
+      // A small alphabet gives long common prefixes
+      std::string key;
+      int len = 1 + rnd.Uniform(key_len);
+      for (int j = 0; j < len; j++) {
+        key.push_back(static_cast<char>('a' + rnd.Uniform(4)));
+      }
+      keys.insert(key);
+    }
+    Build(keys);
+    for (int i = 0; i < 2000; i++) {
+      std::string lower, upper;
+      int lower_len = rnd.Uniform(key_len + 1);
+      for (int j = 0; j < lower_len; j++) {
+        lower.push_back(static_cast<char>('a' + rnd.Uniform(5)));
+      }
+      upper = lower;
+      int upper_len = 1 + rnd.Uniform(3);
+      for (int j = 0; j < upper_len; j++) {
+        upper.push_back(static_cast<char>('a' + rnd.Uniform(5)));
+      }
+      if (rnd.OneIn(2) && !lower.empty()) {
+        // Wider range
+        upper = lower;
+        upper.back() = static_cast<char>(upper.back() + 1 + rnd.Uniform(2));
+      }
+      ASSERT_LT(lower, upper);
+      Check(lower, upper);
+    }
+  }
+}
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
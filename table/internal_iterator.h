@@ -22,6 +22,66 @@ struct IterateResult {
   bool may_be_out_of_upper_bound;
 };
 
+// The entries NextBatch() moves over and adds to the caller's arrays. An
+// entry is added if it is a kTypeValue visible at `sequence`, and its user
+// key is greater than the one of the entry added before it, or
+// `prev_user_key` for the first one, and smaller than `*limit`.
+struct IterateBatch {
+  SequenceNumber sequence = kMaxSequenceNumber;
+  const Comparator* user_comparator = nullptr;
+  Slice prev_user_key;
+  // If not null, the exclusive upper bound of the user keys added
+  const Slice* limit = nullptr;
+  // Whether keys and values that stay valid as long as the
+  // PinnedIteratorsManager pins them can be pinned instead of copied
+  bool pin_data = false;
+  // keys[i] and values[i] hold the user key and value of the i-th entry
+  // added, for i < num_entries
+  PinnableSlice* keys = nullptr;
+  PinnableSlice* values = nullptr;
+  size_t max_entries = 0;
+  size_t num_entries = 0;
+
+  bool full() const { return num_entries >= max_entries; }
+
+  bool Accepts(const Slice& internal_key) const {
+    if (internal_key.size() < 8) {
+      return false;
+    }
+    const uint64_t footer = ExtractInternalKeyFooter(internal_key);
+    if (static_cast<ValueType>(footer & 0xff) != kTypeValue ||
+        (footer >> 8) > sequence) {
+      return false;
+    }
+    const Slice user_key = ExtractUserKey(internal_key);
+    const Slice& prev =
+        num_entries > 0 ? keys[num_entries - 1] : prev_user_key;
+    return user_comparator->Compare(user_key, prev) > 0 &&
+           (limit == nullptr || user_comparator->Compare(user_key, *limit) < 0);
+  }
+
+  // Pins user_key and value if the flags say so, and copies them otherwise.
+  // REQUIRES: !full()
+  void Add(const Slice& user_key, bool key_pinned, const Slice& value,
+           bool value_pinned) {
+    assert(!full());
+    Set(&keys[num_entries], user_key, key_pinned);
+    Set(&values[num_entries], value, value_pinned);
+    num_entries++;
+  }
+
+  static void Set(PinnableSlice* slice, const Slice& data, bool pinned) {
+    slice->Reset();
+    if (pinned) {
+      // Pinned data has nothing to clean up
+      Cleanable no_cleanup;
+      slice->PinSlice(data, &no_cleanup);
+    } else {
+      slice->PinSelf(data);
+    }
+  }
+};
+
 template <class TValue>
 class InternalIteratorBase : public Cleanable {
  public:
@@ -82,6 +142,21 @@ class InternalIteratorBase : public Cleanable {
     return is_valid;
   }
 
+  // Moves to the next entry like NextAndGetResult(), then adds the entries
+  // batch accepts to it and moves past them while it has room, so that the
+  // iterator stops at the first entry it did not add. Iterators override it
+  // to add entries without virtual calls per entry.
+  // REQUIRES: Valid()
+  virtual bool NextBatch(IterateBatch* batch, IterateResult* result) {
+    bool is_valid = NextAndGetResult(result);
+    while (is_valid && !batch->full() && batch->Accepts(result->key)) {
+      batch->Add(ExtractUserKey(result->key), batch->pin_data && IsKeyPinned(),
+                 value(), batch->pin_data && IsValuePinned());
+      is_valid = NextAndGetResult(result);
+    }
+    return is_valid;
+  }
+
   // Moves to the previous entry in the source.  After this call, Valid() is
   // true iff the iterator was not positioned at the first entry in source.
   // REQUIRES: Valid()
@@ -163,6 +238,13 @@ class InternalIteratorBase : public Cleanable {
   bool is_mutable_;
 };
 
+// Index entries are not read in batches.
+template <>
+inline bool InternalIteratorBase<IndexValue>::NextBatch(
+    IterateBatch* /*batch*/, IterateResult* result) {
+  return NextAndGetResult(result);
+}
+
 using InternalIterator = InternalIteratorBase<Slice>;
 
 // Return an empty iterator (yields nothing).
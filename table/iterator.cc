@@ -106,6 +106,19 @@ Status Iterator::GetProperty(std::string prop_name, std::string* prop) {
   return Status::InvalidArgument("Unidentified property.");
 }
 
+size_t Iterator::NextBatch(size_t max_entries, PinnableSlice* keys,
+                           PinnableSlice* values) {
+  size_t n = 0;
+  for (; n < max_entries && Valid(); ++n) {
+    keys[n].Reset();
+    keys[n].PinSelf(key());
+    values[n].Reset();
+    values[n].PinSelf(value());
+    Next();
+  }
+  return n;
+}
+
 namespace {
 class EmptyIterator : public Iterator {
  public:
@@ -72,7 +72,12 @@ class IteratorWrapperBase {
     valid_ = iter_->NextAndGetResult(&result_);
     assert(!valid_ || iter_->status().ok());
   }
-  void Prev()               { assert(iter_); iter_->Prev();        Update(); }
+  void NextBatch(IterateBatch* batch) {
+    assert(iter_);
+    valid_ = iter_->NextBatch(batch, &result_);
+    assert(!valid_ || iter_->status().ok());
+  }
+  void Prev()              { assert(iter_); iter_->Prev();        Update(); }
   void Seek(const Slice& k) {
     assert(iter_);
     iter_->Seek(k);
@@ -12,7 +12,8 @@
 
 namespace rocksdb {
 
-class MergerTest : public testing::Test {
+// Param: whether the merging iterator uses a loser tree
+class MergerTest : public testing::TestWithParam<bool> {
  public:
   MergerTest()
       : icomp_(BytewiseComparator()),
@@ -107,7 +108,9 @@ class MergerTest : public testing::Test {
 
     merging_iterator_.reset(
         NewMergingIterator(&icomp_, &small_iterators[0],
-                           static_cast<int>(small_iterators.size())));
+                           static_cast<int>(small_iterators.size()),
+                           nullptr /* arena */, false /* prefix_seek_mode */,
+                           GetParam() /* use_loser_tree */));
     single_iterator_.reset(new test::VectorIterator(all_keys_));
   }
 
@@ -118,7 +121,7 @@ class MergerTest : public testing::Test {
   std::vector<std::string> all_keys_;
 };
 
-TEST_F(MergerTest, SeekToRandomNextTest) {
+TEST_P(MergerTest, SeekToRandomNextTest) {
   Generate(1000, 50, 50);
   for (int i = 0; i < 10; ++i) {
     SeekToRandom();
@@ -127,7 +130,7 @@ TEST_F(MergerTest, SeekToRandomNextTest) {
   }
 }
 
-TEST_F(MergerTest, SeekToRandomNextSmallStringsTest) {
+TEST_P(MergerTest, SeekToRandomNextSmallStringsTest) {
   Generate(1000, 50, 2);
   for (int i = 0; i < 10; ++i) {
     SeekToRandom();
@@ -136,7 +139,7 @@ TEST_F(MergerTest, SeekToRandomNextSmallStringsTest) {
   }
 }
 
-TEST_F(MergerTest, SeekToRandomPrevTest) {
+TEST_P(MergerTest, SeekToRandomPrevTest) {
   Generate(1000, 50, 50);
   for (int i = 0; i < 10; ++i) {
     SeekToRandom();
@@ -145,7 +148,7 @@ TEST_F(MergerTest, SeekToRandomPrevTest) {
   }
 }
 
-TEST_F(MergerTest, SeekToRandomRandomTest) {
+TEST_P(MergerTest, SeekToRandomRandomTest) {
   Generate(200, 50, 50);
   for (int i = 0; i < 3; ++i) {
     SeekToRandom();
@@ -154,7 +157,7 @@ TEST_F(MergerTest, SeekToRandomRandomTest) {
   }
 }
 
-TEST_F(MergerTest, SeekToFirstTest) {
+TEST_P(MergerTest, SeekToFirstTest) {
   Generate(1000, 50, 50);
   for (int i = 0; i < 10; ++i) {
     SeekToFirst();
@@ -163,7 +166,7 @@ TEST_F(MergerTest, SeekToFirstTest) {
   }
 }
 
-TEST_F(MergerTest, SeekToLastTest) {
+TEST_P(MergerTest, SeekToLastTest) {
   Generate(1000, 50, 50);
   for (int i = 0; i < 10; ++i) {
     SeekToLast();
@@ -172,6 +175,8 @@ TEST_F(MergerTest, SeekToLastTest) {
   }
 }
 
+INSTANTIATE_TEST_CASE_P(MergerTest, MergerTest, ::testing::Bool());
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -30,6 +30,7 @@ namespace rocksdb {
 namespace {
 typedef BinaryHeap<IteratorWrapper*, MaxIteratorComparator> MergerMaxIterHeap;
 typedef BinaryHeap<IteratorWrapper*, MinIteratorComparator> MergerMinIterHeap;
+typedef LoserTree<IteratorWrapper*, MinIteratorComparator> MergerMinIterTree;
 }  // namespace
 
 const size_t kNumIterReserve = 4;
@@ -38,21 +39,27 @@ class MergingIterator : public InternalIterator {
  public:
   MergingIterator(const InternalKeyComparator* comparator,
                   InternalIterator** children, int n, bool is_arena_mode,
-                  bool prefix_seek_mode)
+                  bool prefix_seek_mode, bool use_loser_tree)
       : is_arena_mode_(is_arena_mode),
         comparator_(comparator),
         current_(nullptr),
         direction_(kForward),
         minHeap_(comparator_),
+        use_loser_tree_(use_loser_tree),
+        minTree_(comparator_),
         prefix_seek_mode_(prefix_seek_mode),
         pinned_iters_mgr_(nullptr) {
     children_.resize(n);
     for (int i = 0; i < n; i++) {
       children_[i].Set(children[i]);
     }
-    for (auto& child : children_) {
-      AddToMinHeapOrCheckStatus(&child);
+    if (use_loser_tree_) {
+      minTree_.reset(children_.size());
+    }
+    for (size_t i = 0; i < children_.size(); i++) {
+      AddToMinHeapOrCheckStatus(&children_[i], i);
     }
+    BuildMinTree();
     current_ = CurrentForward();
   }
 
@@ -68,8 +75,23 @@ class MergingIterator : public InternalIterator {
     if (pinned_iters_mgr_) {
       iter->SetPinnedItersMgr(pinned_iters_mgr_);
     }
+    if (use_loser_tree_) {
+      // Children are usually added before the first seek, which sizes and
+      // builds the tree through ClearHeaps(). Only a positioned iterator
+      // has to rebuild it now, as the leaves point into children_, whose
+      // elements may just have moved.
+      if (current_ != nullptr || children_.back().Valid()) {
+        minTree_.reset(children_.size());
+        for (size_t i = 0; i < children_.size(); i++) {
+          AddToMinHeapOrCheckStatus(&children_[i], i);
+        }
+        BuildMinTree();
+        current_ = CurrentForward();
+      }
+      return;
+    }
     auto new_wrapper = children_.back();
-    AddToMinHeapOrCheckStatus(&new_wrapper);
+    AddToMinHeapOrCheckStatus(&new_wrapper, children_.size() - 1);
     if (new_wrapper.Valid()) {
       current_ = CurrentForward();
     }
@@ -88,10 +110,12 @@ class MergingIterator : public InternalIterator {
   void SeekToFirst() override {
     ClearHeaps();
     status_ = Status::OK();
-    for (auto& child : children_) {
+    for (size_t i = 0; i < children_.size(); i++) {
+      auto& child = children_[i];
       child.SeekToFirst();
-      AddToMinHeapOrCheckStatus(&child);
+      AddToMinHeapOrCheckStatus(&child, i);
     }
+    BuildMinTree();
     direction_ = kForward;
     current_ = CurrentForward();
   }
@@ -111,7 +135,8 @@ class MergingIterator : public InternalIterator {
   void Seek(const Slice& target) override {
     ClearHeaps();
     status_ = Status::OK();
-    for (auto& child : children_) {
+    for (size_t i = 0; i < children_.size(); i++) {
+      auto& child = children_[i];
       {
         PERF_TIMER_GUARD(seek_child_seek_time);
         child.Seek(target);
@@ -122,12 +147,13 @@ class MergingIterator : public InternalIterator {
         // Strictly, we timed slightly more than min heap operation,
         // but these operations are very cheap.
         PERF_TIMER_GUARD(seek_min_heap_time);
-        AddToMinHeapOrCheckStatus(&child);
+        AddToMinHeapOrCheckStatus(&child, i);
       }
     }
     direction_ = kForward;
     {
       PERF_TIMER_GUARD(seek_min_heap_time);
+      BuildMinTree();
       current_ = CurrentForward();
     }
   }
@@ -176,18 +202,7 @@ class MergingIterator : public InternalIterator {
 
     // as the current points to the current record. move the iterator forward.
     current_->Next();
-    if (current_->Valid()) {
-      // current is still valid after the Next() call above.  Call
-      // replace_top() to restore the heap property.  When the same child
-      // iterator yields a sequence of keys, this is cheap.
-      assert(current_->status().ok());
-      minHeap_.replace_top(current_);
-    } else {
-      // current stopped being valid, remove it from the heap.
-      considerStatus(current_->status());
-      minHeap_.pop();
-    }
-    current_ = CurrentForward();
+    UpdateCurrentForward();
   }
 
   bool NextAndGetResult(IterateResult* result) override {
@@ -200,6 +215,41 @@ class MergingIterator : public InternalIterator {
     return is_valid;
   }
 
+  bool NextBatch(IterateBatch* batch, IterateResult* result) override {
+    assert(Valid());
+    if (direction_ != kForward) {
+      return InternalIterator::NextBatch(batch, result);
+    }
+    assert(current_ == CurrentForward());
+
+    // current_ can add the entries before the next key of the other children
+    IteratorWrapper* const* next = use_loser_tree_ ? minTree_.second_top()
+                                                   : minHeap_.second_top();
+    const Slice* limit = batch->limit;
+    Slice next_user_key;
+    if (next != nullptr) {
+      next_user_key = ExtractUserKey((*next)->key());
+      if (limit == nullptr ||
+          batch->user_comparator->Compare(next_user_key, *limit) < 0) {
+        batch->limit = &next_user_key;
+      }
+    }
+    const bool pin_data = batch->pin_data;
+    batch->pin_data =
+        pin_data && pinned_iters_mgr_ && pinned_iters_mgr_->PinningEnabled();
+    current_->NextBatch(batch);
+    batch->limit = limit;
+    batch->pin_data = pin_data;
+    UpdateCurrentForward();
+
+    bool is_valid = Valid();
+    if (is_valid) {
+      result->key = key();
+      result->may_be_out_of_upper_bound = MayBeOutOfUpperBound();
+    }
+    return is_valid;
+  }
+
   void Prev() override {
     assert(Valid());
     // Ensure that all children are positioned before key().
@@ -298,6 +348,10 @@ class MergingIterator : public InternalIterator {
   };
   Direction direction_;
   MergerMinIterHeap minHeap_;
+  // If set, minTree_ replaces minHeap_ for forward iteration. Its leaf i
+  // is children_[i].
+  const bool use_loser_tree_;
+  MergerMinIterTree minTree_;
   bool prefix_seek_mode_;
 
   // Max heap is used for reverse iteration, which is way less common than
@@ -306,8 +360,16 @@ class MergingIterator : public InternalIterator {
   PinnedIteratorsManager* pinned_iters_mgr_;
 
   // In forward direction, process a child that is not in the min heap.
-  // If valid, add to the min heap. Otherwise, check status.
-  void AddToMinHeapOrCheckStatus(IteratorWrapper*);
+  // If valid, add to the min heap. Otherwise, check status. `leaf` is the
+  // index of the child in children_, whose elements are not contiguous.
+  void AddToMinHeapOrCheckStatus(IteratorWrapper*, size_t leaf);
+
+  // With the loser tree, plays the matches once all children were added.
+  void BuildMinTree() {
+    if (use_loser_tree_) {
+      minTree_.build();
+    }
+  }
 
   // In backward direction, process a child that is not in the max heap.
   // If valid, add to the min heap. Otherwise, check status.
@@ -319,8 +381,36 @@ class MergingIterator : public InternalIterator {
   // position. Iterator should still be valid.
   void SwitchToBackward();
 
+  // After current_ moved forward, restores the heap property and updates
+  // current_.
+  void UpdateCurrentForward() {
+    if (current_->Valid()) {
+      // current is still valid after moving forward.  Call
+      // replace_top() to restore the heap property.  When the same child
+      // iterator yields a sequence of keys, this is cheap.
+      assert(current_->status().ok());
+      if (use_loser_tree_) {
+        minTree_.replace_top(current_);
+      } else {
+        minHeap_.replace_top(current_);
+      }
+    } else {
+      // current stopped being valid, remove it from the heap.
+      considerStatus(current_->status());
+      if (use_loser_tree_) {
+        minTree_.pop();
+      } else {
+        minHeap_.pop();
+      }
+    }
+    current_ = CurrentForward();
+  }
+
   IteratorWrapper* CurrentForward() const {
     assert(direction_ == kForward);
+    if (use_loser_tree_) {
+      return !minTree_.empty() ? minTree_.top() : nullptr;
+    }
     return !minHeap_.empty() ? minHeap_.top() : nullptr;
   }
 
@@ -331,7 +421,18 @@ class MergingIterator : public InternalIterator {
   }
 };
 
-void MergingIterator::AddToMinHeapOrCheckStatus(IteratorWrapper* child) {
+void MergingIterator::AddToMinHeapOrCheckStatus(IteratorWrapper* child,
+                                                size_t leaf) {
+  if (use_loser_tree_) {
+    if (child->Valid()) {
+      assert(child->status().ok());
+      minTree_.set(leaf, child);
+    } else {
+      minTree_.remove(leaf);
+      considerStatus(child->status());
+    }
+    return;
+  }
   if (child->Valid()) {
     assert(child->status().ok());
     minHeap_.push(child);
@@ -354,7 +455,8 @@ void MergingIterator::SwitchToForward() {
   // just after the if-block.
   ClearHeaps();
   Slice target = key();
-  for (auto& child : children_) {
+  for (size_t i = 0; i < children_.size(); i++) {
+    auto& child = children_[i];
     if (&child != current_) {
       child.Seek(target);
       if (child.Valid() && comparator_->Equal(target, child.key())) {
@@ -362,8 +464,9 @@ void MergingIterator::SwitchToForward() {
         child.Next();
       }
     }
-    AddToMinHeapOrCheckStatus(&child);
+    AddToMinHeapOrCheckStatus(&child, i);
   }
+  BuildMinTree();
   direction_ = kForward;
 }
 
@@ -395,6 +498,11 @@ void MergingIterator::SwitchToBackward() {
 
 void MergingIterator::ClearHeaps() {
   minHeap_.clear();
+  if (use_loser_tree_ && minTree_.num_leaves() != children_.size()) {
+    minTree_.reset(children_.size());
+  } else {
+    minTree_.clear();
+  }
   if (maxHeap_) {
     maxHeap_->clear();
   }
@@ -408,7 +516,8 @@ void MergingIterator::InitMaxHeap() {
 
 InternalIterator* NewMergingIterator(const InternalKeyComparator* cmp,
                                      InternalIterator** list, int n,
-                                     Arena* arena, bool prefix_seek_mode) {
+                                     Arena* arena, bool prefix_seek_mode,
+                                     bool use_loser_tree) {
   assert(n >= 0);
   if (n == 0) {
     return NewEmptyInternalIterator<Slice>(arena);
@@ -416,20 +525,23 @@ InternalIterator* NewMergingIterator(const InternalKeyComparator* cmp,
     return list[0];
   } else {
     if (arena == nullptr) {
-      return new MergingIterator(cmp, list, n, false, prefix_seek_mode);
+      return new MergingIterator(cmp, list, n, false, prefix_seek_mode,
+                                 use_loser_tree);
     } else {
       auto mem = arena->AllocateAligned(sizeof(MergingIterator));
-      return new (mem) MergingIterator(cmp, list, n, true, prefix_seek_mode);
+      return new (mem) MergingIterator(cmp, list, n, true, prefix_seek_mode,
+                                       use_loser_tree);
     }
   }
 }
 
 MergeIteratorBuilder::MergeIteratorBuilder(
-    const InternalKeyComparator* comparator, Arena* a, bool prefix_seek_mode)
+    const InternalKeyComparator* comparator, Arena* a, bool prefix_seek_mode,
+    bool use_loser_tree)
     : first_iter(nullptr), use_merging_iter(false), arena(a) {
   auto mem = arena->AllocateAligned(sizeof(MergingIterator));
-  merge_iter =
-      new (mem) MergingIterator(comparator, nullptr, 0, true, prefix_seek_mode);
+  merge_iter = new (mem) MergingIterator(comparator, nullptr, 0, true,
+                                         prefix_seek_mode, use_loser_tree);
 }
 
 MergeIteratorBuilder::~MergeIteratorBuilder() {
@@ -28,10 +28,17 @@ using InternalIterator = InternalIteratorBase<Slice>;
 // The result does no duplicate suppression.  I.e., if a particular
 // key is present in K child iterators, it will be yielded K times.
 //
+// If use_loser_tree is true, forward iteration picks the smallest child with
+// a loser tree instead of a binary heap. It takes about log(n) comparisons
+// per step, against up to 2*log(n) for the heap when the smallest child
+// changes, but does not benefit from consecutive keys coming from the same
+// child. Reverse iteration always uses a heap.
+//
 // REQUIRES: n >= 0
 extern InternalIterator* NewMergingIterator(
     const InternalKeyComparator* comparator, InternalIterator** children, int n,
-    Arena* arena = nullptr, bool prefix_seek_mode = false);
+    Arena* arena = nullptr, bool prefix_seek_mode = false,
+    bool use_loser_tree = false);
 
 class MergingIterator;
 
@@ -40,8 +47,10 @@ class MergeIteratorBuilder {
  public:
   // comparator: the comparator used in merging comparator
   // arena: where the merging iterator needs to be allocated from.
+  // use_loser_tree: see NewMergingIterator().
   explicit MergeIteratorBuilder(const InternalKeyComparator* comparator,
-                                Arena* arena, bool prefix_seek_mode = false);
+                                Arena* arena, bool prefix_seek_mode = false,
+                                bool use_loser_tree = false);
   ~MergeIteratorBuilder();
 
   // Add iter to the merging iterator.
@@ -0,0 +1,204 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef GFLAGS
+#include <cstdio>
+int main() {
+  fprintf(stderr, "Please install gflags to run rocksdb tools\n");
+  return 1;
+}
+#else
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "memory/arena.h"
+#include "rocksdb/comparator.h"
+#include "rocksdb/env.h"
+#include "table/internal_iterator.h"
+#include "table/merging_iterator.h"
+#include "util/random.h"
+#include "util/stop_watch.h"
+
+#include "util/gflags_compat.h"
+
+using GFLAGS_NAMESPACE::ParseCommandLineFlags;
+
+DEFINE_int32(num_children, 32, "number of child iterators merged");
+
+DEFINE_int32(num_keys, 1000000, "total number of keys over all children");
+
+DEFINE_int32(run_length, 1,
+             "number of consecutive keys that go to the same child");
+
+DEFINE_int32(num_runs, 5, "number of full scans");
+
+DEFINE_int32(num_seeks, 100000, "number of Seek() calls per run");
+
+DEFINE_int32(nexts_per_seek, 10, "number of Next() calls after each Seek()");
+
+DEFINE_int32(num_builds, 1000,
+             "number of merging iterators built with MergeIteratorBuilder");
+
+DEFINE_bool(use_loser_tree, false,
+            "merge with the loser tree instead of the binary heap");
+
+DEFINE_int32(seed, 301, "random number generator seed");
+
+namespace rocksdb {
+
+namespace {
+
+std::string UserKey(uint64_t i) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%016" PRIu64, i);
+  return buf;
+}
+
+std::string InternalKeyString(uint64_t i) {
+  return InternalKey(UserKey(i), 1, kTypeValue).Encode().ToString();
+}
+
+// Iterates over keys owned by the caller, so that building a merging
+// iterator does not copy them
+class ChildIterator : public InternalIterator {
+ public:
+  ChildIterator(const InternalKeyComparator* icmp,
+                const std::vector<std::string>* keys)
+      : icmp_(icmp), keys_(keys), pos_(keys->size()) {}
+
+  bool Valid() const override { return pos_ < keys_->size(); }
+  void SeekToFirst() override { pos_ = 0; }
+  void SeekToLast() override {
+    pos_ = keys_->empty() ? keys_->size() : keys_->size() - 1;
+  }
+  void Seek(const Slice& target) override {
+    pos_ = std::lower_bound(keys_->begin(), keys_->end(), target,
+                            [this](const std::string& a, const Slice& b) {
+                              return icmp_->Compare(a, b) < 0;
+                            }) -
+           keys_->begin();
+  }
+  void SeekForPrev(const Slice& target) override {
+    Seek(target);
+    if (!Valid() || icmp_->Compare((*keys_)[pos_], target) > 0) {
+      pos_ = pos_ == 0 ? keys_->size() : pos_ - 1;
+    }
+  }
+  void Next() override { pos_++; }
+  void Prev() override { pos_ = pos_ == 0 ? keys_->size() : pos_ - 1; }
+  Slice key() const override { return (*keys_)[pos_]; }
+  Slice value() const override { return "value"; }
+  Status status() const override { return Status::OK(); }
+
+ private:
+  const InternalKeyComparator* icmp_;
+  const std::vector<std::string>* keys_;
+  size_t pos_;
+};
+
+std::vector<std::vector<std::string>> ChildKeys() {
+  std::vector<std::vector<std::string>> keys(FLAGS_num_children);
+  Random rnd(FLAGS_seed);
+  int child = 0;
+  for (int i = 0; i < FLAGS_num_keys; i++) {
+    if (i % FLAGS_run_length == 0) {
+      child = static_cast<int>(rnd.Uniform(FLAGS_num_children));
+    }
+    keys[child].push_back(InternalKeyString(i));
+  }
+  return keys;
+}
+
+// Adds the children one by one, like DB iterators do
+InternalIterator* BuildMergingIterator(
+    const InternalKeyComparator* icmp,
+    const std::vector<std::vector<std::string>>& keys, Arena* arena) {
+  MergeIteratorBuilder builder(icmp, arena, false /* prefix_seek_mode */,
+                               FLAGS_use_loser_tree);
+  for (const auto& child_keys : keys) {
+    auto mem = arena->AllocateAligned(sizeof(ChildIterator));
+    builder.AddIterator(new (mem) ChildIterator(icmp, &child_keys));
+  }
+  return builder.Finish();
+}
+
+void Run() {
+  InternalKeyComparator icmp(BytewiseComparator());
+  const std::vector<std::vector<std::string>> keys = ChildKeys();
+  Env* env = Env::Default();
+
+  StopWatchNano build_timer(env, true /* auto_start */);
+  for (int i = 0; i < FLAGS_num_builds; i++) {
+    Arena arena;
+    BuildMergingIterator(&icmp, keys, &arena)->~InternalIterator();
+  }
+  uint64_t build_nanos = build_timer.ElapsedNanos();
+
+  Arena arena;
+  InternalIterator* iter = BuildMergingIterator(&icmp, keys, &arena);
+
+  uint64_t scan_nanos = 0;
+  uint64_t num_nexts = 0;
+  for (int run = 0; run < FLAGS_num_runs; run++) {
+    StopWatchNano timer(env, true /* auto_start */);
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      num_nexts++;
+    }
+    scan_nanos += timer.ElapsedNanos();
+  }
+  if (num_nexts != static_cast<uint64_t>(FLAGS_num_keys) * FLAGS_num_runs) {
+    fprintf(stderr, "Scanned %" PRIu64 " keys, expected %" PRIu64 "\n",
+            num_nexts, static_cast<uint64_t>(FLAGS_num_keys) * FLAGS_num_runs);
+    abort();
+  }
+
+  Random rnd(FLAGS_seed);
+  uint64_t seek_nanos = 0;
+  for (int run = 0; run < FLAGS_num_runs; run++) {
+    for (int i = 0; i < FLAGS_num_seeks; i++) {
+      std::string target = InternalKeyString(rnd.Uniform(FLAGS_num_keys));
+      StopWatchNano timer(env, true /* auto_start */);
+      iter->Seek(target);
+      for (int j = 0; j < FLAGS_nexts_per_seek && iter->Valid(); j++) {
+        iter->Next();
+      }
+      seek_nanos += timer.ElapsedNanos();
+    }
+  }
+
+  fprintf(stdout, "%s, %d children, run length %d\n",
+          FLAGS_use_loser_tree ? "loser tree" : "binary heap",
+          FLAGS_num_children, FLAGS_run_length);
+  fprintf(stdout, "Build: %.2f ns/iterator\n",
+          static_cast<double>(build_nanos) / std::max(FLAGS_num_builds, 1));
+  fprintf(stdout, "Scan: %.2f ns/key\n",
+          static_cast<double>(scan_nanos) / static_cast<double>(num_nexts));
+  fprintf(stdout, "Seek + %d Next: %.2f ns/op\n", FLAGS_nexts_per_seek,
+          static_cast<double>(seek_nanos) /
+              (static_cast<double>(FLAGS_num_seeks) * FLAGS_num_runs));
+  iter->~InternalIterator();
+}
+
+}  // namespace
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ParseCommandLineFlags(&argc, &argv, true);
+  if (FLAGS_num_children <= 0 || FLAGS_run_length <= 0) {
+    fprintf(stderr, "num_children and run_length must be positive\n");
+    return 1;
+  }
+  rocksdb::Run();
+  return 0;
+}
+
+#endif  // GFLAGS
@@ -245,6 +245,7 @@ extern const std::string kPropertiesBlock = "rocksdb.properties";
 extern const std::string kPropertiesBlockOldName = "rocksdb.stats";
 extern const std::string kCompressionDictBlock = "rocksdb.compression_dict";
 extern const std::string kRangeDelBlock = "rocksdb.range_del";
+extern const std::string kRangeFilterBlock = "rocksdb.range_filter";
 
 // Seek to the properties block.
 // Return true if it successfully seeks to the properties block.
@@ -268,4 +269,9 @@ Status SeekToRangeDelBlock(InternalIterator* meta_iter, bool* is_found,
   return SeekToMetaBlock(meta_iter, kRangeDelBlock, is_found, block_handle);
 }
 
+Status SeekToRangeFilterBlock(InternalIterator* meta_iter, bool* is_found,
+                              BlockHandle* block_handle) {
+  return SeekToMetaBlock(meta_iter, kRangeFilterBlock, is_found, block_handle);
+}
+
 }  // namespace rocksdb
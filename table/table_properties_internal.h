@@ -27,4 +27,8 @@ Status SeekToCompressionDictBlock(InternalIterator* meta_iter, bool* is_found,
 Status SeekToRangeDelBlock(InternalIterator* meta_iter, bool* is_found,
                            BlockHandle* block_handle);
 
+// Seek to the range filter block.
+Status SeekToRangeFilterBlock(InternalIterator* meta_iter, bool* is_found,
+                              BlockHandle* block_handle);
+
 }  // namespace rocksdb
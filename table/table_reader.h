@@ -9,6 +9,9 @@
 
 #pragma once
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 #include "db/range_tombstone_fragmenter.h"
 #include "rocksdb/slice_transform.h"
 #include "table/get_context.h"
@@ -72,6 +75,35 @@ class TableReader {
   virtual uint64_t ApproximateSize(const Slice& start, const Slice& end,
                                    TableReaderCaller caller) = 0;
 
+  // A user key of the table with the approximate size of the data between
+  // it and the previous anchor, or the start of the table.
+  struct Anchor {
+    Anchor(const Slice& _user_key, uint64_t _range_size)
+        : user_key(_user_key.ToString()), range_size(_range_size) {}
+    std::string user_key;
+    uint64_t range_size;
+  };
+
+  // Appends to *anchors up to about max_anchors user keys in increasing
+  // order, spreading the data of the table evenly between them. Each anchor
+  // is at least as large as the keys before it, so that the anchors can be
+  // used as boundaries to split the table into ranges of similar size.
+  virtual Status ApproximateKeyAnchors(const ReadOptions& /*read_options*/,
+                                       size_t /*max_anchors*/,
+                                       std::vector<Anchor>* /*anchors*/) {
+    return Status::NotSupported("ApproximateKeyAnchors() not supported");
+  }
+
+  // Appends to *ranges, in increasing order, the user key ranges of the runs
+  // of consecutive data blocks that are in the block cache. A range
+  // (begin, end] runs from the index key of the block before the run, or
+  // from the start of the table if begin is empty, to the index key of the
+  // last block of the run. Tables without a block cache add no ranges.
+  virtual Status GetCachedKeyRanges(
+      std::vector<std::pair<std::string, std::string>>* /*ranges*/) {
+    return Status::NotSupported("GetCachedKeyRanges() not supported");
+  }
+
   // Set up the table for Compaction. Might change some parameters with
   // posix_fadvise
   virtual void SetupForCompaction() = 0;
@@ -52,6 +52,26 @@ static std::string MakeKey(int i, int j, bool through_db) {
 uint64_t Now(Env* env, bool measured_by_nanosecond) {
   return measured_by_nanosecond ? env->NowNanos() : env->NowMicros();
 }
+
+// Orders keys like BytewiseComparator() without being recognized as it, so
+// that every user key comparison is a virtual call.
+class ForwardingBytewiseComparator : public Comparator {
+ public:
+  const char* Name() const override { return BytewiseComparator()->Name(); }
+  int Compare(const Slice& a, const Slice& b) const override {
+    return BytewiseComparator()->Compare(a, b);
+  }
+  bool Equal(const Slice& a, const Slice& b) const override {
+    return BytewiseComparator()->Equal(a, b);
+  }
+  void FindShortestSeparator(std::string* start,
+                             const Slice& limit) const override {
+    BytewiseComparator()->FindShortestSeparator(start, limit);
+  }
+  void FindShortSuccessor(std::string* key) const override {
+    BytewiseComparator()->FindShortSuccessor(key);
+  }
+};
 }  // namespace
 
 // A very simple benchmark that.
@@ -272,6 +292,20 @@ DEFINE_bool(mmap_read, true, "Whether use mmap read");
 DEFINE_string(table_factory, "block_based",
               "Table factory to use: `block_based` (default), `plain_table` or "
               "`cuckoo_hash`.");
+DEFINE_int32(format_version,
+             static_cast<int32_t>(
+                 rocksdb::BlockBasedTableOptions().format_version),
+             "format_version of block based tables. Compare 5 and 6 to "
+             "measure seeks with and without restart key prefixes.");
+DEFINE_int32(block_restart_interval,
+             rocksdb::BlockBasedTableOptions().block_restart_interval,
+             "Number of keys between restart points of data blocks in block "
+             "based tables.");
+DEFINE_bool(forwarding_comparator, false,
+            "Use a comparator forwarding to BytewiseComparator instead of "
+            "BytewiseComparator itself, to measure the gain of the inlined "
+            "comparisons for BytewiseComparator. Use with format_version=5, "
+            "as restart key prefixes need BytewiseComparator.");
 DEFINE_string(time_unit, "microsecond",
               "The time unit used for measuring performance. User can specify "
               "`microsecond` (default) or `nanosecond`");
@@ -291,6 +325,10 @@ int main(int argc, char** argv) {
   rocksdb::EnvOptions env_options;
   options.create_if_missing = true;
   options.compression = rocksdb::CompressionType::kNoCompression;
+  rocksdb::ForwardingBytewiseComparator forwarding_comparator;
+  if (FLAGS_forwarding_comparator) {
+    options.comparator = &forwarding_comparator;
+  }
 
   if (FLAGS_table_factory == "cuckoo_hash") {
 #ifndef ROCKSDB_LITE
@@ -321,7 +359,10 @@ int main(int argc, char** argv) {
     exit(1);
 #endif  // ROCKSDB_LITE
   } else if (FLAGS_table_factory == "block_based") {
-    tf.reset(new rocksdb::BlockBasedTableFactory());
+    rocksdb::BlockBasedTableOptions table_options;
+    table_options.format_version = static_cast<uint32_t>(FLAGS_format_version);
+    table_options.block_restart_interval = FLAGS_block_restart_interval;
+    tf.reset(new rocksdb::BlockBasedTableFactory(table_options));
   } else {
     fprintf(stderr, "Invalid table type %s\n", FLAGS_table_factory.c_str());
   }
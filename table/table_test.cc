@@ -13,6 +13,7 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -1262,7 +1263,15 @@ TEST_P(BlockBasedTableTest, BasicBlockBasedTableProperties) {
     block_builder.Add(item.first, item.second);
   }
   Slice content = block_builder.Finish();
-  ASSERT_EQ(content.size() + kBlockTrailerSize + diff_internal_user_bytes,
+  // Since format_version 6, the block also stores the key prefix of each of
+  // its restart points
+  const size_t restart_key_prefix_bytes =
+      BlockBuilder::UseRestartKeyPrefixes(table_options.format_version,
+                                          options.comparator)
+          ? kvmap.size() * sizeof(uint64_t)
+          : 0;
+  ASSERT_EQ(content.size() + kBlockTrailerSize + diff_internal_user_bytes +
+                restart_key_prefix_bytes,
             props.data_size);
   c.ResetTableReader();
 }
@@ -1898,6 +1907,82 @@ TEST_P(BlockBasedTableTest, HashIndexTest) {
   IndexTest(table_options);
 }
 
+TEST_P(BlockBasedTableTest, LearnedIndexTest) {
+  BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+  table_options.index_type = BlockBasedTableOptions::kLearnedIndexSearch;
+  IndexTest(table_options);
+}
+
+TEST_P(BlockBasedTableTest, LearnedIndexSeek) {
+  // 8 byte big endian keys in clusters of varying density, so that the model
+  // needs several segments
+  auto encode = [](uint64_t v) {
+    std::string key(8, '\0');
+    for (int i = 7; i >= 0; i--, v >>= 8) {
+      key[i] = static_cast<char>(v & 0xff);
+    }
+    return key;
+  };
+  Random64 rnd(301);
+  std::set<std::string> user_keys;
+  uint64_t v = 0;
+  while (user_keys.size() < 5000) {
+    v += rnd.OneIn(50) ? rnd.Uniform(uint64_t{1} << 40) : 1 + rnd.Uniform(100);
+    user_keys.insert(encode(v));
+  }
+
+  for (int restart_interval : {1, 4}) {
+    size_t memory_usage[2];
+    for (int i = 0; i < 2; i++) {
+      BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+      table_options.index_type =
+          i == 0 ? BlockBasedTableOptions::kBinarySearch
+                 : BlockBasedTableOptions::kLearnedIndexSearch;
+      table_options.index_block_restart_interval = restart_interval;
+      table_options.block_size = 64;
+      Options options;
+      options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+      TableConstructor c(BytewiseComparator(),
+                         true /* convert_to_internal_key_ */);
+      for (const auto& key : user_keys) {
+        c.Add(key, "v");
+      }
+      std::vector<std::string> keys;
+      stl_wrappers::KVMap kvmap;
+      const ImmutableCFOptions ioptions(options);
+      const MutableCFOptions moptions(options);
+      const InternalKeyComparator internal_comparator(options.comparator);
+      c.Finish(options, ioptions, moptions, table_options, internal_comparator,
+               &keys, &kvmap);
+      auto* reader = c.GetTableReader();
+      memory_usage[i] = reader->ApproximateMemoryUsage();
+
+      std::unique_ptr<InternalIterator> iter(reader->NewIterator(
+          ReadOptions(), moptions.prefix_extractor.get(), /*arena=*/nullptr,
+          /*skip_filters=*/false, TableReaderCaller::kUncategorized));
+      for (int j = 0; j < 2000; j++) {
+        const uint64_t target_value = rnd.OneIn(10)
+                                          ? rnd.Next()
+                                          : rnd.Uniform(v + 100);
+        const std::string target = encode(target_value);
+        iter->Seek(InternalKey(target, kMaxSequenceNumber, kValueTypeForSeek)
+                       .Encode());
+        ASSERT_OK(iter->status());
+        auto expected = user_keys.lower_bound(target);
+        if (expected == user_keys.end()) {
+          ASSERT_FALSE(iter->Valid());
+        } else {
+          ASSERT_TRUE(iter->Valid());
+          ASSERT_EQ(*expected, ExtractUserKey(iter->key()).ToString());
+        }
+      }
+      c.ResetTableReader();
+    }
+    // The learned index reader holds the model
+    ASSERT_GT(memory_usage[1], memory_usage[0]);
+  }
+}
+
 TEST_P(BlockBasedTableTest, PartitionIndexTest) {
   const int max_index_keys = 5;
   const int est_max_index_key_value_size = 32;
@@ -1910,6 +1995,89 @@ TEST_P(BlockBasedTableTest, PartitionIndexTest) {
   }
 }
 
+TEST_P(BlockBasedTableTest, PartitionIndexHashTest) {
+  for (int i : {1, 64, 256}) {
+    BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+    table_options.index_type = BlockBasedTableOptions::kTwoLevelIndexSearch;
+    table_options.hash_index_partitions = true;
+    table_options.metadata_block_size = i;
+    IndexTest(table_options);
+  }
+}
+
+TEST_P(BlockBasedTableTest, PartitionIndexHashSeek) {
+  Random rnd(301);
+  std::set<std::string> user_keys;
+  while (user_keys.size() < 3000) {
+    user_keys.insert(RandomString(&rnd, 1 + rnd.Uniform(12)));
+  }
+  const std::vector<std::string> key_list(user_keys.begin(), user_keys.end());
+
+  for (int restart_interval : {1, 4}) {
+    BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+    table_options.index_type = BlockBasedTableOptions::kTwoLevelIndexSearch;
+    table_options.hash_index_partitions = true;
+    table_options.index_block_restart_interval = restart_interval;
+    table_options.block_size = 64;
+    table_options.metadata_block_size = 256;
+    Options options;
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    TableConstructor c(BytewiseComparator(),
+                       true /* convert_to_internal_key_ */);
+    for (const auto& key : user_keys) {
+      c.Add(key, "v" + key);
+    }
+    std::vector<std::string> keys;
+    stl_wrappers::KVMap kvmap;
+    const ImmutableCFOptions ioptions(options);
+    const MutableCFOptions moptions(options);
+    const InternalKeyComparator internal_comparator(options.comparator);
+    c.Finish(options, ioptions, moptions, table_options, internal_comparator,
+             &keys, &kvmap);
+    auto* reader = c.GetTableReader();
+
+    std::unique_ptr<InternalIterator> iter(reader->NewIterator(
+        ReadOptions(), moptions.prefix_extractor.get(), /*arena=*/nullptr,
+        /*skip_filters=*/false, TableReaderCaller::kUncategorized));
+    for (int j = 0; j < 3000; j++) {
+      // Keys of the table and absent keys
+      const std::string user_target =
+          rnd.OneIn(2) ? key_list[rnd.Uniform(
+                             static_cast<int>(key_list.size()))]
+                       : RandomString(&rnd, 1 + rnd.Uniform(12));
+      iter->Seek(InternalKey(user_target, kMaxSequenceNumber,
+                             kValueTypeForSeek)
+                     .Encode());
+      ASSERT_OK(iter->status());
+      auto expected = user_keys.lower_bound(user_target);
+      if (expected == user_keys.end()) {
+        ASSERT_FALSE(iter->Valid());
+      } else {
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(*expected, ExtractUserKey(iter->key()).ToString());
+        ASSERT_EQ("v" + *expected, iter->value().ToString());
+      }
+
+      PinnableSlice value;
+      GetContext get_context(options.comparator, nullptr, nullptr, nullptr,
+                             GetContext::kNotFound, user_target, &value,
+                             nullptr, nullptr, true, nullptr, nullptr);
+      ASSERT_OK(reader->Get(ReadOptions(),
+                            InternalKey(user_target, kMaxSequenceNumber,
+                                        kTypeValue)
+                                .Encode(),
+                            &get_context, moptions.prefix_extractor.get()));
+      if (user_keys.count(user_target)) {
+        ASSERT_EQ(GetContext::kFound, get_context.State());
+        ASSERT_EQ("v" + user_target, value.ToString());
+      } else {
+        ASSERT_EQ(GetContext::kNotFound, get_context.State());
+      }
+    }
+    c.ResetTableReader();
+  }
+}
+
 TEST_P(BlockBasedTableTest, IndexSeekOptimizationIncomplete) {
   std::unique_ptr<InternalKeyComparator> comparator(
       new InternalKeyComparator(BytewiseComparator()));
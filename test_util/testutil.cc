@@ -24,7 +24,7 @@ namespace rocksdb {
 namespace test {
 
 const uint32_t kDefaultFormatVersion = BlockBasedTableOptions().format_version;
-const uint32_t kLatestFormatVersion = 5u;
+const uint32_t kLatestFormatVersion = 6u;
 
 Slice RandomString(Random* rnd, int len, std::string* dst) {
   dst->resize(len);
@@ -202,9 +202,10 @@ BlockBasedTableOptions RandomBlockBasedTableOptions(Random* rnd) {
   opt.pin_l0_filter_and_index_blocks_in_cache = rnd->Uniform(2);
   opt.pin_top_level_index_and_filter = rnd->Uniform(2);
   using IndexType = BlockBasedTableOptions::IndexType;
-  const std::array<IndexType, 4> index_types = {
+  const std::array<IndexType, 5> index_types = {
       {IndexType::kBinarySearch, IndexType::kHashSearch,
-       IndexType::kTwoLevelIndexSearch, IndexType::kBinarySearchWithFirstKey}};
+       IndexType::kTwoLevelIndexSearch, IndexType::kBinarySearchWithFirstKey,
+       IndexType::kLearnedIndexSearch}};
   opt.index_type =
       index_types[rnd->Uniform(static_cast<int>(index_types.size()))];
   opt.hash_index_allow_collision = rnd->Uniform(2);
@@ -214,6 +215,8 @@ BlockBasedTableOptions RandomBlockBasedTableOptions(Random* rnd) {
   opt.block_restart_interval = rnd->Uniform(100);
   opt.index_block_restart_interval = rnd->Uniform(100);
   opt.whole_key_filtering = rnd->Uniform(2);
+  opt.range_filter = rnd->Uniform(2);
+  opt.hash_index_partitions = rnd->Uniform(2);
 
   return opt;
 }
@@ -300,9 +303,12 @@ void RandomInitDBOptions(DBOptions* db_opt, Random* rnd) {
   db_opt->max_manifest_file_size = uint_max + rnd->Uniform(100000);
   db_opt->max_total_wal_size = uint_max + rnd->Uniform(100000);
   db_opt->wal_bytes_per_sync = uint_max + rnd->Uniform(100000);
+  db_opt->compaction_autoscale_write_latency_micros =
+      uint_max + rnd->Uniform(100000);
 
   // unsigned int options
   db_opt->stats_dump_period_sec = rnd->Uniform(100000);
+  db_opt->compaction_autoscale_period_sec = rnd->Uniform(100000);
 }
 
 void RandomInitCFOptions(ColumnFamilyOptions* cf_opt, DBOptions& db_options,
@@ -316,6 +322,8 @@ void RandomInitCFOptions(ColumnFamilyOptions* cf_opt, DBOptions& db_options,
   cf_opt->level_compaction_dynamic_level_bytes = rnd->Uniform(2);
   cf_opt->optimize_filters_for_hits = rnd->Uniform(2);
   cf_opt->paranoid_file_checks = rnd->Uniform(2);
+  cf_opt->level_compaction_dynamic_file_size = rnd->Uniform(2);
+  cf_opt->warm_hot_blocks_after_compaction = rnd->Uniform(2);
   cf_opt->purge_redundant_kvs_while_flush = rnd->Uniform(2);
   cf_opt->force_consistency_checks = rnd->Uniform(2);
   cf_opt->compaction_options_fifo.allow_compaction = rnd->Uniform(2);
@@ -493,6 +493,15 @@ DEFINE_bool(enable_index_compression,
 DEFINE_bool(block_align, rocksdb::BlockBasedTableOptions().block_align,
             "Align data blocks on page size");
 
+DEFINE_bool(range_filter, rocksdb::BlockBasedTableOptions().range_filter,
+            "Write a range filter in each table, used by seeks with an upper "
+            "bound");
+
+DEFINE_bool(hash_index_partitions,
+            rocksdb::BlockBasedTableOptions().hash_index_partitions,
+            "Add a hash table of the user keys to each index partition when "
+            "--partition_index is set");
+
 DEFINE_bool(use_data_block_hash_index, false,
             "if use kDataBlockBinaryAndHash "
             "instead of kDataBlockBinarySearch. "
@@ -529,6 +538,10 @@ DEFINE_int32(random_access_max_buffer_size, 1024 * 1024,
 DEFINE_int32(writable_file_max_buffer_size, 1024 * 1024,
              "Maximum write buffer for Writable File");
 
+DEFINE_int32(max_async_writes_per_file, 0,
+             "Maximum number of io_uring writes in flight per written file. "
+             "0 means writes are synchronous.");
+
 DEFINE_int32(bloom_bits, -1, "Bloom filter bits per key. Negative means"
              " use default settings.");
 DEFINE_double(memtable_bloom_size_ratio, 0,
@@ -618,6 +631,16 @@ DEFINE_int32(target_file_size_multiplier,
              rocksdb::Options().target_file_size_multiplier,
              "A multiplier to compute target level-N file size (N >= 2)");
 
+DEFINE_bool(level_compaction_dynamic_file_size,
+            rocksdb::Options().level_compaction_dynamic_file_size,
+            "Cut leveled compaction output files at the file boundaries of "
+            "the next level, with dynamic file sizes");
+
+DEFINE_bool(warm_hot_blocks_after_compaction,
+            rocksdb::Options().warm_hot_blocks_after_compaction,
+            "Load the output blocks holding the keys of the cached input "
+            "blocks into the block cache at the end of a compaction");
+
 DEFINE_uint64(max_bytes_for_level_base,
               rocksdb::Options().max_bytes_for_level_base,
               "Max bytes for level-1");
@@ -700,6 +723,16 @@ DEFINE_bool(optimistic_transaction_db, false,
             "Open a OptimisticTransactionDB instance. "
             "Required for randomtransaction benchmark.");
 
+DEFINE_bool(optimistic_transaction_parallel_validate, false,
+            "If using an optimistic_transaction_db, validate transactions "
+            "concurrently before they enter the write group instead of on "
+            "the write thread");
+
+DEFINE_uint64(optimistic_transaction_lock_buckets,
+              rocksdb::OptimisticTransactionDBOptions().occ_lock_buckets,
+              "Number of lock buckets of an optimistic_transaction_db with "
+              "--optimistic_transaction_parallel_validate");
+
 DEFINE_bool(transaction_db, false,
             "Open a TransactionDB instance. "
             "Required for randomtransaction benchmark.");
@@ -719,6 +752,10 @@ DEFINE_int32(transaction_sleep, 0,
 DEFINE_uint64(transaction_lock_timeout, 100,
               "If using a transaction_db, specifies the lock wait timeout in"
               " milliseconds before failing a transaction waiting on a lock");
+
+DEFINE_bool(transaction_scalable_lock_manager, false,
+            "If using a transaction_db, lock keys with the "
+            "SCALABLE_LOCK_MANAGER instead of the striped lock manager");
 DEFINE_string(
     options_file, "",
     "The path to a RocksDB options file.  If specified, then db_bench will "
@@ -977,6 +1014,14 @@ DEFINE_bool(rate_limiter_auto_tuned, false,
             "Enable dynamic adjustment of rate limit according to demand for "
             "background I/O");
 
+DEFINE_bool(weighted_rate_limiter, false,
+            "Use NewWeightedRateLimiter() with its default class weights for "
+            "options.rate_limiter");
+
+DEFINE_int32(weighted_rate_limiter_user_read_weight, 0,
+             "Weight of user reads in the weighted rate limiter. 0 means "
+             "user reads are not rate limited.");
+
 
 DEFINE_bool(sine_write_rate, false,
             "Use a sine wave write_rate_limit");
@@ -1112,6 +1157,10 @@ static auto FLAGS_compaction_fadvice_e =
 DEFINE_bool(use_tailing_iterator, false,
             "Use tailing iterator to access a series of keys instead of get");
 
+DEFINE_int32(iter_next_batch_size, 0,
+             "If positive, readseq reads this many entries per "
+             "Iterator::NextBatch() call instead of calling Next()");
+
 DEFINE_bool(use_adaptive_mutex, rocksdb::Options().use_adaptive_mutex,
             "Use adaptive mutex");
 
@@ -1171,6 +1220,8 @@ DEFINE_bool(total_order_seek, false,
             "Enable total order seek regardless of index format.");
 DEFINE_bool(prefix_same_as_start, false,
             "Enforce iterator to return keys with prefix same as seek key.");
+DEFINE_bool(use_loser_tree_merge, false,
+            "Merge iterator children with a loser tree instead of a heap.");
 DEFINE_bool(
     seek_missing_prefix, false,
     "Iterator seek to keys with non-exist prefixes. Require prefix_size > 8");
@@ -3480,10 +3531,15 @@ class Benchmark {
     options.compaction_readahead_size = FLAGS_compaction_readahead_size;
     options.random_access_max_buffer_size = FLAGS_random_access_max_buffer_size;
     options.writable_file_max_buffer_size = FLAGS_writable_file_max_buffer_size;
+    options.max_async_writes_per_file = FLAGS_max_async_writes_per_file;
     options.use_fsync = FLAGS_use_fsync;
     options.num_levels = FLAGS_num_levels;
     options.target_file_size_base = FLAGS_target_file_size_base;
     options.target_file_size_multiplier = FLAGS_target_file_size_multiplier;
+    options.level_compaction_dynamic_file_size =
+        FLAGS_level_compaction_dynamic_file_size;
+    options.warm_hot_blocks_after_compaction =
+        FLAGS_warm_hot_blocks_after_compaction;
     options.max_bytes_for_level_base = FLAGS_max_bytes_for_level_base;
     options.level_compaction_dynamic_level_bytes =
         FLAGS_level_compaction_dynamic_level_bytes;
@@ -3614,6 +3670,8 @@ class Benchmark {
       block_based_options.enable_index_compression =
           FLAGS_enable_index_compression;
       block_based_options.block_align = FLAGS_block_align;
+      block_based_options.range_filter = FLAGS_range_filter;
+      block_based_options.hash_index_partitions = FLAGS_hash_index_partitions;
       if (FLAGS_use_data_block_hash_index) {
         block_based_options.data_block_index_type =
             rocksdb::BlockBasedTableOptions::kDataBlockBinaryAndHash;
@@ -3844,12 +3902,24 @@ class Benchmark {
                 "new_table_reader_for_compaction_inputs set\n");
         exit(1);
       }
-      options.rate_limiter.reset(NewGenericRateLimiter(
-          FLAGS_rate_limiter_bytes_per_sec, 100 * 1000 /* refill_period_us */,
-          10 /* fairness */,
-          FLAGS_rate_limit_bg_reads ? RateLimiter::Mode::kReadsOnly
-                                    : RateLimiter::Mode::kWritesOnly,
-          FLAGS_rate_limiter_auto_tuned));
+      if (FLAGS_weighted_rate_limiter) {
+        WeightedRateLimiterOptions rate_limiter_options;
+        rate_limiter_options.rate_bytes_per_sec =
+            FLAGS_rate_limiter_bytes_per_sec;
+        auto& user_read_options = rate_limiter_options.io_classes[
+            static_cast<int>(RateLimiter::IOClass::kUserRead)];
+        user_read_options.weight = static_cast<uint32_t>(
+            std::max(0, FLAGS_weighted_rate_limiter_user_read_weight));
+        options.rate_limiter.reset(
+            NewWeightedRateLimiter(rate_limiter_options));
+      } else {
+        options.rate_limiter.reset(NewGenericRateLimiter(
+            FLAGS_rate_limiter_bytes_per_sec,
+            100 * 1000 /* refill_period_us */, 10 /* fairness */,
+            FLAGS_rate_limit_bg_reads ? RateLimiter::Mode::kReadsOnly
+                                      : RateLimiter::Mode::kWritesOnly,
+            FLAGS_rate_limiter_auto_tuned));
+      }
     }
 
     options.listeners.emplace_back(listener_);
@@ -3896,6 +3966,18 @@ class Benchmark {
     InitializeOptionsGeneral(opts);
   }
 
+#ifndef ROCKSDB_LITE
+  OptimisticTransactionDBOptions GetOccOptions() {
+    OptimisticTransactionDBOptions occ_options;
+    if (FLAGS_optimistic_transaction_parallel_validate) {
+      occ_options.validate_policy = OccValidationPolicy::kValidateParallel;
+    }
+    occ_options.occ_lock_buckets =
+        static_cast<uint32_t>(FLAGS_optimistic_transaction_lock_buckets);
+    return occ_options;
+  }
+#endif  // ROCKSDB_LITE
+
   void OpenDb(Options options, const std::string& db_name,
       DBWithColumnFamilies* db) {
     Status s;
@@ -3940,14 +4022,19 @@ class Benchmark {
         s = DB::OpenForReadOnly(options, db_name, column_families,
             &db->cfh, &db->db);
       } else if (FLAGS_optimistic_transaction_db) {
-        s = OptimisticTransactionDB::Open(options, db_name, column_families,
-                                          &db->cfh, &db->opt_txn_db);
+        s = OptimisticTransactionDB::Open(options, GetOccOptions(), db_name,
+                                          column_families, &db->cfh,
+                                          &db->opt_txn_db);
         if (s.ok()) {
           db->db = db->opt_txn_db->GetBaseDB();
         }
       } else if (FLAGS_transaction_db) {
         TransactionDB* ptr;
         TransactionDBOptions txn_db_options;
+        if (FLAGS_transaction_scalable_lock_manager) {
+          txn_db_options.lock_manager =
+              TxnDBLockManager::SCALABLE_LOCK_MANAGER;
+        }
         if (options.unordered_write) {
           options.two_write_queues = true;
           txn_db_options.skip_concurrency_control = true;
@@ -3972,13 +4059,25 @@ class Benchmark {
     } else if (FLAGS_readonly) {
       s = DB::OpenForReadOnly(options, db_name, &db->db);
     } else if (FLAGS_optimistic_transaction_db) {
-      s = OptimisticTransactionDB::Open(options, db_name, &db->opt_txn_db);
+      std::vector<ColumnFamilyDescriptor> column_families = {
+          ColumnFamilyDescriptor(kDefaultColumnFamilyName,
+                                 ColumnFamilyOptions(options))};
+      std::vector<ColumnFamilyHandle*> handles;
+      s = OptimisticTransactionDB::Open(options, GetOccOptions(), db_name,
+                                        column_families, &handles,
+                                        &db->opt_txn_db);
       if (s.ok()) {
+        // DBImpl holds a reference to the default column family
+        assert(handles.size() == 1);
+        delete handles[0];
         db->db = db->opt_txn_db->GetBaseDB();
       }
     } else if (FLAGS_transaction_db) {
       TransactionDB* ptr = nullptr;
       TransactionDBOptions txn_db_options;
+      if (FLAGS_transaction_scalable_lock_manager) {
+        txn_db_options.lock_manager = TxnDBLockManager::SCALABLE_LOCK_MANAGER;
+      }
       if (options.unordered_write) {
         options.two_write_queues = true;
         txn_db_options.skip_concurrency_control = true;
@@ -4633,20 +4732,46 @@ class Benchmark {
   void ReadSequential(ThreadState* thread, DB* db) {
     ReadOptions options(FLAGS_verify_checksum, true);
     options.tailing = FLAGS_use_tailing_iterator;
+    options.use_loser_tree_merge = FLAGS_use_loser_tree_merge;
 
     Iterator* iter = db->NewIterator(options);
     int64_t i = 0;
     int64_t bytes = 0;
-    for (iter->SeekToFirst(); i < reads_ && iter->Valid(); iter->Next()) {
-      bytes += iter->key().size() + iter->value().size();
-      thread->stats.FinishedOps(nullptr, db, 1, kRead);
-      ++i;
+    if (FLAGS_iter_next_batch_size > 0) {
+      const size_t batch_size = static_cast<size_t>(FLAGS_iter_next_batch_size);
+      std::unique_ptr<PinnableSlice[]> keys(new PinnableSlice[batch_size]);
+      std::unique_ptr<PinnableSlice[]> values(new PinnableSlice[batch_size]);
+      iter->SeekToFirst();
+      while (i < reads_ && iter->Valid()) {
+        size_t n = iter->NextBatch(
+            std::min(batch_size, static_cast<size_t>(reads_ - i)), keys.get(),
+            values.get());
+        for (size_t j = 0; j < n; j++) {
+          bytes += keys[j].size() + values[j].size();
+        }
+        thread->stats.FinishedOps(nullptr, db, static_cast<int64_t>(n), kRead);
+        int64_t prev_i = i;
+        i += static_cast<int64_t>(n);
 
-      if (thread->shared->read_rate_limiter.get() != nullptr &&
-          i % 1024 == 1023) {
-        thread->shared->read_rate_limiter->Request(1024, Env::IO_HIGH,
-                                                   nullptr /* stats */,
-                                                   RateLimiter::OpType::kRead);
+        if (thread->shared->read_rate_limiter.get() != nullptr &&
+            i / 1024 != prev_i / 1024) {
+          thread->shared->read_rate_limiter->Request(
+              1024, Env::IO_HIGH, nullptr /* stats */,
+              RateLimiter::OpType::kRead);
+        }
+      }
+    } else {
+      for (iter->SeekToFirst(); i < reads_ && iter->Valid(); iter->Next()) {
+        bytes += iter->key().size() + iter->value().size();
+        thread->stats.FinishedOps(nullptr, db, 1, kRead);
+        ++i;
+
+        if (thread->shared->read_rate_limiter.get() != nullptr &&
+            i % 1024 == 1023) {
+          thread->shared->read_rate_limiter->Request(
+              1024, Env::IO_HIGH, nullptr /* stats */,
+              RateLimiter::OpType::kRead);
+        }
       }
     }
 
@@ -5421,6 +5546,7 @@ class Benchmark {
     int64_t bytes = 0;
     ReadOptions options(FLAGS_verify_checksum, true);
     options.total_order_seek = FLAGS_total_order_seek;
+    options.use_loser_tree_merge = FLAGS_use_loser_tree_merge;
     options.prefix_same_as_start = FLAGS_prefix_same_as_start;
     options.tailing = FLAGS_use_tailing_iterator;
     options.readahead_size = FLAGS_readahead_size;
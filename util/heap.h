@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <functional>
+#include <vector>
 #include "port/port.h"
 #include "util/autovector.h"
 
@@ -58,6 +59,18 @@ class BinaryHeap {
     return data_.front();
   }
 
+  // Returns the element top() would return after pop(), or nullptr if there
+  // is none.
+  const T* second_top() const {
+    if (data_.size() < 2) {
+      return nullptr;
+    }
+    if (data_.size() == 2 || !cmp_(data_[1], data_[2])) {
+      return &data_[1];
+    }
+    return &data_[2];
+  }
+
   void replace_top(const T& value) {
     assert(!empty());
     data_.front() = value;
@@ -163,4 +176,160 @@ class BinaryHeap {
   size_t root_cmp_cache_ = port::kMaxSizet;
 };
 
+// Loser tree (tournament tree) for merging a fixed number of input streams.
+// Each leaf holds the current head of one stream, or nothing once the stream
+// is exhausted, and each internal node remembers the loser of the match
+// played there. When the winning stream advances, only the matches on the
+// path from its leaf to the root are replayed, which takes about logN
+// comparisons whether or not the top changes, against up to 2logN for
+// BinaryHeap::replace_top(). On the other hand it never takes the single
+// comparison replace_top() needs when the same stream keeps winning.
+//
+// The tree uses the same ordering as BinaryHeap: top() returns the maximum
+// according to Compare. Leaves are set with set() and remove() followed by
+// build(), which replays all matches, while replace_top() and pop() only
+// replay the matches of the top leaf.
+
+template <typename T, typename Compare = std::less<T>>
+class LoserTree {
+ public:
+  LoserTree() {}
+  explicit LoserTree(Compare cmp) : cmp_(std::move(cmp)) {}
+
+  // Resizes the tree to `num_leaves` leaves, all empty.
+  void reset(size_t num_leaves) {
+    leaves_.assign(num_leaves, Leaf());
+    nodes_.assign(num_leaves, 0);
+    winners_.resize(num_leaves);
+    built_ = false;
+  }
+
+  size_t num_leaves() const { return leaves_.size(); }
+
+  void set(size_t leaf, const T& value) {
+    assert(leaf < leaves_.size());
+    leaves_[leaf].value = value;
+    leaves_[leaf].present = true;
+    built_ = false;
+  }
+
+  void remove(size_t leaf) {
+    assert(leaf < leaves_.size());
+    leaves_[leaf].present = false;
+    built_ = false;
+  }
+
+  // Empties all leaves.
+  void clear() {
+    for (auto& leaf : leaves_) {
+      leaf.present = false;
+    }
+    built_ = false;
+  }
+
+  // Plays all matches after set(), remove() or clear().
+  void build() {
+    if (built_) {
+      return;
+    }
+    const size_t n = leaves_.size();
+    // Internal node i has children 2i and 2i+1, where n + j stands for leaf j
+    for (size_t i = n > 0 ? n - 1 : 0; i > 0; --i) {
+      const size_t left = 2 * i < n ? winners_[2 * i] : 2 * i - n;
+      const size_t right = 2 * i + 1 < n ? winners_[2 * i + 1] : 2 * i + 1 - n;
+      if (Beats(right, left)) {
+        winners_[i] = right;
+        nodes_[i] = left;
+      } else {
+        winners_[i] = left;
+        nodes_[i] = right;
+      }
+    }
+    if (n > 0) {
+      nodes_[0] = n > 1 ? winners_[1] : 0;
+    }
+    built_ = true;
+  }
+
+  bool empty() const {
+    assert(built_);
+    return leaves_.empty() || !leaves_[nodes_[0]].present;
+  }
+
+  const T& top() const {
+    assert(!empty());
+    return leaves_[nodes_[0]].value;
+  }
+
+  // Index of the leaf holding top()
+  size_t top_leaf() const {
+    assert(!empty());
+    return nodes_[0];
+  }
+
+  // Returns the value top() would return after pop(), or nullptr if there is
+  // none. It lost a match against the top leaf, so it is one of the losers on
+  // the path of the top leaf.
+  const T* second_top() const {
+    assert(!empty());
+    const size_t n = leaves_.size();
+    size_t best = n;
+    for (size_t i = (nodes_[0] + n) / 2; i > 0; i /= 2) {
+      const size_t leaf = nodes_[i];
+      if (leaves_[leaf].present && (best == n || Beats(leaf, best))) {
+        best = leaf;
+      }
+    }
+    return best < n ? &leaves_[best].value : nullptr;
+  }
+
+  void replace_top(const T& value) {
+    assert(!empty());
+    leaves_[nodes_[0]].value = value;
+    replay(nodes_[0]);
+  }
+
+  void pop() {
+    assert(!empty());
+    leaves_[nodes_[0]].present = false;
+    replay(nodes_[0]);
+  }
+
+ private:
+  struct Leaf {
+    T value = T();
+    bool present = false;
+  };
+
+  // Whether leaf a wins the match against leaf b. An empty leaf loses
+  // against any other leaf.
+  bool Beats(size_t a, size_t b) const {
+    const Leaf& la = leaves_[a];
+    const Leaf& lb = leaves_[b];
+    if (!la.present || !lb.present) {
+      return la.present;
+    }
+    return cmp_(lb.value, la.value);
+  }
+
+  // Replays the matches from `leaf` up to the root
+  void replay(size_t leaf) {
+    size_t winner = leaf;
+    for (size_t i = (leaf + leaves_.size()) / 2; i > 0; i /= 2) {
+      if (Beats(nodes_[i], winner)) {
+        std::swap(nodes_[i], winner);
+      }
+    }
+    nodes_[0] = winner;
+  }
+
+  Compare cmp_;
+  std::vector<Leaf> leaves_;
+  // nodes_[0] is the winner, nodes_[i] for i > 0 the loser at internal node i
+  std::vector<size_t> nodes_;
+  // Scratch space for build()
+  std::vector<size_t> winners_;
+  bool built_ = false;
+};
+
 }  // namespace rocksdb
@@ -10,6 +10,7 @@
 #include <queue>
 #include <random>
 #include <utility>
+#include <vector>
 
 #include "util/heap.h"
 
@@ -91,6 +92,15 @@ TEST_P(HeapTest, Test) {
     ASSERT_EQ(size == 0, heap.empty());
     if (size > 0) {
       ASSERT_EQ(ref.top(), heap.top());
+      HeapTestValue top = ref.top();
+      ref.pop();
+      if (ref.empty()) {
+        ASSERT_EQ(nullptr, heap.second_top());
+      } else {
+        ASSERT_NE(nullptr, heap.second_top());
+        ASSERT_EQ(ref.top(), *heap.second_top());
+      }
+      ref.push(top);
     }
   }
 
@@ -102,6 +112,79 @@ TEST_P(HeapTest, Test) {
   ASSERT_TRUE(heap.empty());
 }
 
+TEST_P(HeapTest, LoserTree) {
+  // Same as above for a LoserTree with MAX_HEAP_SIZE leaves. Inserting fills
+  // a random empty leaf and replays all matches with build().
+  const auto MAX_HEAP_SIZE = std::get<0>(GetParam());
+  const auto MAX_VALUE = std::get<1>(GetParam());
+  const auto RNG_SEED = std::get<2>(GetParam());
+
+  LoserTree<HeapTestValue> tree;
+  tree.reset(MAX_HEAP_SIZE);
+  tree.build();
+  ASSERT_TRUE(tree.empty());
+  std::priority_queue<HeapTestValue> ref;
+  std::vector<size_t> empty_leaves;
+  for (size_t i = 0; i < MAX_HEAP_SIZE; ++i) {
+    empty_leaves.push_back(i);
+  }
+
+  std::mt19937 rng(static_cast<unsigned int>(RNG_SEED));
+  std::uniform_int_distribution<HeapTestValue> value_dist(0, MAX_VALUE);
+  bool draining = false;
+  // Rebuilding is O(n), so do fewer operations than the heap test
+  const int64_t iters = FLAGS_iters / 10;
+  for (int64_t i = 0; i < iters; ++i) {
+    if (ref.empty()) {
+      draining = false;
+    }
+
+    if (!draining && (ref.empty() || std::bernoulli_distribution(0.4)(rng))) {
+      // insert
+      size_t pos = std::uniform_int_distribution<size_t>(
+          0, empty_leaves.size() - 1)(rng);
+      std::swap(empty_leaves[pos], empty_leaves.back());
+      HeapTestValue val = value_dist(rng);
+      tree.set(empty_leaves.back(), val);
+      tree.build();
+      empty_leaves.pop_back();
+      ref.push(val);
+      if (empty_leaves.empty()) {
+        draining = true;
+      }
+    } else if (std::bernoulli_distribution(0.5)(rng)) {
+      // replace top
+      HeapTestValue val = value_dist(rng);
+      tree.replace_top(val);
+      ref.pop();
+      ref.push(val);
+    } else {
+      // pop
+      empty_leaves.push_back(tree.top_leaf());
+      tree.pop();
+      ref.pop();
+    }
+
+    ASSERT_EQ(ref.empty(), tree.empty());
+    if (!ref.empty()) {
+      ASSERT_EQ(ref.top(), tree.top());
+      HeapTestValue top = ref.top();
+      ref.pop();
+      if (ref.empty()) {
+        ASSERT_EQ(nullptr, tree.second_top());
+      } else {
+        ASSERT_NE(nullptr, tree.second_top());
+        ASSERT_EQ(ref.top(), *tree.second_top());
+      }
+      ref.push(top);
+    }
+  }
+
+  tree.clear();
+  tree.build();
+  ASSERT_TRUE(tree.empty());
+}
+
 // Basic test, MAX_VALUE = 3*MAX_HEAP_SIZE (occasional duplicates)
 INSTANTIATE_TEST_CASE_P(
   Basic, HeapTest,
@@ -33,6 +33,21 @@ size_t RateLimiter::RequestToken(size_t bytes, size_t alignment,
   return bytes;
 }
 
+size_t RateLimiter::RequestToken(size_t bytes, size_t alignment,
+                                 Env::IOPriority io_priority, Statistics* stats,
+                                 RateLimiter::OpType op_type,
+                                 RateLimiter::IOClass io_class) {
+  if (IsRateLimited(op_type, io_class)) {
+    bytes = std::min(bytes, static_cast<size_t>(GetSingleBurstBytes()));
+
+    if (alignment > 0) {
+      bytes = std::max(alignment, TruncateToPageBoundary(alignment, bytes));
+    }
+    Request(bytes, io_priority, stats, op_type, io_class);
+  }
+  return bytes;
+}
+
 // Pending request
 struct GenericRateLimiter::Req {
   explicit Req(int64_t _bytes, port::Mutex* _mu)
@@ -18,6 +18,7 @@
 #include "test_util/sync_point.h"
 #include "test_util/testharness.h"
 #include "util/random.h"
+#include "util/weighted_rate_limiter.h"
 
 namespace rocksdb {
 
@@ -227,6 +228,146 @@ TEST_F(RateLimiterTest, AutoTuneIncreaseWhenFull) {
   ASSERT_LT(new_bytes_per_sec, orig_bytes_per_sec);
 }
 
+TEST_F(RateLimiterTest, IOClasses) {
+  GenericRateLimiter generic_limiter(
+      2000 /* rate_bytes_per_sec */, 1000 * 1000 /* refill_period_us */,
+      10 /* fairness */, RateLimiter::Mode::kWritesOnly, Env::Default(),
+      false /* auto_tuned */);
+  ASSERT_FALSE(generic_limiter.IsRateLimited(RateLimiter::OpType::kRead,
+                                             RateLimiter::IOClass::kUserRead));
+  ASSERT_FALSE(generic_limiter.IsRateLimited(RateLimiter::OpType::kWrite,
+                                             RateLimiter::IOClass::kWAL));
+  ASSERT_TRUE(generic_limiter.IsRateLimited(
+      RateLimiter::OpType::kWrite, RateLimiter::IOClass::kL0Compaction));
+  generic_limiter.Request(1000 /* bytes */, Env::IO_LOW, nullptr /* stats */,
+                          RateLimiter::OpType::kWrite,
+                          RateLimiter::IOClass::kBackup);
+  ASSERT_EQ(1000, generic_limiter.GetTotalBytesThrough(Env::IO_LOW));
+
+  WeightedRateLimiterOptions options;
+  options.rate_bytes_per_sec = 2000;
+  options.refill_period_us = 1000 * 1000;
+  options.io_classes[static_cast<int>(RateLimiter::IOClass::kUserRead)]
+      .weight = 1;
+  WeightedRateLimiter limiter(options, Env::Default());
+  ASSERT_TRUE(limiter.IsRateLimited(RateLimiter::OpType::kRead,
+                                    RateLimiter::IOClass::kUserRead));
+  ASSERT_FALSE(limiter.IsRateLimited(RateLimiter::OpType::kWrite,
+                                     RateLimiter::IOClass::kWAL));
+
+  // Requests without a class are classified by priority
+  limiter.Request(500 /* bytes */, Env::IO_HIGH, nullptr /* stats */);
+  limiter.Request(300 /* bytes */, Env::IO_LOW, nullptr /* stats */,
+                  RateLimiter::OpType::kWrite);
+  limiter.Request(100 /* bytes */, Env::IO_TOTAL, nullptr /* stats */,
+                  RateLimiter::OpType::kRead, RateLimiter::IOClass::kUserRead);
+  // Not rate limited
+  limiter.Request(1000 /* bytes */, Env::IO_TOTAL, nullptr /* stats */,
+                  RateLimiter::OpType::kWrite, RateLimiter::IOClass::kWAL);
+  ASSERT_EQ(500, limiter.GetTotalBytesThroughClass(
+                     RateLimiter::IOClass::kFlush));
+  ASSERT_EQ(300, limiter.GetTotalBytesThroughClass(
+                     RateLimiter::IOClass::kCompaction));
+  ASSERT_EQ(100, limiter.GetTotalBytesThroughClass(
+                     RateLimiter::IOClass::kUserRead));
+  ASSERT_EQ(0,
+            limiter.GetTotalBytesThroughClass(RateLimiter::IOClass::kWAL));
+  ASSERT_EQ(500, limiter.GetTotalBytesThrough(Env::IO_HIGH));
+  ASSERT_EQ(900, limiter.GetTotalBytesThrough());
+  ASSERT_EQ(3, limiter.GetTotalRequests());
+
+  // Compaction input reads are charged to kCompaction, unless the mode
+  // leaves reads out
+  limiter.RequestToken(200 /* bytes */, 0 /* alignment */, Env::IO_LOW,
+                       nullptr /* stats */, RateLimiter::OpType::kRead);
+  ASSERT_EQ(500, limiter.GetTotalBytesThroughClass(
+                     RateLimiter::IOClass::kCompaction));
+
+  options.mode = RateLimiter::Mode::kWritesOnly;
+  WeightedRateLimiter writes_only_limiter(options, Env::Default());
+  ASSERT_FALSE(writes_only_limiter.IsRateLimited(
+      RateLimiter::OpType::kRead, RateLimiter::IOClass::kUserRead));
+  writes_only_limiter.RequestToken(200 /* bytes */, 0 /* alignment */,
+                                   Env::IO_LOW, nullptr /* stats */,
+                                   RateLimiter::OpType::kRead);
+  writes_only_limiter.Request(
+      100 /* bytes */, Env::IO_TOTAL, nullptr /* stats */,
+      RateLimiter::OpType::kRead, RateLimiter::IOClass::kUserRead);
+  ASSERT_EQ(0, writes_only_limiter.GetTotalBytesThrough());
+  ASSERT_EQ(0, writes_only_limiter.GetTotalRequests());
+}
+
+TEST_F(RateLimiterTest, WeightedShares) {
+  const int64_t kRate = 1000 * 1000;
+  const int64_t kRequestBytes = 25 * 1000;
+  WeightedRateLimiterOptions options;
+  options.rate_bytes_per_sec = kRate;
+  options.refill_period_us = 100 * 1000;
+  for (auto& class_options : options.io_classes) {
+    class_options.weight = 0;
+  }
+  options.io_classes[static_cast<int>(RateLimiter::IOClass::kFlush)].weight =
+      3;
+  options.io_classes[static_cast<int>(
+                         RateLimiter::IOClass::kBottommostCompaction)]
+      .weight = 1;
+  auto& backup_options =
+      options.io_classes[static_cast<int>(RateLimiter::IOClass::kBackup)];
+  backup_options.weight = 1;
+  backup_options.min_bytes_per_sec = kRate * 2 / 5;
+  WeightedRateLimiter limiter(options, Env::Default());
+  auto stats = CreateDBStatistics();
+
+  // Keep every class backlogged. Each refill of 100KB grants backup its
+  // 40KB first, then shares the other 60KB by weight: 36KB to flush, 12KB to
+  // bottommost compaction and 12KB to backup. The four threads of a class
+  // queue 100KB, more than any class is granted in a refill.
+  std::atomic<bool> stop(false);
+  std::vector<port::Thread> threads;
+  for (auto io_class : {RateLimiter::IOClass::kFlush,
+                        RateLimiter::IOClass::kBottommostCompaction,
+                        RateLimiter::IOClass::kBackup}) {
+    for (int i = 0; i < 4; i++) {
+      threads.emplace_back([&, io_class]() {
+        while (!stop.load()) {
+          limiter.Request(kRequestBytes, Env::IO_LOW, stats.get(),
+                          RateLimiter::OpType::kWrite, io_class);
+        }
+      });
+    }
+  }
+  auto bytes_through = [&](RateLimiter::IOClass io_class) {
+    return limiter.GetTotalBytesThroughClass(io_class);
+  };
+  // Skip the grants made while the threads start
+  Env::Default()->SleepForMicroseconds(500 * 1000);
+  int64_t flush_bytes = -bytes_through(RateLimiter::IOClass::kFlush);
+  int64_t bottommost_bytes =
+      -bytes_through(RateLimiter::IOClass::kBottommostCompaction);
+  int64_t backup_bytes = -bytes_through(RateLimiter::IOClass::kBackup);
+  Env::Default()->SleepForMicroseconds(2 * 1000 * 1000);
+  flush_bytes += bytes_through(RateLimiter::IOClass::kFlush);
+  bottommost_bytes +=
+      bytes_through(RateLimiter::IOClass::kBottommostCompaction);
+  backup_bytes += bytes_through(RateLimiter::IOClass::kBackup);
+  stop.store(true);
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  ASSERT_GT(flush_bytes, 2 * bottommost_bytes);
+  ASSERT_GT(backup_bytes, 3 * bottommost_bytes);
+  ASSERT_GT(backup_bytes, flush_bytes);
+
+  HistogramData flush_delay;
+  stats->histogramData(RATE_LIMITER_DELAY_FLUSH_MICROS, &flush_delay);
+  ASSERT_GT(flush_delay.count, 0U);
+  ASSERT_GT(flush_delay.max, 0);
+  HistogramData wal_delay;
+  stats->histogramData(RATE_LIMITER_DELAY_WAL_MICROS, &wal_delay);
+  ASSERT_EQ(0U, wal_delay.count);
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
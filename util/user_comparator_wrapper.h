@@ -15,22 +15,43 @@ namespace rocksdb {
 
 // Wrapper of user comparator, with auto increment to
 // perf_context.user_key_comparison_count.
+//
+// When the user comparator is BytewiseComparator() or
+// ReverseBytewiseComparator(), which is detected once at construction,
+// Compare() and Equal() compare the keys inline instead of calling the user
+// comparator. As the class is final, callers holding the wrapper by value,
+// like InternalKeyComparator, then compare user keys without any virtual
+// call.
 class UserComparatorWrapper final : public Comparator {
  public:
   explicit UserComparatorWrapper(const Comparator* const user_cmp)
-      : user_comparator_(user_cmp) {}
-  
+      : user_comparator_(user_cmp),
+        kind_(user_cmp == BytewiseComparator()
+                  ? kBytewise
+                  : user_cmp == ReverseBytewiseComparator() ? kReverseBytewise
+                                                            : kOther) {}
+
   ~UserComparatorWrapper() = default;
 
   const Comparator* user_comparator() const { return user_comparator_; }
 
   int Compare(const Slice& a, const Slice& b) const override {
     PERF_COUNTER_ADD(user_key_comparison_count, 1);
-    return user_comparator_->Compare(a, b);
+    switch (kind_) {
+      case kBytewise:
+        return a.compare(b);
+      case kReverseBytewise:
+        return b.compare(a);
+      default:
+        return user_comparator_->Compare(a, b);
+    }
   }
 
   bool Equal(const Slice& a, const Slice& b) const override {
     PERF_COUNTER_ADD(user_key_comparison_count, 1);
+    if (kind_ != kOther) {
+      return a == b;
+    }
     return user_comparator_->Equal(a, b);
   }
 
@@ -59,7 +80,14 @@ class UserComparatorWrapper final : public Comparator {
   }
 
  private:
+  enum Kind : unsigned char {
+    kBytewise,
+    kReverseBytewise,
+    kOther,
+  };
+
   const Comparator* user_comparator_;
+  Kind kind_;
 };
 
 }  // namespace rocksdb
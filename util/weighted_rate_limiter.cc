@@ -0,0 +1,355 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "util/weighted_rate_limiter.h"
+#include <algorithm>
+#include "monitoring/statistics.h"
+#include "test_util/sync_point.h"
+
+namespace rocksdb {
+
+namespace {
+// Queueing delay histogram of each RateLimiter::IOClass.
+const Histograms kQueueingDelayHistograms[] = {
+    RATE_LIMITER_DELAY_USER_READ_MICROS,
+    RATE_LIMITER_DELAY_WAL_MICROS,
+    RATE_LIMITER_DELAY_FLUSH_MICROS,
+    RATE_LIMITER_DELAY_L0_COMPACTION_MICROS,
+    RATE_LIMITER_DELAY_COMPACTION_MICROS,
+    RATE_LIMITER_DELAY_BOTTOMMOST_COMPACTION_MICROS,
+    RATE_LIMITER_DELAY_BACKUP_MICROS,
+};
+static_assert(sizeof(kQueueingDelayHistograms) /
+                      sizeof(kQueueingDelayHistograms[0]) ==
+                  static_cast<size_t>(RateLimiter::IOClass::kNumIOClasses),
+              "Every IOClass needs a queueing delay histogram");
+}  // namespace
+
+WeightedRateLimiterOptions::WeightedRateLimiterOptions() {
+  io_classes[static_cast<int>(RateLimiter::IOClass::kFlush)].weight = 8;
+  io_classes[static_cast<int>(RateLimiter::IOClass::kL0Compaction)].weight = 4;
+  io_classes[static_cast<int>(RateLimiter::IOClass::kCompaction)].weight = 2;
+  io_classes[static_cast<int>(RateLimiter::IOClass::kBottommostCompaction)]
+      .weight = 1;
+  io_classes[static_cast<int>(RateLimiter::IOClass::kBackup)].weight = 1;
+}
+
+// Pending request
+struct WeightedRateLimiter::Req {
+  Req(int64_t _bytes, Env::IOPriority _pri, uint64_t _enqueue_us,
+      Statistics* _stats, port::Mutex* _mu)
+      : bytes(_bytes),
+        request_bytes(_bytes),
+        pri(_pri),
+        enqueue_us(_enqueue_us),
+        stats(_stats),
+        cv(_mu),
+        granted(false) {}
+  int64_t bytes;
+  // Bytes not charged yet
+  int64_t request_bytes;
+  Env::IOPriority pri;
+  uint64_t enqueue_us;
+  Statistics* stats;
+  port::CondVar cv;
+  bool granted;
+};
+
+WeightedRateLimiter::WeightedRateLimiter(
+    const WeightedRateLimiterOptions& options, Env* env)
+    : RateLimiter(options.mode),
+      refill_period_us_(options.refill_period_us),
+      rate_bytes_per_sec_(options.rate_bytes_per_sec),
+      refill_bytes_per_period_(
+          CalculateRefillBytesPerPeriod(options.rate_bytes_per_sec)),
+      env_(env),
+      stop_(false),
+      exit_cv_(&request_mutex_),
+      requests_to_wait_(0),
+      available_bytes_(0),
+      next_refill_us_(NowMicrosMonotonic()),
+      leader_(nullptr),
+      num_waiting_(0) {
+  for (size_t c = 0; c < kNumClasses; c++) {
+    const auto& class_options = options.io_classes[c];
+    weights_[c] = class_options.weight;
+    min_bytes_per_period_[c] = 0;
+    if (class_options.min_bytes_per_sec > 0) {
+      min_bytes_per_period_[c] =
+          std::max<int64_t>(1, CalculateRefillBytesPerPeriod(
+                                   class_options.min_bytes_per_sec));
+    }
+    max_queueing_delay_us_[c] = class_options.max_queueing_delay_us;
+    total_requests_[c] = 0;
+    total_bytes_through_[c] = 0;
+  }
+  for (int pri = 0; pri < Env::IO_TOTAL; pri++) {
+    total_requests_by_pri_[pri] = 0;
+    total_bytes_through_by_pri_[pri] = 0;
+  }
+}
+
+WeightedRateLimiter::~WeightedRateLimiter() {
+  MutexLock g(&request_mutex_);
+  stop_ = true;
+  requests_to_wait_ = static_cast<int32_t>(num_waiting_);
+  for (auto& queue : queues_) {
+    for (auto& r : queue) {
+      r->cv.Signal();
+    }
+  }
+  while (requests_to_wait_ > 0) {
+    exit_cv_.Wait();
+  }
+}
+
+void WeightedRateLimiter::SetBytesPerSecond(int64_t bytes_per_second) {
+  assert(bytes_per_second > 0);
+  rate_bytes_per_sec_.store(bytes_per_second, std::memory_order_relaxed);
+  refill_bytes_per_period_.store(
+      CalculateRefillBytesPerPeriod(bytes_per_second),
+      std::memory_order_relaxed);
+}
+
+bool WeightedRateLimiter::IsRateLimited(OpType op_type, IOClass io_class) {
+  return weights_[static_cast<size_t>(io_class)] > 0 &&
+         RateLimiter::IsRateLimited(op_type);
+}
+
+void WeightedRateLimiter::Request(const int64_t bytes,
+                                  const Env::IOPriority pri,
+                                  Statistics* stats) {
+  Request(bytes, pri, stats, OpType::kWrite,
+          pri == Env::IO_HIGH ? IOClass::kFlush : IOClass::kCompaction);
+}
+
+void WeightedRateLimiter::Request(const int64_t bytes,
+                                  const Env::IOPriority pri,
+                                  Statistics* stats, OpType op_type,
+                                  IOClass io_class) {
+  const size_t c = static_cast<size_t>(io_class);
+  assert(c < kNumClasses);
+  if (!IsRateLimited(op_type, io_class)) {
+    return;
+  }
+  assert(bytes <= refill_bytes_per_period_.load(std::memory_order_relaxed));
+  TEST_SYNC_POINT("WeightedRateLimiter::Request");
+  uint64_t enqueue_us = NowMicrosMonotonic();
+  MutexLock g(&request_mutex_);
+
+  if (stop_) {
+    return;
+  }
+
+  ++total_requests_[c];
+  if (pri < Env::IO_TOTAL) {
+    ++total_requests_by_pri_[pri];
+  }
+
+  if (num_waiting_ == 0 && available_bytes_ >= bytes) {
+    available_bytes_ -= bytes;
+    total_bytes_through_[c] += bytes;
+    if (pri < Env::IO_TOTAL) {
+      total_bytes_through_by_pri_[pri] += bytes;
+    }
+    RecordInHistogram(stats, kQueueingDelayHistograms[c], 0);
+    return;
+  }
+
+  // Request cannot be satisfied at this moment, enqueue
+  Req r(bytes, pri, enqueue_us, stats, &request_mutex_);
+  queues_[c].push_back(&r);
+  ++num_waiting_;
+
+  do {
+    if (leader_ == nullptr) {
+      // The leader waits for the next refill and performs it
+      leader_ = &r;
+      uint64_t now = NowMicrosMonotonic();
+      if (next_refill_us_ > now) {
+        RecordTick(stats, NUMBER_RATE_LIMITER_DRAINS);
+        r.cv.TimedWait(env_->NowMicros() + (next_refill_us_ - now));
+      }
+      if (!stop_ && NowMicrosMonotonic() >= next_refill_us_) {
+        Refill();
+      }
+      leader_ = nullptr;
+      if (r.granted) {
+        // Hand over the leadership to a request that still waits
+        for (auto& queue : queues_) {
+          if (!queue.empty()) {
+            queue.front()->cv.Signal();
+            break;
+          }
+        }
+      }
+    } else {
+      // Waits to be granted, or to be elected as leader
+      r.cv.Wait();
+    }
+
+    // request_mutex_ is held from now on. Granted requests are not waited
+    // for by the destructor.
+    if (stop_ && !r.granted) {
+      --requests_to_wait_;
+      exit_cv_.Signal();
+      return;
+    }
+  } while (!r.granted);
+}
+
+int64_t WeightedRateLimiter::Grant(size_t c, int64_t budget,
+                                   uint64_t now_us) {
+  int64_t used = 0;
+  auto* queue = &queues_[c];
+  while (!queue->empty() && used < budget) {
+    Req* next_req = queue->front();
+    int64_t charged = std::min(next_req->request_bytes, budget - used);
+    next_req->request_bytes -= charged;
+    used += charged;
+    if (next_req->request_bytes > 0) {
+      break;
+    }
+    queue->pop_front();
+    --num_waiting_;
+    total_bytes_through_[c] += next_req->bytes;
+    if (next_req->pri < Env::IO_TOTAL) {
+      total_bytes_through_by_pri_[next_req->pri] += next_req->bytes;
+    }
+    RecordInHistogram(next_req->stats, kQueueingDelayHistograms[c],
+                      now_us - next_req->enqueue_us);
+
+    next_req->granted = true;
+    if (next_req != leader_) {
+      // Quota granted, signal the thread
+      next_req->cv.Signal();
+    }
+  }
+  available_bytes_ -= used;
+  return used;
+}
+
+void WeightedRateLimiter::Refill() {
+  TEST_SYNC_POINT("WeightedRateLimiter::Refill");
+  const uint64_t now = NowMicrosMonotonic();
+  next_refill_us_ = now + refill_period_us_;
+  // Carry over the left over quota from the last period
+  auto refill_bytes_per_period =
+      refill_bytes_per_period_.load(std::memory_order_relaxed);
+  if (available_bytes_ < refill_bytes_per_period) {
+    available_bytes_ += refill_bytes_per_period;
+  }
+
+  // Minimum guarantees
+  for (size_t c = 0; c < kNumClasses && available_bytes_ > 0; c++) {
+    if (min_bytes_per_period_[c] > 0) {
+      Grant(c, std::min(min_bytes_per_period_[c], available_bytes_), now);
+    }
+  }
+
+  // Classes whose oldest request has waited for longer than their max
+  // queueing delay, most overdue first
+  while (available_bytes_ > 0) {
+    size_t most_overdue = kNumClasses;
+    double max_overdue_ratio = 1.0;
+    for (size_t c = 0; c < kNumClasses; c++) {
+      if (max_queueing_delay_us_[c] <= 0 || queues_[c].empty()) {
+        continue;
+      }
+      double overdue_ratio =
+          static_cast<double>(now - queues_[c].front()->enqueue_us) /
+          static_cast<double>(max_queueing_delay_us_[c]);
+      if (overdue_ratio > max_overdue_ratio) {
+        max_overdue_ratio = overdue_ratio;
+        most_overdue = c;
+      }
+    }
+    if (most_overdue == kNumClasses) {
+      break;
+    }
+    // Only the request at the front may stay in the queue, and it waited
+    // for no longer than those granted before it
+    Grant(most_overdue, available_bytes_, now);
+    if (!queues_[most_overdue].empty()) {
+      break;
+    }
+  }
+
+  // Shares of the rest by weight. A class that does not use its share
+  // leaves it to the others in the next round.
+  while (available_bytes_ > 0) {
+    uint64_t total_weight = 0;
+    for (size_t c = 0; c < kNumClasses; c++) {
+      if (!queues_[c].empty()) {
+        total_weight += weights_[c];
+      }
+    }
+    if (total_weight == 0) {
+      break;
+    }
+    const int64_t budget = available_bytes_;
+    for (size_t c = 0; c < kNumClasses && available_bytes_ > 0; c++) {
+      if (queues_[c].empty()) {
+        continue;
+      }
+      int64_t share = static_cast<int64_t>(static_cast<double>(budget) *
+                                           weights_[c] / total_weight);
+      Grant(c, std::min(std::max<int64_t>(share, 1), available_bytes_), now);
+    }
+  }
+}
+
+int64_t WeightedRateLimiter::CalculateRefillBytesPerPeriod(
+    int64_t rate_bytes_per_sec) const {
+  if (port::kMaxInt64 / rate_bytes_per_sec < refill_period_us_) {
+    // Avoid unexpected result in the overflow case. The result now is still
+    // inaccurate but is a number that is large enough.
+    return port::kMaxInt64 / 1000000;
+  } else {
+    return std::max(kMinRefillBytesPerPeriod,
+                    rate_bytes_per_sec * refill_period_us_ / 1000000);
+  }
+}
+
+int64_t WeightedRateLimiter::GetTotalBytesThrough(
+    const Env::IOPriority pri) const {
+  MutexLock g(&request_mutex_);
+  if (pri == Env::IO_TOTAL) {
+    int64_t total = 0;
+    for (size_t c = 0; c < kNumClasses; c++) {
+      total += total_bytes_through_[c];
+    }
+    return total;
+  }
+  return total_bytes_through_by_pri_[pri];
+}
+
+int64_t WeightedRateLimiter::GetTotalRequests(
+    const Env::IOPriority pri) const {
+  MutexLock g(&request_mutex_);
+  if (pri == Env::IO_TOTAL) {
+    int64_t total = 0;
+    for (size_t c = 0; c < kNumClasses; c++) {
+      total += total_requests_[c];
+    }
+    return total;
+  }
+  return total_requests_by_pri_[pri];
+}
+
+int64_t WeightedRateLimiter::GetTotalBytesThroughClass(
+    IOClass io_class) const {
+  MutexLock g(&request_mutex_);
+  return total_bytes_through_[static_cast<size_t>(io_class)];
+}
+
+RateLimiter* NewWeightedRateLimiter(
+    const WeightedRateLimiterOptions& options) {
+  assert(options.rate_bytes_per_sec > 0);
+  assert(options.refill_period_us > 0);
+  return new WeightedRateLimiter(options, Env::Default());
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,114 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include "port/port.h"
+#include "rocksdb/env.h"
+#include "rocksdb/rate_limiter.h"
+#include "util/mutexlock.h"
+
+namespace rocksdb {
+
+// Shares one bytes-per-second budget between the classes of I/O, see
+// NewWeightedRateLimiter().
+//
+// Like GenericRateLimiter, the budget is refilled once per refill period by
+// the waiting request elected as leader, and requests larger than what is
+// left are charged across periods. A refill first grants each waiting class
+// its minimum bytes per period, then the classes whose oldest request has
+// waited for longer than their max queueing delay, most overdue first, and
+// finally shares the rest between the waiting classes by weight. Requests
+// only take the fast path, without waiting for a refill, while no request
+// waits.
+class WeightedRateLimiter : public RateLimiter {
+ public:
+  WeightedRateLimiter(const WeightedRateLimiterOptions& options, Env* env);
+
+  virtual ~WeightedRateLimiter();
+
+  virtual void SetBytesPerSecond(int64_t bytes_per_second) override;
+
+  // Requests that do not tell their class are classified by priority:
+  // IO_HIGH as kFlush, others as kCompaction.
+  using RateLimiter::Request;
+  virtual void Request(const int64_t bytes, const Env::IOPriority pri,
+                       Statistics* stats) override;
+
+  virtual void Request(const int64_t bytes, const Env::IOPriority pri,
+                       Statistics* stats, OpType op_type,
+                       IOClass io_class) override;
+
+  using RateLimiter::IsRateLimited;
+  virtual bool IsRateLimited(OpType op_type, IOClass io_class) override;
+
+  virtual int64_t GetSingleBurstBytes() const override {
+    return refill_bytes_per_period_.load(std::memory_order_relaxed);
+  }
+
+  virtual int64_t GetTotalBytesThrough(
+      const Env::IOPriority pri = Env::IO_TOTAL) const override;
+
+  virtual int64_t GetTotalRequests(
+      const Env::IOPriority pri = Env::IO_TOTAL) const override;
+
+  virtual int64_t GetBytesPerSecond() const override {
+    return rate_bytes_per_sec_.load(std::memory_order_relaxed);
+  }
+
+  int64_t GetTotalBytesThroughClass(IOClass io_class) const;
+
+ private:
+  static const size_t kNumClasses =
+      static_cast<size_t>(IOClass::kNumIOClasses);
+
+  struct Req;
+
+  // Grants the requests of class c in queue order using up to budget
+  // bytes, charging the first request that does not fit with the rest of
+  // the budget. Returns the bytes used. REQUIRED: request_mutex_ is held.
+  int64_t Grant(size_t c, int64_t budget, uint64_t now_us);
+  // REQUIRED: request_mutex_ is held.
+  void Refill();
+  int64_t CalculateRefillBytesPerPeriod(int64_t rate_bytes_per_sec) const;
+
+  uint64_t NowMicrosMonotonic() const {
+    return env_->NowNanos() / std::milli::den;
+  }
+
+  // This mutex guard all internal states
+  mutable port::Mutex request_mutex_;
+
+  const int64_t kMinRefillBytesPerPeriod = 100;
+
+  const int64_t refill_period_us_;
+  std::atomic<int64_t> rate_bytes_per_sec_;
+  std::atomic<int64_t> refill_bytes_per_period_;
+  Env* const env_;
+
+  uint32_t weights_[kNumClasses];
+  int64_t min_bytes_per_period_[kNumClasses];
+  int64_t max_queueing_delay_us_[kNumClasses];
+
+  bool stop_;
+  port::CondVar exit_cv_;
+  int32_t requests_to_wait_;
+
+  int64_t total_requests_[kNumClasses];
+  int64_t total_bytes_through_[kNumClasses];
+  int64_t total_requests_by_pri_[Env::IO_TOTAL];
+  int64_t total_bytes_through_by_pri_[Env::IO_TOTAL];
+  int64_t available_bytes_;
+  uint64_t next_refill_us_;
+
+  Req* leader_;
+  size_t num_waiting_;
+  std::deque<Req*> queues_[kNumClasses];
+};
+
+}  // namespace rocksdb
@@ -1337,7 +1337,8 @@ Status BackupEngineImpl::CopyOrCreateFile(
     s = dest_writer->Append(data);
     if (rate_limiter != nullptr) {
       rate_limiter->Request(data.size(), Env::IO_LOW, nullptr /* stats */,
-                            RateLimiter::OpType::kWrite);
+                            RateLimiter::OpType::kWrite,
+                            RateLimiter::IOClass::kBackup);
     }
     if (processed_buffer_size > options_.callback_trigger_interval_size) {
       processed_buffer_size -= options_.callback_trigger_interval_size;
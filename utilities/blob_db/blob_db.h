@@ -204,6 +204,16 @@ class BlobDB : public StackableDB {
     return NewIterator(options);
   }
 
+  // Scans through NewIterator() above, which resolves blob indexes, rather
+  // than through the base DB's scan cache.
+  using rocksdb::StackableDB::Scan;
+  virtual Status Scan(
+      const ReadOptions& options, ColumnFamilyHandle* column_family,
+      const Slice& start, size_t limit, std::vector<std::string>* keys,
+      std::vector<std::string>* values) override {
+    return DB::Scan(options, column_family, start, limit, keys, values);
+  }
+
   Status CompactFiles(
       const CompactionOptions& compact_options,
       const std::vector<std::string>& input_file_names, const int output_level,
@@ -95,6 +95,8 @@ BlobDBImpl::BlobDBImpl(const std::string& dbname,
                   ? dbname + "/" + bdb_options_.blob_dir
                   : bdb_options_.blob_dir;
   env_options_.bytes_per_sync = blob_db_options.bytes_per_sync;
+  // Blob files are read while they are written
+  env_options_.max_async_writes_per_file = 0;
 }
 
 BlobDBImpl::~BlobDBImpl() {
@@ -1656,15 +1658,8 @@ bool BlobDBImpl::VisibleToActiveSnapshot(
   // [earliest_sequence, obsolete_sequence). But doing so will make the
   // implementation more complicated.
   SequenceNumber obsolete_sequence = bfile->GetObsoleteSequence();
-  SequenceNumber oldest_snapshot = kMaxSequenceNumber;
-  {
-    // Need to lock DBImpl mutex before access snapshot list.
-    InstrumentedMutexLock l(db_impl_->mutex());
-    auto& snapshots = db_impl_->snapshots();
-    if (!snapshots.empty()) {
-      oldest_snapshot = snapshots.oldest()->GetSequenceNumber();
-    }
-  }
+  SequenceNumber oldest_snapshot =
+      db_impl_->snapshots().GetOldest(kMaxSequenceNumber);
   bool visible = oldest_snapshot < obsolete_sequence;
   if (visible) {
     ROCKS_LOG_INFO(db_options_.info_log,
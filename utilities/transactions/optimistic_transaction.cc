@@ -7,6 +7,7 @@
 
 #include "utilities/transactions/optimistic_transaction.h"
 
+#include <set>
 #include <string>
 
 #include "db/column_family.h"
@@ -16,7 +17,9 @@
 #include "rocksdb/status.h"
 #include "rocksdb/utilities/optimistic_transaction_db.h"
 #include "util/cast_util.h"
+#include "util/hash.h"
 #include "util/string_util.h"
+#include "utilities/transactions/optimistic_transaction_db_impl.h"
 #include "utilities/transactions/transaction_util.h"
 
 namespace rocksdb {
@@ -54,6 +57,17 @@ Status OptimisticTransaction::Prepare() {
 }
 
 Status OptimisticTransaction::Commit() {
+  auto txn_db_impl = static_cast_with_check<OptimisticTransactionDBImpl,
+                                            OptimisticTransactionDB>(txn_db_);
+  assert(txn_db_impl);
+  if (txn_db_impl->GetValidatePolicy() ==
+      OccValidationPolicy::kValidateParallel) {
+    return CommitWithParallelValidate();
+  }
+  return CommitWithSerialValidate();
+}
+
+Status OptimisticTransaction::CommitWithSerialValidate() {
   // Set up callback which will call CheckTransactionForConflicts() to
   // check whether this transaction is safe to be committed.
   OptimisticTransactionCallback callback(this);
@@ -70,6 +84,44 @@ Status OptimisticTransaction::Commit() {
   return s;
 }
 
+Status OptimisticTransaction::CommitWithParallelValidate() {
+  auto txn_db_impl = static_cast_with_check<OptimisticTransactionDBImpl,
+                                            OptimisticTransactionDB>(txn_db_);
+  assert(txn_db_impl);
+  DBImpl* db_impl = static_cast_with_check<DBImpl, DB>(db_->GetRootDB());
+  assert(db_impl);
+
+  const size_t space = txn_db_impl->GetLockBucketsSize();
+  std::set<size_t> lk_idxes;
+  for (const auto& cf_keys : GetTrackedKeys()) {
+    for (const auto& key_info : cf_keys.second) {
+      lk_idxes.insert(fastrange64(GetSliceNPHash64(key_info.first), space));
+    }
+  }
+  // All transactions take their bucket locks in ascending order, so that
+  // they cannot deadlock. The locks are held until the write is done: a
+  // transaction validated concurrently on the same bucket would otherwise
+  // miss this write.
+  std::vector<std::unique_lock<std::mutex>> lks;
+  lks.reserve(lk_idxes.size());
+  for (size_t idx : lk_idxes) {
+    lks.emplace_back(txn_db_impl->LockBucket(idx));
+  }
+
+  Status s = TransactionUtil::CheckKeysForConflicts(db_impl, GetTrackedKeys(),
+                                                    true /* cache_only */);
+  if (!s.ok()) {
+    return s;
+  }
+
+  s = db_impl->Write(write_options_, GetWriteBatch()->GetWriteBatch());
+  if (s.ok()) {
+    Clear();
+  }
+
+  return s;
+}
+
 Status OptimisticTransaction::Rollback() {
   Clear();
   return Status::OK();
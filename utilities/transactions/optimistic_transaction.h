@@ -55,7 +55,7 @@ class OptimisticTransaction : public TransactionBaseImpl {
                  const bool assume_tracked = false) override;
 
  private:
-  ROCKSDB_FIELD_UNUSED OptimisticTransactionDB* const txn_db_;
+  OptimisticTransactionDB* const txn_db_;
 
   friend class OptimisticTransactionCallback;
 
@@ -68,6 +68,14 @@ class OptimisticTransaction : public TransactionBaseImpl {
   // Should only be called on writer thread.
   Status CheckTransactionForConflicts(DB* db);
 
+  // Validates the transaction on the write thread, see
+  // OccValidationPolicy::kValidateSerial.
+  Status CommitWithSerialValidate();
+
+  // Validates the transaction before entering the write group, holding the
+  // lock buckets of its keys, see OccValidationPolicy::kValidateParallel.
+  Status CommitWithParallelValidate();
+
   void Clear() override;
 
   void UnlockGetForUpdate(ColumnFamilyHandle* /* unused */,
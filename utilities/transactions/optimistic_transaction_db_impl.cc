@@ -14,6 +14,7 @@
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
 #include "rocksdb/utilities/optimistic_transaction_db.h"
+#include "util/cast_util.h"
 #include "utilities/transactions/optimistic_transaction.h"
 
 namespace rocksdb {
@@ -54,16 +55,30 @@ Status OptimisticTransactionDB::Open(
     const std::vector<ColumnFamilyDescriptor>& column_families,
     std::vector<ColumnFamilyHandle*>* handles,
     OptimisticTransactionDB** dbptr) {
+  return OptimisticTransactionDB::Open(db_options,
+                                       OptimisticTransactionDBOptions(), dbname,
+                                       column_families, handles, dbptr);
+}
+
+Status OptimisticTransactionDB::Open(
+    const DBOptions& db_options,
+    const OptimisticTransactionDBOptions& occ_options,
+    const std::string& dbname,
+    const std::vector<ColumnFamilyDescriptor>& column_families,
+    std::vector<ColumnFamilyHandle*>* handles,
+    OptimisticTransactionDB** dbptr) {
   Status s;
   DB* db;
 
   std::vector<ColumnFamilyDescriptor> column_families_copy = column_families;
 
-  // Enable MemTable History if not already enabled
+  // Enable MemTable History if not already enabled, unless conflicts are
+  // checked against the latest write sequence numbers of the keys
   for (auto& column_family : column_families_copy) {
     ColumnFamilyOptions* options = &column_family.options;
 
-    if (options->max_write_buffer_size_to_maintain == 0 &&
+    if (occ_options.occ_write_seq_buckets == 0 &&
+        options->max_write_buffer_size_to_maintain == 0 &&
         options->max_write_buffer_number_to_maintain == 0) {
       // Setting to -1 will set the History size to
       // max_write_buffer_number * write_buffer_size.
@@ -74,7 +89,11 @@ Status OptimisticTransactionDB::Open(
   s = DB::Open(db_options, dbname, column_families_copy, handles, &db);
 
   if (s.ok()) {
-    *dbptr = new OptimisticTransactionDBImpl(db);
+    if (occ_options.occ_write_seq_buckets > 0) {
+      static_cast_with_check<DBImpl, DB>(db->GetRootDB())
+          ->EnableWriteSeqTable(occ_options.occ_write_seq_buckets);
+    }
+    *dbptr = new OptimisticTransactionDBImpl(db, occ_options);
   }
 
   return s;
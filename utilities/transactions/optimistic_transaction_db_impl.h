@@ -6,6 +6,9 @@
 #pragma once
 #ifndef ROCKSDB_LITE
 
+#include <mutex>
+#include <vector>
+
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
 #include "rocksdb/utilities/optimistic_transaction_db.h"
@@ -14,8 +17,17 @@ namespace rocksdb {
 
 class OptimisticTransactionDBImpl : public OptimisticTransactionDB {
  public:
-  explicit OptimisticTransactionDBImpl(DB* db, bool take_ownership = true)
-      : OptimisticTransactionDB(db), db_owner_(take_ownership) {}
+  explicit OptimisticTransactionDBImpl(
+      DB* db, const OptimisticTransactionDBOptions& occ_options,
+      bool take_ownership = true)
+      : OptimisticTransactionDB(db),
+        db_owner_(take_ownership),
+        validate_policy_(occ_options.validate_policy) {
+    if (validate_policy_ == OccValidationPolicy::kValidateParallel) {
+      bucketed_locks_ = std::vector<std::mutex>(
+          occ_options.occ_lock_buckets > 0 ? occ_options.occ_lock_buckets : 1);
+    }
+  }
 
   ~OptimisticTransactionDBImpl() {
     // Prevent this stackable from destroying
@@ -29,10 +41,26 @@ class OptimisticTransactionDBImpl : public OptimisticTransactionDB {
                                 const OptimisticTransactionOptions& txn_options,
                                 Transaction* old_txn) override;
 
+  OccValidationPolicy GetValidatePolicy() const { return validate_policy_; }
+
+  size_t GetLockBucketsSize() const { return bucketed_locks_.size(); }
+
+  // REQUIRES: validate policy is kValidateParallel
+  std::unique_lock<std::mutex> LockBucket(size_t idx) {
+    assert(idx < bucketed_locks_.size());
+    return std::unique_lock<std::mutex>(bucketed_locks_[idx]);
+  }
+
  private:
 
    bool db_owner_;
 
+  const OccValidationPolicy validate_policy_;
+
+  // Only allocated with kValidateParallel. Transactions lock the buckets of
+  // their keys in ascending order so that they cannot deadlock.
+  std::vector<std::mutex> bucketed_locks_;
+
   void ReinitializeTransaction(Transaction* txn,
                                const WriteOptions& write_options,
                                const OptimisticTransactionOptions& txn_options =
@@ -92,6 +92,7 @@ void PessimisticTransaction::Initialize(const TransactionOptions& txn_options) {
 
 PessimisticTransaction::~PessimisticTransaction() {
   txn_db_impl_->UnLock(this, &GetTrackedKeys());
+  UnLockRanges();
   if (expiration_time_ > 0) {
     txn_db_impl_->RemoveExpirableTransaction(txn_id_);
   }
@@ -102,6 +103,7 @@ PessimisticTransaction::~PessimisticTransaction() {
 
 void PessimisticTransaction::Clear() {
   txn_db_impl_->UnLock(this, &GetTrackedKeys());
+  UnLockRanges();
   TransactionBaseImpl::Clear();
 }
 
@@ -698,6 +700,30 @@ void PessimisticTransaction::UnlockGetForUpdate(
   txn_db_impl_->UnLock(this, GetColumnFamilyID(column_family), key.ToString());
 }
 
+Status PessimisticTransaction::GetRangeLock(ColumnFamilyHandle* column_family,
+                                            const Slice& start,
+                                            const Slice& end) {
+  if (UNLIKELY(skip_concurrency_control_)) {
+    return Status::OK();
+  }
+  uint32_t cfh_id = GetColumnFamilyID(column_family);
+  std::string start_str = start.ToString();
+  std::string end_str = end.ToString();
+  Status s = txn_db_impl_->TryRangeLock(this, cfh_id, start_str, end_str);
+  if (s.ok()) {
+    tracked_ranges_[cfh_id].emplace_back(std::move(start_str),
+                                         std::move(end_str));
+  }
+  return s;
+}
+
+void PessimisticTransaction::UnLockRanges() {
+  if (!tracked_ranges_.empty()) {
+    txn_db_impl_->UnLockRanges(this, tracked_ranges_);
+    tracked_ranges_.clear();
+  }
+}
+
 Status PessimisticTransaction::SetName(const TransactionName& name) {
   Status s;
   if (txn_state_ == STARTED) {
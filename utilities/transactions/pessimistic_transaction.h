@@ -116,6 +116,9 @@ class PessimisticTransaction : public TransactionBaseImpl {
 
   int64_t GetDeadlockDetectDepth() const { return deadlock_detect_depth_; }
 
+  Status GetRangeLock(ColumnFamilyHandle* column_family, const Slice& start,
+                      const Slice& end) override;
+
  protected:
   // Refer to
   // TransactionOptions::use_only_the_last_commit_time_batch_for_recovery
@@ -144,6 +147,9 @@ class PessimisticTransaction : public TransactionBaseImpl {
 
   void Clear() override;
 
+  // Releases the range locks of this transaction.
+  void UnLockRanges();
+
   PessimisticTransactionDB* txn_db_impl_;
   DBImpl* db_impl_;
 
@@ -190,6 +196,10 @@ class PessimisticTransaction : public TransactionBaseImpl {
   // Refer to TransactionOptions::skip_concurrency_control
   bool skip_concurrency_control_;
 
+  // Ranges locked by GetRangeLock(), which are held until the transaction
+  // commits or rolls back.
+  TransactionRangeMap tracked_ranges_;
+
   virtual Status ValidateSnapshot(ColumnFamilyHandle* column_family,
                                   const Slice& key,
                                   SequenceNumber* tracked_at_seq);
@@ -20,23 +20,43 @@
 #include "util/cast_util.h"
 #include "util/mutexlock.h"
 #include "utilities/transactions/pessimistic_transaction.h"
+#include "utilities/transactions/read_only_txn.h"
+#include "utilities/transactions/scalable_lock_mgr.h"
 #include "utilities/transactions/transaction_db_mutex_impl.h"
 #include "utilities/transactions/write_prepared_txn_db.h"
 #include "utilities/transactions/write_unprepared_txn_db.h"
 
 namespace rocksdb {
 
+namespace {
+BaseLockMgr* NewLockMgr(TransactionDB* txn_db,
+                        const TransactionDBOptions& txn_db_options) {
+  if (txn_db_options.lock_manager ==
+      TxnDBLockManager::SCALABLE_LOCK_MANAGER) {
+    return new ScalableLockMgr(txn_db, txn_db_options.max_num_locks,
+                               txn_db_options.max_num_deadlocks);
+  }
+  return new TransactionLockMgr(
+      txn_db, txn_db_options.num_stripes, txn_db_options.max_num_locks,
+      txn_db_options.max_num_deadlocks,
+      txn_db_options.custom_mutex_factory
+          ? txn_db_options.custom_mutex_factory
+          : std::shared_ptr<TransactionDBMutexFactory>(
+                new TransactionDBMutexFactoryImpl()));
+}
+
+// How often the views of read-only transactions are checked for expired
+// leases.
+const uint64_t kReadOnlyTxnLeaseCheckPeriodMicros = 100 * 1000;
+}  // anonymous namespace
+
 PessimisticTransactionDB::PessimisticTransactionDB(
     DB* db, const TransactionDBOptions& txn_db_options)
     : TransactionDB(db),
       db_impl_(static_cast_with_check<DBImpl, DB>(db)),
       txn_db_options_(txn_db_options),
-      lock_mgr_(this, txn_db_options_.num_stripes, txn_db_options.max_num_locks,
-                txn_db_options_.max_num_deadlocks,
-                txn_db_options_.custom_mutex_factory
-                    ? txn_db_options_.custom_mutex_factory
-                    : std::shared_ptr<TransactionDBMutexFactory>(
-                          new TransactionDBMutexFactoryImpl())) {
+      lock_mgr_(NewLockMgr(this, txn_db_options_)),
+      range_lock_mgr_(lock_mgr_.get()) {
   assert(db_impl_ != nullptr);
   info_log_ = db_impl_->GetDBOptions().info_log;
 }
@@ -62,16 +82,15 @@ PessimisticTransactionDB::PessimisticTransactionDB(
     : TransactionDB(db),
       db_impl_(static_cast_with_check<DBImpl, DB>(db->GetRootDB())),
       txn_db_options_(txn_db_options),
-      lock_mgr_(this, txn_db_options_.num_stripes, txn_db_options.max_num_locks,
-                txn_db_options_.max_num_deadlocks,
-                txn_db_options_.custom_mutex_factory
-                    ? txn_db_options_.custom_mutex_factory
-                    : std::shared_ptr<TransactionDBMutexFactory>(
-                          new TransactionDBMutexFactoryImpl())) {
+      lock_mgr_(NewLockMgr(this, txn_db_options_)),
+      range_lock_mgr_(lock_mgr_.get()) {
   assert(db_impl_ != nullptr);
 }
 
 PessimisticTransactionDB::~PessimisticTransactionDB() {
+  if (read_only_txn_lease_thread_ != nullptr) {
+    read_only_txn_lease_thread_->cancel();
+  }
   while (!transactions_.empty()) {
     delete transactions_.begin()->second;
     // TODO(myabandeh): this seems to be an unsafe approach as it is not quite
@@ -178,6 +197,13 @@ Transaction* WriteCommittedTxnDB::BeginTransaction(
   }
 }
 
+ReadOnlyTransaction* WriteCommittedTxnDB::BeginReadOnlyTransaction(
+    const ReadOnlyTransactionOptions& txn_options,
+    const std::vector<ColumnFamilyHandle*>& column_families) {
+  return new ReadOnlyTxn(this, db_impl_, nullptr, txn_options,
+                         column_families);
+}
+
 TransactionDBOptions PessimisticTransactionDB::ValidateTxnDBOptions(
     const TransactionDBOptions& txn_db_options) {
   TransactionDBOptions validated = txn_db_options;
@@ -355,11 +381,12 @@ Status TransactionDB::WrapStackableDB(
   return s;
 }
 
-// Let TransactionLockMgr know that this column family exists so it can
+// Let the lock manager know that this column family exists so it can
 // allocate a LockMap for it.
 void PessimisticTransactionDB::AddColumnFamily(
     const ColumnFamilyHandle* handle) {
-  lock_mgr_.AddColumnFamily(handle->GetID());
+  lock_mgr_->AddColumnFamily(handle->GetID());
+  range_lock_mgr_.AddColumnFamily(handle->GetID(), handle->GetComparator());
 }
 
 Status PessimisticTransactionDB::CreateColumnFamily(
@@ -373,14 +400,16 @@ Status PessimisticTransactionDB::CreateColumnFamily(
 
   s = db_->CreateColumnFamily(options, column_family_name, handle);
   if (s.ok()) {
-    lock_mgr_.AddColumnFamily((*handle)->GetID());
+    lock_mgr_->AddColumnFamily((*handle)->GetID());
+    range_lock_mgr_.AddColumnFamily((*handle)->GetID(),
+                                    (*handle)->GetComparator());
     UpdateCFComparatorMap(*handle);
   }
 
   return s;
 }
 
-// Let TransactionLockMgr know that it can deallocate the LockMap for this
+// Let the lock manager know that it can deallocate the LockMap for this
 // column family.
 Status PessimisticTransactionDB::DropColumnFamily(
     ColumnFamilyHandle* column_family) {
@@ -388,7 +417,8 @@ Status PessimisticTransactionDB::DropColumnFamily(
 
   Status s = db_->DropColumnFamily(column_family);
   if (s.ok()) {
-    lock_mgr_.RemoveColumnFamily(column_family->GetID());
+    lock_mgr_->RemoveColumnFamily(column_family->GetID());
+    range_lock_mgr_.RemoveColumnFamily(column_family->GetID());
   }
 
   return s;
@@ -398,17 +428,49 @@ Status PessimisticTransactionDB::TryLock(PessimisticTransaction* txn,
                                          uint32_t cfh_id,
                                          const std::string& key,
                                          bool exclusive) {
-  return lock_mgr_.TryLock(txn, cfh_id, key, GetEnv(), exclusive);
+  // Waiting for ranges and for the point lock share the lock timeout. Its
+  // deadline is only computed once ranges have to be checked.
+  int64_t timeout = txn->GetLockTimeout();
+  uint64_t end_time = 0;
+  while (true) {
+    Status s = range_lock_mgr_.WaitForRanges(txn, cfh_id, key, GetEnv(),
+                                             &timeout, &end_time);
+    if (!s.ok()) {
+      return s;
+    }
+    s = lock_mgr_->TryLock(txn, cfh_id, key, GetEnv(), exclusive, timeout);
+    if (!s.ok() || range_lock_mgr_.MayKeepPointLock(txn, cfh_id, key)) {
+      return s;
+    }
+    // A range covering the key was locked in the meantime
+    UnLock(txn, cfh_id, key);
+  }
 }
 
 void PessimisticTransactionDB::UnLock(PessimisticTransaction* txn,
                                       const TransactionKeyMap* keys) {
-  lock_mgr_.UnLock(txn, keys, GetEnv());
+  lock_mgr_->UnLock(txn, keys, GetEnv());
+  for (const auto& cf_iter : *keys) {
+    range_lock_mgr_.OnPointLocksReleased(cf_iter.first);
+  }
 }
 
 void PessimisticTransactionDB::UnLock(PessimisticTransaction* txn,
                                       uint32_t cfh_id, const std::string& key) {
-  lock_mgr_.UnLock(txn, cfh_id, key, GetEnv());
+  lock_mgr_->UnLock(txn, cfh_id, key, GetEnv());
+  range_lock_mgr_.OnPointLocksReleased(cfh_id);
+}
+
+Status PessimisticTransactionDB::TryRangeLock(PessimisticTransaction* txn,
+                                              uint32_t cfh_id,
+                                              const std::string& start,
+                                              const std::string& end) {
+  return range_lock_mgr_.TryLock(txn, cfh_id, start, end, GetEnv());
+}
+
+void PessimisticTransactionDB::UnLockRanges(PessimisticTransaction* txn,
+                                            const TransactionRangeMap& ranges) {
+  range_lock_mgr_.UnLock(txn, ranges);
 }
 
 // Used when wrapping DB write operations in a transaction
@@ -598,17 +660,17 @@ void PessimisticTransactionDB::GetAllPreparedTransactions(
   }
 }
 
-TransactionLockMgr::LockStatusData
+BaseLockMgr::LockStatusData
 PessimisticTransactionDB::GetLockStatusData() {
-  return lock_mgr_.GetLockStatusData();
+  return lock_mgr_->GetLockStatusData();
 }
 
 std::vector<DeadlockPath> PessimisticTransactionDB::GetDeadlockInfoBuffer() {
-  return lock_mgr_.GetDeadlockInfoBuffer();
+  return lock_mgr_->GetDeadlockInfoBuffer();
 }
 
 void PessimisticTransactionDB::SetDeadlockInfoBufferSize(uint32_t target_size) {
-  lock_mgr_.Resize(target_size);
+  lock_mgr_->Resize(target_size);
 }
 
 void PessimisticTransactionDB::RegisterTransaction(Transaction* txn) {
@@ -628,5 +690,32 @@ void PessimisticTransactionDB::UnregisterTransaction(Transaction* txn) {
   transactions_.erase(it);
 }
 
+void PessimisticTransactionDB::RegisterReadOnlyTxn(ReadOnlyTxn* txn) {
+  assert(txn);
+  std::lock_guard<std::mutex> lock(read_only_txns_mutex_);
+  read_only_txns_.insert(txn);
+  if (read_only_txn_lease_thread_ == nullptr) {
+    read_only_txn_lease_thread_.reset(new RepeatableThread(
+        [this]() { ReleaseExpiredReadOnlyTxns(); }, "lease",
+        db_impl_->GetEnv(), kReadOnlyTxnLeaseCheckPeriodMicros));
+  }
+}
+
+void PessimisticTransactionDB::UnregisterReadOnlyTxn(ReadOnlyTxn* txn) {
+  assert(txn);
+  std::lock_guard<std::mutex> lock(read_only_txns_mutex_);
+  read_only_txns_.erase(txn);
+}
+
+void PessimisticTransactionDB::ReleaseExpiredReadOnlyTxns() {
+  uint64_t now_micros = db_impl_->GetEnv()->NowMicros();
+  TEST_SYNC_POINT_CALLBACK(
+      "PessimisticTransactionDB::ReleaseExpiredReadOnlyTxns:Now", &now_micros);
+  std::lock_guard<std::mutex> lock(read_only_txns_mutex_);
+  for (auto txn : read_only_txns_) {
+    txn->ReleaseIfExpired(now_micros);
+  }
+}
+
 }  //  namespace rocksdb
 #endif  // ROCKSDB_LITE
@@ -11,6 +11,7 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "db/db_iter.h"
@@ -20,12 +21,16 @@
 #include "rocksdb/options.h"
 #include "rocksdb/utilities/transaction_db.h"
 #include "util/cast_util.h"
+#include "util/repeatable_thread.h"
 #include "utilities/transactions/pessimistic_transaction.h"
+#include "utilities/transactions/range_lock_mgr.h"
 #include "utilities/transactions/transaction_lock_mgr.h"
 #include "utilities/transactions/write_prepared_txn.h"
 
 namespace rocksdb {
 
+class ReadOnlyTxn;
+
 class PessimisticTransactionDB : public TransactionDB {
  public:
   explicit PessimisticTransactionDB(DB* db,
@@ -104,6 +109,11 @@ class PessimisticTransactionDB : public TransactionDB {
   void UnLock(PessimisticTransaction* txn, uint32_t cfh_id,
               const std::string& key);
 
+  Status TryRangeLock(PessimisticTransaction* txn, uint32_t cfh_id,
+                      const std::string& start, const std::string& end);
+  void UnLockRanges(PessimisticTransaction* txn,
+                    const TransactionRangeMap& ranges);
+
   void AddColumnFamily(const ColumnFamilyHandle* handle);
 
   static TransactionDBOptions ValidateTxnDBOptions(
@@ -128,10 +138,16 @@ class PessimisticTransactionDB : public TransactionDB {
   void RegisterTransaction(Transaction* txn);
   void UnregisterTransaction(Transaction* txn);
 
+  // Read-only transactions with a lease register themselves, so that their
+  // SuperVersions are released once the lease has expired even if they are
+  // not read from again.
+  void RegisterReadOnlyTxn(ReadOnlyTxn* txn);
+  void UnregisterReadOnlyTxn(ReadOnlyTxn* txn);
+
   // not thread safe. current use case is during recovery (single thread)
   void GetAllPreparedTransactions(std::vector<Transaction*>* trans) override;
 
-  TransactionLockMgr::LockStatusData GetLockStatusData() override;
+  BaseLockMgr::LockStatusData GetLockStatusData() override;
 
   std::vector<DeadlockPath> GetDeadlockInfoBuffer() override;
   void SetDeadlockInfoBufferSize(uint32_t target_size) override;
@@ -166,7 +182,8 @@ class PessimisticTransactionDB : public TransactionDB {
   friend class TransactionTest_TwoPhaseOutOfOrderDelete_Test;
   friend class WriteUnpreparedTransactionTest_RecoveryTest_Test;
   friend class WriteUnpreparedTransactionTest_MarkLogWithPrepSection_Test;
-  TransactionLockMgr lock_mgr_;
+  std::unique_ptr<BaseLockMgr> lock_mgr_;
+  RangeLockMgr range_lock_mgr_;
 
   // Must be held when adding/dropping column families.
   InstrumentedMutex column_family_mutex_;
@@ -183,6 +200,15 @@ class PessimisticTransactionDB : public TransactionDB {
   std::mutex name_map_mutex_;
   std::unordered_map<TransactionName, Transaction*> transactions_;
 
+  // Releases the SuperVersions of the read-only transactions whose lease has
+  // expired. Runs on read_only_txn_lease_thread_, which is started with the
+  // first read-only transaction that has a lease.
+  void ReleaseExpiredReadOnlyTxns();
+
+  std::mutex read_only_txns_mutex_;
+  std::unordered_set<ReadOnlyTxn*> read_only_txns_;
+  std::unique_ptr<RepeatableThread> read_only_txn_lease_thread_;
+
   // Signal that we are testing a crash scenario. Some asserts could be relaxed
   // in such cases.
   virtual void TEST_Crash() {}
@@ -206,6 +232,10 @@ class WriteCommittedTxnDB : public PessimisticTransactionDB {
                                 const TransactionOptions& txn_options,
                                 Transaction* old_txn) override;
 
+  ReadOnlyTransaction* BeginReadOnlyTransaction(
+      const ReadOnlyTransactionOptions& txn_options,
+      const std::vector<ColumnFamilyHandle*>& column_families) override;
+
   // Optimized version of ::Write that makes use of skip_concurrency_control
   // hint
   using TransactionDB::Write;
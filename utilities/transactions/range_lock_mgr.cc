@@ -0,0 +1,575 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef ROCKSDB_LITE
+
+#include "utilities/transactions/range_lock_mgr.h"
+
+#include <cinttypes>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "monitoring/perf_context_imp.h"
+#include "test_util/sync_point.h"
+#include "utilities/transactions/pessimistic_transaction.h"
+
+namespace rocksdb {
+
+struct RangeLockTable {
+  struct KeyLess {
+    explicit KeyLess(const Comparator* _cmp) : cmp(_cmp) {}
+    bool operator()(const std::string& a, const std::string& b) const {
+      return cmp->Compare(a, b) < 0;
+    }
+    const Comparator* cmp;
+  };
+
+  struct Range {
+    Range(const std::string& _end, TransactionID _txn_id,
+          uint64_t _expiration_time)
+        : end(_end), txn_id(_txn_id), expiration_time(_expiration_time) {}
+
+    std::string end;
+    TransactionID txn_id;
+    uint64_t expiration_time;
+    // Transactions holding point locks in the range. Empty once the range has
+    // been granted.
+    autovector<TransactionID> waiting_for;
+    // False until the point locks in the range have been looked up once.
+    // Until then, point lock requests wait for the range without taking part
+    // in deadlock detection, since they may turn out to be holders that can
+    // bypass it.
+    bool scanned = false;
+  };
+
+  // Ranges keyed by their start key. They never overlap each other.
+  using RangeMap = std::map<std::string, Range, KeyLess>;
+
+  explicit RangeLockTable(const Comparator* _cmp)
+      : cmp(_cmp), ranges(KeyLess(_cmp)) {}
+
+  // Sets *overlapping to the ranges that overlap [start, end], from the last
+  // one to the first one.
+  void GetOverlapping(const std::string& start, const std::string& end,
+                      autovector<RangeMap::iterator>* overlapping) {
+    overlapping->clear();
+    // Since the ranges are disjoint, their ends are sorted like their starts.
+    auto it = ranges.upper_bound(end);
+    while (it != ranges.begin()) {
+      --it;
+      if (cmp->Compare(it->second.end, start) < 0) {
+        break;
+      }
+      overlapping->push_back(it);
+    }
+  }
+
+  const Comparator* cmp;
+  // Protects ranges and point_lock_releases. Waiters for a range wait on cv.
+  std::mutex mutex;
+  std::condition_variable cv;
+  RangeMap ranges;
+  // Number of times point locks of the column family were released while
+  // range requests waited for them.
+  uint64_t point_lock_releases = 0;
+};
+
+namespace {
+void UnrefRangeLockTablesCache(void* ptr) {
+  // Called when a thread exits or a ThreadLocalPtr gets destroyed.
+  auto range_lock_tables_cache = static_cast<
+      std::unordered_map<uint32_t, std::shared_ptr<RangeLockTable>>*>(ptr);
+  delete range_lock_tables_cache;
+}
+
+bool Contains(const autovector<TransactionID>& ids, TransactionID id) {
+  return std::find(ids.begin(), ids.end(), id) != ids.end();
+}
+}  // anonymous namespace
+
+RangeLockMgr::RangeLockMgr(BaseLockMgr* point_lock_mgr)
+    : point_lock_mgr_(point_lock_mgr),
+      num_ranges_(0),
+      num_point_waiters_(0),
+      range_lock_tables_cache_(
+          new ThreadLocalPtr(&UnrefRangeLockTablesCache)) {}
+
+RangeLockMgr::~RangeLockMgr() {}
+
+void RangeLockMgr::AddColumnFamily(uint32_t column_family_id,
+                                   const Comparator* cmp) {
+  InstrumentedMutexLock l(&range_lock_table_mutex_);
+
+  if (range_lock_tables_.find(column_family_id) == range_lock_tables_.end()) {
+    range_lock_tables_.emplace(column_family_id,
+                               std::make_shared<RangeLockTable>(cmp));
+  } else {
+    // column_family already exists in range lock tables
+    assert(false);
+  }
+}
+
+void RangeLockMgr::RemoveColumnFamily(uint32_t column_family_id) {
+  // Concurrent transactions can keep using the table until they release
+  // their references to it.
+  {
+    InstrumentedMutexLock l(&range_lock_table_mutex_);
+
+    auto range_lock_tables_iter = range_lock_tables_.find(column_family_id);
+    assert(range_lock_tables_iter != range_lock_tables_.end());
+
+    RangeLockTable* table = range_lock_tables_iter->second.get();
+    {
+      std::lock_guard<std::mutex> table_lock(table->mutex);
+      num_ranges_.fetch_sub(static_cast<int64_t>(table->ranges.size()));
+    }
+    range_lock_tables_.erase(range_lock_tables_iter);
+  }  // range_lock_table_mutex_
+
+  // Clear all thread-local caches
+  autovector<void*> local_caches;
+  range_lock_tables_cache_->Scrape(&local_caches, nullptr);
+  for (auto cache : local_caches) {
+    delete static_cast<RangeLockTables*>(cache);
+  }
+}
+
+std::shared_ptr<RangeLockTable> RangeLockMgr::GetRangeLockTable(
+    uint32_t column_family_id) {
+  // First check thread-local cache
+  if (range_lock_tables_cache_->Get() == nullptr) {
+    range_lock_tables_cache_->Reset(new RangeLockTables());
+  }
+
+  auto range_lock_tables_cache =
+      static_cast<RangeLockTables*>(range_lock_tables_cache_->Get());
+
+  auto iter = range_lock_tables_cache->find(column_family_id);
+  if (iter != range_lock_tables_cache->end()) {
+    return iter->second;
+  }
+
+  // Not found in local cache, grab mutex and check shared tables
+  InstrumentedMutexLock l(&range_lock_table_mutex_);
+
+  iter = range_lock_tables_.find(column_family_id);
+  if (iter == range_lock_tables_.end()) {
+    return std::shared_ptr<RangeLockTable>(nullptr);
+  } else {
+    // Found table.  Store in thread-local cache and return.
+    std::shared_ptr<RangeLockTable>& table = iter->second;
+    range_lock_tables_cache->insert({column_family_id, table});
+
+    return table;
+  }
+}
+
+void RangeLockMgr::FindConflicts(RangeLockTable* table,
+                                 const PessimisticTransaction* txn,
+                                 const std::string& start,
+                                 const std::string& end, bool point, Env* env,
+                                 autovector<TransactionID>* wait_ids,
+                                 uint64_t* expire_time_hint,
+                                 bool* detect_deadlock) {
+  TransactionID txn_id = txn->GetID();
+  wait_ids->clear();
+  *expire_time_hint = 0;
+  *detect_deadlock = false;
+
+  autovector<RangeLockTable::RangeMap::iterator> overlapping;
+  table->GetOverlapping(start, end, &overlapping);
+  bool stolen = false;
+  for (auto it : overlapping) {
+    const RangeLockTable::Range& range = it->second;
+    if (range.txn_id == txn_id ||
+        (point && Contains(range.waiting_for, txn_id))) {
+      continue;
+    }
+
+    autovector<TransactionID> owner;
+    owner.push_back(range.txn_id);
+    uint64_t expire_time = 0;
+    if (point_lock_mgr_->IsLockExpired(txn_id, range.expiration_time, owner,
+                                       env, &expire_time)) {
+      table->ranges.erase(it);
+      num_ranges_.fetch_sub(1);
+      stolen = true;
+      continue;
+    }
+    if (expire_time > 0 &&
+        (*expire_time_hint == 0 || expire_time < *expire_time_hint)) {
+      *expire_time_hint = expire_time;
+    }
+    if (!Contains(*wait_ids, range.txn_id)) {
+      wait_ids->push_back(range.txn_id);
+    }
+    if (!point || range.scanned) {
+      *detect_deadlock = true;
+    }
+  }
+
+  if (stolen) {
+    table->cv.notify_all();
+  }
+}
+
+Status RangeLockMgr::Wait(RangeLockTable* table,
+                          std::unique_lock<std::mutex>* lock,
+                          PessimisticTransaction* txn,
+                          uint32_t column_family_id, const std::string& key,
+                          const autovector<TransactionID>& wait_ids,
+                          int64_t timeout, uint64_t end_time,
+                          uint64_t expire_time_hint, bool detect_deadlock,
+                          Env* env, bool* timed_out) {
+  PERF_TIMER_GUARD(key_lock_wait_time);
+  PERF_COUNTER_ADD(key_lock_wait_count, 1);
+
+  // Decide how long to wait
+  int64_t cv_end_time = -1;
+  if (expire_time_hint > 0 &&
+      (timeout < 0 || (timeout > 0 && expire_time_hint < end_time))) {
+    // expiration time is sooner than our timeout
+    cv_end_time = expire_time_hint;
+  } else if (timeout >= 0) {
+    cv_end_time = end_time;
+  }
+
+  // We are dependent on other transactions to finish, so perform deadlock
+  // detection.
+  detect_deadlock = detect_deadlock && txn->IsDeadlockDetect();
+  if (detect_deadlock) {
+    if (point_lock_mgr_->IncrementWaiters(txn, wait_ids, key,
+                                          column_family_id, true /* exclusive */,
+                                          env)) {
+      return Status::Busy(Status::SubCode::kDeadlock);
+    }
+  }
+  txn->SetWaitingTxn(wait_ids, column_family_id, &key);
+
+  TEST_SYNC_POINT("RangeLockMgr::Wait:WaitingTxn");
+  if (cv_end_time < 0) {
+    // Wait indefinitely
+    table->cv.wait(*lock);
+  } else {
+    uint64_t now = env->NowMicros();
+    if (static_cast<uint64_t>(cv_end_time) > now) {
+      table->cv.wait_for(*lock, std::chrono::microseconds(cv_end_time - now));
+    }
+  }
+
+  txn->ClearWaitingTxn();
+  if (detect_deadlock) {
+    point_lock_mgr_->DecrementWaiters(txn, wait_ids);
+  }
+
+  if (timeout >= 0 && env->NowMicros() >= end_time) {
+    // Even though we timed out, the caller makes one more attempt to acquire
+    // the lock (it is possible the lock expired and we were never signaled).
+    *timed_out = true;
+  }
+  return Status::OK();
+}
+
+Status RangeLockMgr::TryLock(PessimisticTransaction* txn,
+                             uint32_t column_family_id,
+                             const std::string& start, const std::string& end,
+                             Env* env) {
+  std::shared_ptr<RangeLockTable> table_ptr =
+      GetRangeLockTable(column_family_id);
+  RangeLockTable* table = table_ptr.get();
+  if (table == nullptr) {
+    char msg[255];
+    snprintf(msg, sizeof(msg), "Column family id not found: %" PRIu32,
+             column_family_id);
+
+    return Status::InvalidArgument(msg);
+  }
+  if (table->cmp->Compare(start, end) > 0) {
+    return Status::InvalidArgument("Range start is greater than range end");
+  }
+
+  TransactionID txn_id = txn->GetID();
+  int64_t timeout = txn->GetLockTimeout();
+  uint64_t end_time = 0;
+  if (timeout > 0) {
+    end_time = env->NowMicros() + timeout;
+  }
+  bool timed_out = false;
+  autovector<TransactionID> wait_ids;
+  uint64_t expire_time_hint = 0;
+  bool detect_deadlock;
+
+  std::unique_lock<std::mutex> lock(table->mutex);
+
+  // Wait for the overlapping ranges of other transactions to be unlocked
+  while (true) {
+    FindConflicts(table, txn, start, end, false /* point */, env, &wait_ids,
+                  &expire_time_hint, &detect_deadlock);
+    if (wait_ids.empty()) {
+      break;
+    }
+    if (timeout == 0 || timed_out) {
+      return Status::TimedOut(Status::SubCode::kLockTimeout);
+    }
+    Status s = Wait(table, &lock, txn, column_family_id, start, wait_ids,
+                    timeout, end_time, expire_time_hint, detect_deadlock, env,
+                    &timed_out);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  // Only ranges of this transaction overlap [start, end] now. Merge them
+  // into the new range, and keep them in case the request fails.
+  autovector<RangeLockTable::RangeMap::iterator> overlapping;
+  table->GetOverlapping(start, end, &overlapping);
+  std::string new_start = start;
+  std::string new_end = end;
+  if (!overlapping.empty()) {
+    const std::string& first_start = overlapping.back()->first;
+    const std::string& last_end = overlapping.front()->second.end;
+    if (overlapping.size() == 1 && table->cmp->Compare(first_start, start) <= 0 &&
+        table->cmp->Compare(last_end, end) >= 0) {
+      // Already locked
+      return Status::OK();
+    }
+    if (table->cmp->Compare(first_start, new_start) < 0) {
+      new_start = first_start;
+    }
+    if (table->cmp->Compare(last_end, new_end) > 0) {
+      new_end = last_end;
+    }
+  }
+  std::vector<std::pair<std::string, RangeLockTable::Range>> merged;
+  for (auto it : overlapping) {
+    assert(it->second.txn_id == txn_id);
+    assert(it->second.waiting_for.empty());
+    merged.emplace_back(it->first, it->second);
+    table->ranges.erase(it);
+  }
+  auto range_iter =
+      table->ranges
+          .emplace(new_start, RangeLockTable::Range(
+                                  new_end, txn_id, txn->GetExpirationTime()))
+          .first;
+  num_ranges_.fetch_add(1 - static_cast<int64_t>(merged.size()));
+  num_point_waiters_.fetch_add(1);
+  // Pairs with the fences of MayKeepPointLock() and OnPointLocksReleased(),
+  // so that either the scan below sees a point lock, or its holder sees the
+  // new range.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  // Wait for the point locks in the range to be released. The point lock
+  // manager is scanned without holding the table mutex, so that point lock
+  // requests checking the ranges and requests for other ranges do not wait
+  // for the scan. A release during the scan makes it start over instead of
+  // waiting, since its notification went out before this request waits.
+  Status result;
+  while (true) {
+    autovector<TransactionID> holders;
+    uint64_t point_lock_releases = table->point_lock_releases;
+    lock.unlock();
+    point_lock_mgr_->GetLockHolders(column_family_id, table->cmp, new_start,
+                                    new_end, txn_id, &holders);
+    lock.lock();
+    range_iter = table->ranges.find(new_start);
+    if (range_iter == table->ranges.end() ||
+        range_iter->second.txn_id != txn_id) {
+      // The range was stolen because this transaction expired.
+      result = Status::Expired();
+      break;
+    }
+    if (!range_iter->second.scanned) {
+      // Point lock requests waiting for the range may now either bypass it
+      // or wait for it with deadlock detection.
+      range_iter->second.scanned = true;
+      table->cv.notify_all();
+    }
+    autovector<TransactionID>& waiting_for = range_iter->second.waiting_for;
+    bool new_holders = false;
+    for (auto id : holders) {
+      if (!Contains(waiting_for, id)) {
+        new_holders = true;
+        break;
+      }
+    }
+    waiting_for = holders;
+    if (holders.empty()) {
+      break;
+    }
+    if (new_holders) {
+      // The new holders may bypass the range now.
+      table->cv.notify_all();
+    }
+    if (timeout == 0 || timed_out) {
+      result = Status::TimedOut(Status::SubCode::kLockTimeout);
+      break;
+    }
+    if (table->point_lock_releases != point_lock_releases) {
+      continue;
+    }
+    result = Wait(table, &lock, txn, column_family_id, start, holders,
+                  timeout, end_time, 0 /* expire_time_hint */,
+                  true /* detect_deadlock */, env, &timed_out);
+    if (!result.ok()) {
+      break;
+    }
+  }
+  num_point_waiters_.fetch_sub(1);
+
+  if (!result.ok()) {
+    range_iter = table->ranges.find(new_start);
+    if (range_iter != table->ranges.end() &&
+        range_iter->second.txn_id == txn_id) {
+      table->ranges.erase(range_iter);
+      for (auto& range : merged) {
+        table->ranges.emplace(std::move(range.first), std::move(range.second));
+      }
+      num_ranges_.fetch_add(static_cast<int64_t>(merged.size()) - 1);
+    }
+    table->cv.notify_all();
+  }
+
+  return result;
+}
+
+void RangeLockMgr::UnLock(const PessimisticTransaction* txn,
+                          const TransactionRangeMap& ranges) {
+  TransactionID txn_id = txn->GetID();
+  for (const auto& cf_iter : ranges) {
+    std::shared_ptr<RangeLockTable> table_ptr =
+        GetRangeLockTable(cf_iter.first);
+    RangeLockTable* table = table_ptr.get();
+    if (table == nullptr) {
+      // Column Family must have been dropped.
+      continue;
+    }
+
+    // Every merged range of txn overlaps one of the ranges that it requested.
+    int64_t num_unlocked = 0;
+    std::lock_guard<std::mutex> lock(table->mutex);
+    autovector<RangeLockTable::RangeMap::iterator> overlapping;
+    for (const auto& range : cf_iter.second) {
+      table->GetOverlapping(range.first, range.second, &overlapping);
+      for (auto it : overlapping) {
+        if (it->second.txn_id == txn_id) {
+          table->ranges.erase(it);
+          num_unlocked++;
+        }
+      }
+    }
+    if (num_unlocked > 0) {
+      num_ranges_.fetch_sub(num_unlocked);
+      table->cv.notify_all();
+    }
+  }
+}
+
+Status RangeLockMgr::WaitForRanges(PessimisticTransaction* txn,
+                                   uint32_t column_family_id,
+                                   const std::string& key, Env* env,
+                                   int64_t* timeout, uint64_t* end_time) {
+  if (num_ranges_.load(std::memory_order_acquire) == 0) {
+    // A range locked concurrently is caught by MayKeepPointLock().
+    return Status::OK();
+  }
+  std::shared_ptr<RangeLockTable> table_ptr =
+      GetRangeLockTable(column_family_id);
+  RangeLockTable* table = table_ptr.get();
+  if (table == nullptr) {
+    // The point lock manager reports the missing column family.
+    return Status::OK();
+  }
+
+  if (*timeout > 0 && *end_time == 0) {
+    *end_time = env->NowMicros() + *timeout;
+  }
+  bool timed_out = false;
+  autovector<TransactionID> wait_ids;
+  uint64_t expire_time_hint = 0;
+  bool detect_deadlock;
+
+  std::unique_lock<std::mutex> lock(table->mutex);
+  while (true) {
+    FindConflicts(table, txn, key, key, true /* point */, env, &wait_ids,
+                  &expire_time_hint, &detect_deadlock);
+    if (wait_ids.empty()) {
+      break;
+    }
+    if (*timeout == 0 || timed_out) {
+      return Status::TimedOut(Status::SubCode::kLockTimeout);
+    }
+    Status s = Wait(table, &lock, txn, column_family_id, key, wait_ids,
+                    *timeout, *end_time, expire_time_hint, detect_deadlock,
+                    env, &timed_out);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  if (*timeout > 0) {
+    // Leave the point lock what is left of the timeout. Once the deadline
+    // has passed, it still gets one attempt without waiting.
+    uint64_t now = env->NowMicros();
+    *timeout = now < *end_time ? static_cast<int64_t>(*end_time - now) : 0;
+  }
+  return Status::OK();
+}
+
+bool RangeLockMgr::MayKeepPointLock(const PessimisticTransaction* txn,
+                                    uint32_t column_family_id,
+                                    const std::string& key) {
+  // Pairs with the fence of TryLock().
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (num_ranges_.load(std::memory_order_relaxed) == 0) {
+    return true;
+  }
+  std::shared_ptr<RangeLockTable> table_ptr =
+      GetRangeLockTable(column_family_id);
+  RangeLockTable* table = table_ptr.get();
+  if (table == nullptr) {
+    return true;
+  }
+
+  TransactionID txn_id = txn->GetID();
+  std::lock_guard<std::mutex> lock(table->mutex);
+  autovector<RangeLockTable::RangeMap::iterator> overlapping;
+  table->GetOverlapping(key, key, &overlapping);
+  for (auto it : overlapping) {
+    if (it->second.txn_id != txn_id &&
+        !Contains(it->second.waiting_for, txn_id)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void RangeLockMgr::OnPointLocksReleased(uint32_t column_family_id) {
+  // Pairs with the fence of TryLock().
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (num_point_waiters_.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+
+  std::shared_ptr<RangeLockTable> table_ptr =
+      GetRangeLockTable(column_family_id);
+  RangeLockTable* table = table_ptr.get();
+  if (table == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(table->mutex);
+  table->point_lock_releases++;
+  table->cv.notify_all();
+}
+
+}  //  namespace rocksdb
+#endif  // ROCKSDB_LITE
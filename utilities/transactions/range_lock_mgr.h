@@ -0,0 +1,132 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#ifndef ROCKSDB_LITE
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "monitoring/instrumented_mutex.h"
+#include "rocksdb/comparator.h"
+#include "util/autovector.h"
+#include "util/thread_local.h"
+#include "utilities/transactions/transaction_lock_mgr.h"
+#include "utilities/transactions/transaction_util.h"
+
+namespace rocksdb {
+
+struct RangeLockTable;
+
+// Exclusive locks on ranges of keys, see Transaction::GetRangeLock().
+//
+// The ranges locked in a column family are kept in an ordered map of
+// disjoint intervals: the ranges of different transactions never overlap,
+// and the overlapping ranges of the same transaction are merged. A range is
+// inserted as soon as no range of another transaction overlaps it, but it is
+// only granted once no other transaction holds a point lock on a key inside
+// of it. Until then it records the transactions it waits for, and only these
+// transactions can keep locking keys in the range. Requests for point locks
+// check the ranges both before and after locking the key in the point lock
+// manager, so that they never hold a key that a granted range covers. While
+// no range is locked, this only costs a fence and atomic counter reads.
+//
+// Waits for ranges take part in the deadlock detection of the point lock
+// manager. Ranges of expired transactions are stolen like point locks, but
+// requests for ranges do not steal the point locks of expired transactions.
+class RangeLockMgr {
+ public:
+  explicit RangeLockMgr(BaseLockMgr* point_lock_mgr);
+  // No copying allowed
+  RangeLockMgr(const RangeLockMgr&) = delete;
+  void operator=(const RangeLockMgr&) = delete;
+
+  ~RangeLockMgr();
+
+  void AddColumnFamily(uint32_t column_family_id, const Comparator* cmp);
+
+  void RemoveColumnFamily(uint32_t column_family_id);
+
+  // Attempt to lock the keys k with start <= k <= end.  If OK status is
+  // returned, the caller is responsible for calling UnLock() on this range.
+  Status TryLock(PessimisticTransaction* txn, uint32_t column_family_id,
+                 const std::string& start, const std::string& end, Env* env);
+
+  // Unlock the ranges locked by TryLock().  txn must be the same Transaction
+  // that locked these ranges.
+  void UnLock(const PessimisticTransaction* txn,
+              const TransactionRangeMap& ranges);
+
+  // Waits until no range of another transaction that txn may not bypass
+  // covers key.  Called before locking key in the point lock manager.
+  //
+  // *timeout is the part of the lock timeout of txn that is left, and
+  // *end_time its deadline, or 0 if it has not been computed yet.  Once
+  // ranges have to be checked, the deadline is set, and *timeout is reduced
+  // to the time left until it, so that waiting for the ranges and then for
+  // the point lock does not take longer than the lock timeout.
+  Status WaitForRanges(PessimisticTransaction* txn, uint32_t column_family_id,
+                       const std::string& key, Env* env, int64_t* timeout,
+                       uint64_t* end_time);
+
+  // Returns false if txn has to release the point lock it just took on key
+  // and wait for the ranges again, because another transaction locked a
+  // range covering key in the meantime.
+  bool MayKeepPointLock(const PessimisticTransaction* txn,
+                        uint32_t column_family_id, const std::string& key);
+
+  // Called after point locks of column_family_id have been released, to wake
+  // up the range requests of the column family that wait for them.
+  void OnPointLocksReleased(uint32_t column_family_id);
+
+ private:
+  BaseLockMgr* const point_lock_mgr_;
+
+  // Number of ranges locked or being locked in all column families.
+  std::atomic<int64_t> num_ranges_;
+  // Number of range requests that wait for point locks to be released.
+  std::atomic<int64_t> num_point_waiters_;
+
+  // Must be held when accessing/modifying range_lock_tables_.
+  InstrumentedMutex range_lock_table_mutex_;
+
+  // Map of ColumnFamilyId to its table of locked ranges
+  using RangeLockTables =
+      std::unordered_map<uint32_t, std::shared_ptr<RangeLockTable>>;
+  RangeLockTables range_lock_tables_;
+
+  // Thread-local cache of entries in range_lock_tables_.
+  std::unique_ptr<ThreadLocalPtr> range_lock_tables_cache_;
+
+  std::shared_ptr<RangeLockTable> GetRangeLockTable(uint32_t column_family_id);
+
+  // Sets *wait_ids to the transactions whose ranges overlap [start, end] and
+  // conflict with txn, after stealing the ranges of expired transactions.
+  // If point is true, ranges that still wait for txn do not conflict.
+  // Sets *detect_deadlock unless all conflicts are with ranges whose point
+  // locks have not been looked up yet.
+  // REQUIRED: table->mutex is held.
+  void FindConflicts(RangeLockTable* table, const PessimisticTransaction* txn,
+                     const std::string& start, const std::string& end,
+                     bool point, Env* env, autovector<TransactionID>* wait_ids,
+                     uint64_t* expire_time_hint, bool* detect_deadlock);
+
+  // Waits on the condition variable of table once, performing deadlock
+  // detection first if detect_deadlock is set. Sets *timed_out if end_time
+  // has been reached.
+  // REQUIRED: lock holds table->mutex.
+  Status Wait(RangeLockTable* table, std::unique_lock<std::mutex>* lock,
+              PessimisticTransaction* txn, uint32_t column_family_id,
+              const std::string& key,
+              const autovector<TransactionID>& wait_ids, int64_t timeout,
+              uint64_t end_time, uint64_t expire_time_hint,
+              bool detect_deadlock, Env* env, bool* timed_out);
+};
+
+}  //  namespace rocksdb
+#endif  // ROCKSDB_LITE
@@ -0,0 +1,159 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef ROCKSDB_LITE
+
+#include "utilities/transactions/read_only_txn.h"
+
+#include "db/arena_wrapped_db_iter.h"
+#include "db/column_family.h"
+#include "port/likely.h"
+#include "rocksdb/env.h"
+#include "util/mutexlock.h"
+#include "utilities/transactions/pessimistic_transaction_db.h"
+#include "utilities/transactions/write_prepared_txn_db.h"
+
+namespace rocksdb {
+
+ReadOnlyTxn::ReadOnlyTxn(
+    PessimisticTransactionDB* txn_db, DBImpl* db_impl,
+    WritePreparedTxnDB* wp_db, const ReadOnlyTransactionOptions& txn_options,
+    const std::vector<ColumnFamilyHandle*>& column_families)
+    : txn_db_(txn_db),
+      db_impl_(db_impl),
+      wp_db_(wp_db),
+      lease_end_micros_(0),
+      min_uncommitted_(0),
+      seq_(0) {
+  if (txn_options.lease >= 0) {
+    lease_end_micros_ = db_impl_->GetEnv()->NowMicros() +
+                        static_cast<uint64_t>(txn_options.lease) * 1000;
+  }
+  std::vector<ColumnFamilyHandle*> cfs = column_families;
+  if (cfs.empty()) {
+    cfs.push_back(db_impl_->DefaultColumnFamily());
+  }
+  cf_ids_.reserve(cfs.size());
+  for (auto cf : cfs) {
+    cf_ids_.push_back(cf->GetID());
+  }
+  if (wp_db_ != nullptr) {
+    // As in WritePreparedTxnDB::Get(), the smallest uncommitted sequence
+    // number has to be read before the sequence number of the view.
+    min_uncommitted_ = wp_db_->SmallestUnCommittedSeq();
+  }
+  seq_ = db_impl_->PinSuperVersions(cfs, &super_versions_);
+  if (lease_end_micros_ > 0) {
+    txn_db_->RegisterReadOnlyTxn(this);
+  }
+}
+
+ReadOnlyTxn::~ReadOnlyTxn() {
+  if (lease_end_micros_ > 0) {
+    txn_db_->UnregisterReadOnlyTxn(this);
+  }
+  db_impl_->UnpinSuperVersions(&super_versions_);
+}
+
+void ReadOnlyTxn::ReleaseIfExpired(uint64_t now_micros) {
+  MutexLock l(&mutex_);
+  if (now_micros >= lease_end_micros_) {
+    db_impl_->UnpinSuperVersions(&super_versions_);
+  }
+}
+
+Status ReadOnlyTxn::PrepareRead(const ReadOptions& options,
+                                ColumnFamilyHandle* column_family,
+                                SuperVersion** sv) {
+  if (options.snapshot != nullptr) {
+    return Status::InvalidArgument(
+        "Read-only transactions read at their own sequence number");
+  }
+  if (super_versions_.empty()) {
+    return Status::Expired();
+  }
+  if (lease_end_micros_ > 0 &&
+      db_impl_->GetEnv()->NowMicros() >= lease_end_micros_) {
+    db_impl_->UnpinSuperVersions(&super_versions_);
+    return Status::Expired();
+  }
+  uint32_t cf_id = column_family->GetID();
+  for (size_t i = 0; i < cf_ids_.size(); i++) {
+    if (cf_ids_[i] == cf_id) {
+      *sv = super_versions_[i];
+      return Status::OK();
+    }
+  }
+  return Status::InvalidArgument(
+      "Column family was not given when starting the read-only transaction");
+}
+
+Status ReadOnlyTxn::Get(const ReadOptions& options,
+                        ColumnFamilyHandle* column_family, const Slice& key,
+                        PinnableSlice* value) {
+  MutexLock l(&mutex_);
+  SuperVersion* sv = nullptr;
+  Status s = PrepareRead(options, column_family, &sv);
+  if (!s.ok()) {
+    return s;
+  }
+  DBImpl::GetImplOptions get_impl_options;
+  get_impl_options.column_family = column_family;
+  get_impl_options.value = value;
+  get_impl_options.pinned_super_version = sv;
+  get_impl_options.pinned_seq = seq_;
+  if (wp_db_ == nullptr) {
+    return db_impl_->GetImpl(options, key, get_impl_options);
+  }
+
+  // The sequence number is not backed by a snapshot, so the commit cache may
+  // evict entries that are needed to tell whether keys are visible to it.
+  WritePreparedTxnReadCallback callback(wp_db_, seq_, min_uncommitted_,
+                                        kUnbackedByDBSnapshot);
+  get_impl_options.callback = &callback;
+  s = db_impl_->GetImpl(options, key, get_impl_options);
+  if (LIKELY(callback.valid() &&
+             wp_db_->ValidateSnapshot(seq_, kUnbackedByDBSnapshot))) {
+    return s;
+  }
+  return Status::TryAgain();
+}
+
+std::vector<Status> ReadOnlyTxn::MultiGet(
+    const ReadOptions& options,
+    const std::vector<ColumnFamilyHandle*>& column_family,
+    const std::vector<Slice>& keys, std::vector<std::string>* values) {
+  size_t num_keys = keys.size();
+  values->resize(num_keys);
+
+  std::vector<Status> stat_list(num_keys);
+  for (size_t i = 0; i < num_keys; ++i) {
+    stat_list[i] = Get(options, column_family[i], keys[i], &(*values)[i]);
+  }
+  return stat_list;
+}
+
+Iterator* ReadOnlyTxn::GetIterator(const ReadOptions& options,
+                                   ColumnFamilyHandle* column_family) {
+  MutexLock l(&mutex_);
+  SuperVersion* sv = nullptr;
+  Status s = PrepareRead(options, column_family, &sv);
+  if (!s.ok()) {
+    return NewErrorIterator(s);
+  }
+  if (wp_db_ != nullptr) {
+    // An iterator could not report that the commit cache evicted entries it
+    // needs.
+    return NewErrorIterator(Status::NotSupported(
+        "Iterators of read-only transactions require WRITE_COMMITTED"));
+  }
+  auto cfd = reinterpret_cast<ColumnFamilyHandleImpl*>(column_family)->cfd();
+  return db_impl_->NewIteratorImpl(options, cfd, seq_, nullptr /*callback*/,
+                                   false /*allow_blob*/,
+                                   false /*allow_refresh*/, sv);
+}
+
+}  // namespace rocksdb
+#endif  // ROCKSDB_LITE
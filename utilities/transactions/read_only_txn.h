@@ -0,0 +1,85 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#ifndef ROCKSDB_LITE
+
+#include <string>
+#include <vector>
+
+#include "db/db_impl/db_impl.h"
+#include "port/port.h"
+#include "rocksdb/utilities/transaction_db.h"
+
+namespace rocksdb {
+
+class PessimisticTransactionDB;
+class WritePreparedTxnDB;
+
+// Reads from the SuperVersions of its column families that it references
+// from its start until its lease expires, at a sequence number that all of
+// them contain the data of. See ReadOnlyTransaction.
+//
+// A transaction with a lease is registered with txn_db, which releases its
+// SuperVersions from a background thread once the lease has expired.
+class ReadOnlyTxn : public ReadOnlyTransaction {
+ public:
+  // wp_db is the WritePreparedTxnDB the transaction reads from, if any.
+  ReadOnlyTxn(PessimisticTransactionDB* txn_db, DBImpl* db_impl,
+              WritePreparedTxnDB* wp_db,
+              const ReadOnlyTransactionOptions& txn_options,
+              const std::vector<ColumnFamilyHandle*>& column_families);
+
+  ~ReadOnlyTxn() override;
+
+  using ReadOnlyTransaction::Get;
+  Status Get(const ReadOptions& options, ColumnFamilyHandle* column_family,
+             const Slice& key, PinnableSlice* value) override;
+
+  std::vector<Status> MultiGet(
+      const ReadOptions& options,
+      const std::vector<ColumnFamilyHandle*>& column_family,
+      const std::vector<Slice>& keys,
+      std::vector<std::string>* values) override;
+
+  Iterator* GetIterator(const ReadOptions& options,
+                        ColumnFamilyHandle* column_family) override;
+
+  SequenceNumber GetSequenceNumber() const override { return seq_; }
+
+  // Releases the SuperVersions if the lease has expired at now_micros.
+  void ReleaseIfExpired(uint64_t now_micros);
+
+ private:
+  // Sets *sv to the pinned SuperVersion of column_family if the transaction
+  // may read from it with options.
+  // REQUIRES: mutex_ is held, and stays held while *sv is used.
+  Status PrepareRead(const ReadOptions& options,
+                     ColumnFamilyHandle* column_family, SuperVersion** sv);
+
+  PessimisticTransactionDB* const txn_db_;
+  DBImpl* const db_impl_;
+  WritePreparedTxnDB* const wp_db_;
+
+  // Held while reading from super_versions_ and while releasing them, since
+  // the background thread of txn_db_ may release them at any time.
+  port::Mutex mutex_;
+
+  // Time in microseconds at which the lease expires, 0 if it never does.
+  uint64_t lease_end_micros_;
+
+  // Smallest uncommitted sequence number when the transaction started, only
+  // used with WritePreparedTxnDB.
+  SequenceNumber min_uncommitted_;
+  SequenceNumber seq_;
+
+  // Ids of the column families of the transaction, and their SuperVersions.
+  // super_versions_ is cleared once the lease has expired.
+  std::vector<uint32_t> cf_ids_;
+  std::vector<SuperVersion*> super_versions_;
+};
+
+}  // namespace rocksdb
+#endif  // ROCKSDB_LITE
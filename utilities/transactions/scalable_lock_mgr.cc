@@ -0,0 +1,866 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef ROCKSDB_LITE
+
+#include "utilities/transactions/scalable_lock_mgr.h"
+
+#include <cinttypes>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "monitoring/perf_context_imp.h"
+#include "port/port.h"
+#include "test_util/sync_point.h"
+#include "util/core_local.h"
+#include "util/hash.h"
+#include "utilities/transactions/pessimistic_transaction_db.h"
+
+namespace rocksdb {
+
+namespace {
+// Value of KeyLock::word while the lock is described by the fields that are
+// protected by KeyLock::mutex. Transaction ids never get this large.
+const uint64_t kSlowLockWord = uint64_t{1} << 63;
+
+const size_t kMinLockTableSlots = 1024;
+}  // anonymous namespace
+
+// A transaction blocked on a KeyLock, linked into the wait queue of the key.
+struct LockWaiter {
+  LockWaiter(TransactionID _txn_id, bool _exclusive, bool _deadlock_detect)
+      : txn_id(_txn_id),
+        exclusive(_exclusive),
+        deadlock_detect(_deadlock_detect) {}
+
+  const TransactionID txn_id;
+  const bool exclusive;
+  const bool deadlock_detect;
+  std::condition_variable cv;
+  LockWaiter* prev = nullptr;
+  LockWaiter* next = nullptr;
+};
+
+struct KeyLock {
+  // 0 if the key is not locked, the id of the holder if a transaction
+  // without expiration holds it exclusively and nobody waits for it, or
+  // kSlowLockWord if the fields protected by mutex describe the lock.
+  std::atomic<uint64_t> word{0};
+
+  // Immutable while the node is in a table.
+  uint64_t hash = 0;
+  std::string key;
+
+  std::mutex mutex;
+  bool exclusive = false;
+  autovector<TransactionID> holders;
+  uint64_t expiration_time = 0;
+  LockWaiter* waiters_head = nullptr;
+  LockWaiter* waiters_tail = nullptr;
+
+  // Protected by KeyLockTable::pool_mutex while the node is free.
+  KeyLock* next_free = nullptr;
+};
+
+// Open-addressed hash table of the key locks of a column family.
+//
+// Threads look up and insert nodes inside a gate made of per-core counters,
+// and the table is only resized or purged of idle nodes by a rebuild that
+// closes the gate and waits for it to drain. A thread that blocks on a key
+// leaves the gate first; its entry in the wait queue keeps the node from
+// being recycled, and it does not need the table again to finish.
+struct KeyLockTable {
+  KeyLockTable() { ResetSlots(kMinLockTableSlots); }
+
+  // Returns the index to pass to ExitGate().
+  size_t EnterGate();
+  void ExitGate(size_t gate_idx);
+
+  // REQUIRED: inside the gate.
+  KeyLock* Find(const std::string& key, uint64_t hash) const;
+  // Sets *key_lock to the node of key, inserting an unlocked one if needed.
+  // Returns false if the table has to be rebuilt first.
+  // REQUIRED: inside the gate.
+  bool FindOrInsert(const std::string& key, uint64_t hash,
+                    KeyLock** key_lock);
+  // REQUIRED: outside the gate.
+  void Rebuild();
+
+  // Number of locked keys, only maintained if max_num_locks is positive.
+  std::atomic<int64_t> lock_cnt{0};
+
+  // Only changed by Rebuild() while the gate is closed and drained.
+  size_t num_slots;
+  std::unique_ptr<std::atomic<KeyLock*>[]> slots;
+
+ private:
+  struct GateCounter {
+    char padding[56] ROCKSDB_FIELD_UNUSED;
+    std::atomic<int64_t> threads;
+
+    GateCounter() : threads(0) {}
+  };
+
+  CoreLocalArray<GateCounter> gate_;
+  std::atomic<bool> rebuilding_{false};
+  // Held by Rebuild(); threads wait on it while the gate is closed.
+  std::mutex rebuild_mutex_;
+
+  // Occupied slots, including the ones of idle nodes.
+  std::atomic<size_t> num_used_{0};
+
+  std::mutex pool_mutex_;
+  std::deque<KeyLock> pool_;
+  KeyLock* free_list_ = nullptr;
+
+  size_t MaxUsedSlots() const { return num_slots / 4 * 3; }
+  void ResetSlots(size_t n);
+  KeyLock* NewKeyLock(const std::string& key, uint64_t hash);
+  void FreeKeyLock(KeyLock* key_lock);
+};
+
+size_t KeyLockTable::EnterGate() {
+  while (true) {
+    auto counter = gate_.AccessElementAndIndex();
+    counter.first->threads.fetch_add(1);
+    if (!rebuilding_.load()) {
+      return counter.second;
+    }
+    counter.first->threads.fetch_sub(1);
+    // Wait for the rebuild to finish
+    std::lock_guard<std::mutex> l(rebuild_mutex_);
+  }
+}
+
+void KeyLockTable::ExitGate(size_t gate_idx) {
+  gate_.AccessAtCore(gate_idx)->threads.fetch_sub(1,
+                                                  std::memory_order_release);
+}
+
+KeyLock* KeyLockTable::Find(const std::string& key, uint64_t hash) const {
+  size_t i = static_cast<size_t>(fastrange64(hash, num_slots));
+  while (true) {
+    KeyLock* key_lock = slots[i].load(std::memory_order_acquire);
+    if (key_lock == nullptr) {
+      return nullptr;
+    }
+    if (key_lock->hash == hash && key_lock->key == key) {
+      return key_lock;
+    }
+    i = (i + 1 == num_slots) ? 0 : i + 1;
+  }
+}
+
+bool KeyLockTable::FindOrInsert(const std::string& key, uint64_t hash,
+                                KeyLock** key_lock) {
+  KeyLock* fresh = nullptr;
+  size_t i = static_cast<size_t>(fastrange64(hash, num_slots));
+  while (true) {
+    KeyLock* slot = slots[i].load(std::memory_order_acquire);
+    if (slot == nullptr) {
+      if (fresh == nullptr) {
+        // Keeping a quarter of the slots free bounds the probes and ensures
+        // that an empty slot is found below.
+        if (num_used_.fetch_add(1, std::memory_order_relaxed) >=
+            MaxUsedSlots()) {
+          num_used_.fetch_sub(1, std::memory_order_relaxed);
+          return false;
+        }
+        fresh = NewKeyLock(key, hash);
+      }
+      if (slots[i].compare_exchange_strong(slot, fresh,
+                                           std::memory_order_acq_rel)) {
+        *key_lock = fresh;
+        return true;
+      }
+      // Lost the slot, check whether the winner has the same key.
+    }
+    if (slot->hash == hash && slot->key == key) {
+      if (fresh != nullptr) {
+        FreeKeyLock(fresh);
+        num_used_.fetch_sub(1, std::memory_order_relaxed);
+      }
+      *key_lock = slot;
+      return true;
+    }
+    i = (i + 1 == num_slots) ? 0 : i + 1;
+  }
+}
+
+void KeyLockTable::Rebuild() {
+  std::lock_guard<std::mutex> l(rebuild_mutex_);
+  if (num_used_.load(std::memory_order_relaxed) < MaxUsedSlots()) {
+    // Another thread rebuilt the table in the meantime.
+    return;
+  }
+
+  // Close the gate and wait for the threads inside to leave. A thread that
+  // entered before the flag was set has incremented its counter before it
+  // is read below, and decrements the same counter when it leaves.
+  rebuilding_.store(true);
+  for (size_t c = 0; c < gate_.Size(); c++) {
+    while (gate_.AccessAtCore(c)->threads.load() != 0) {
+      std::this_thread::yield();
+    }
+  }
+
+  // Threads that wait for a key, or that gave up waiting, may still use its
+  // node under its mutex.
+  std::vector<KeyLock*> kept;
+  for (size_t i = 0; i < num_slots; i++) {
+    KeyLock* key_lock = slots[i].load(std::memory_order_relaxed);
+    if (key_lock == nullptr) {
+      continue;
+    }
+    std::lock_guard<std::mutex> key_guard(key_lock->mutex);
+    uint64_t word = key_lock->word.load(std::memory_order_relaxed);
+    if (key_lock->waiters_head == nullptr &&
+        (word == 0 || (word == kSlowLockWord && key_lock->holders.empty()))) {
+      FreeKeyLock(key_lock);
+    } else {
+      kept.push_back(key_lock);
+    }
+  }
+
+  size_t n = kMinLockTableSlots;
+  while (kept.size() * 2 >= n) {
+    n *= 2;
+  }
+  ResetSlots(n);
+  for (KeyLock* key_lock : kept) {
+    size_t i = static_cast<size_t>(fastrange64(key_lock->hash, num_slots));
+    while (slots[i].load(std::memory_order_relaxed) != nullptr) {
+      i = (i + 1 == num_slots) ? 0 : i + 1;
+    }
+    slots[i].store(key_lock, std::memory_order_relaxed);
+  }
+  num_used_.store(kept.size(), std::memory_order_relaxed);
+
+  rebuilding_.store(false);
+}
+
+void KeyLockTable::ResetSlots(size_t n) {
+  num_slots = n;
+  slots.reset(new std::atomic<KeyLock*>[n]);
+  for (size_t i = 0; i < n; i++) {
+    slots[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+KeyLock* KeyLockTable::NewKeyLock(const std::string& key, uint64_t hash) {
+  KeyLock* key_lock;
+  {
+    std::lock_guard<std::mutex> l(pool_mutex_);
+    if (free_list_ != nullptr) {
+      key_lock = free_list_;
+      free_list_ = key_lock->next_free;
+    } else {
+      pool_.emplace_back();
+      key_lock = &pool_.back();
+    }
+  }
+  // Reuses the buffer of a recycled node.
+  key_lock->key.assign(key);
+  key_lock->hash = hash;
+  key_lock->word.store(0, std::memory_order_relaxed);
+  key_lock->holders.clear();
+  key_lock->exclusive = false;
+  key_lock->expiration_time = 0;
+  assert(key_lock->waiters_head == nullptr);
+  return key_lock;
+}
+
+void KeyLockTable::FreeKeyLock(KeyLock* key_lock) {
+  std::lock_guard<std::mutex> l(pool_mutex_);
+  key_lock->next_free = free_list_;
+  free_list_ = key_lock;
+}
+
+namespace {
+void UnrefLockTablesCache(void* ptr) {
+  // Called when a thread exits or a ThreadLocalPtr gets destroyed.
+  auto lock_tables_cache =
+      static_cast<std::unordered_map<uint32_t, std::shared_ptr<KeyLockTable>>*>(
+          ptr);
+  delete lock_tables_cache;
+}
+
+// Moves the lock state from the word into the fields protected by the mutex.
+// REQUIRED: key_lock->mutex must be held.
+void MakeSlow(KeyLock* key_lock) {
+  uint64_t word = key_lock->word.load(std::memory_order_relaxed);
+  while (word != kSlowLockWord) {
+    if (key_lock->word.compare_exchange_weak(word, kSlowLockWord,
+                                             std::memory_order_acq_rel)) {
+      key_lock->holders.clear();
+      if (word != 0) {
+        key_lock->holders.push_back(word);
+      }
+      key_lock->exclusive = true;
+      key_lock->expiration_time = 0;
+      return;
+    }
+  }
+}
+
+// Lets the fast paths handle the key again if its state fits in the word.
+// REQUIRED: key_lock->mutex must be held.
+void MaybeMakeFast(KeyLock* key_lock) {
+  assert(key_lock->word.load(std::memory_order_relaxed) == kSlowLockWord);
+  if (key_lock->waiters_head != nullptr) {
+    return;
+  }
+  if (key_lock->holders.empty()) {
+    key_lock->word.store(0, std::memory_order_release);
+  } else if (key_lock->holders.size() == 1 && key_lock->exclusive &&
+             key_lock->expiration_time == 0) {
+    key_lock->word.store(key_lock->holders[0], std::memory_order_release);
+  }
+}
+
+void EnqueueWaiter(KeyLock* key_lock, LockWaiter* waiter) {
+  waiter->prev = key_lock->waiters_tail;
+  waiter->next = nullptr;
+  if (key_lock->waiters_tail != nullptr) {
+    key_lock->waiters_tail->next = waiter;
+  } else {
+    key_lock->waiters_head = waiter;
+  }
+  key_lock->waiters_tail = waiter;
+}
+
+void DequeueWaiter(KeyLock* key_lock, LockWaiter* waiter) {
+  if (waiter->prev != nullptr) {
+    waiter->prev->next = waiter->next;
+  } else {
+    key_lock->waiters_head = waiter->next;
+  }
+  if (waiter->next != nullptr) {
+    waiter->next->prev = waiter->prev;
+  } else {
+    key_lock->waiters_tail = waiter->prev;
+  }
+}
+
+// Wakes up the waiters that can be granted the lock in queue order, up to
+// the first exclusive one, and the deadlock detecting waiters whose set of
+// holders to wait for has changed.
+// REQUIRED: key_lock->mutex must be held, after the holders changed.
+void WakeWaiters(KeyLock* key_lock) {
+  size_t num_holders = key_lock->holders.size();
+  bool exclusive = key_lock->exclusive && num_holders > 0;
+  bool granting = true;
+  bool granted = false;
+  for (LockWaiter* waiter = key_lock->waiters_head; waiter != nullptr;
+       waiter = waiter->next) {
+    bool grantable = false;
+    if (granting) {
+      // A lone holder can change the mode of its own lock.
+      bool sole_holder = !granted && num_holders == 1 &&
+                         key_lock->holders[0] == waiter->txn_id;
+      grantable = num_holders == 0 || sole_holder ||
+                  (!waiter->exclusive && !exclusive);
+    }
+    if (grantable) {
+      waiter->cv.notify_one();
+      if (waiter->exclusive) {
+        granting = false;
+      } else {
+        num_holders++;
+        granted = true;
+      }
+    } else if (waiter->deadlock_detect) {
+      waiter->cv.notify_one();
+    }
+  }
+}
+}  // anonymous namespace
+
+ScalableLockMgr::ScalableLockMgr(TransactionDB* txn_db, int64_t max_num_locks,
+                                 uint32_t max_num_deadlocks)
+    : BaseLockMgr(txn_db, max_num_deadlocks),
+      max_num_locks_(max_num_locks),
+      lock_tables_cache_(new ThreadLocalPtr(&UnrefLockTablesCache)) {}
+
+ScalableLockMgr::~ScalableLockMgr() {}
+
+void ScalableLockMgr::AddColumnFamily(uint32_t column_family_id) {
+  InstrumentedMutexLock l(&lock_table_mutex_);
+
+  if (lock_tables_.find(column_family_id) == lock_tables_.end()) {
+    lock_tables_.emplace(column_family_id, std::make_shared<KeyLockTable>());
+  } else {
+    // column_family already exists in lock map
+    assert(false);
+  }
+}
+
+void ScalableLockMgr::RemoveColumnFamily(uint32_t column_family_id) {
+  // Remove the lock table for this column family.  Concurrent transactions
+  // can keep using it until they release their references to it.
+  {
+    InstrumentedMutexLock l(&lock_table_mutex_);
+
+    auto lock_tables_iter = lock_tables_.find(column_family_id);
+    assert(lock_tables_iter != lock_tables_.end());
+
+    lock_tables_.erase(lock_tables_iter);
+  }  // lock_table_mutex_
+
+  // Clear all thread-local caches
+  autovector<void*> local_caches;
+  lock_tables_cache_->Scrape(&local_caches, nullptr);
+  for (auto cache : local_caches) {
+    delete static_cast<LockTables*>(cache);
+  }
+}
+
+std::shared_ptr<KeyLockTable> ScalableLockMgr::GetLockTable(
+    uint32_t column_family_id) {
+  // First check thread-local cache
+  if (lock_tables_cache_->Get() == nullptr) {
+    lock_tables_cache_->Reset(new LockTables());
+  }
+
+  auto lock_tables_cache = static_cast<LockTables*>(lock_tables_cache_->Get());
+
+  auto lock_table_iter = lock_tables_cache->find(column_family_id);
+  if (lock_table_iter != lock_tables_cache->end()) {
+    return lock_table_iter->second;
+  }
+
+  // Not found in local cache, grab mutex and check shared LockTables
+  InstrumentedMutexLock l(&lock_table_mutex_);
+
+  lock_table_iter = lock_tables_.find(column_family_id);
+  if (lock_table_iter == lock_tables_.end()) {
+    return std::shared_ptr<KeyLockTable>(nullptr);
+  } else {
+    std::shared_ptr<KeyLockTable>& lock_table = lock_table_iter->second;
+    lock_tables_cache->insert({column_family_id, lock_table});
+
+    return lock_table;
+  }
+}
+
+Status ScalableLockMgr::TryLock(PessimisticTransaction* txn,
+                                uint32_t column_family_id,
+                                const std::string& key, Env* env,
+                                bool exclusive, int64_t timeout) {
+  std::shared_ptr<KeyLockTable> lock_table_ptr =
+      GetLockTable(column_family_id);
+  KeyLockTable* lock_table = lock_table_ptr.get();
+  if (lock_table == nullptr) {
+    char msg[255];
+    snprintf(msg, sizeof(msg), "Column family id not found: %" PRIu32,
+             column_family_id);
+
+    return Status::InvalidArgument(msg);
+  }
+
+  uint64_t hash = GetSliceNPHash64(key);
+  KeyLock* key_lock = nullptr;
+  size_t gate_idx;
+  while (true) {
+    gate_idx = lock_table->EnterGate();
+    if (lock_table->FindOrInsert(key, hash, &key_lock)) {
+      break;
+    }
+    lock_table->ExitGate(gate_idx);
+    lock_table->Rebuild();
+  }
+
+  if (exclusive && txn->GetExpirationTime() == 0) {
+    Status result;
+    if (TryLockFast(lock_table, key_lock, txn->GetID(), &result)) {
+      lock_table->ExitGate(gate_idx);
+      return result;
+    }
+  }
+
+  return AcquireWithTimeout(txn, lock_table, key_lock, gate_idx,
+                            column_family_id, key, env, exclusive, timeout);
+}
+
+bool ScalableLockMgr::TryLockFast(KeyLockTable* lock_table, KeyLock* key_lock,
+                                  TransactionID txn_id, Status* result) {
+  uint64_t word = key_lock->word.load(std::memory_order_relaxed);
+  if (word == txn_id) {
+    // Already held exclusively by this transaction.
+    *result = Status::OK();
+    return true;
+  }
+  if (word != 0) {
+    return false;
+  }
+
+  if (max_num_locks_ > 0 &&
+      lock_table->lock_cnt.fetch_add(1, std::memory_order_relaxed) >=
+          max_num_locks_) {
+    lock_table->lock_cnt.fetch_sub(1, std::memory_order_relaxed);
+    *result = Status::Busy(Status::SubCode::kLockLimit);
+    return true;
+  }
+  if (key_lock->word.compare_exchange_strong(word, txn_id,
+                                             std::memory_order_acq_rel)) {
+    *result = Status::OK();
+    return true;
+  }
+  if (max_num_locks_ > 0) {
+    lock_table->lock_cnt.fetch_sub(1, std::memory_order_relaxed);
+  }
+  return false;
+}
+
+Status ScalableLockMgr::AcquireWithTimeout(
+    PessimisticTransaction* txn, KeyLockTable* lock_table, KeyLock* key_lock,
+    size_t gate_idx, uint32_t column_family_id, const std::string& key,
+    Env* env, bool exclusive, int64_t timeout) {
+  TransactionID txn_id = txn->GetID();
+  uint64_t expiration_time = txn->GetExpirationTime();
+  uint64_t end_time = 0;
+
+  if (timeout > 0) {
+    uint64_t start_time = env->NowMicros();
+    end_time = start_time + timeout;
+  }
+
+  std::unique_lock<std::mutex> key_mutex(key_lock->mutex);
+  MakeSlow(key_lock);
+
+  // Acquire lock if we are able to
+  uint64_t expire_time_hint = 0;
+  autovector<TransactionID> wait_ids;
+  Status result =
+      AcquireLocked(lock_table, key_lock, txn_id, exclusive, expiration_time,
+                    env, &expire_time_hint, &wait_ids);
+
+  if (!result.ok() && !result.IsBusy() && timeout != 0) {
+    PERF_TIMER_GUARD(key_lock_wait_time);
+    PERF_COUNTER_ADD(key_lock_wait_count, 1);
+    LockWaiter waiter(txn_id, exclusive, txn->IsDeadlockDetect());
+    EnqueueWaiter(key_lock, &waiter);
+    // The queued waiter keeps the node out of rebuilds.
+    lock_table->ExitGate(gate_idx);
+
+    // If we weren't able to acquire the lock, we will keep retrying as long
+    // as the timeout allows.
+    bool timed_out = false;
+    do {
+      // Decide how long to wait
+      int64_t cv_end_time = -1;
+
+      // Check if held lock's expiration time is sooner than our timeout
+      if (expire_time_hint > 0 &&
+          (timeout < 0 || (timeout > 0 && expire_time_hint < end_time))) {
+        // expiration time is sooner than our timeout
+        cv_end_time = expire_time_hint;
+      } else if (timeout >= 0) {
+        cv_end_time = end_time;
+      }
+
+      assert(wait_ids.size() != 0);
+
+      // We are dependent on a transaction to finish, so perform deadlock
+      // detection.
+      if (txn->IsDeadlockDetect()) {
+        if (IncrementWaiters(txn, wait_ids, key, column_family_id, exclusive,
+                             env)) {
+          result = Status::Busy(Status::SubCode::kDeadlock);
+          break;
+        }
+      }
+      txn->SetWaitingTxn(wait_ids, column_family_id, &key);
+
+      TEST_SYNC_POINT("ScalableLockMgr::AcquireWithTimeout:WaitingTxn");
+      bool wait_timed_out = true;
+      if (cv_end_time < 0) {
+        // Wait indefinitely
+        waiter.cv.wait(key_mutex);
+        wait_timed_out = false;
+      } else {
+        uint64_t now = env->NowMicros();
+        if (static_cast<uint64_t>(cv_end_time) > now) {
+          wait_timed_out =
+              waiter.cv.wait_for(key_mutex, std::chrono::microseconds(
+                                                cv_end_time - now)) ==
+              std::cv_status::timeout;
+        }
+      }
+
+      txn->ClearWaitingTxn();
+      if (txn->IsDeadlockDetect()) {
+        DecrementWaiters(txn, wait_ids);
+      }
+
+      if (wait_timed_out) {
+        // Even though we timed out, we will still make one more attempt to
+        // acquire lock below (it is possible the lock expired and we
+        // were never signaled).
+        timed_out = true;
+      }
+
+      result = AcquireLocked(lock_table, key_lock, txn_id, exclusive,
+                             expiration_time, env, &expire_time_hint,
+                             &wait_ids);
+    } while (!result.ok() && !result.IsBusy() && !timed_out);
+
+    DequeueWaiter(key_lock, &waiter);
+    MaybeMakeFast(key_lock);
+    return result;
+  }
+
+  MaybeMakeFast(key_lock);
+  key_mutex.unlock();
+  lock_table->ExitGate(gate_idx);
+  return result;
+}
+
+// Try to lock this key after we have acquired the mutex of the key.
+// Sets *expire_time to the expiration time in microseconds
+//  or 0 if no expiration.
+// REQUIRED:  key_lock->mutex must be held and the lock in slow mode.
+Status ScalableLockMgr::AcquireLocked(KeyLockTable* lock_table,
+                                      KeyLock* key_lock, TransactionID txn_id,
+                                      bool exclusive, uint64_t expiration_time,
+                                      Env* env, uint64_t* expire_time,
+                                      autovector<TransactionID>* txn_ids) {
+  assert(key_lock->word.load(std::memory_order_relaxed) == kSlowLockWord);
+  Status result;
+  auto& holders = key_lock->holders;
+  if (!holders.empty()) {
+    // Lock already held
+    if (key_lock->exclusive || exclusive) {
+      if (holders.size() == 1 && holders[0] == txn_id) {
+        // The list contains one txn and we're it, so just take it.
+        key_lock->exclusive = exclusive;
+        key_lock->expiration_time = expiration_time;
+      } else if (IsLockExpired(txn_id, key_lock->expiration_time, holders,
+                               env, expire_time)) {
+        // lock is expired, can steal it
+        holders.clear();
+        holders.push_back(txn_id);
+        key_lock->exclusive = exclusive;
+        key_lock->expiration_time = expiration_time;
+        // lock_cnt does not change
+        WakeWaiters(key_lock);
+      } else {
+        result = Status::TimedOut(Status::SubCode::kLockTimeout);
+        *txn_ids = holders;
+      }
+    } else {
+      // We are requesting shared access to a shared lock, so just grant it.
+      holders.push_back(txn_id);
+      key_lock->expiration_time =
+          std::max(key_lock->expiration_time, expiration_time);
+    }
+  } else {  // Lock not held.
+    // Check lock limit
+    if (max_num_locks_ > 0 &&
+        lock_table->lock_cnt.fetch_add(1, std::memory_order_relaxed) >=
+            max_num_locks_) {
+      lock_table->lock_cnt.fetch_sub(1, std::memory_order_relaxed);
+      result = Status::Busy(Status::SubCode::kLockLimit);
+    } else {
+      holders.push_back(txn_id);
+      key_lock->exclusive = exclusive;
+      key_lock->expiration_time = expiration_time;
+    }
+  }
+
+  return result;
+}
+
+// REQUIRED: inside the gate of lock_table.
+void ScalableLockMgr::UnLockKey(const PessimisticTransaction* txn,
+                                const std::string& key,
+                                KeyLockTable* lock_table, Env* env) {
+#ifdef NDEBUG
+  (void)env;
+#endif
+  TransactionID txn_id = txn->GetID();
+  bool found = false;
+
+  KeyLock* key_lock = lock_table->Find(key, GetSliceNPHash64(key));
+  if (key_lock != nullptr) {
+    uint64_t word = txn_id;
+    if (key_lock->word.compare_exchange_strong(word, 0,
+                                               std::memory_order_acq_rel)) {
+      found = true;
+      if (max_num_locks_ > 0) {
+        lock_table->lock_cnt.fetch_sub(1, std::memory_order_relaxed);
+      }
+    } else if (word == kSlowLockWord) {
+      std::lock_guard<std::mutex> key_mutex(key_lock->mutex);
+      // The lock may have switched back to the word in the meantime.
+      MakeSlow(key_lock);
+      auto& txns = key_lock->holders;
+      auto txn_it = std::find(txns.begin(), txns.end(), txn_id);
+      if (txn_it != txns.end()) {
+        found = true;
+        auto last_it = txns.end() - 1;
+        if (txn_it != last_it) {
+          *txn_it = *last_it;
+        }
+        txns.pop_back();
+
+        if (txns.empty() && max_num_locks_ > 0) {
+          // Maintain lock count if there is a limit on the number of locks.
+          assert(lock_table->lock_cnt.load(std::memory_order_relaxed) > 0);
+          lock_table->lock_cnt.fetch_sub(1, std::memory_order_relaxed);
+        }
+        WakeWaiters(key_lock);
+      } else {
+        // Locked by someone else.
+        found = true;
+      }
+      MaybeMakeFast(key_lock);
+    } else if (word != 0) {
+      // Locked by someone else.
+      found = true;
+    }
+  }
+
+  if (!found) {
+    // This key is not locked.  This should only happen if the unlocking
+    // transaction has expired.
+    assert(txn->GetExpirationTime() > 0 &&
+           txn->GetExpirationTime() < env->NowMicros());
+  }
+}
+
+void ScalableLockMgr::UnLock(PessimisticTransaction* txn,
+                             uint32_t column_family_id, const std::string& key,
+                             Env* env) {
+  std::shared_ptr<KeyLockTable> lock_table_ptr =
+      GetLockTable(column_family_id);
+  KeyLockTable* lock_table = lock_table_ptr.get();
+  if (lock_table == nullptr) {
+    // Column Family must have been dropped.
+    return;
+  }
+
+  size_t gate_idx = lock_table->EnterGate();
+  UnLockKey(txn, key, lock_table, env);
+  lock_table->ExitGate(gate_idx);
+}
+
+void ScalableLockMgr::UnLock(const PessimisticTransaction* txn,
+                             const TransactionKeyMap* key_map, Env* env) {
+  for (auto& key_map_iter : *key_map) {
+    uint32_t column_family_id = key_map_iter.first;
+    auto& keys = key_map_iter.second;
+
+    std::shared_ptr<KeyLockTable> lock_table_ptr =
+        GetLockTable(column_family_id);
+    KeyLockTable* lock_table = lock_table_ptr.get();
+
+    if (lock_table == nullptr) {
+      // Column Family must have been dropped.
+      return;
+    }
+
+    size_t gate_idx = lock_table->EnterGate();
+    for (auto& key_iter : keys) {
+      UnLockKey(txn, key_iter.first, lock_table, env);
+    }
+    lock_table->ExitGate(gate_idx);
+  }
+}
+
+ScalableLockMgr::LockStatusData ScalableLockMgr::GetLockStatusData() {
+  LockStatusData data;
+  InstrumentedMutexLock l(&lock_table_mutex_);
+
+  for (const auto& lock_table_iter : lock_tables_) {
+    KeyLockTable* lock_table = lock_table_iter.second.get();
+    size_t gate_idx = lock_table->EnterGate();
+    for (size_t i = 0; i < lock_table->num_slots; i++) {
+      KeyLock* key_lock =
+          lock_table->slots[i].load(std::memory_order_acquire);
+      if (key_lock == nullptr) {
+        continue;
+      }
+      struct KeyLockInfo info;
+      {
+        std::lock_guard<std::mutex> key_mutex(key_lock->mutex);
+        uint64_t word = key_lock->word.load(std::memory_order_acquire);
+        if (word == 0) {
+          continue;
+        } else if (word != kSlowLockWord) {
+          info.exclusive = true;
+          info.ids.push_back(word);
+        } else if (key_lock->holders.empty()) {
+          continue;
+        } else {
+          info.exclusive = key_lock->exclusive;
+          for (const auto& id : key_lock->holders) {
+            info.ids.push_back(id);
+          }
+        }
+      }
+      info.key = key_lock->key;
+      data.insert({lock_table_iter.first, info});
+    }
+    lock_table->ExitGate(gate_idx);
+  }
+
+  return data;
+}
+
+void ScalableLockMgr::GetLockHolders(uint32_t column_family_id,
+                                     const Comparator* cmp, const Slice& start,
+                                     const Slice& end, TransactionID txn_id,
+                                     autovector<TransactionID>* holders) {
+  std::shared_ptr<KeyLockTable> lock_table_ptr =
+      GetLockTable(column_family_id);
+  KeyLockTable* lock_table = lock_table_ptr.get();
+  if (lock_table == nullptr) {
+    return;
+  }
+
+  auto add_holder = [&](TransactionID id) {
+    if (id != txn_id &&
+        std::find(holders->begin(), holders->end(), id) == holders->end()) {
+      holders->push_back(id);
+    }
+  };
+  size_t gate_idx = lock_table->EnterGate();
+  for (size_t i = 0; i < lock_table->num_slots; i++) {
+    KeyLock* key_lock = lock_table->slots[i].load(std::memory_order_acquire);
+    if (key_lock == nullptr ||
+        key_lock->word.load(std::memory_order_acquire) == 0 ||
+        cmp->Compare(key_lock->key, start) < 0 ||
+        cmp->Compare(key_lock->key, end) > 0) {
+      continue;
+    }
+    uint64_t word = key_lock->word.load(std::memory_order_acquire);
+    if (word == kSlowLockWord) {
+      std::lock_guard<std::mutex> key_mutex(key_lock->mutex);
+      word = key_lock->word.load(std::memory_order_acquire);
+      if (word == kSlowLockWord) {
+        for (auto id : key_lock->holders) {
+          add_holder(id);
+        }
+        continue;
+      }
+    }
+    if (word != 0) {
+      add_holder(word);
+    }
+  }
+  lock_table->ExitGate(gate_idx);
+}
+
+}  //  namespace rocksdb
+#endif  // ROCKSDB_LITE
@@ -0,0 +1,108 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#ifndef ROCKSDB_LITE
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "monitoring/instrumented_mutex.h"
+#include "util/autovector.h"
+#include "util/thread_local.h"
+#include "utilities/transactions/transaction_lock_mgr.h"
+
+namespace rocksdb {
+
+struct KeyLock;
+struct KeyLockTable;
+
+// Lock manager used with TxnDBLockManager::SCALABLE_LOCK_MANAGER.
+//
+// The keys of a column family are locked in an open-addressed hash table of
+// pooled per-key lock nodes. A key that is exclusively locked by one
+// transaction without expiration, and that nobody waits for, is represented
+// by the id of its holder in an atomic word of its node, so uncontended
+// exclusive locks are taken and released with a single compare-and-swap.
+// Every other lock state is kept under a mutex of the key, together with a
+// FIFO queue of the transactions waiting for it. Unlocking a key wakes up the
+// waiters that can now acquire it, and the deadlock detecting waiters that
+// have to update the transactions they wait for, but no one else.
+//
+// The nodes of unlocked keys stay in the table, and are reused when the same
+// keys are locked again, until the table runs out of free slots. It is then
+// rebuilt with a size that fits the keys that are still locked or waited
+// for, and the other nodes are recycled for new keys. Requests that would
+// exceed max_num_locks fail right away instead of waiting for other keys to
+// be unlocked. GetLockStatusData() is consistent per key but not across keys.
+class ScalableLockMgr : public BaseLockMgr {
+ public:
+  ScalableLockMgr(TransactionDB* txn_db, int64_t max_num_locks,
+                  uint32_t max_num_deadlocks);
+
+  ~ScalableLockMgr() override;
+
+  void AddColumnFamily(uint32_t column_family_id) override;
+
+  void RemoveColumnFamily(uint32_t column_family_id) override;
+
+  Status TryLock(PessimisticTransaction* txn, uint32_t column_family_id,
+                 const std::string& key, Env* env, bool exclusive,
+                 int64_t timeout) override;
+
+  void UnLock(const PessimisticTransaction* txn, const TransactionKeyMap* keys,
+              Env* env) override;
+  void UnLock(PessimisticTransaction* txn, uint32_t column_family_id,
+              const std::string& key, Env* env) override;
+
+  LockStatusData GetLockStatusData() override;
+
+  void GetLockHolders(uint32_t column_family_id, const Comparator* cmp,
+                      const Slice& start, const Slice& end,
+                      TransactionID txn_id,
+                      autovector<TransactionID>* holders) override;
+
+ private:
+  // Limit on number of keys locked per column family
+  const int64_t max_num_locks_;
+
+  // Must be held when accessing/modifying lock_tables_.
+  InstrumentedMutex lock_table_mutex_;
+
+  // Map of ColumnFamilyId to its table of key locks
+  using LockTables =
+      std::unordered_map<uint32_t, std::shared_ptr<KeyLockTable>>;
+  LockTables lock_tables_;
+
+  // Thread-local cache of entries in lock_tables_.
+  std::unique_ptr<ThreadLocalPtr> lock_tables_cache_;
+
+  std::shared_ptr<KeyLockTable> GetLockTable(uint32_t column_family_id);
+
+  // Takes an unlocked key, or one that txn_id already holds exclusively,
+  // without its mutex. Returns false if the slow path has to be taken.
+  bool TryLockFast(KeyLockTable* table, KeyLock* key_lock,
+                   TransactionID txn_id, Status* result);
+
+  // Called inside the gate of the table with index gate_idx, which it leaves
+  // before returning.
+  Status AcquireWithTimeout(PessimisticTransaction* txn, KeyLockTable* table,
+                            KeyLock* key_lock, size_t gate_idx,
+                            uint32_t column_family_id, const std::string& key,
+                            Env* env, bool exclusive, int64_t timeout);
+
+  Status AcquireLocked(KeyLockTable* table, KeyLock* key_lock,
+                       TransactionID txn_id, bool exclusive,
+                       uint64_t expiration_time, Env* env,
+                       uint64_t* expire_time,
+                       autovector<TransactionID>* txn_ids);
+
+  void UnLockKey(const PessimisticTransaction* txn, const std::string& key,
+                 KeyLockTable* table, Env* env);
+};
+
+}  //  namespace rocksdb
+#endif  // ROCKSDB_LITE
@@ -160,20 +160,22 @@ void UnrefLockMapsCache(void* ptr) {
 }
 }  // anonymous namespace
 
+BaseLockMgr::BaseLockMgr(TransactionDB* txn_db, uint32_t max_num_deadlocks)
+    : txn_db_impl_(nullptr), dlock_buffer_(max_num_deadlocks) {
+  assert(txn_db);
+  txn_db_impl_ =
+      static_cast_with_check<PessimisticTransactionDB, TransactionDB>(txn_db);
+}
+
 TransactionLockMgr::TransactionLockMgr(
     TransactionDB* txn_db, size_t default_num_stripes, int64_t max_num_locks,
     uint32_t max_num_deadlocks,
     std::shared_ptr<TransactionDBMutexFactory> mutex_factory)
-    : txn_db_impl_(nullptr),
+    : BaseLockMgr(txn_db, max_num_deadlocks),
       default_num_stripes_(default_num_stripes),
       max_num_locks_(max_num_locks),
       lock_maps_cache_(new ThreadLocalPtr(&UnrefLockMapsCache)),
-      dlock_buffer_(max_num_deadlocks),
-      mutex_factory_(mutex_factory) {
-  assert(txn_db);
-  txn_db_impl_ =
-      static_cast_with_check<PessimisticTransactionDB, TransactionDB>(txn_db);
-}
+      mutex_factory_(mutex_factory) {}
 
 TransactionLockMgr::~TransactionLockMgr() {}
 
@@ -252,19 +254,18 @@ std::shared_ptr<LockMap> TransactionLockMgr::GetLockMap(
 // transaction.
 // If false, sets *expire_time to the expiration time of the lock according
 // to Env->GetMicros() or 0 if no expiration.
-bool TransactionLockMgr::IsLockExpired(TransactionID txn_id,
-                                       const LockInfo& lock_info, Env* env,
-                                       uint64_t* expire_time) {
+bool BaseLockMgr::IsLockExpired(TransactionID txn_id, uint64_t expiration_time,
+                                const autovector<TransactionID>& holders,
+                                Env* env, uint64_t* expire_time) {
   auto now = env->NowMicros();
 
-  bool expired =
-      (lock_info.expiration_time > 0 && lock_info.expiration_time <= now);
+  bool expired = (expiration_time > 0 && expiration_time <= now);
 
-  if (!expired && lock_info.expiration_time > 0) {
+  if (!expired && expiration_time > 0) {
     // return how many microseconds until lock will be expired
-    *expire_time = lock_info.expiration_time;
+    *expire_time = expiration_time;
   } else {
-    for (auto id : lock_info.txn_ids) {
+    for (auto id : holders) {
       if (txn_id == id) {
         continue;
       }
@@ -284,7 +285,7 @@ bool TransactionLockMgr::IsLockExpired(TransactionID txn_id,
 Status TransactionLockMgr::TryLock(PessimisticTransaction* txn,
                                    uint32_t column_family_id,
                                    const std::string& key, Env* env,
-                                   bool exclusive) {
+                                   bool exclusive, int64_t timeout) {
   // Lookup lock map for this column family id
   std::shared_ptr<LockMap> lock_map_ptr = GetLockMap(column_family_id);
   LockMap* lock_map = lock_map_ptr.get();
@@ -302,7 +303,6 @@ Status TransactionLockMgr::TryLock(PessimisticTransaction* txn,
   LockMapStripe* stripe = lock_map->lock_map_stripes_.at(stripe_num);
 
   LockInfo lock_info(txn->GetID(), txn->GetExpirationTime(), exclusive);
-  int64_t timeout = txn->GetLockTimeout();
 
   return AcquireWithTimeout(txn, lock_map, stripe, column_family_id, key, env,
                             timeout, std::move(lock_info));
@@ -412,14 +412,14 @@ Status TransactionLockMgr::AcquireWithTimeout(
   return result;
 }
 
-void TransactionLockMgr::DecrementWaiters(
+void BaseLockMgr::DecrementWaiters(
     const PessimisticTransaction* txn,
     const autovector<TransactionID>& wait_ids) {
   std::lock_guard<std::mutex> lock(wait_txn_map_mutex_);
   DecrementWaitersImpl(txn, wait_ids);
 }
 
-void TransactionLockMgr::DecrementWaitersImpl(
+void BaseLockMgr::DecrementWaitersImpl(
     const PessimisticTransaction* txn,
     const autovector<TransactionID>& wait_ids) {
   auto id = txn->GetID();
@@ -434,7 +434,7 @@ void TransactionLockMgr::DecrementWaitersImpl(
   }
 }
 
-bool TransactionLockMgr::IncrementWaiters(
+bool BaseLockMgr::IncrementWaiters(
     const PessimisticTransaction* txn,
     const autovector<TransactionID>& wait_ids, const std::string& key,
     const uint32_t& cf_id, const bool& exclusive, Env* const env) {
@@ -543,8 +543,8 @@ Status TransactionLockMgr::AcquireLocked(LockMap* lock_map,
         // Check if it's expired. Skips over txn_lock_info.txn_ids[0] in case
         // it's there for a shared lock with multiple holders which was not
         // caught in the first case.
-        if (IsLockExpired(txn_lock_info.txn_ids[0], lock_info, env,
-                          expire_time)) {
+        if (IsLockExpired(txn_lock_info.txn_ids[0], lock_info.expiration_time,
+                          lock_info.txn_ids, env, expire_time)) {
           // lock is expired, can steal it
           lock_info.txn_ids = txn_lock_info.txn_ids;
           lock_info.exclusive = txn_lock_info.exclusive;
@@ -733,11 +733,41 @@ TransactionLockMgr::LockStatusData TransactionLockMgr::GetLockStatusData() {
 
   return data;
 }
-std::vector<DeadlockPath> TransactionLockMgr::GetDeadlockInfoBuffer() {
+void TransactionLockMgr::GetLockHolders(uint32_t column_family_id,
+                                        const Comparator* cmp,
+                                        const Slice& start, const Slice& end,
+                                        TransactionID txn_id,
+                                        autovector<TransactionID>* holders) {
+  std::shared_ptr<LockMap> lock_map_ptr = GetLockMap(column_family_id);
+  LockMap* lock_map = lock_map_ptr.get();
+  if (lock_map == nullptr) {
+    return;
+  }
+
+  for (LockMapStripe* stripe : lock_map->lock_map_stripes_) {
+    stripe->stripe_mutex->Lock();
+    for (const auto& it : stripe->keys) {
+      if (cmp->Compare(it.first, start) < 0 ||
+          cmp->Compare(it.first, end) > 0) {
+        continue;
+      }
+      for (auto id : it.second.txn_ids) {
+        if (id != txn_id &&
+            std::find(holders->begin(), holders->end(), id) ==
+                holders->end()) {
+          holders->push_back(id);
+        }
+      }
+    }
+    stripe->stripe_mutex->UnLock();
+  }
+}
+
+std::vector<DeadlockPath> BaseLockMgr::GetDeadlockInfoBuffer() {
   return dlock_buffer_.PrepareBuffer();
 }
 
-void TransactionLockMgr::Resize(uint32_t target_size) {
+void BaseLockMgr::Resize(uint32_t target_size) {
   dlock_buffer_.Resize(target_size);
 }
 
@@ -52,45 +52,122 @@ struct TrackedTrxInfo {
 class Slice;
 class PessimisticTransactionDB;
 
-class TransactionLockMgr {
+// The lock manager of a PessimisticTransactionDB, see
+// TransactionDBOptions::lock_manager. Implementations share the deadlock
+// detection and the stealing of expired locks.
+class BaseLockMgr {
  public:
-  TransactionLockMgr(TransactionDB* txn_db, size_t default_num_stripes,
-                     int64_t max_num_locks, uint32_t max_num_deadlocks,
-                     std::shared_ptr<TransactionDBMutexFactory> factory);
+  BaseLockMgr(TransactionDB* txn_db, uint32_t max_num_deadlocks);
   // No copying allowed
-  TransactionLockMgr(const TransactionLockMgr&) = delete;
-  void operator=(const TransactionLockMgr&) = delete;
+  BaseLockMgr(const BaseLockMgr&) = delete;
+  void operator=(const BaseLockMgr&) = delete;
 
-  ~TransactionLockMgr();
+  virtual ~BaseLockMgr() {}
 
   // Creates a new LockMap for this column family.  Caller should guarantee
   // that this column family does not already exist.
-  void AddColumnFamily(uint32_t column_family_id);
+  virtual void AddColumnFamily(uint32_t column_family_id) = 0;
 
   // Deletes the LockMap for this column family.  Caller should guarantee that
   // this column family is no longer in use.
-  void RemoveColumnFamily(uint32_t column_family_id);
+  virtual void RemoveColumnFamily(uint32_t column_family_id) = 0;
 
-  // Attempt to lock key.  If OK status is returned, the caller is responsible
-  // for calling UnLock() on this key.
-  Status TryLock(PessimisticTransaction* txn, uint32_t column_family_id,
-                 const std::string& key, Env* env, bool exclusive);
+  // Attempt to lock key, waiting for up to timeout microseconds, or
+  // indefinitely if timeout is negative.  If OK status is returned, the
+  // caller is responsible for calling UnLock() on this key.
+  virtual Status TryLock(PessimisticTransaction* txn,
+                         uint32_t column_family_id, const std::string& key,
+                         Env* env, bool exclusive, int64_t timeout) = 0;
 
   // Unlock a key locked by TryLock().  txn must be the same Transaction that
   // locked this key.
-  void UnLock(const PessimisticTransaction* txn, const TransactionKeyMap* keys,
-              Env* env);
-  void UnLock(PessimisticTransaction* txn, uint32_t column_family_id,
-              const std::string& key, Env* env);
+  virtual void UnLock(const PessimisticTransaction* txn,
+                      const TransactionKeyMap* keys, Env* env) = 0;
+  virtual void UnLock(PessimisticTransaction* txn, uint32_t column_family_id,
+                      const std::string& key, Env* env) = 0;
 
   using LockStatusData = std::unordered_multimap<uint32_t, KeyLockInfo>;
-  LockStatusData GetLockStatusData();
+  virtual LockStatusData GetLockStatusData() = 0;
+
+  // Appends to *holders the transactions other than txn_id that hold a lock
+  // on a key k of the column family with start <= k <= end.
+  virtual void GetLockHolders(uint32_t column_family_id, const Comparator* cmp,
+                              const Slice& start, const Slice& end,
+                              TransactionID txn_id,
+                              autovector<TransactionID>* holders) = 0;
+
   std::vector<DeadlockPath> GetDeadlockInfoBuffer();
   void Resize(uint32_t);
 
- private:
+ protected:
+  // Shares the deadlock detection and lock expiration.
+  friend class RangeLockMgr;
+
   PessimisticTransactionDB* txn_db_impl_;
 
+  // Returns true if the lock held by `holders` has expired and can be
+  // acquired by another transaction.
+  // If false, sets *expire_time to the expiration time of the lock according
+  // to Env->GetMicros() or 0 if no expiration.
+  bool IsLockExpired(TransactionID txn_id, uint64_t expiration_time,
+                     const autovector<TransactionID>& holders, Env* env,
+                     uint64_t* expire_time);
+
+  // Records that txn waits for wait_ids. Returns true, and removes the
+  // record, if this closes a wait cycle.
+  bool IncrementWaiters(const PessimisticTransaction* txn,
+                        const autovector<TransactionID>& wait_ids,
+                        const std::string& key, const uint32_t& cf_id,
+                        const bool& exclusive, Env* const env);
+  void DecrementWaiters(const PessimisticTransaction* txn,
+                        const autovector<TransactionID>& wait_ids);
+
+ private:
+  // Must be held when modifying wait_txn_map_ and rev_wait_txn_map_. Locked
+  // after any mutex of the implementations.
+  std::mutex wait_txn_map_mutex_;
+
+  // Maps from waitee -> number of waiters.
+  HashMap<TransactionID, int> rev_wait_txn_map_;
+  // Maps from waiter -> waitee.
+  HashMap<TransactionID, TrackedTrxInfo> wait_txn_map_;
+  DeadlockInfoBuffer dlock_buffer_;
+
+  void DecrementWaitersImpl(const PessimisticTransaction* txn,
+                            const autovector<TransactionID>& wait_ids);
+};
+
+// Locks keys in per column family hash maps, split into stripes that each
+// have a mutex and a condition variable.
+class TransactionLockMgr : public BaseLockMgr {
+ public:
+  TransactionLockMgr(TransactionDB* txn_db, size_t default_num_stripes,
+                     int64_t max_num_locks, uint32_t max_num_deadlocks,
+                     std::shared_ptr<TransactionDBMutexFactory> factory);
+
+  ~TransactionLockMgr() override;
+
+  void AddColumnFamily(uint32_t column_family_id) override;
+
+  void RemoveColumnFamily(uint32_t column_family_id) override;
+
+  Status TryLock(PessimisticTransaction* txn, uint32_t column_family_id,
+                 const std::string& key, Env* env, bool exclusive,
+                 int64_t timeout) override;
+
+  void UnLock(const PessimisticTransaction* txn, const TransactionKeyMap* keys,
+              Env* env) override;
+  void UnLock(PessimisticTransaction* txn, uint32_t column_family_id,
+              const std::string& key, Env* env) override;
+
+  LockStatusData GetLockStatusData() override;
+
+  void GetLockHolders(uint32_t column_family_id, const Comparator* cmp,
+                      const Slice& start, const Slice& end,
+                      TransactionID txn_id,
+                      autovector<TransactionID>* holders) override;
+
+ private:
   // Default number of lock map stripes per column family
   const size_t default_num_stripes_;
 
@@ -114,21 +191,9 @@ class TransactionLockMgr {
   // to avoid acquiring a mutex in order to look up a LockMap
   std::unique_ptr<ThreadLocalPtr> lock_maps_cache_;
 
-  // Must be held when modifying wait_txn_map_ and rev_wait_txn_map_.
-  std::mutex wait_txn_map_mutex_;
-
-  // Maps from waitee -> number of waiters.
-  HashMap<TransactionID, int> rev_wait_txn_map_;
-  // Maps from waiter -> waitee.
-  HashMap<TransactionID, TrackedTrxInfo> wait_txn_map_;
-  DeadlockInfoBuffer dlock_buffer_;
-
   // Used to allocate mutexes/condvars to use when locking keys
   std::shared_ptr<TransactionDBMutexFactory> mutex_factory_;
 
-  bool IsLockExpired(TransactionID txn_id, const LockInfo& lock_info, Env* env,
-                     uint64_t* wait_time);
-
   std::shared_ptr<LockMap> GetLockMap(uint32_t column_family_id);
 
   Status AcquireWithTimeout(PessimisticTransaction* txn, LockMap* lock_map,
@@ -143,15 +208,6 @@ class TransactionLockMgr {
 
   void UnLockKey(const PessimisticTransaction* txn, const std::string& key,
                  LockMapStripe* stripe, LockMap* lock_map, Env* env);
-
-  bool IncrementWaiters(const PessimisticTransaction* txn,
-                        const autovector<TransactionID>& wait_ids,
-                        const std::string& key, const uint32_t& cf_id,
-                        const bool& exclusive, Env* const env);
-  void DecrementWaiters(const PessimisticTransaction* txn,
-                        const autovector<TransactionID>& wait_ids);
-  void DecrementWaitersImpl(const PessimisticTransaction* txn,
-                            const autovector<TransactionID>& wait_ids);
 };
 
 }  //  namespace rocksdb
@@ -257,6 +257,231 @@ TEST_P(TransactionTest, ValidateSnapshotTest) {
   }
 }
 
+TEST_P(TransactionTest, ReadOnlyTransaction) {
+  WriteOptions write_options;
+  ReadOptions read_options;
+  std::string value;
+
+  ColumnFamilyHandle* cfa;
+  ColumnFamilyOptions cf_options;
+  ASSERT_OK(db->CreateColumnFamily(cf_options, "CFA", &cfa));
+  ASSERT_OK(db->Put(write_options, "foo", "bar"));
+  ASSERT_OK(db->Put(write_options, cfa, "foo", "bar_a"));
+
+  ReadOnlyTransaction* txn = db->BeginReadOnlyTransaction(
+      ReadOnlyTransactionOptions(), {db->DefaultColumnFamily(), cfa});
+  ASSERT_TRUE(txn);
+  uint64_t num_snapshots;
+  ASSERT_TRUE(db->GetIntProperty("rocksdb.num-snapshots", &num_snapshots));
+  ASSERT_EQ(0, num_snapshots);
+
+  // Overwrite the keys the transaction reads and compact the old versions
+  // away.
+  ASSERT_OK(db->Put(write_options, "foo", "bar2"));
+  ASSERT_OK(db->Put(write_options, "foo2", "bar2"));
+  ASSERT_OK(db->Delete(write_options, cfa, "foo"));
+  ASSERT_OK(db->Flush(FlushOptions()));
+  ASSERT_OK(db->Flush(FlushOptions(), cfa));
+  ASSERT_OK(db->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_OK(db->CompactRange(CompactRangeOptions(), cfa, nullptr, nullptr));
+
+  ASSERT_OK(txn->Get(read_options, db->DefaultColumnFamily(), "foo", &value));
+  ASSERT_EQ("bar", value);
+  ASSERT_TRUE(
+      txn->Get(read_options, db->DefaultColumnFamily(), "foo2", &value)
+          .IsNotFound());
+  std::vector<std::string> values;
+  auto statuses = txn->MultiGet(read_options, {db->DefaultColumnFamily(), cfa},
+                                {"foo", "foo"}, &values);
+  ASSERT_OK(statuses[0]);
+  ASSERT_OK(statuses[1]);
+  ASSERT_EQ("bar", values[0]);
+  ASSERT_EQ("bar_a", values[1]);
+  ASSERT_OK(db->Get(read_options, "foo", &value));
+  ASSERT_EQ("bar2", value);
+  ASSERT_TRUE(db->Get(read_options, cfa, "foo", &value).IsNotFound());
+
+  Iterator* iter = txn->GetIterator(read_options, db->DefaultColumnFamily());
+  if (txn_db_options.write_policy == WRITE_COMMITTED) {
+    iter->SeekToFirst();
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ("foo", iter->key().ToString());
+    ASSERT_EQ("bar", iter->value().ToString());
+    iter->Next();
+    ASSERT_FALSE(iter->Valid());
+    ASSERT_OK(iter->status());
+  } else {
+    ASSERT_TRUE(iter->status().IsNotSupported());
+  }
+  delete iter;
+
+  const Snapshot* snapshot = db->GetSnapshot();
+  read_options.snapshot = snapshot;
+  ASSERT_TRUE(txn->Get(read_options, cfa, "foo", &value).IsInvalidArgument());
+  read_options.snapshot = nullptr;
+  db->ReleaseSnapshot(snapshot);
+  delete txn;
+
+  // Without column families, only the default one can be read.
+  txn = db->BeginReadOnlyTransaction();
+  ASSERT_OK(txn->Get(read_options, db->DefaultColumnFamily(), "foo", &value));
+  ASSERT_EQ("bar2", value);
+  ASSERT_TRUE(txn->Get(read_options, cfa, "foo", &value).IsInvalidArgument());
+  delete txn;
+
+  ReadOnlyTransactionOptions txn_options;
+  txn_options.lease = 0;
+  txn = db->BeginReadOnlyTransaction(txn_options);
+  ASSERT_TRUE(
+      txn->Get(read_options, db->DefaultColumnFamily(), "foo", &value)
+          .IsExpired());
+  iter = txn->GetIterator(read_options, db->DefaultColumnFamily());
+  ASSERT_TRUE(iter->status().IsExpired());
+  delete iter;
+  delete txn;
+
+  delete cfa;
+}
+
+TEST_P(TransactionTest, ReadOnlyTransactionLeaseReleasesFiles) {
+  WriteOptions write_options;
+  ReadOptions read_options;
+  std::string value;
+
+  ASSERT_OK(db->Put(write_options, "foo", "bar"));
+  ASSERT_OK(db->Flush(FlushOptions()));
+  std::vector<LiveFileMetaData> files;
+  db->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(1, files.size());
+  const std::string pinned_file = files[0].db_path + files[0].name;
+
+  // The lease only expires for the background thread, whose clock the test
+  // moves forward below.
+  ReadOnlyTransactionOptions txn_options;
+  txn_options.lease = 3600 * 1000;
+  ReadOnlyTransaction* txn = db->BeginReadOnlyTransaction(txn_options);
+  ASSERT_TRUE(txn);
+
+  // The compaction output replaces the file, which the transaction keeps
+  // alive. The new file spans "foo", so that the compaction cannot just move
+  // both files to L1.
+  ASSERT_OK(db->Put(write_options, "a", "b"));
+  ASSERT_OK(db->Put(write_options, "foo", "bar2"));
+  ASSERT_OK(db->Put(write_options, "z", "b"));
+  ASSERT_OK(db->Flush(FlushOptions()));
+  CompactRangeOptions compact_options;
+  compact_options.bottommost_level_compaction =
+      BottommostLevelCompaction::kForce;
+  ASSERT_OK(db->CompactRange(compact_options, nullptr, nullptr));
+  files.clear();
+  db->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(1, files.size());
+  ASSERT_NE(pinned_file, files[0].db_path + files[0].name);
+  ASSERT_OK(env->FileExists(pinned_file));
+  ASSERT_OK(txn->Get(read_options, db->DefaultColumnFamily(), "foo", &value));
+  ASSERT_EQ("bar", value);
+
+  // Once the lease has expired, the file is deleted without reading from
+  // the transaction again.
+  SyncPoint::GetInstance()->SetCallBack(
+      "PessimisticTransactionDB::ReleaseExpiredReadOnlyTxns:Now",
+      [&](void* arg) {
+        uint64_t* now_micros = reinterpret_cast<uint64_t*>(arg);
+        *now_micros += 2 * 3600 * 1000000ull;
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+  for (int i = 0; i < 1000 && env->FileExists(pinned_file).ok(); i++) {
+    env->SleepForMicroseconds(10 * 1000);
+  }
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_TRUE(env->FileExists(pinned_file).IsNotFound());
+  ASSERT_TRUE(
+      txn->Get(read_options, db->DefaultColumnFamily(), "foo", &value)
+          .IsExpired());
+  delete txn;
+}
+
+TEST_P(TransactionTest, SyncedPrepareAndCommitShareWALSync) {
+  if (txn_db_options.write_policy != WRITE_PREPARED ||
+      !options.two_write_queues || options.unordered_write) {
+    return;
+  }
+  options.statistics = CreateDBStatistics();
+  ASSERT_OK(ReOpen());
+  DBImpl* db_impl = reinterpret_cast<DBImpl*>(db->GetRootDB());
+
+  WriteOptions write_options;
+  write_options.sync = true;
+  TransactionOptions txn_options;
+  Transaction* txn1 = db->BeginTransaction(write_options, txn_options);
+  ASSERT_OK(txn1->SetName("xid1"));
+  ASSERT_OK(txn1->Put("foo1", "bar1"));
+  ASSERT_OK(txn1->Prepare());
+  Transaction* txn2 = db->BeginTransaction(write_options, txn_options);
+  ASSERT_OK(txn2->SetName("xid2"));
+  ASSERT_OK(txn2->Put("foo2", "bar2"));
+
+  // Once the prepare of txn2 is in the WAL, a SyncWAL() call starts a sync
+  // and holds it until the prepare, written by the main write queue, and
+  // the commit of txn1, written by the WAL-only write queue, wait for it.
+  // They then share one sync.
+  std::atomic<bool> prepare_written(false);
+  std::atomic<bool> first_sync(true);
+  std::atomic<bool> first_sync_started(false);
+  std::atomic<bool> first_sync_released(false);
+  std::atomic<int> num_waiting(0);
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::WriteImpl:BeforeSyncWAL", [&](void* /*arg*/) {
+        prepare_written = true;
+        while (!first_sync_started) {
+          env->SleepForMicroseconds(100);
+        }
+      });
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "DBWALTest::SyncWALNotWaitWrite:1", [&](void* /*arg*/) {
+        if (first_sync.exchange(false)) {
+          first_sync_started = true;
+          while (!first_sync_released) {
+            env->SleepForMicroseconds(100);
+          }
+        }
+      });
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::SyncWAL:Wait", [&](void* /*arg*/) { num_waiting++; });
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+  uint64_t syncs = options.statistics->getTickerCount(WAL_FILE_SYNCED);
+  rocksdb::port::Thread prepare([&]() { ASSERT_OK(txn2->Prepare()); });
+  while (!prepare_written) {
+    env->SleepForMicroseconds(100);
+  }
+  rocksdb::port::Thread first([&]() { ASSERT_OK(db_impl->SyncWAL()); });
+  while (!first_sync_started) {
+    env->SleepForMicroseconds(100);
+  }
+  rocksdb::port::Thread commit([&]() { ASSERT_OK(txn1->Commit()); });
+  while (num_waiting < 2) {
+    env->SleepForMicroseconds(100);
+  }
+  first_sync_released = true;
+  first.join();
+  prepare.join();
+  commit.join();
+  ASSERT_EQ(syncs + 2, options.statistics->getTickerCount(WAL_FILE_SYNCED));
+
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+  rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_OK(txn2->Commit());
+  delete txn1;
+  delete txn2;
+  std::string value;
+  ASSERT_OK(db->Get(ReadOptions(), "foo1", &value));
+  ASSERT_EQ("bar1", value);
+  ASSERT_OK(db->Get(ReadOptions(), "foo2", &value));
+  ASSERT_EQ("bar2", value);
+}
+
 TEST_P(TransactionTest, WaitingTxn) {
   WriteOptions write_options;
   ReadOptions read_options;
@@ -850,6 +1075,80 @@ TEST_P(TransactionStressTest, DeadlockStress) {
     t.join();
   }
 }
+
+TEST_P(TransactionStressTest, ScalableLockMgrStress) {
+  const uint32_t NUM_TXN_THREADS = 8;
+  const uint32_t NUM_KEYS = 100;
+  const uint32_t NUM_ITERS = 1000;
+
+  WriteOptions write_options;
+  ReadOptions read_options;
+  TransactionOptions txn_options;
+
+  delete db;
+  db = nullptr;
+  txn_db_options.lock_manager = TxnDBLockManager::SCALABLE_LOCK_MANAGER;
+  ASSERT_OK(ReOpen());
+
+  txn_options.lock_timeout = 1000000;
+  txn_options.deadlock_detect = true;
+  std::vector<std::string> keys;
+
+  for (uint32_t i = 0; i < NUM_KEYS; i++) {
+    db->Put(write_options, Slice(ToString(i)), Slice(""));
+    keys.push_back(ToString(i));
+  }
+
+  size_t tid = std::hash<std::thread::id>()(std::this_thread::get_id());
+  Random rnd(static_cast<uint32_t>(tid));
+  std::function<void(uint32_t, uint32_t)> stress_thread = [&](uint32_t seed,
+                                                              uint32_t id) {
+    std::default_random_engine g(seed);
+
+    Transaction* txn;
+    for (uint32_t i = 0; i < NUM_ITERS; i++) {
+      txn = db->BeginTransaction(write_options, txn_options);
+      // Lock a key that is never locked again, so that the lock table
+      // keeps getting rebuilt.
+      ASSERT_OK(txn->GetForUpdate(read_options,
+                                  "u" + ToString(id) + "_" + ToString(i),
+                                  nullptr));
+      auto random_keys = keys;
+      std::shuffle(random_keys.begin(), random_keys.end(), g);
+
+      // Lock keys in random order.
+      bool ok = true;
+      for (const auto& k : random_keys) {
+        // Lock mostly for shared access, but exclusive 1/4 of the time.
+        auto s =
+            txn->GetForUpdate(read_options, k, nullptr, txn->GetID() % 4 == 0);
+        if (!s.ok()) {
+          ASSERT_TRUE(s.IsDeadlock());
+          ok = false;
+          break;
+        }
+      }
+      if (ok) {
+        ASSERT_OK(txn->Commit());
+      } else {
+        ASSERT_OK(txn->Rollback());
+      }
+
+      delete txn;
+    }
+  };
+
+  std::vector<port::Thread> threads;
+  for (uint32_t i = 0; i < NUM_TXN_THREADS; i++) {
+    threads.emplace_back(stress_thread, rnd.Next(), i);
+  }
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  ASSERT_EQ(db->GetLockStatusData().size(), 0);
+}
 #endif  // ROCKSDB_VALGRIND_RUN
 
 TEST_P(TransactionTest, CommitTimeBatchFailTest) {
@@ -3474,6 +3773,395 @@ TEST_P(TransactionTest, LockLimitTest) {
   delete txn2;
 }
 
+TEST_P(TransactionTest, ScalableLockMgrTest) {
+  WriteOptions write_options;
+  ReadOptions read_options;
+  TransactionOptions txn_options;
+  Status s;
+
+  delete db;
+  db = nullptr;
+  txn_db_options.lock_manager = TxnDBLockManager::SCALABLE_LOCK_MANAGER;
+  ASSERT_OK(ReOpen());
+
+  txn_options.lock_timeout = 1;
+  Transaction* txn1 = db->BeginTransaction(write_options, txn_options);
+  Transaction* txn2 = db->BeginTransaction(write_options, txn_options);
+  Transaction* txn3 = db->BeginTransaction(write_options, txn_options);
+  ASSERT_TRUE(txn1);
+  ASSERT_TRUE(txn2);
+  ASSERT_TRUE(txn3);
+
+  // Uncontended exclusive lock
+  ASSERT_OK(txn1->GetForUpdate(read_options, "foo", nullptr));
+  auto lock_data = db->GetLockStatusData();
+  ASSERT_EQ(lock_data.size(), 1);
+  ASSERT_EQ(lock_data.begin()->second.key, "foo");
+  ASSERT_EQ(lock_data.begin()->second.ids,
+            std::vector<TransactionID>({txn1->GetID()}));
+  ASSERT_TRUE(lock_data.begin()->second.exclusive);
+
+  s = txn2->GetForUpdate(read_options, "foo", nullptr, false /* exclusive */);
+  ASSERT_TRUE(s.IsTimedOut());
+  ASSERT_EQ(s.ToString(), "Operation timed out: Timeout waiting to lock key");
+  txn1->Rollback();
+  ASSERT_EQ(db->GetLockStatusData().size(), 0);
+
+  // Shared locks
+  ASSERT_OK(
+      txn1->GetForUpdate(read_options, "foo", nullptr, false /* exclusive */));
+  ASSERT_OK(
+      txn2->GetForUpdate(read_options, "foo", nullptr, false /* exclusive */));
+  ASSERT_OK(
+      txn3->GetForUpdate(read_options, "foo", nullptr, false /* exclusive */));
+  lock_data = db->GetLockStatusData();
+  ASSERT_EQ(lock_data.size(), 1);
+  std::vector<TransactionID> expected_txns = {txn1->GetID(), txn2->GetID(),
+                                              txn3->GetID()};
+  ASSERT_EQ(lock_data.begin()->second.ids, expected_txns);
+  ASSERT_FALSE(lock_data.begin()->second.exclusive);
+
+  // Upgrade once the other holders are gone
+  s = txn3->GetForUpdate(read_options, "foo", nullptr);
+  ASSERT_TRUE(s.IsTimedOut());
+  txn1->Rollback();
+  txn2->Rollback();
+  ASSERT_OK(txn3->GetForUpdate(read_options, "foo", nullptr));
+  lock_data = db->GetLockStatusData();
+  ASSERT_EQ(lock_data.size(), 1);
+  ASSERT_EQ(lock_data.begin()->second.ids,
+            std::vector<TransactionID>({txn3->GetID()}));
+  ASSERT_TRUE(lock_data.begin()->second.exclusive);
+  s = txn1->Put("foo", "bar");
+  ASSERT_TRUE(s.IsTimedOut());
+  ASSERT_OK(txn3->Put("foo", "bar3"));
+  ASSERT_OK(txn3->Commit());
+  ASSERT_EQ(db->GetLockStatusData().size(), 0);
+
+  // Locks of an expired transaction can be stolen
+  txn_options.expiration = 0;
+  Transaction* txn4 = db->BeginTransaction(write_options, txn_options);
+  ASSERT_OK(txn4->Put("foo", "bar4"));
+  ASSERT_OK(txn1->Put("foo", "bar1"));
+  ASSERT_OK(txn1->Commit());
+  ASSERT_TRUE(txn4->Commit().IsExpired());
+  std::string value;
+  ASSERT_OK(db->Get(read_options, "foo", &value));
+  ASSERT_EQ(value, "bar1");
+
+  delete txn1;
+  delete txn2;
+  delete txn3;
+  delete txn4;
+}
+
+TEST_P(TransactionTest, ScalableLockMgrWaitingTxn) {
+  WriteOptions write_options;
+  ReadOptions read_options;
+  TransactionOptions txn_options;
+
+  delete db;
+  db = nullptr;
+  txn_db_options.lock_manager = TxnDBLockManager::SCALABLE_LOCK_MANAGER;
+  ASSERT_OK(ReOpen());
+
+  txn_options.lock_timeout = 1000000;
+  txn_options.deadlock_detect = true;
+  Transaction* txn1 = db->BeginTransaction(write_options, txn_options);
+  Transaction* txn2 = db->BeginTransaction(write_options, txn_options);
+  TransactionID id1 = txn1->GetID();
+
+  std::atomic<int> waiting(0);
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "ScalableLockMgr::AcquireWithTimeout:WaitingTxn", [&](void* /*arg*/) {
+        std::string key;
+        uint32_t cf_id;
+        std::vector<TransactionID> wait = txn2->GetWaitingTxns(&cf_id, &key);
+        ASSERT_EQ(key, "A");
+        ASSERT_EQ(wait.size(), 1);
+        ASSERT_EQ(wait[0], id1);
+        ASSERT_EQ(cf_id, 0U);
+        waiting++;
+      });
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+  ASSERT_OK(txn1->Put("A", "a1"));
+  ASSERT_OK(txn2->Put("B", "b2"));
+
+  // txn2 waits for txn1
+  port::Thread t([&]() { ASSERT_OK(txn2->Put("A", "a2")); });
+  while (waiting.load() == 0) {
+    env->SleepForMicroseconds(1000);
+  }
+
+  // txn1 waiting for txn2 closes a cycle
+  Status s = txn1->Put("B", "b1");
+  ASSERT_TRUE(s.IsDeadlock());
+  auto dlock_buffer = db->GetDeadlockInfoBuffer();
+  ASSERT_EQ(dlock_buffer.size(), 1);
+  ASSERT_EQ(dlock_buffer[0].path.size(), 2);
+
+  // Releasing the key hands it to txn2
+  ASSERT_OK(txn1->Rollback());
+  t.join();
+  ASSERT_OK(txn2->Commit());
+  std::string value;
+  ASSERT_OK(db->Get(read_options, "A", &value));
+  ASSERT_EQ(value, "a2");
+
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+  rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  delete txn1;
+  delete txn2;
+}
+
+TEST_P(TransactionTest, ScalableLockMgrLockLimit) {
+  WriteOptions write_options;
+  TransactionOptions txn_options;
+
+  delete db;
+  db = nullptr;
+  txn_db_options.max_num_locks = 3;
+  txn_db_options.lock_manager = TxnDBLockManager::SCALABLE_LOCK_MANAGER;
+  ASSERT_OK(ReOpen());
+
+  Transaction* txn1 = db->BeginTransaction(write_options, txn_options);
+  Transaction* txn2 = db->BeginTransaction(write_options, txn_options);
+
+  ASSERT_OK(txn1->Put("X", "x"));
+  ASSERT_OK(txn1->Put("Y", "y"));
+  ASSERT_OK(txn2->GetForUpdate(ReadOptions(), "Z", nullptr, false));
+  ASSERT_TRUE(txn1->Put("W", "w").IsBusy());
+  // Sharing a locked key does not count against the limit
+  ASSERT_OK(txn1->GetForUpdate(ReadOptions(), "Z", nullptr, false));
+  ASSERT_OK(txn1->Put("X", "xx"));
+
+  ASSERT_OK(txn2->Rollback());
+  ASSERT_TRUE(txn2->Put("W", "w").IsBusy());
+  ASSERT_OK(txn1->Commit());
+  ASSERT_OK(txn2->Put("W", "w"));
+  ASSERT_OK(txn2->Put("X", "x2"));
+  ASSERT_OK(txn2->Put("Y", "y2"));
+  ASSERT_TRUE(txn2->Put("Z", "z2").IsBusy());
+  ASSERT_OK(txn2->Commit());
+
+  delete txn1;
+  delete txn2;
+}
+
+TEST_P(TransactionTest, RangeLockTest) {
+  WriteOptions write_options;
+  ReadOptions read_options;
+  TransactionOptions txn_options;
+  std::string value;
+
+  for (auto lock_manager : {TxnDBLockManager::STRIPED_LOCK_MANAGER,
+                            TxnDBLockManager::SCALABLE_LOCK_MANAGER}) {
+    delete db;
+    db = nullptr;
+    txn_db_options.lock_manager = lock_manager;
+    ASSERT_OK(ReOpen());
+
+    txn_options.lock_timeout = 1;
+    Transaction* txn1 = db->BeginTransaction(write_options, txn_options);
+    Transaction* txn2 = db->BeginTransaction(write_options, txn_options);
+
+    ASSERT_TRUE(txn1->GetRangeLock(db->DefaultColumnFamily(), "d", "b")
+                    .IsInvalidArgument());
+    ASSERT_OK(txn1->GetRangeLock(db->DefaultColumnFamily(), "b", "d"));
+
+    // Keys in the range, including missing ones, and overlapping ranges are
+    // locked for other transactions
+    Status s = txn2->Put("c", "c2");
+    ASSERT_TRUE(s.IsTimedOut());
+    s = txn2->GetForUpdate(read_options, "b", &value);
+    ASSERT_TRUE(s.IsTimedOut());
+    s = txn2->GetRangeLock(db->DefaultColumnFamily(), "d", "f");
+    ASSERT_TRUE(s.IsTimedOut());
+    ASSERT_OK(txn2->Put("a", "a2"));
+    ASSERT_OK(txn2->Put("e", "e2"));
+
+    // but not for the transaction itself
+    ASSERT_OK(txn1->Put("c", "c1"));
+    ASSERT_OK(txn1->Put("b", "b1"));
+    ASSERT_OK(txn1->GetRangeLock(db->DefaultColumnFamily(), "c", "d"));
+
+    // A range is not granted while other transactions hold keys in it, and
+    // a failed request keeps the ranges locked before
+    s = txn1->GetRangeLock(db->DefaultColumnFamily(), "a", "c");
+    ASSERT_TRUE(s.IsTimedOut());
+    s = txn2->Put("d", "d2");
+    ASSERT_TRUE(s.IsTimedOut());
+
+    // Rolling back to a save point keeps the ranges
+    txn1->SetSavePoint();
+    ASSERT_OK(txn1->GetRangeLock(db->DefaultColumnFamily(), "x", "z"));
+    ASSERT_OK(txn1->RollbackToSavePoint());
+    s = txn2->Put("y", "y2");
+    ASSERT_TRUE(s.IsTimedOut());
+
+    ASSERT_OK(txn1->Commit());
+    ASSERT_OK(txn2->Put("c", "c2"));
+    ASSERT_OK(txn2->Put("y", "y2"));
+    ASSERT_OK(txn2->GetRangeLock(db->DefaultColumnFamily(), "a", "f"));
+    ASSERT_OK(txn2->Commit());
+
+    ASSERT_OK(db->Get(read_options, "b", &value));
+    ASSERT_EQ(value, "b1");
+    ASSERT_OK(db->Get(read_options, "c", &value));
+    ASSERT_EQ(value, "c2");
+
+    delete txn1;
+    delete txn2;
+  }
+}
+
+TEST_P(TransactionTest, RangeLockWaitingTxn) {
+  WriteOptions write_options;
+  ReadOptions read_options;
+  TransactionOptions txn_options;
+
+  txn_options.lock_timeout = 1000000;
+  txn_options.deadlock_detect = true;
+  Transaction* txn1 = db->BeginTransaction(write_options, txn_options);
+  Transaction* txn2 = db->BeginTransaction(write_options, txn_options);
+  TransactionID id1 = txn1->GetID();
+
+  std::atomic<int> waiting(0);
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "RangeLockMgr::Wait:WaitingTxn", [&](void* /*arg*/) { waiting++; });
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+  ASSERT_OK(txn1->Put("m", "m1"));
+  ASSERT_OK(txn2->Put("x", "x2"));
+
+  // txn2 waits for the point lock of txn1
+  port::Thread t([&]() {
+    ASSERT_OK(txn2->GetRangeLock(db->DefaultColumnFamily(), "a", "n"));
+  });
+  while (waiting.load() == 0) {
+    env->SleepForMicroseconds(1000);
+  }
+  std::string key;
+  uint32_t cf_id;
+  std::vector<TransactionID> wait = txn2->GetWaitingTxns(&cf_id, &key);
+  ASSERT_EQ(key, "a");
+  ASSERT_EQ(wait.size(), 1);
+  ASSERT_EQ(wait[0], id1);
+  ASSERT_EQ(cf_id, 0U);
+
+  // Until the range is granted, txn1 can lock more keys in it, but other
+  // transactions cannot
+  ASSERT_OK(txn1->Put("b", "b1"));
+  TransactionOptions txn_options3;
+  txn_options3.lock_timeout = 1;
+  Transaction* txn3 = db->BeginTransaction(write_options, txn_options3);
+  Status s = txn3->Put("c", "c3");
+  ASSERT_TRUE(s.IsTimedOut());
+
+  // txn1 waiting for txn2 closes a cycle
+  s = txn1->Put("x", "x1");
+  ASSERT_TRUE(s.IsDeadlock());
+
+  // Releasing the point locks grants the range
+  ASSERT_OK(txn1->Rollback());
+  t.join();
+  s = txn3->Put("c", "c3");
+  ASSERT_TRUE(s.IsTimedOut());
+  ASSERT_OK(txn2->Put("b", "b2"));
+  ASSERT_OK(txn2->Commit());
+  ASSERT_OK(txn3->Put("c", "c3"));
+  ASSERT_OK(txn3->Commit());
+
+  std::string value;
+  ASSERT_OK(db->Get(read_options, "b", &value));
+  ASSERT_EQ(value, "b2");
+
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+  rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  delete txn1;
+  delete txn2;
+  delete txn3;
+}
+
+TEST_P(TransactionTest, RangeLockConcurrency) {
+  WriteOptions write_options;
+  ReadOptions read_options;
+  TransactionOptions txn_options;
+  const int kNumKeys = 8;
+  const int kNumThreads = 8;
+  const int kNumCommits = 50;
+
+  for (auto lock_manager : {TxnDBLockManager::STRIPED_LOCK_MANAGER,
+                            TxnDBLockManager::SCALABLE_LOCK_MANAGER}) {
+    delete db;
+    db = nullptr;
+    txn_db_options.lock_manager = lock_manager;
+    ASSERT_OK(ReOpen());
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_OK(db->Put(write_options, ToString(i), "0"));
+    }
+
+    // Half of the threads increment every key under a range lock, the other
+    // half increments two keys under point locks. Without mutual exclusion
+    // some increments are lost.
+    txn_options.lock_timeout = 1000000;
+    txn_options.deadlock_detect = true;
+    std::atomic<int> num_incs(0);
+    std::vector<port::Thread> threads;
+    for (int t = 0; t < kNumThreads; t++) {
+      threads.emplace_back([&, t]() {
+        Random rnd(t + 1);
+        int commits = 0;
+        while (commits < kNumCommits) {
+          Transaction* txn = db->BeginTransaction(write_options, txn_options);
+          std::vector<std::string> keys;
+          Status s;
+          if (t % 2 == 0) {
+            s = txn->GetRangeLock(db->DefaultColumnFamily(), "0",
+                                  ToString(kNumKeys - 1));
+            for (int i = 0; i < kNumKeys; i++) {
+              keys.push_back(ToString(i));
+            }
+          } else {
+            keys.push_back(ToString(rnd.Uniform(kNumKeys)));
+            keys.push_back(ToString(rnd.Uniform(kNumKeys)));
+          }
+          for (size_t i = 0; s.ok() && i < keys.size(); i++) {
+            std::string value;
+            s = txn->GetForUpdate(read_options, keys[i], &value);
+            if (s.ok()) {
+              s = txn->Put(keys[i], ToString(std::stoi(value) + 1));
+            }
+          }
+          if (s.ok()) {
+            ASSERT_OK(txn->Commit());
+            num_incs += static_cast<int>(keys.size());
+            commits++;
+          } else {
+            ASSERT_TRUE(s.IsDeadlock());
+            ASSERT_OK(txn->Rollback());
+          }
+          delete txn;
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+
+    int sum = 0;
+    for (int i = 0; i < kNumKeys; i++) {
+      std::string value;
+      ASSERT_OK(db->Get(read_options, ToString(i), &value));
+      sum += std::stoi(value);
+    }
+    ASSERT_EQ(sum, num_incs.load());
+  }
+}
+
 TEST_P(TransactionTest, IteratorTest) {
   // This test does writes without snapshot validation, and then tries to create
   // iterator later, which is unsupported in write unprepared.
@@ -153,6 +153,7 @@ Status TransactionUtil::CheckKeysForConflicts(DBImpl* db_impl,
 
     SequenceNumber earliest_seq =
         db_impl->GetEarliestMemTableSequenceNumber(sv, true);
+    const WriteSeqTable* write_seq_table = db_impl->write_seq_table();
 
     // For each of the keys in this transaction, check to see if someone has
     // written to this key since the start of the transaction.
@@ -160,6 +161,21 @@ Status TransactionUtil::CheckKeysForConflicts(DBImpl* db_impl,
       const auto& key = key_iter.first;
       const SequenceNumber key_seq = key_iter.second.seq;
 
+      if (write_seq_table != nullptr) {
+        bool known = false;
+        bool written =
+            write_seq_table->MayHaveWrittenAfter(cf_id, key, key_seq, &known);
+        if (known) {
+          if (written) {
+            result = Status::Busy();
+            break;
+          }
+          continue;
+        }
+        // The key was tracked before the table was created, fall back to the
+        // memtables.
+      }
+
       result = CheckKey(db_impl, sv, earliest_seq, key_seq, key, cache_only);
 
       if (!result.ok()) {
@@ -9,6 +9,8 @@
 
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "db/dbformat.h"
 #include "db/read_callback.h"
@@ -45,6 +47,11 @@ using TransactionKeyMap =
     std::unordered_map<uint32_t,
                        std::unordered_map<std::string, TransactionKeyMapInfo>>;
 
+// The [start, end] key ranges locked by a transaction, per column family
+using TransactionRangeMap =
+    std::unordered_map<uint32_t,
+                       std::vector<std::pair<std::string, std::string>>>;
+
 class DBImpl;
 struct SuperVersion;
 class WriteBatchWithIndex;
@@ -77,7 +84,8 @@ class TransactionUtil {
   // status for any unexpected errors.
   //
   // REQUIRED: this function should only be called on the write thread or if the
-  // mutex is held.
+  // mutex is held, or with the keys locked against concurrent writers until
+  // the caller's write is done.
   static Status CheckKeysForConflicts(DBImpl* db_impl,
                                       const TransactionKeyMap& keys,
                                       bool cache_only);
@@ -23,6 +23,7 @@
 #include "util/mutexlock.h"
 #include "util/string_util.h"
 #include "utilities/transactions/pessimistic_transaction.h"
+#include "utilities/transactions/read_only_txn.h"
 #include "utilities/transactions/transaction_db_mutex_impl.h"
 
 namespace rocksdb {
@@ -112,6 +113,12 @@ Transaction* WritePreparedTxnDB::BeginTransaction(
   }
 }
 
+ReadOnlyTransaction* WritePreparedTxnDB::BeginReadOnlyTransaction(
+    const ReadOnlyTransactionOptions& txn_options,
+    const std::vector<ColumnFamilyHandle*>& column_families) {
+  return new ReadOnlyTxn(this, db_impl_, this, txn_options, column_families);
+}
+
 Status WritePreparedTxnDB::Write(const WriteOptions& opts,
                                  WriteBatch* updates) {
   if (txn_db_options_.skip_concurrency_control) {
@@ -747,8 +754,6 @@ void WritePreparedTxnDB::AdvanceSeqByOne() {
 const std::vector<SequenceNumber> WritePreparedTxnDB::GetSnapshotListFromDB(
     SequenceNumber max) {
   ROCKS_LOG_DETAILS(info_log_, "GetSnapshotListFromDB with max %" PRIu64, max);
-  InstrumentedMutexLock dblock(db_impl_->mutex());
-  db_impl_->mutex()->AssertHeld();
   return db_impl_->snapshots().GetAll(nullptr, max);
 }
 
@@ -69,6 +69,10 @@ class WritePreparedTxnDB : public PessimisticTransactionDB {
                                 const TransactionOptions& txn_options,
                                 Transaction* old_txn) override;
 
+  ReadOnlyTransaction* BeginReadOnlyTransaction(
+      const ReadOnlyTransactionOptions& txn_options,
+      const std::vector<ColumnFamilyHandle*>& column_families) override;
+
   using TransactionDB::Write;
   Status Write(const WriteOptions& opts, WriteBatch* updates) override;
 
@@ -105,6 +109,16 @@ class WritePreparedTxnDB : public PessimisticTransactionDB {
       const std::vector<ColumnFamilyHandle*>& column_families,
       std::vector<Iterator*>* iterators) override;
 
+  // Scans through NewIterator() above, which hides uncommitted data, rather
+  // than through the base DB's scan cache.
+  using DB::Scan;
+  virtual Status Scan(
+      const ReadOptions& options, ColumnFamilyHandle* column_family,
+      const Slice& start, size_t limit, std::vector<std::string>* keys,
+      std::vector<std::string>* values) override {
+    return DB::Scan(options, column_family, start, limit, keys, values);
+  }
+
   // Check whether the transaction that wrote the value with sequence number seq
   // is visible to the snapshot with sequence number snapshot_seq.
   // Returns true if commit_seq <= snapshot_seq
@@ -470,6 +484,7 @@ class WritePreparedTxnDB : public PessimisticTransactionDB {
   friend class PreparedHeap_BasicsTest_Test;
   friend class PreparedHeap_Concurrent_Test;
   friend class PreparedHeap_EmptyAtTheEnd_Test;
+  friend class ReadOnlyTxn;
   friend class SnapshotConcurrentAccessTest_SnapshotConcurrentAccessTest_Test;
   friend class WritePreparedCommitEntryPreReleaseCallback;
   friend class WritePreparedTransactionTestBase;
@@ -693,6 +693,7 @@ Status WriteUnpreparedTxn::RollbackInternal() {
 void WriteUnpreparedTxn::Clear() {
   if (!recovered_txn_) {
     txn_db_impl_->UnLock(this, &GetTrackedKeys());
+    UnLockRanges();
   }
   unprep_seqs_.clear();
   flushed_save_points_.reset(nullptr);
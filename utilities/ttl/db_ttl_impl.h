@@ -80,6 +80,16 @@ class DBWithTTLImpl : public DBWithTTL {
   virtual Iterator* NewIterator(const ReadOptions& opts,
                                 ColumnFamilyHandle* column_family) override;
 
+  // Scans through NewIterator() above, which strips the timestamps, rather
+  // than through the base DB's scan cache.
+  using StackableDB::Scan;
+  virtual Status Scan(
+      const ReadOptions& options, ColumnFamilyHandle* column_family,
+      const Slice& start, size_t limit, std::vector<std::string>* keys,
+      std::vector<std::string>* values) override {
+    return DB::Scan(options, column_family, start, limit, keys, values);
+  }
+
   virtual DB* GetBaseDB() override { return db_; }
 
   static bool IsStale(const Slice& value, int32_t ttl, Env* env);
@@ -66,6 +66,13 @@ class TtlTest : public testing::Test {
     ASSERT_OK(DBWithTTL::Open(options_, dbname_, &db_ttl_));
   }
 
+  // Open database with TTL support and a scan cache in the base DB
+  void OpenTtlWithScanCache() {
+    ASSERT_TRUE(db_ttl_ == nullptr);
+    options_.scan_cache_size = 1 << 20;
+    ASSERT_OK(DBWithTTL::Open(options_, dbname_, &db_ttl_));
+  }
+
   // Open database with TTL support when TTL provided with db_ttl_ pointer
   void OpenTtl(int32_t ttl) {
     ASSERT_TRUE(db_ttl_ == nullptr);
@@ -225,6 +232,21 @@ class TtlTest : public testing::Test {
     }
   }
 
+  // Scans all of kvmap_ and checks that the values come back without their
+  // timestamps
+  void SimpleScanTest() {
+    std::vector<std::string> keys, values;
+    ASSERT_OK(db_ttl_->Scan(ReadOptions(), kvmap_.begin()->first,
+                            kvmap_.size(), &keys, &values));
+    ASSERT_EQ(kvmap_.size(), keys.size());
+    size_t i = 0;
+    for (auto& kv : kvmap_) {
+      ASSERT_EQ(kv.first, keys[i]);
+      ASSERT_EQ(kv.second, values[i]);
+      ++i;
+    }
+  }
+
   // Sleeps for slp_tim then runs a manual compaction
   // Checks span starting from st_pos from kvmap_ in the db and
   // Gets should return true if check is true and false otherwise
@@ -605,6 +627,20 @@ TEST_F(TtlTest, MultiGetTest) {
   CloseTtl();
 }
 
+TEST_F(TtlTest, ScanTest) {
+  MakeKVMap(kSampleSize_);
+
+  OpenTtlWithScanCache();
+  PutValues(0, kSampleSize_, false);
+
+  // Scans must not return the base DB's values, which carry timestamps,
+  // even once they could have been cached there
+  SimpleScanTest();
+  SimpleScanTest();
+
+  CloseTtl();
+}
+
 TEST_F(TtlTest, ColumnFamiliesTest) {
   DB* db;
   Options options;
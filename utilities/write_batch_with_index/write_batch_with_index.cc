@@ -7,14 +7,14 @@
 
 #include "rocksdb/utilities/write_batch_with_index.h"
 
+#include <string.h>
+
 #include <memory>
 
 #include "db/column_family.h"
 #include "db/db_impl/db_impl.h"
 #include "db/merge_context.h"
 #include "db/merge_helper.h"
-#include "memory/arena.h"
-#include "memtable/skiplist.h"
 #include "options/db_options.h"
 #include "rocksdb/comparator.h"
 #include "rocksdb/iterator.h"
@@ -339,45 +339,40 @@ class BaseDeltaIterator : public Iterator {
   const Slice* iterate_upper_bound_;
 };
 
-typedef SkipList<WriteBatchIndexEntry*, const WriteBatchEntryComparator&>
-    WriteBatchEntrySkipList;
-
 class WBWIIteratorImpl : public WBWIIterator {
  public:
-  WBWIIteratorImpl(uint32_t column_family_id,
-                   WriteBatchEntrySkipList* skip_list,
+  WBWIIteratorImpl(uint32_t column_family_id, WriteBatchEntryIndex* index,
                    const ReadableWriteBatch* write_batch)
       : column_family_id_(column_family_id),
-        skip_list_iter_(skip_list),
+        index_iter_(index),
         write_batch_(write_batch) {}
 
   ~WBWIIteratorImpl() override {}
 
   bool Valid() const override {
-    if (!skip_list_iter_.Valid()) {
+    if (!index_iter_.Valid()) {
       return false;
     }
-    const WriteBatchIndexEntry* iter_entry = skip_list_iter_.key();
-    return (iter_entry != nullptr &&
-            iter_entry->column_family == column_family_id_);
+    const WriteBatchIndexEntry* iter_entry = index_iter_.key();
+    return iter_entry->column_family == column_family_id_;
   }
 
   void SeekToFirst() override {
     WriteBatchIndexEntry search_entry(
         nullptr /* search_key */, column_family_id_,
         true /* is_forward_direction */, true /* is_seek_to_first */);
-    skip_list_iter_.Seek(&search_entry);
+    index_iter_.Seek(&search_entry);
   }
 
   void SeekToLast() override {
     WriteBatchIndexEntry search_entry(
         nullptr /* search_key */, column_family_id_ + 1,
         true /* is_forward_direction */, true /* is_seek_to_first */);
-    skip_list_iter_.Seek(&search_entry);
-    if (!skip_list_iter_.Valid()) {
-      skip_list_iter_.SeekToLast();
+    index_iter_.Seek(&search_entry);
+    if (!index_iter_.Valid()) {
+      index_iter_.SeekToLast();
     } else {
-      skip_list_iter_.Prev();
+      index_iter_.Prev();
     }
   }
 
@@ -385,24 +380,24 @@ class WBWIIteratorImpl : public WBWIIterator {
     WriteBatchIndexEntry search_entry(&key, column_family_id_,
                                       true /* is_forward_direction */,
                                       false /* is_seek_to_first */);
-    skip_list_iter_.Seek(&search_entry);
+    index_iter_.Seek(&search_entry);
   }
 
   void SeekForPrev(const Slice& key) override {
     WriteBatchIndexEntry search_entry(&key, column_family_id_,
                                       false /* is_forward_direction */,
                                       false /* is_seek_to_first */);
-    skip_list_iter_.SeekForPrev(&search_entry);
+    index_iter_.SeekForPrev(&search_entry);
   }
 
-  void Next() override { skip_list_iter_.Next(); }
+  void Next() override { index_iter_.Next(); }
 
-  void Prev() override { skip_list_iter_.Prev(); }
+  void Prev() override { index_iter_.Prev(); }
 
   WriteEntry Entry() const override {
     WriteEntry ret;
     Slice blob, xid;
-    const WriteBatchIndexEntry* iter_entry = skip_list_iter_.key();
+    const WriteBatchIndexEntry* iter_entry = index_iter_.key();
     // this is guaranteed with Valid()
     assert(iter_entry != nullptr &&
            iter_entry->column_family == column_family_id_);
@@ -422,12 +417,12 @@ class WBWIIteratorImpl : public WBWIIterator {
   }
 
   const WriteBatchIndexEntry* GetRawEntry() const {
-    return skip_list_iter_.key();
+    return index_iter_.key();
   }
 
  private:
   uint32_t column_family_id_;
-  WriteBatchEntrySkipList::Iterator skip_list_iter_;
+  WriteBatchEntryIndex::Iterator index_iter_;
   const ReadableWriteBatch* write_batch_;
 };
 
@@ -435,16 +430,15 @@ struct WriteBatchWithIndex::Rep {
   explicit Rep(const Comparator* index_comparator, size_t reserved_bytes = 0,
                size_t max_bytes = 0, bool _overwrite_key = false)
       : write_batch(reserved_bytes, max_bytes),
-        comparator(index_comparator, &write_batch),
-        skip_list(comparator, &arena),
+        comparator(index_comparator),
+        index(comparator),
         overwrite_key(_overwrite_key),
         last_entry_offset(0),
         last_sub_batch_offset(0),
         sub_batch_cnt(1) {}
   ReadableWriteBatch write_batch;
   WriteBatchEntryComparator comparator;
-  Arena arena;
-  WriteBatchEntrySkipList skip_list;
+  WriteBatchEntryIndex index;
   bool overwrite_key;
   size_t last_entry_offset;
   // The starting offset of the last sub-batch. A sub-batch starts right before
@@ -469,9 +463,9 @@ struct WriteBatchWithIndex::Rep {
   void AddOrUpdateIndex(ColumnFamilyHandle* column_family, const Slice& key);
   void AddOrUpdateIndex(const Slice& key);
 
-  // Allocate an index entry pointing to the last entry in the write batch and
-  // put it to skip list.
-  void AddNewEntry(uint32_t column_family_id);
+  // Allocate an index entry pointing to the last entry in the write batch,
+  // whose key is key, and put it to the index.
+  void AddNewEntry(uint32_t column_family_id, const Slice& key);
 
   // Clear all updates buffered in this batch.
   void Clear();
@@ -494,16 +488,20 @@ bool WriteBatchWithIndex::Rep::UpdateExistingEntryWithCfId(
     return false;
   }
 
-  WBWIIteratorImpl iter(column_family_id, &skip_list, &write_batch);
-  iter.Seek(key);
+  WriteBatchIndexEntry search_entry(&key, column_family_id,
+                                    true /* is_forward_direction */,
+                                    false /* is_seek_to_first */);
+  WriteBatchEntryIndex::Iterator iter(&index);
+  iter.Seek(&search_entry);
   if (!iter.Valid()) {
     return false;
   }
-  if (comparator.CompareKey(column_family_id, key, iter.Entry().key) != 0) {
+  WriteBatchIndexEntry* non_const_entry = iter.key();
+  if (non_const_entry->column_family != column_family_id ||
+      comparator.CompareKey(column_family_id, key, non_const_entry->key()) !=
+          0) {
     return false;
   }
-  WriteBatchIndexEntry* non_const_entry =
-      const_cast<WriteBatchIndexEntry*>(iter.GetRawEntry());
   if (LIKELY(last_sub_batch_offset <= non_const_entry->offset)) {
     last_sub_batch_offset = last_entry_offset;
     sub_batch_cnt++;
@@ -520,32 +518,27 @@ void WriteBatchWithIndex::Rep::AddOrUpdateIndex(
     if (cf_cmp != nullptr) {
       comparator.SetComparatorForCF(cf_id, cf_cmp);
     }
-    AddNewEntry(cf_id);
+    AddNewEntry(cf_id, key);
   }
 }
 
 void WriteBatchWithIndex::Rep::AddOrUpdateIndex(const Slice& key) {
   if (!UpdateExistingEntryWithCfId(0, key)) {
-    AddNewEntry(0);
+    AddNewEntry(0, key);
   }
 }
 
-void WriteBatchWithIndex::Rep::AddNewEntry(uint32_t column_family_id) {
-  const std::string& wb_data = write_batch.Data();
-  Slice entry_ptr = Slice(wb_data.data() + last_entry_offset,
-                          wb_data.size() - last_entry_offset);
-  // Extract key
-  Slice key;
-  bool success __attribute__((__unused__));
-  success =
-      ReadKeyFromWriteBatchEntry(&entry_ptr, &key, column_family_id != 0);
-  assert(success);
-
-  auto* mem = arena.Allocate(sizeof(WriteBatchIndexEntry));
-  auto* index_entry =
-      new (mem) WriteBatchIndexEntry(last_entry_offset, column_family_id,
-                                      key.data() - wb_data.data(), key.size());
-  skip_list.Insert(index_entry);
+void WriteBatchWithIndex::Rep::AddNewEntry(uint32_t column_family_id,
+                                           const Slice& key) {
+  // The key is copied right after the entry
+  char* mem = index.Allocate(sizeof(WriteBatchIndexEntry) + key.size());
+  char* key_data = mem + sizeof(WriteBatchIndexEntry);
+  if (key.size() > 0) {
+    memcpy(key_data, key.data(), key.size());
+  }
+  auto* index_entry = new (mem) WriteBatchIndexEntry(
+      last_entry_offset, column_family_id, key_data, key.size());
+  index.Insert(index_entry);
 }
 
 void WriteBatchWithIndex::Rep::Clear() {
@@ -554,10 +547,7 @@ void WriteBatchWithIndex::Rep::Clear() {
 }
 
 void WriteBatchWithIndex::Rep::ClearIndex() {
-  skip_list.~WriteBatchEntrySkipList();
-  arena.~Arena();
-  new (&arena) Arena();
-  new (&skip_list) WriteBatchEntrySkipList(comparator, &arena);
+  index.Clear();
   last_entry_offset = 0;
   last_sub_batch_offset = 0;
   sub_batch_cnt = 1;
@@ -605,7 +595,7 @@ Status WriteBatchWithIndex::Rep::ReBuildIndex() {
       case kTypeMerge:
         found++;
         if (!UpdateExistingEntryWithCfId(column_family_id, key)) {
-          AddNewEntry(column_family_id);
+          AddNewEntry(column_family_id, key);
         }
         break;
       case kTypeLogData:
@@ -648,13 +638,13 @@ WriteBatch* WriteBatchWithIndex::GetWriteBatch() { return &rep->write_batch; }
 size_t WriteBatchWithIndex::SubBatchCnt() { return rep->sub_batch_cnt; }
 
 WBWIIterator* WriteBatchWithIndex::NewIterator() {
-  return new WBWIIteratorImpl(0, &(rep->skip_list), &rep->write_batch);
+  return new WBWIIteratorImpl(0, &(rep->index), &rep->write_batch);
 }
 
 WBWIIterator* WriteBatchWithIndex::NewIterator(
     ColumnFamilyHandle* column_family) {
   return new WBWIIteratorImpl(GetColumnFamilyID(column_family),
-                              &(rep->skip_list), &rep->write_batch);
+                              &(rep->index), &rep->write_batch);
 }
 
 Iterator* WriteBatchWithIndex::NewIteratorWithBase(
@@ -7,12 +7,17 @@
 
 #include "utilities/write_batch_with_index/write_batch_with_index_internal.h"
 
+#include <string.h>
+
+#include <algorithm>
+
 #include "db/column_family.h"
 #include "db/merge_context.h"
 #include "db/merge_helper.h"
 #include "rocksdb/comparator.h"
 #include "rocksdb/db.h"
 #include "rocksdb/utilities/write_batch_with_index.h"
+#include "util/autovector.h"
 #include "util/coding.h"
 #include "util/string_util.h"
 
@@ -88,13 +93,13 @@ Status ReadableWriteBatch::GetEntryFromDataOffset(size_t data_offset,
 // If both of `entry1` and `entry2` point to real entry in write batch, we
 // compare the entries as following:
 // 1. first compare the column family, the one with larger CF will be larger;
-// 2. Inside the same CF, we first decode the entry to find the key of the entry
-//    and the entry with larger key will be larger;
+// 2. Inside the same CF, we compare the keys that the index copied next to the
+//    entries, and the entry with larger key will be larger;
 // 3. If two entries are of the same CF and offset, the one with larger offset
 //    will be larger.
 // Some times either `entry1` or `entry2` is dummy entry, which is actually
-// a search key. In this case, in step 2, we don't go ahead and decode the
-// entry but use the value in WriteBatchIndexEntry::search_key.
+// a search key. In this case, in step 2, we use the value in
+// WriteBatchIndexEntry::search_key.
 // One special case is WriteBatchIndexEntry::key_size is kFlagMinInCf.
 // This indicate that we are going to seek to the first of the column family.
 // Once we see this, this entry will be smaller than all the real entries of
@@ -117,14 +122,12 @@ int WriteBatchEntryComparator::operator()(
 
   Slice key1, key2;
   if (entry1->search_key == nullptr) {
-    key1 = Slice(write_batch_->Data().data() + entry1->key_offset,
-                 entry1->key_size);
+    key1 = entry1->key();
   } else {
     key1 = *(entry1->search_key);
   }
   if (entry2->search_key == nullptr) {
-    key2 = Slice(write_batch_->Data().data() + entry2->key_offset,
-                 entry2->key_size);
+    key2 = entry2->key();
   } else {
     key2 = *(entry2->search_key);
   }
@@ -151,6 +154,338 @@ int WriteBatchEntryComparator::CompareKey(uint32_t column_family,
   }
 }
 
+namespace {
+const size_t kIndexAlignment = 8;
+const size_t kMinIndexBlockSize = 4096;
+const size_t kMaxIndexBlockSize = 256 << 10;
+}  // anonymous namespace
+
+struct WriteBatchEntryIndex::LeafNode : public Node {
+  LeafNode* prev;
+  LeafNode* next;
+  WriteBatchIndexEntry* entries[kNodeSlots];
+};
+
+struct WriteBatchEntryIndex::InnerNode : public Node {
+  // keys[i] is the smallest entry under children[i], for i > 0.
+  WriteBatchIndexEntry* keys[kNodeSlots];
+  Node* children[kNodeSlots];
+};
+
+struct WriteBatchEntryIndex::Path {
+  // The inner nodes from the root to a leaf, with the index of the child
+  // taken in each of them.
+  autovector<std::pair<InnerNode*, size_t>, 8> nodes;
+};
+
+WriteBatchEntryIndex::WriteBatchEntryIndex(const WriteBatchEntryComparator& cmp)
+    : cmp_(cmp),
+      root_(nullptr),
+      first_leaf_(nullptr),
+      last_leaf_(nullptr),
+      version_(0),
+      blocks_in_use_(0),
+      alloc_ptr_(nullptr),
+      alloc_bytes_remaining_(0) {}
+
+char* WriteBatchEntryIndex::Allocate(size_t bytes) {
+  assert(bytes > 0);
+  bytes = (bytes + kIndexAlignment - 1) & ~(kIndexAlignment - 1);
+  if (bytes <= alloc_bytes_remaining_) {
+    char* result = alloc_ptr_;
+    alloc_ptr_ += bytes;
+    alloc_bytes_remaining_ -= bytes;
+    return result;
+  }
+  return AllocateFallback(bytes);
+}
+
+char* WriteBatchEntryIndex::AllocateFallback(size_t bytes) {
+  if (bytes > kMinIndexBlockSize / 4) {
+    // Like Arena, give large requests their own block, so that the rest of
+    // the current block is not wasted.
+    irregular_blocks_.emplace_back(new char[bytes]);
+    return irregular_blocks_.back().get();
+  }
+
+  if (blocks_in_use_ == blocks_.size()) {
+    size_t block_size = kMinIndexBlockSize;
+    if (!blocks_.empty()) {
+      block_size = std::min(blocks_.back().second * 2, kMaxIndexBlockSize);
+    }
+    blocks_.emplace_back(std::unique_ptr<char[]>(new char[block_size]),
+                         block_size);
+  }
+  // Continue with the next block, which may have been kept by Clear()
+  auto& block = blocks_[blocks_in_use_++];
+  alloc_ptr_ = block.first.get() + bytes;
+  alloc_bytes_remaining_ = block.second - bytes;
+  return block.first.get();
+}
+
+void WriteBatchEntryIndex::Clear() {
+  root_ = nullptr;
+  first_leaf_ = nullptr;
+  last_leaf_ = nullptr;
+  version_++;
+  irregular_blocks_.clear();
+  blocks_in_use_ = 0;
+  alloc_ptr_ = nullptr;
+  alloc_bytes_remaining_ = 0;
+}
+
+WriteBatchEntryIndex::LeafNode* WriteBatchEntryIndex::NewLeaf() {
+  auto* leaf = new (Allocate(sizeof(LeafNode))) LeafNode();
+  leaf->is_leaf = true;
+  leaf->num = 0;
+  leaf->prev = nullptr;
+  leaf->next = nullptr;
+  return leaf;
+}
+
+WriteBatchEntryIndex::InnerNode* WriteBatchEntryIndex::NewInner() {
+  auto* inner = new (Allocate(sizeof(InnerNode))) InnerNode();
+  inner->is_leaf = false;
+  inner->num = 0;
+  return inner;
+}
+
+WriteBatchEntryIndex::LeafNode* WriteBatchEntryIndex::FindLeaf(
+    const WriteBatchIndexEntry* target, bool or_equal, Path* path) const {
+  assert(root_ != nullptr);
+  Node* node = root_;
+  while (!node->is_leaf) {
+    auto* inner = static_cast<InnerNode*>(node);
+    // Take the last child whose smallest entry is less than target (or equal
+    // to it if or_equal), or the first one.
+    size_t lo = 1;
+    size_t hi = inner->num;
+    while (lo < hi) {
+      size_t mid = lo + (hi - lo) / 2;
+      int c = cmp_(inner->keys[mid], target);
+      if (c < 0 || (or_equal && c == 0)) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    if (path != nullptr) {
+      path->nodes.emplace_back(inner, lo - 1);
+    }
+    node = inner->children[lo - 1];
+  }
+  return static_cast<LeafNode*>(node);
+}
+
+size_t WriteBatchEntryIndex::FindInLeaf(const LeafNode* leaf,
+                                        const WriteBatchIndexEntry* target,
+                                        bool or_equal) const {
+  size_t lo = 0;
+  size_t hi = leaf->num;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    int c = cmp_(leaf->entries[mid], target);
+    if (c < 0 || (or_equal && c == 0)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+void WriteBatchEntryIndex::Insert(WriteBatchIndexEntry* entry) {
+  version_++;
+  if (root_ == nullptr) {
+    LeafNode* leaf = NewLeaf();
+    leaf->entries[0] = entry;
+    leaf->num = 1;
+    root_ = first_leaf_ = last_leaf_ = leaf;
+    return;
+  }
+
+  Path path;
+  LeafNode* leaf = FindLeaf(entry, false /* or_equal */, &path);
+  size_t pos = FindInLeaf(leaf, entry, false /* or_equal */);
+  if (leaf->num < kNodeSlots) {
+    memmove(&leaf->entries[pos + 1], &leaf->entries[pos],
+            (leaf->num - pos) * sizeof(leaf->entries[0]));
+    leaf->entries[pos] = entry;
+    leaf->num++;
+    return;
+  }
+
+  // Split the full leaf in halves, unless the entry is appended to the last
+  // leaf: then it starts a new leaf, which keeps the leaves full when the
+  // keys are written in order.
+  size_t split = kNodeSlots / 2;
+  if (pos == kNodeSlots && leaf->next == nullptr) {
+    split = kNodeSlots;
+  }
+  LeafNode* right = NewLeaf();
+  memcpy(&right->entries[0], &leaf->entries[split],
+         (kNodeSlots - split) * sizeof(leaf->entries[0]));
+  right->num = static_cast<uint32_t>(kNodeSlots - split);
+  leaf->num = static_cast<uint32_t>(split);
+  right->prev = leaf;
+  right->next = leaf->next;
+  if (leaf->next != nullptr) {
+    leaf->next->prev = right;
+  } else {
+    last_leaf_ = right;
+  }
+  leaf->next = right;
+
+  LeafNode* target = leaf;
+  if (pos > split || split == kNodeSlots) {
+    target = right;
+    pos -= split;
+  }
+  memmove(&target->entries[pos + 1], &target->entries[pos],
+          (target->num - pos) * sizeof(target->entries[0]));
+  target->entries[pos] = entry;
+  target->num++;
+
+  InsertIntoParent(&path, leaf, right->entries[0], right);
+}
+
+void WriteBatchEntryIndex::InsertIntoParent(Path* path, Node* left,
+                                            WriteBatchIndexEntry* separator,
+                                            Node* right) {
+  if (path->nodes.empty()) {
+    // left was the root
+    InnerNode* root = NewInner();
+    root->children[0] = left;
+    root->children[1] = right;
+    root->keys[1] = separator;
+    root->num = 2;
+    root_ = root;
+    return;
+  }
+
+  InnerNode* parent = path->nodes.back().first;
+  size_t idx = path->nodes.back().second + 1;
+  path->nodes.pop_back();
+  if (parent->num < kNodeSlots) {
+    memmove(&parent->keys[idx + 1], &parent->keys[idx],
+            (parent->num - idx) * sizeof(parent->keys[0]));
+    memmove(&parent->children[idx + 1], &parent->children[idx],
+            (parent->num - idx) * sizeof(parent->children[0]));
+    parent->keys[idx] = separator;
+    parent->children[idx] = right;
+    parent->num++;
+    return;
+  }
+
+  // Split the full parent, and push up the smallest entry of its new right
+  // half.
+  WriteBatchIndexEntry* keys[kNodeSlots + 1];
+  Node* children[kNodeSlots + 1];
+  memcpy(&keys[0], &parent->keys[0], idx * sizeof(keys[0]));
+  memcpy(&children[0], &parent->children[0], idx * sizeof(children[0]));
+  keys[idx] = separator;
+  children[idx] = right;
+  memcpy(&keys[idx + 1], &parent->keys[idx],
+         (kNodeSlots - idx) * sizeof(keys[0]));
+  memcpy(&children[idx + 1], &parent->children[idx],
+         (kNodeSlots - idx) * sizeof(children[0]));
+
+  const size_t split = (kNodeSlots + 1) / 2;
+  InnerNode* new_right = NewInner();
+  memcpy(&parent->keys[0], &keys[0], split * sizeof(keys[0]));
+  memcpy(&parent->children[0], &children[0], split * sizeof(children[0]));
+  parent->num = static_cast<uint32_t>(split);
+  memcpy(&new_right->keys[0], &keys[split],
+         (kNodeSlots + 1 - split) * sizeof(keys[0]));
+  memcpy(&new_right->children[0], &children[split],
+         (kNodeSlots + 1 - split) * sizeof(children[0]));
+  new_right->num = static_cast<uint32_t>(kNodeSlots + 1 - split);
+
+  InsertIntoParent(path, parent, keys[split], new_right);
+}
+
+WriteBatchEntryIndex::Iterator::Iterator(const WriteBatchEntryIndex* index)
+    : index_(index),
+      leaf_(nullptr),
+      pos_(0),
+      version_(0),
+      entry_(nullptr) {}
+
+void WriteBatchEntryIndex::Iterator::SetPosition(const LeafNode* leaf,
+                                                 size_t pos) {
+  if (leaf != nullptr && pos >= leaf->num) {
+    // Leaves are never empty
+    leaf = leaf->next;
+    pos = 0;
+  }
+  leaf_ = leaf;
+  pos_ = pos;
+  version_ = index_->version_;
+  entry_ = leaf != nullptr ? leaf->entries[pos] : nullptr;
+}
+
+void WriteBatchEntryIndex::Iterator::Sync() {
+  if (entry_ != nullptr && version_ != index_->version_) {
+    WriteBatchIndexEntry* entry = entry_;
+    const LeafNode* leaf = index_->FindLeaf(entry, false, nullptr);
+    SetPosition(leaf, index_->FindInLeaf(leaf, entry, false));
+    assert(entry_ == entry);
+  }
+}
+
+void WriteBatchEntryIndex::Iterator::Next() {
+  assert(Valid());
+  Sync();
+  SetPosition(leaf_, pos_ + 1);
+}
+
+void WriteBatchEntryIndex::Iterator::Prev() {
+  assert(Valid());
+  Sync();
+  if (pos_ > 0) {
+    SetPosition(leaf_, pos_ - 1);
+  } else if (leaf_->prev != nullptr) {
+    SetPosition(leaf_->prev, leaf_->prev->num - 1);
+  } else {
+    SetPosition(nullptr, 0);
+  }
+}
+
+void WriteBatchEntryIndex::Iterator::Seek(const WriteBatchIndexEntry* target) {
+  if (index_->root_ == nullptr) {
+    SetPosition(nullptr, 0);
+    return;
+  }
+  const LeafNode* leaf = index_->FindLeaf(target, false, nullptr);
+  SetPosition(leaf, index_->FindInLeaf(leaf, target, false));
+}
+
+void WriteBatchEntryIndex::Iterator::SeekForPrev(
+    const WriteBatchIndexEntry* target) {
+  if (index_->root_ == nullptr) {
+    SetPosition(nullptr, 0);
+    return;
+  }
+  const LeafNode* leaf = index_->FindLeaf(target, true, nullptr);
+  size_t pos = index_->FindInLeaf(leaf, target, true);
+  if (pos > 0) {
+    SetPosition(leaf, pos - 1);
+  } else if (leaf->prev != nullptr) {
+    SetPosition(leaf->prev, leaf->prev->num - 1);
+  } else {
+    SetPosition(nullptr, 0);
+  }
+}
+
+void WriteBatchEntryIndex::Iterator::SeekToFirst() {
+  SetPosition(index_->first_leaf_, 0);
+}
+
+void WriteBatchEntryIndex::Iterator::SeekToLast() {
+  const LeafNode* leaf = index_->last_leaf_;
+  SetPosition(leaf, leaf != nullptr ? leaf->num - 1 : 0);
+}
+
 WriteBatchWithIndexInternal::Result WriteBatchWithIndexInternal::GetFromBatch(
     const ImmutableDBOptions& immuable_db_options, WriteBatchWithIndex* batch,
     ColumnFamilyHandle* column_family, const Slice& key,
@@ -165,28 +500,8 @@ WriteBatchWithIndexInternal::Result WriteBatchWithIndexInternal::GetFromBatch(
       std::unique_ptr<WBWIIterator>(batch->NewIterator(column_family));
 
   // We want to iterate in the reverse order that the writes were added to the
-  // batch.  Since we don't have a reverse iterator, we must seek past the end.
-  // TODO(agiardullo): consider adding support for reverse iteration
-  iter->Seek(key);
-  while (iter->Valid()) {
-    const WriteEntry entry = iter->Entry();
-    if (cmp->CompareKey(cf_id, entry.key, key) != 0) {
-      break;
-    }
-
-    iter->Next();
-  }
-
-  if (!(*s).ok()) {
-    return WriteBatchWithIndexInternal::Result::kError;
-  }
-
-  if (!iter->Valid()) {
-    // Read past end of results.  Reposition on last result.
-    iter->SeekToLast();
-  } else {
-    iter->Prev();
-  }
+  // batch, starting from the last entry of the key.
+  iter->SeekForPrev(key);
 
   Slice entry_value;
   while (iter->Valid()) {
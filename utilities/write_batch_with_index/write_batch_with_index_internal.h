@@ -7,7 +7,9 @@
 #ifndef ROCKSDB_LITE
 
 #include <limits>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "options/db_options.h"
@@ -23,12 +25,13 @@ namespace rocksdb {
 class MergeContext;
 struct Options;
 
-// Key used by skip list, as the binary searchable index of WriteBatchWithIndex.
+// Key used by WriteBatchEntryIndex, as the binary searchable index of
+// WriteBatchWithIndex.
 struct WriteBatchIndexEntry {
-  WriteBatchIndexEntry(size_t o, uint32_t c, size_t ko, size_t ksz)
+  WriteBatchIndexEntry(size_t o, uint32_t c, const char* kd, size_t ksz)
       : offset(o),
         column_family(c),
-        key_offset(ko),
+        key_data(kd),
         key_size(ksz),
         search_key(nullptr) {}
   // Create a dummy entry as the search key. This index entry won't be backed
@@ -45,7 +48,7 @@ struct WriteBatchIndexEntry {
       // entry who has the same search key. Otherwise, we'll miss those entries.
       : offset(is_forward_direction ? 0 : port::kMaxSizet),
         column_family(_column_family),
-        key_offset(0),
+        key_data(nullptr),
         key_size(is_seek_to_first ? kFlagMinInCf : 0),
         search_key(_search_key) {
     assert(_search_key != nullptr || is_seek_to_first);
@@ -57,10 +60,16 @@ struct WriteBatchIndexEntry {
 
   bool is_min_in_cf() const {
     assert(key_size != kFlagMinInCf ||
-           (key_offset == 0 && search_key == nullptr));
+           (key_data == nullptr && search_key == nullptr));
     return key_size == kFlagMinInCf;
   }
 
+  // REQUIRED: not a dummy look up entry.
+  Slice key() const {
+    assert(search_key == nullptr && !is_min_in_cf());
+    return Slice(key_data, key_size);
+  }
+
   // offset of an entry in write batch's string buffer. If this is a dummy
   // lookup key, in which case search_key != nullptr, offset is set to either
   // 0 or max, only for comparison purpose. Because when entries have the same
@@ -71,7 +80,9 @@ struct WriteBatchIndexEntry {
   // SeekForPrev() will see all the keys with the same key.
   size_t offset;
   uint32_t column_family;  // c1olumn family of the entry.
-  size_t key_offset;       // offset of the key in write batch's string buffer.
+  const char* key_data;    // copy of the key, allocated by the index right
+                           // after the entry, so that comparisons neither
+                           // decode the write batch nor depend on its buffer.
   size_t key_size;         // size of the key. kFlagMinInCf indicates
                            // that this is a dummy look up entry for
                            // SeekToFirst() to the beginning of the column
@@ -95,9 +106,8 @@ class ReadableWriteBatch : public WriteBatch {
 
 class WriteBatchEntryComparator {
  public:
-  WriteBatchEntryComparator(const Comparator* _default_comparator,
-                            const ReadableWriteBatch* write_batch)
-      : default_comparator_(_default_comparator), write_batch_(write_batch) {}
+  explicit WriteBatchEntryComparator(const Comparator* _default_comparator)
+      : default_comparator_(_default_comparator) {}
   // Compare a and b. Return a negative value if a is less than b, 0 if they
   // are equal, and a positive value if a is greater than b
   int operator()(const WriteBatchIndexEntry* entry1,
@@ -119,7 +129,114 @@ class WriteBatchEntryComparator {
  private:
   const Comparator* default_comparator_;
   std::vector<const Comparator*> cf_comparators_;
-  const ReadableWriteBatch* write_batch_;
+};
+
+// The ordered index of a WriteBatchWithIndex: a B+ tree of entries sorted by
+// WriteBatchEntryComparator. A node holds the pointers to up to kNodeSlots
+// entries or children next to each other, so a search touches a few cache
+// lines per level instead of one per skip list node, and the entries are
+// allocated together with their keys.
+//
+// Nodes, entries and keys are carved out of memory blocks owned by the index.
+// Clear() keeps the blocks and reuses them for the next entries, so that a
+// batch that is cleared and refilled, like the one of a transaction reused
+// with BeginTransaction(), stops allocating once it has seen its largest
+// size. Not thread-safe.
+class WriteBatchEntryIndex {
+  struct LeafNode;
+  struct InnerNode;
+
+ public:
+  explicit WriteBatchEntryIndex(const WriteBatchEntryComparator& cmp);
+  // No copying allowed
+  WriteBatchEntryIndex(const WriteBatchEntryIndex&) = delete;
+  void operator=(const WriteBatchEntryIndex&) = delete;
+
+  // Returns 8-byte aligned memory that stays valid until Clear().
+  char* Allocate(size_t bytes);
+
+  // REQUIRED: entry compares unequal to every entry in the index.
+  void Insert(WriteBatchIndexEntry* entry);
+
+  // Removes every entry. Invalidates the iterators and the memory returned by
+  // Allocate(), but keeps the memory blocks for reuse.
+  void Clear();
+
+  // Remains usable while entries are inserted: it then finds its entry again
+  // on the next move.
+  class Iterator {
+   public:
+    explicit Iterator(const WriteBatchEntryIndex* index);
+
+    bool Valid() const { return entry_ != nullptr; }
+
+    // REQUIRED: Valid()
+    WriteBatchIndexEntry* key() const {
+      assert(Valid());
+      return entry_;
+    }
+
+    void Next();
+    void Prev();
+    // Advance to the first entry >= target
+    void Seek(const WriteBatchIndexEntry* target);
+    // Retreat to the last entry <= target
+    void SeekForPrev(const WriteBatchIndexEntry* target);
+    void SeekToFirst();
+    void SeekToLast();
+
+   private:
+    const WriteBatchEntryIndex* index_;
+    const LeafNode* leaf_;
+    size_t pos_;
+    uint64_t version_;
+    WriteBatchIndexEntry* entry_;
+
+    // Moves to entry pos of leaf, or to the first entry of the next leaf if
+    // pos is past the end of leaf.
+    void SetPosition(const LeafNode* leaf, size_t pos);
+    // Relocates entry_ if entries were inserted since it was positioned.
+    void Sync();
+  };
+
+ private:
+  static const size_t kNodeSlots = 32;
+
+  struct Node {
+    bool is_leaf;
+    uint32_t num;
+  };
+  struct Path;
+
+  const WriteBatchEntryComparator& cmp_;
+  Node* root_;
+  LeafNode* first_leaf_;
+  LeafNode* last_leaf_;
+  // Incremented whenever the position of an entry may have changed.
+  uint64_t version_;
+
+  // Memory blocks, reused in order after Clear().
+  std::vector<std::pair<std::unique_ptr<char[]>, size_t>> blocks_;
+  // Blocks for large allocations, released by Clear().
+  std::vector<std::unique_ptr<char[]>> irregular_blocks_;
+  size_t blocks_in_use_;
+  char* alloc_ptr_;
+  size_t alloc_bytes_remaining_;
+
+  char* AllocateFallback(size_t bytes);
+  LeafNode* NewLeaf();
+  InnerNode* NewInner();
+
+  // Returns the leaf that holds the first entry >= target (or > target if
+  // or_equal), or the one before it. Records the inner nodes visited in
+  // *path if it is not null.
+  LeafNode* FindLeaf(const WriteBatchIndexEntry* target, bool or_equal,
+                     Path* path) const;
+  // Index of the first entry of leaf >= target (or > target if or_equal).
+  size_t FindInLeaf(const LeafNode* leaf, const WriteBatchIndexEntry* target,
+                    bool or_equal) const;
+  void InsertIntoParent(Path* path, Node* left, WriteBatchIndexEntry* separator,
+                        Node* right);
 };
 
 class WriteBatchWithIndexInternal {
@@ -10,6 +10,8 @@
 #ifndef ROCKSDB_LITE
 
 #include "rocksdb/utilities/write_batch_with_index.h"
+#include <functional>
+#include <iterator>
 #include <map>
 #include <memory>
 #include "db/column_family.h"
@@ -1387,6 +1389,122 @@ TEST_F(WriteBatchWithIndexTest, MutateWhileIteratingCorrectnessTest) {
   AssertKey("w", iter.get());
 }
 
+namespace {
+// Compares the entries of column family cf in batch with model, which maps
+// each key to its values in the order they were written.
+template <typename Model>
+void CheckLargeBatch(WriteBatchWithIndex* batch, ColumnFamilyHandle* cf,
+                     const Model& model, bool overwrite_key, Random* rnd) {
+  std::unique_ptr<WBWIIterator> iter(batch->NewIterator(cf));
+  iter->SeekToFirst();
+  for (const auto& kv : model) {
+    size_t n = overwrite_key ? 1 : kv.second.size();
+    for (size_t j = 0; j < n; j++) {
+      ASSERT_TRUE(iter->Valid());
+      WriteEntry entry = iter->Entry();
+      ASSERT_EQ(kv.first, entry.key.ToString());
+      ASSERT_EQ(kv.second[overwrite_key ? kv.second.size() - 1 : j],
+                entry.value.ToString());
+      iter->Next();
+    }
+  }
+  ASSERT_FALSE(iter->Valid());
+
+  iter->SeekToLast();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(model.rbegin()->first, iter->Entry().key.ToString());
+  ASSERT_EQ(model.rbegin()->second.back(),
+            iter->Entry().value.ToString());
+
+  for (int i = 0; i < 1000; i++) {
+    std::string key = ToString(rnd->Uniform(10000));
+    auto lb = model.lower_bound(key);
+    iter->Seek(key);
+    if (lb == model.end()) {
+      ASSERT_FALSE(iter->Valid());
+    } else {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(lb->first, iter->Entry().key.ToString());
+    }
+
+    auto ub = model.upper_bound(key);
+    iter->SeekForPrev(key);
+    if (ub == model.begin()) {
+      ASSERT_FALSE(iter->Valid());
+    } else {
+      --ub;
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(ub->first, iter->Entry().key.ToString());
+      ASSERT_EQ(ub->second.back(), iter->Entry().value.ToString());
+    }
+
+    std::string value;
+    Status s = batch->GetFromBatch(cf, DBOptions(), key, &value);
+    if (model.count(key) == 0) {
+      ASSERT_TRUE(s.IsNotFound());
+    } else {
+      ASSERT_OK(s);
+      ASSERT_EQ(model.find(key)->second.back(), value);
+    }
+  }
+}
+}  // namespace
+
+TEST_F(WriteBatchWithIndexTest, LargeBatchIndexTest) {
+  ColumnFamilyHandleImplDummy cf1(6, BytewiseComparator());
+  ColumnFamilyHandleImplDummy cf2(2, ReverseBytewiseComparator());
+  Random rnd(301);
+
+  for (bool overwrite_key : {false, true}) {
+    WriteBatchWithIndex batch(BytewiseComparator(), 0, overwrite_key);
+    // Refilling the batch after Clear() reuses the memory of the index
+    for (int round = 0; round < 2; round++) {
+      batch.Clear();
+      // The values of each key in the order they are written
+      std::map<std::string, std::vector<std::string>> model1;
+      std::map<std::string, std::vector<std::string>,
+               std::greater<std::string>>
+          model2;
+      std::unique_ptr<WBWIIterator> held_iter(batch.NewIterator(&cf1));
+      std::string held_key;
+      for (int i = 0; i < 20000; i++) {
+        // In order keys fill the leaves, random keys split them
+        std::string key = (i % 2 == 0) ? ToString(1000000 + i)
+                                       : ToString(rnd.Uniform(10000));
+        std::string value = ToString(i);
+        if (i % 3 == 0) {
+          ASSERT_OK(batch.Put(&cf2, key, value));
+          model2[key].push_back(value);
+        } else {
+          ASSERT_OK(batch.Put(&cf1, key, value));
+          model1[key].push_back(value);
+        }
+        if (i == 1000) {
+          held_iter->Seek(key);
+          ASSERT_TRUE(held_iter->Valid());
+          held_key = held_iter->Entry().key.ToString();
+        }
+      }
+
+      // An iterator positioned before the inserts still moves from its key
+      auto model_it = model1.find(held_key);
+      ASSERT_TRUE(model_it != model1.end());
+      ASSERT_EQ(held_key, held_iter->Entry().key.ToString());
+      held_iter->Prev();
+      if (model_it == model1.begin()) {
+        ASSERT_FALSE(held_iter->Valid());
+      } else {
+        ASSERT_TRUE(held_iter->Valid());
+        ASSERT_EQ(std::prev(model_it)->first,
+                  held_iter->Entry().key.ToString());
+      }
+
+      CheckLargeBatch(&batch, &cf1, model1, overwrite_key, &rnd);
+      CheckLargeBatch(&batch, &cf2, model2, overwrite_key, &rnd);
+    }
+  }
+}
+
 void AssertIterKey(std::string key, Iterator* iter) {
   ASSERT_TRUE(iter->Valid());
   ASSERT_EQ(key, iter->key().ToString());